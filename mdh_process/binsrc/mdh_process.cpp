@@ -73,9 +73,24 @@
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <cctype>
 #include <string>
+#include <deque>
+#include <map>
+#include <set>
+#include <algorithm>
 
 #include <sys/times.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <limits.h>
 #include <unistd.h>
 #include <C_scanopt.h>
 #include <stdlib.h>
@@ -92,9 +107,15 @@
 #include "c_SMessage.h"
 
 #include "asch.h"
+#include "c_ascconv.h"
+#include "c_options.h"
 #include "c_adcpack.h"
 #include "c_adc.h"
 #include "c_io.h"
+#include "c_container.h"
+#include "c_scheduler.h"
+#include "c_streamsocket.h"
+#include "c_volumering.h"
 
 //BEGIN: Added by Mohana R to accomodate Rec File Creation
 #include "RecFile.h"
@@ -109,9 +130,94 @@ typedef enum _savetype {
     e_native            = 0,
     e_mgh_realImag      = 10,
     e_mgh_magPhase      = 11,
-    e_analyze75_snorm   = 20
+    e_mgh_realImag4D    = 12,
+    e_mgh_magPhase4D    = 13,
+    e_analyze75_snorm   = 20,
+    e_nifti_complex     = 30
 } e_SAVETYPE;
 
+// How the raw data are unpacked within a --memoryBudget
+typedef enum _memoryplan {
+    e_planFull          = 0,            // all volumes of a channel at once
+    e_planGrouped       = 1,            // targeted passes over the raw data
+    e_planMinimal       = 2             // targeted passes, shiftInPlace
+} e_MEMORYPLAN;
+
+typedef struct _memoryPlan {
+    e_MEMORYPLAN	e_plan;
+    s_memoryFootprint	s_footprint;
+    int			channelsPerPass;	// unpacked together
+    int			echoesPerPass;
+    int			repetitionsPerPass;
+    int			passes;		// passes over the raw data
+    bool		b_shiftInPlace;
+    double		v_peak;		// estimated peak bytes
+} s_memoryPlan;
+
+// The volumes of one pass over the raw data, as ranges of positions in
+//	the run's channel/echo/repetition lists
+typedef struct _passUnits {
+    int			channel0,	channels;
+    int			echo0,		echoes;
+    int			repetition0,	repetitions;
+} s_passUnits;
+
+// A --batch manifest entry, or a --serve job request
+typedef struct _study {
+    string		str_inDir;
+    string		str_cfgFile;
+    string		str_outDir;
+    string		str_runID;
+    s_unpackTargets	s_targets;	// lists that override the
+					//	command line ones
+} s_study;
+
+// The command line options that apply to every study of a run
+typedef struct _studyOptions {
+    string		str_measFile;
+    s_unpackTargets	s_targets;
+    bool		b_preprocessSave;
+    bool		b_preprocessLoad;
+    int			argc;
+    char**		ppch_argv;
+} s_studyOptions;
+
+// A --serve job, and the client that requested it
+typedef struct _serveJob {
+    C_streamSocket*	pc_client;
+    s_study		s_job;
+} s_serveJob;
+
+// A --serve client whose request line has not all arrived yet
+typedef struct _serveRequest {
+    C_streamSocket*	pc_client;
+    time_t		since;		// when it connected
+} s_serveRequest;
+
+// A --distribute connection to a daemon, running one job at a time
+typedef struct _distributeSlot {
+    string		str_address;
+    C_streamSocket*	pc_daemon;	// connection of the running job
+    int			job;		// running job, or -1
+    bool		b_dead;		// unreachable, or went away
+    string		str_output;	// output of the running job
+    double		v_start;	// when the running job started (s)
+    int			jobs;		// jobs done
+    int			channels;	// channels done
+    double		v_busy;		// seconds spent on jobs done
+} s_distributeSlot;
+
+// Lines of the --serve protocol that are not job output
+const string		SERVE_TAG	= "mdh_serve: ";
+// A --serve client that has not sent its whole request line within
+//	this many seconds, or this many bytes, is turned away
+const int		SERVE_REQUESTTIMEOUT	= 10;
+const size_t		SERVE_REQUESTMAX	= 65536;
+
+// Seconds a run waits for the lock of a --sharedCache (held by the run
+//	populating it) before it goes on with a cache of its own
+const int		SHMCACHE_TIMEOUT	= VOLUMERING_TIMEOUT;
+
 //
 // within an OO type framework, one might consider the "top level" program
 //	that knits together all the objects pertaining to the program function
@@ -160,6 +266,64 @@ string			Gstr_outDir	    = "/tmp";	// Output dir containing recon'd
 
 e_SAVETYPE		Ge_saveType	    = e_mgh_realImag;
                                                         // Type of output data to save
+C_container*		Gpc_container	    = NULL;	// preprocess container, opened
+							//	on the first extracted
+							//	volume save/load
+bool			Gb_cache	    = true;	// automatic k-space cache
+string			Gstr_cacheDir	    = "";	// cache directory, defaults
+							//	to --inDir
+C_container*		Gpc_cache	    = NULL;	// k-space cache being built
+							//	by the current run
+bool			Gb_cacheCompress    = false;	// compress new preprocess/cache
+							//	containers
+bool			Gb_sharedCache	    = false;	// k-space cache in POSIX
+							//	shared memory
+string			Gstr_shmCache	    = "";	// the shared cache this
+							//	run uses
+int			G_shmLock	    = -1;	// its lock object, held
+							//	exclusively while
+							//	populating it
+int			G_shmUse	    = -1;	// the shared cache, held
+							//	(shared lock) while
+							//	in use
+bool			Gb_imageCache	    = false;	// keep/use reconstructed volumes
+C_container*		Gpc_imageCache	    = NULL;	// image cache, read or being
+							//	built by the current run
+string			Gstr_shmRing	    = "";	// --shmRing volume sink
+int			G_shmRingSlots	    = 4;	// ... its volumes
+int			G_shmRingReaders    = 1;	// ... and its readers
+int			G_shmRingTimeout    = VOLUMERING_TIMEOUT;
+							// ... seconds to wait
+							//	for them
+C_volumeRing*		Gpc_ring	    = NULL;	// the ring of the current
+							//	study
+CMatrix<double>*	GpM_ringVox2ras	    = NULL;	// vox2ras of its volumes
+bool			Gb_journal	    = false;	// keep a run journal
+bool			Gb_resume	    = false;	// skip the units the run
+							//	journal has done
+int			G_journal	    = -1;	// run journal, appended
+							//	to by every worker
+set<string>		G_journalDone;			// units verified done
+bool			Gb_autoDimension    = false;	// dimension from a header
+							//	pre-scan of meas.out
+int			G_reconWorkers	    = 1;	// reconstruction worker
+							//	processes per channel
+							//	(0: one per CPU)
+double			Gv_memoryBudget	    = 0.0;	// bytes the unpack and
+							//	recon may use
+							//	(0: no limit)
+string			Gstr_batchFile	    = "";	// manifest of studies to
+							//	process in this run
+bool			Gb_batchStudy	    = false;	// a batch or served study
+							//	is running: errors
+							//	abandon it rather
+							//	than exit
+string			Gstr_serveAddress   = "";	// --serve socket address
+int			G_serveJobs	    = 1;	// served jobs run at once
+string			Gstr_submitAddress  = "";	// --submit socket address
+string			Gstr_distribute	    = "";	// --distribute daemon
+							//	addresses
+volatile sig_atomic_t	Gb_serveStop	    = 0;	// SIGINT/SIGTERM seen
 
 //BEGIN: Added by Mohana R to create Rec File
 string		   	Gstr_recParamFile   = "";	// Rec Param file name 
@@ -198,6 +362,22 @@ static struct option const longopts[] =
   {"syslogPrepend",     no_argument, 	        NULL, 'p'},
   {"preprocessSave",    no_argument, 	        NULL, 'S'},
   {"preprocessLoad",    no_argument, 	        NULL, 'L'},
+  {"cacheDir",          required_argument,      NULL, 'C'},
+  {"noCache",           no_argument,            NULL, 'N'},
+  {"cacheCompress",     no_argument,            NULL, 'Z'},
+  {"sharedCache",       no_argument,            NULL, 'H'},
+  {"imageCache",        no_argument,            NULL, 'I'},
+  {"shmRing",           required_argument,      NULL, 'G'},
+  {"resume",            no_argument,            NULL, 'E'},
+  {"journal",           no_argument,            NULL, 'j'},
+  {"autoDimension",     no_argument,            NULL, 'A'},
+  {"reconWorkers",      required_argument,      NULL, 'W'},
+  {"memoryBudget",      required_argument,      NULL, 'B'},
+  {"batch",             required_argument,      NULL, 'b'},
+  {"serve",             required_argument,      NULL, 'Q'},
+  {"serveJobs",         required_argument,      NULL, 'J'},
+  {"submit",            required_argument,      NULL, 'U'},
+  {"distribute",        required_argument,      NULL, 'D'},
   {"version",           no_argument,            NULL, 'v'},
   {NULL, 0, NULL, 0}
 };
@@ -218,16 +398,27 @@ error_exit(
     //  Dumps a simple error message and then exits to syste with
     //  errorCode.
     //
+    //	While a --batch study is running, the study is abandoned instead:
+    //	errorCode is thrown back to batch_process().
+    //
     // HISTORY
     // 13 August 2003
     //  o Initial design and coding.
     //
+    // 19 October 2026
+    //	o Abandons a batch study rather than exiting.
+    //
 
     cerr << endl << G_SELF;
     cerr << endl << "\tDanger, Will Robinson!";
     cerr << endl << "\tWhile I was "    << str_action;
     cerr << endl << "\t"                << str_errorMsg;
     cerr << endl;
+    if(Gb_batchStudy) {
+	cerr << endl << "\tAbandoning this study with code " << errorCode;
+	cerr << endl;
+	throw(errorCode);
+    }
     cerr << endl << "\tExiting to system with code " << errorCode;
     cerr << endl;
     exit(errorCode);
@@ -285,6 +476,9 @@ synopsis_show(void) {
     cout << endl << "\t--optionsFile=<optionsFile>, -f <optionsFile>";
     cout << endl << "\tThe optionsFile specifies a filename containing meta-data information describing";
     cout << endl << "\tvolumetric data and other miscellaneous run-time parameters.";
+    cout << endl << "\tAll raw data records are unpacked unless \"recordReject\" is set: to an";
+    cout << endl << "\tevalInfoMask bit mask (e.g. 0x2000020) of records to skip, or to \"auxiliary\"";
+    cout << endl << "\tto skip the feedback, sync and noise adjust records that are never k-space.";
     cout << endl << "";
     cout << endl << "\t--meas=<measFile>, -m <measFile>";
     cout << endl << "\tThis specifies the Siemens meas.asc filename containing scan specific";
@@ -292,7 +486,12 @@ synopsis_show(void) {
     cout << endl << "";
     cout << endl << "\t--outDir=<outputDir>, -o <outputDir>";
     cout << endl << "\tThis defines the output directory to which the output image volumes will be written.";
-    cout << endl << "\tThe type of volume image is specified in the optionsFile.";
+    cout << endl << "\tThe type of volume image is specified in the optionsFile \"outputFormat\":";
+    cout << endl << "\t\t10: MGH real/imag, 11: MGH mag/phase, 20: analyze75 short norm,";
+    cout << endl << "\t\t12/13: as 10/11, but one multi-frame MGH per channel holding";
+    cout << endl << "\t\tall (repetition, echo) volumes, echoes fastest. The MGH trailer";
+    cout << endl << "\t\tholds the TE of the first echo only,";
+    cout << endl << "\t\t30: NIfTI-1 complex (single file per volume).";
     cout << endl << "";
     cout << endl << "\t--runID=<string>, -d <string>";
     cout << endl << "\tAn optional string can be defined that describes a current process run. This";
@@ -308,22 +507,22 @@ synopsis_show(void) {
     cout << endl << "\tLogs any output to the specified file. Can use stdout and stderr as file names to";
     cout << endl << "\tstream to standard output or standard error.";
     cout << endl << "";
-    cout << endl << "\t--channelTarget=<id>, -c <id>";
-    cout << endl << "\tParses raw data file *only* for the specified channel ID. All other channel data";
-    cout << endl << "\tis ignored";
+    cout << endl << "\t--channelTarget=<list>, -c <list>";
+    cout << endl << "\tParses raw data file *only* for the specified channel IDs. All other channel data";
+    cout << endl << "\tis ignored. A list is a comma separated set of IDs and ranges, e.g. \"0,3,7\" or";
+    cout << endl << "\t\"0-7,12\". The listed channels are unpacked in a single pass over the raw data.";
     cout << endl << "";
-    cout << endl << "\t--echoTarget=<num>, -e <num>";
-    cout << endl << "\tParses raw data file *only* for the specified echo.";
-    cout << endl << "\tThis parameter *must* be used in conjunction with --repetitionTarget";
+    cout << endl << "\t--echoTarget=<list>, -e <list>";
+    cout << endl << "\tParses raw data file *only* for the specified echoes (list as for --channelTarget).";
     cout << endl << "";
-    cout << endl << "\t--repetitionTarget=<num>, -r <num>";
-    cout << endl << "\tParses raw data file *only* for the specified repetition.";
-    cout << endl << "\tThis parameter *must* be used in conjunction with --echoTarget";
+    cout << endl << "\t--repetitionTarget=<list>, -r <list>";
+    cout << endl << "\tParses raw data file *only* for the specified repetitions (list as for";
+    cout << endl << "\t--channelTarget).";
     cout << endl << "";
     cout << endl << "\t--preprocessSave, -S";
     cout << endl << "\tForces unpack *only* (i.e. no reconstruction). Volumes are parsed from the raw data";
     cout << endl << "\tand packed into channel/echo/repetition images. Volumes are saved in --inDir";
-    cout << endl << "\tin a binary format using the --runID string as a file prefix and ending in <mdh>.";
+    cout << endl << "\tinto a single indexed container, <runID>_extracted.mdhc.";
     cout << endl << "\tSubsequent runs of this program can use --preprocessLoad to load these unpacked";
     cout << endl << "\tvolumes for reconstruction. Note that loading preprocessed volumes is considerably";
     cout << endl << "\tfaster than parsing the original raw data file.";
@@ -333,6 +532,135 @@ synopsis_show(void) {
     cout << endl << "\tinput volumes are loaded from --inDir and saved to --outDir. The --runID specifies";
     cout << endl << "\tthe file prefix name to load and is also used to construct the output filenames.";
     cout << endl << "";
+    cout << endl << "\t--cacheDir=<dir>, -C <dir>";
+    cout << endl << "\tUnless --preprocessSave or --preprocessLoad is given, unpacked volumes are";
+    cout << endl << "\tcached automatically, keyed on a fingerprint of meas.out and of the unpack";
+    cout << endl << "\trelated options. A later run with the same fingerprint (e.g. one that only";
+    cout << endl << "\tchanges the output format) loads the cache instead of parsing the raw data.";
+    cout << endl << "\tThe cache is kept in <dir>, which defaults to --inDir.";
+    cout << endl << "";
+    cout << endl << "\t--noCache, -N";
+    cout << endl << "\tDisables the automatic cache.";
+    cout << endl << "";
+    cout << endl << "\t--cacheCompress, -Z";
+    cout << endl << "\tStores --preprocessSave and cache volumes losslessly compressed (byte plane";
+    cout << endl << "\tshuffle + LZ, in parallel on \"IOthreads\" threads). Compressed volumes are";
+    cout << endl << "\tdecoded automatically on load.";
+    cout << endl << "";
+    cout << endl << "\t--sharedCache, -H";
+    cout << endl << "\tIf there is no k-space cache in --cacheDir, shares one in POSIX shared memory";
+    cout << endl << "\t(/dev/shm/mdhshm_<fingerprint>) between runs on the same raw data at the";
+    cout << endl << "\tsame time. The first run populates it while it unpacks; runs that start";
+    cout << endl << "\tmeanwhile wait for it to be complete, and then map it read only instead of";
+    cout << endl << "\tparsing the raw data themselves. The fingerprint leaves out --channelTarget,";
+    cout << endl << "\tso runs on different channels share a cache populated by a run on all of";
+    cout << endl << "\tthem; a run that needs volumes the shared cache lacks unpacks on its own.";
+    cout << endl << "\tThe last run to finish removes it. Shared volumes are never compressed.";
+    cout << endl << "\tA run does not wait for the cache longer than " << SHMCACHE_TIMEOUT
+	 << " s; it then unpacks";
+    cout << endl << "\ton its own.";
+    cout << endl << "";
+    cout << endl << "\t--imageCache, -I";
+    cout << endl << "\tAlso keeps the reconstructed (complex image) volumes in --cacheDir, keyed on";
+    cout << endl << "\tthe same fingerprint. A later run that differs only in its output settings";
+    cout << endl << "\t(outputFormat, readOutCrop, byteOrder, ...) then skips straight to saving.";
+    cout << endl << "";
+    cout << endl << "\t--shmRing=<name>[,<slots>[,<readers>[,<timeout>]]], -G <name>[,...]";
+    cout << endl << "\tPublishes the reconstructed complex volumes into a ring of <slots> (default";
+    cout << endl << "\t4) volumes in the POSIX shared memory object /<name> (/dev/shm/<name>),";
+    cout << endl << "\tinstead of saving them to --outDir. Each volume carries its channel, echo";
+    cout << endl << "\tand repetition and the vox2ras matrix of the options file; see";
+    cout << endl << "\tc_volumering.h for the layout. Exactly <readers> (default 1) local";
+    cout << endl << "\tconsumers must each take and release every volume: the reconstruction";
+    cout << endl << "\twaits for them while the ring is full, and a study only ends once they";
+    cout << endl << "\thave released all its volumes. The run fails rather than wait for more than";
+    cout << endl << "\t<timeout> (default 600) seconds for a slot, or for the last volumes to be";
+    cout << endl << "\treleased, as it would for a dead reader. The ring is created anew for each";
+    cout << endl << "\tstudy.";
+    cout << endl << "";
+    cout << endl << "\t--journal, -j";
+    cout << endl << "\tKeeps a journal, <outDir>/<runID>.mdhjournal, of the volumes the run has";
+    cout << endl << "\tsaved, with the size and checksum of each output file, and of the state";
+    cout << endl << "\tof the k-space cache, for a later --resume. This reads every output file";
+    cout << endl << "\tback once, and is off by default.";
+    cout << endl << "";
+    cout << endl << "\t--resume, -E";
+    cout << endl << "\tImplies --journal. A rerun of an interrupted run with a journal checks";
+    cout << endl << "\tthe files of the journal and only reconstructs the volumes that are";
+    cout << endl << "\tmissing; channels with none missing are not unpacked at all. A journal";
+    cout << endl << "\tof a run with other raw data or options is discarded. Not for 4D outputs,";
+    cout << endl << "\t--shmRing, --preprocessSave or --recParamFile, which write shared files.";
+    cout << endl << "";
+    cout << endl << "\t--autoDimension, -A";
+    cout << endl << "\tBefore anything is allocated, reads only the sMDH headers of meas.out";
+    cout << endl << "\t(skipping the samples) and sizes the line, partition/slice, echo and";
+    cout << endl << "\trepetition dimensions, the read out samples and the channel count to";
+    cout << endl << "\twhat the raw data actually hold. Differences to the meta data files";
+    cout << endl << "\tare reported.";
+    cout << endl << "";
+    cout << endl << "\t--reconWorkers=<n>, -W <n>";
+    cout << endl << "\tReconstructs the (repetition, echo) volumes of each channel on <n> worker";
+    cout << endl << "\tprocesses (0: one per online CPU) that share the unpacked k-space and";
+    cout << endl << "\tsteal work from each other. Fewer workers are used if their volumes would";
+    cout << endl << "\tnot fit in the available memory. Runs that read or write containers";
+    cout << endl << "\t(other than the k-space cache), write Rec files or save 4D MGH volumes";
+    cout << endl << "\treconstruct sequentially. The default is 1.";
+    cout << endl << "";
+    cout << endl << "\t--batch=<manifest>, -b <manifest>";
+    cout << endl << "\tProcesses every study listed in <manifest> in this one process, one study";
+    cout << endl << "\tafter the other, with the other options shared by all of them. Each line";
+    cout << endl << "\tof <manifest> holds the <inDir> <optionsFile> <outDir> <runID> of a study,";
+    cout << endl << "\toptionally followed by channels=<list>, echoes=<list> or repetitions=<list>";
+    cout << endl << "\t(see --channelTarget) to override the targets of the command line for that";
+    cout << endl << "\tstudy. Blank lines and lines starting with '#' are skipped. While a study is";
+    cout << endl << "\treconstructed, the raw data of the next one are read ahead into the page";
+    cout << endl << "\tcache. A study that fails is reported and skipped; the exit code is that of";
+    cout << endl << "\tthe last failed study (0 if all succeeded). Replaces --inDir, --optionsFile,";
+    cout << endl << "\t--outDir and --runID.";
+    cout << endl << "";
+    cout << endl << "\t--serve=<address>, -Q <address>";
+    cout << endl << "\tRuns as a recon daemon, listening on <address> for job requests (see";
+    cout << endl << "\t--submit). <address> is a Unix domain socket path (\"unix:<path>\", or any";
+    cout << endl << "\tpath containing a '/'), or a TCP \"[tcp:][<host>:]<port>\"; a port alone";
+    cout << endl << "\tlistens on the loopback interface only, and \"*:<port>\" on all of them.";
+    cout << endl << "\tA request is a line as in a --batch manifest. Jobs are queued, and each is";
+    cout << endl << "\trun in a process forked from the daemon, with the other options of the";
+    cout << endl << "\tdaemon's command line. Its output is streamed back to the client, followed";
+    cout << endl << "\tby a \"mdh_serve: done <code>\" line. SIGINT/SIGTERM stop the daemon once";
+    cout << endl << "\tthe running jobs have finished.";
+    cout << endl << "";
+    cout << endl << "\t--serveJobs=<n>, -J <n>";
+    cout << endl << "\tThe number of jobs a --serve daemon runs at once. The default is 1.";
+    cout << endl << "";
+    cout << endl << "\t--submit=<address>, -U <address>";
+    cout << endl << "\tSubmits the study of --inDir, --optionsFile, --outDir and --runID to the";
+    cout << endl << "\t--serve daemon at <address> instead of processing it, prints the job's";
+    cout << endl << "\toutput as it arrives, and exits with the job's code.";
+    cout << endl << "";
+    cout << endl << "\t--distribute=<addresses>, -D <addresses>";
+    cout << endl << "\tCoordinates the reconstruction of the study of --inDir, --optionsFile,";
+    cout << endl << "\t--outDir and --runID over the --serve daemons at the comma separated";
+    cout << endl << "\t<addresses>, rather than processing it here. The channels (all, or those of";
+    cout << endl << "\t--channelTarget) are split into groups, about two per daemon, that are";
+    cout << endl << "\tdispatched as channel targeted jobs to whichever daemon is free. Give an";
+    cout << endl << "\taddress more than once to keep several jobs running on that daemon (see";
+    cout << endl << "\t--serveJobs). The daemons read the raw data and write the volumes";
+    cout << endl << "\tthemselves, so --inDir and --outDir must be the same paths on all nodes; the";
+    cout << endl << "\tdaemons' own options (other than the targets) apply, and should not include";
+    cout << endl << "\t--preprocessSave or --recParamFile, whose files are per run. A job whose";
+    cout << endl << "\tdaemon goes away is dispatched again elsewhere. Reports the throughput of";
+    cout << endl << "\teach daemon; the exit code is that of the last failed job (0 if all";
+    cout << endl << "\tsucceeded).";
+    cout << endl << "";
+    cout << endl << "\t--memoryBudget=<size>, -B <size>";
+    cout << endl << "\tPlans the unpack to fit in <size> (in MB, or with a K, M, G or T suffix).";
+    cout << endl << "\tThe footprint of the k-space and the reconstruction is estimated from the";
+    cout << endl << "\tdimension lists, and the data are then unpacked either all channels at";
+    cout << endl << "\tonce, or in passes over as many channels as fit, or, if not even one channel";
+    cout << endl << "\tfits, in passes over groups of its repetitions or echoes (with shiftInPlace";
+    cout << endl << "\tif needed). The plan is printed before it is executed. Also caps the";
+    cout << endl << "\t--reconWorkers.";
+    cout << endl << "";
     cout << endl << "\t--syslogPrepend, -p";
     cout << endl << "\tPrepends output with syslog-style data/host stamps.";
     cout << endl << "";
@@ -388,7 +716,7 @@ RecFile_fileName_get(
 
 void 
 RecFile_flipAngle_set(
-	C_scanopt&	acso_meas) 
+	C_ascconv&	acso_meas) 
 {
     //
     // ARGS
@@ -412,7 +740,7 @@ RecFile_flipAngle_set(
 
 void  
 RecFile_paramFileData_set(
-	C_scanopt&	acso_meas) 
+	C_ascconv&	acso_meas) 
 {
     //
     // ARGS
@@ -645,6 +973,48 @@ volume_ifft() {
     COUTnl("\t\t[OK]\n");
 }
 
+void
+container_configure(
+    C_container*	apc_container
+) {
+    //
+    // ARGS
+    //	apc_container		in/out		container to configure
+    //
+    // DESC
+    //	Applies the run's encoding and thread settings to a container. The
+    //	thread count follows the "IOthreads" meta data option (0: one per
+    //	online CPU).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    int		threads	= Gpc_measOut->pc_dimension_get()->IOthreads_get();
+
+    if(threads <= 0)
+	threads	= sysconf(_SC_NPROCESSORS_ONLN);
+    apc_container->threads_set(threads);
+    // Shared memory volumes are mapped in place by the readers
+    if(Gb_cacheCompress && !apc_container->b_sharedMemory_get())
+	apc_container->e_encoding_set(e_encodingShuffleLZ);
+}
+
+string
+extract_containerName() {
+    //
+    // DESC
+    //	Name of the container holding all the extracted volumes of a run.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    return Gstr_inDir + "/" + Gstr_runID + "_extracted.mdhc";
+}
+
 void
 volume_extractSave(
     int		a_channelId,
@@ -671,18 +1041,26 @@ volume_extractSave(
     // 06 November 2003
     //	o Multichannel.
     //
+    // 19 October 2026
+    //	o All volumes of a run are appended to a single indexed container.
+    //
     
-    stringstream        sout("");
     char		ch;
     
     IFPAUSE( "Enter a char to continue" );
     COUT("\tsaving extracted volume:...\t\t");
-    sout << Gstr_inDir << "/" << Gstr_runID;
-    sout << "_extracted_channel" << a_channelId;
-    sout << "_echo" << a_echoIndex  << "_rep" << a_repetitionIndex;
-    sout << ".mdh"; 
-    Gpc_measOut->dataMemory_volumeSave(sout.str());
-    COUTnl("\t[OK]\n"); sout.str("");
+    if(!Gpc_container) {
+	Gpc_container	= new C_container(extract_containerName(), e_containerWrite);
+	if(!Gpc_container->b_isOpen())
+	    error_exit(	"saving extracted volumes",
+			"I could not create " + extract_containerName(), 1);
+    }
+    container_configure(Gpc_container);
+    if(!Gpc_measOut->dataMemory_volumeSave(	*Gpc_container, a_channelId,
+						a_echoIndex, a_repetitionIndex))
+	error_exit(	"saving extracted volumes",
+			"I could not write to " + extract_containerName(), 1);
+    COUTnl("\t[OK]\n");
 }
 
 void
@@ -701,6 +1079,10 @@ volume_extractLoad(
     //	Loads an extracted volume. An extracted volume is merely a "raw" volume
     //	that has been filtered out of the raw data file. 
     //
+    //	Volumes are picked from the run's container, which is mapped once.
+    //	If there is no container, the volume is read from an individual
+    //	<mdh> file as saved by earlier versions.
+    //
     // HISTORY
     // 22 October 2003
     //	o Initial design and coding.
@@ -708,795 +1090,3499 @@ volume_extractLoad(
     // 06 November 2003
     //	o Multichannel.
     //
+    // 19 October 2026
+    //	o Load from the run's container.
+    //
     
     stringstream        sout("");
     char		ch;
     
     IFPAUSE( "Enter a char to continue" );
     COUT("\tloading extracted volume:...\t\t");
-    sout << Gstr_inDir << "/" << Gstr_runID;
-    sout << "_extracted_channel" << a_channelId;
-    sout << "_echo" << a_echoIndex  << "_rep" << a_repetitionIndex;
-    sout << ".mdh"; 
+    if(!Gpc_container)
+	Gpc_container	= new C_container(extract_containerName(), e_containerRead);
     Gpc_measOut->dataMemory_volumeConstruct();
-    Gpc_measOut->dataMemory_volumeLoad(sout.str());
+    if(Gpc_container->b_isOpen()) {
+	container_configure(Gpc_container);
+	if(!Gpc_measOut->dataMemory_volumeLoad(	*Gpc_container, a_channelId,
+						a_echoIndex, a_repetitionIndex))
+	    error_exit(	"loading extracted volumes",
+			"I could not find the volume in " + extract_containerName(), 1);
+    } else {
+	sout << Gstr_inDir << "/" << Gstr_runID;
+	sout << "_extracted_channel" << a_channelId;
+	sout << "_echo" << a_echoIndex  << "_rep" << a_repetitionIndex;
+	sout << ".mdh"; 
+	Gpc_measOut->dataMemory_volumeLoad(sout.str());
+    }
     COUTnl("\t[OK]\n"); sout.str("");
 }
 
-void
-volume_saveAnalyze75(
-    int		a_channelId,
-    int		a_echoIndex,
-    int		a_repetitionIndex
+string
+cache_fingerprint(
+    const C_options&		ac_options,
+    C_dimensionLists*		apCdim,
+    int				a_channels,
+    const s_unpackTargets&	as_targets
 ) {
     //
     // ARGS
-    //	a_channelId		in		current channel being processed
-    //	a_echoIndex		in		current echo being processed
-    //	a_repetitionIndex	in		current rep being processed
+    //	ac_options		in		parsed options file
+    //	apCdim			in		dimension lists of the raw data
+    //	a_channels		in		channels in the raw data
+    //	as_targets		in		command line targets
     //
     // DESC
-    //	Saves an extracted volume.
+    //	Fingerprints everything that determines the unpacked volumes: the
+    //	raw data file (size, mtime and sampled contents), the unpack
+    //	related options and the dimension files they refer to, the
+    //	dimensions actually in effect (which --autoDimension may have
+    //	taken from the raw data instead), and the command line targets.
+    //	Output related options (outputFormat, readOutCrop, byteOrder, ...)
+    //	are deliberately left out, so that format-only re-runs hit the
+    //	cache.
     //
     // HISTORY
-    // 16 October 2003
+    // 19 October 2026
     //	o Initial design and coding.
+    //	o Hashes --autoDimension and the resolved dimension lists.
+    //	o Hashes the record filter in effect.
     //
-    // 22 October 2003
-    //	o Added repetition parameter
-    //
-    // 06 November 2003
-    //	o Multichannel.
-    //
-    
-    stringstream        sout("");
-    char		ch;
-    
-    IFPAUSE( "Enter a char to continue" );
-    COUT("\tSaving (short norm) of extracted volume... ");
-    sout << Gstr_outDir << "/" << Gstr_runID;
-    sout << "_channel" << a_channelId;
-    sout << "_echo" << a_echoIndex  << "_rep" << a_repetitionIndex;
-    sout << "-snorm";
-    Gpc_measOut->dataMemory_volumeSaveNorm(sout.str());
-    COUTnl("\t[OK]\n"); sout.str("");
+
+    const char*		ppch_keys[]	= {
+	"ADCbaseDirectory",	"ROpePCDimensionFile",	"kListDimensionFile",
+	"repListDimensionFile",	"echoListDimensionFile", "3DflagFile",
+	"channels",		"unpackWpadShift",	"packAdditionalData",
+	"phaseCorrect",		"shiftInPlace",		"recordReject",
+	NULL
+    };
+    const char*		ppch_files[]	= {
+	"ROpePCDimensionFile",	"kListDimensionFile",	"repListDimensionFile",
+	"echoListDimensionFile", NULL
+    };
+    unsigned long long	hash		= C_container::hash_update(
+					    CONTAINER_HASH_SEED, &CONTAINER_VERSION,
+					    sizeof(CONTAINER_VERSION));
+    string		str_value;
+    string		str_baseDir	= "";
+
+    hash	= C_container::file_fingerprint(
+				apCdim->str_ADCfileBaseName_get() + ".out", hash);
+    for(int i=0; ppch_keys[i]; i++) {
+	str_value	= "";
+	ac_options.scanFor(ppch_keys[i], &str_value);
+	hash	= C_container::hash_update(hash, str_value);
+    }
+    ac_options.scanFor("ADCbaseDirectory", &str_baseDir);
+    for(int i=0; ppch_files[i]; i++) {
+	str_value	= "";
+	if(ac_options.scanFor(ppch_files[i], &str_value))
+	    hash	= C_container::file_fingerprint(str_baseDir + "/" + str_value, hash);
+    }
+    str_value	= "";
+    if(ac_options.scanFor("3DflagFile", &str_value))
+	hash	= C_container::file_fingerprint(str_value, hash);
+    if(ac_options.str_bundleFile_get().length())
+	hash	= C_container::file_fingerprint(ac_options.str_bundleFile_get(), hash);
+    // The dimensions in effect, whether from the files or the raw data
+    CMatrix<int>	pM_lists[]	= {
+	apCdim->M_sliceSelectionList_get(),	apCdim->M_repetitionList_get(),
+	apCdim->M_echoList_get(),		apCdim->M_ROpePC_get()
+    };
+    int			autoDimension	= Gb_autoDimension;
+    unsigned		recordReject	= apCdim->recordReject_get();
+    hash	= C_container::hash_update(hash, &autoDimension, sizeof(autoDimension));
+    // The mask in effect, not the option's spelling ("auxiliary" or bits)
+    hash	= C_container::hash_update(hash, &recordReject, sizeof(recordReject));
+    hash	= C_container::hash_update(hash, &a_channels, sizeof(a_channels));
+    for(int list=0; list<4; list++) {
+	int	entries	= pM_lists[list].cols_get();
+	hash	= C_container::hash_update(hash, &entries, sizeof(entries));
+	for(int i=0; i<entries; i++) {
+	    int	entry	= pM_lists[list].val(0, i);
+	    hash	= C_container::hash_update(hash, &entry, sizeof(entry));
+	}
+    }
+    hash	= C_container::hash_update(hash,
+			C_adcPack::str_targetList(as_targets.v_channels)    + ";" +
+			C_adcPack::str_targetList(as_targets.v_echoes)      + ";" +
+			C_adcPack::str_targetList(as_targets.v_repetitions));
+
+    return C_container::hash_str(hash);
 }
 
-void
-volume_saveMGH(
-    int		a_channelId,
-    int		a_echoIndex,
-    int		a_repetitionIndex
+bool
+cache_complete(
+    C_container&		ac_cache,
+    const s_unpackTargets&	as_IO
 ) {
     //
     // ARGS
-    //	a_channelId		in		current channel being processed
-    //	a_echoIndex		in		current echo being processed
-    //	a_repetitionIndex	in		current rep being processed
+    //	ac_cache		in		cache opened for reading
+    //	as_IO			in		channels/echoes/repetitions of
+    //							the run, as named
     //
     // DESC
-    //	Saves an extracted volume.
+    //	Checks that the cache holds every volume that the main processing
+    //	loop will ask for, using the same channel/echo/repetition IO
+    //	indices as the loop.
     //
     // HISTORY
-    // 16 October 2003
+    // 19 October 2026
     //	o Initial design and coding.
+    //	o Target lists.
     //
-    // 22 October 2003
-    //	o Added repetition parameter
+
+    for(unsigned c=0; c<as_IO.v_channels.size(); c++)
+	for(unsigned r=0; r<as_IO.v_repetitions.size(); r++)
+	    for(unsigned e=0; e<as_IO.v_echoes.size(); e++)
+		if(!ac_cache.entry_find(as_IO.v_channels[c], as_IO.v_echoes[e],
+					as_IO.v_repetitions[r]))
+		    return false;
+    return true;
+}
+
+C_container*
+cache_lookup(
+    string			astr_fileName,
+    const s_unpackTargets&	as_IO
+) {
     //
-    // 06 November 2003
-    //	o Multichannel.
+    // ARGS
+    //	astr_fileName		in		cache file
+    //	as_IO			in		see cache_complete()
+    //
+    // DESC
+    //	Opens a cache for reading if it exists and is complete for this
+    //	run. Returns NULL otherwise.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of main().
     //
 
-    stringstream        sout("");
-    char		ch;
-    string              str_target;
-    e_IOTYPE            e_iotype;
-
-    IFPAUSE( "Enter a char to continue" );
-    for(int i=0; i<2; i++) {
-        switch(Ge_saveType) {
-            case e_mgh_realImag:
-                str_target      = !i ? "real" : "imag";
-                e_iotype        = !i ? e_real : e_imaginary;
-            break;
-            case e_mgh_magPhase:
-                str_target      = !i ? "mag" : "phase";
-                e_iotype        = !i ? e_magnitude : e_phase;
-            break;
-        }
+    if(access(astr_fileName.c_str(), R_OK))
+	return NULL;
 
-        COUT("\tSaving " + str_target + " component of extracted volume...");
-        sout << Gstr_outDir << "/" << Gstr_runID;
-        sout << "_channel" << a_channelId;
-        sout << "_echo" << a_echoIndex  << "_rep" << a_repetitionIndex;
-        sout << "-" << str_target << ".mgh";
-        Gpc_measOut->dataMemory_volumeSave( sout.str(), e_iotype);
-        COUTnl("\t[OK]\n"); sout.str("");
-    }
+    C_container*	pc_cache	= new C_container(astr_fileName, e_containerRead);
+    if(pc_cache->b_isOpen() && cache_complete(*pc_cache, as_IO))
+	return pc_cache;
+    delete pc_cache;
+    return NULL;
 }
 
-void
-volume_save(
-    int		a_channelId,
-    int		a_echoIndex,
-    int		a_repetitionIndex
+string
+tmp_reserve(
+    const string&	astr_fileName
 ) {
     //
     // ARGS
-    //	a_channelId		in		current channel being processed
-    //	a_echoIndex		in		current echo being processed
-    //	a_repetitionIndex	in		current rep being processed
+    //	astr_fileName		in		file to be written
     //
     // DESC
-    //	Dispatching layer to saving an extracted volume.
+    //	Reserves a temporary file next to astr_fileName, with a name
+    //	unique to this run, to build the file under before rename()ing
+    //	it into place. Concurrent runs writing the same file thus never
+    //	write into each other's temporary file.
+    //
+    // POSTCONDITIONS
+    //	o Returns the name of the (empty) temporary file, or "" if it
+    //	  could not be created.
     //
     // HISTORY
-    // 16 October 2003
+    // 19 October 2026
     //	o Initial design and coding.
     //
-    // 23 October 2003
-    //	o Initial design and coding.
+
+    string	str_template	= astr_fileName + ".tmp.XXXXXX";
+    vector<char>	v_name(str_template.begin(), str_template.end());
+    int		fd;
+
+    v_name.push_back('\0');
+    fd	= mkstemp(&v_name[0]);
+    if(fd < 0)
+	return "";
+    fchmod(fd, 0644);
+    close(fd);
+    return string(&v_name[0]);
+}
+
+C_container*
+cache_create(
+    string		astr_fileName
+) {
     //
-    // 06 November 2003
-    //	o Multichannel.
+    // ARGS
+    //	astr_fileName		in		cache file to build
     //
-    
-    switch(Ge_saveType) {
-        case e_mgh_magPhase:
-	case e_mgh_realImag:
-	    volume_saveMGH( a_channelId, a_echoIndex, a_repetitionIndex);
-	    break;
-	case e_analyze75_snorm:
-	    volume_saveAnalyze75( a_channelId, a_echoIndex, a_repetitionIndex);
-	    break;
+    // DESC
+    //	Creates a new cache under a temporary name - see cache_publish().
+    //	Returns NULL if the cache cannot be created.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of main().
+    //	o Temporary name unique to the run.
+    //
+
+    string		str_tmp		= tmp_reserve(astr_fileName);
+    C_container*	pc_cache;
+
+    if(!str_tmp.length())
+	return NULL;
+    pc_cache	= new C_container(str_tmp, e_containerWrite);
+    if(!pc_cache->b_isOpen()) {
+	delete pc_cache;
+	unlink(str_tmp.c_str());
+	pc_cache	= NULL;
     }
+    return pc_cache;
 }
 
-void
-volume_destruct() {
+int
+shmLock_acquire(
+    const string&		astr_name,
+    const s_unpackTargets*	aps_IO
+) {
+    //
+    // ARGS
+    //	astr_name		in		shared memory object name
+    //	aps_IO			in		see cache_complete(), or NULL
     //
     // DESC
-    //	Destructs an extracted volume.
+    //	Locks the "<name>.lock" object of a --sharedCache exclusively.
+    //	The run populating the cache holds the lock for as long as that
+    //	takes, with its channels written into the object: a run on
+    //	channels those do not cover (given aps_IO) would find the cache
+    //	incomplete anyway, and does not wait for it.
+    //
+    //	The object is removed with the cache (see shmCache_release()),
+    //	so a lock on an object no longer under its name is dropped and
+    //	taken again on the current one.
+    //
+    //	A populating run that hangs (or a very slow one) does not hold
+    //	the others up for longer than SHMCACHE_TIMEOUT seconds.
+    //
+    // POSTCONDITIONS
+    //	o Returns the locked object, -1 on failure, -2 if the cache is
+    //	  being populated for other channels, or -3 if the lock was not
+    //	  had within SHMCACHE_TIMEOUT seconds.
     //
     // HISTORY
-    // 16 October 2003
+    // 19 October 2026
     //	o Initial design and coding.
+    //	o Gives up after SHMCACHE_TIMEOUT seconds.
     //
-    //
-    
-    stringstream        sout("");
-    char		ch;
-    
-    IFPAUSE( "Enter a char to continue" );
-    sout << "\tDestructing extraced volume:...\t";
-    COUT(sout.str());    sout.str("");
-    Gpc_measOut->dataMemory_volumeDestruct(            e_normalKSpace);
-    COUTnl("\t\t[OK]\n"); sout.str("");
+
+    string		str_lock	= astr_name + ".lock";
+    time_t		deadline	= time(NULL) + SHMCACHE_TIMEOUT;
+    struct stat		st_held, st_named;
+    int			fd, fd_named;
+    char		pch_targets[1024];
+    ssize_t		length;
+    vector<int>		v_channels;
+    bool		b_covered;
+
+    while(true) {
+	fd	= shm_open(str_lock.c_str(), O_RDWR | O_CREAT, 0600);
+	if(fd < 0)
+	    return -1;
+	while(flock(fd, LOCK_EX | LOCK_NB)) {
+	    length	= pread(fd, pch_targets, sizeof(pch_targets)-1, 0);
+	    if(aps_IO && length > 0) {
+		pch_targets[length]	= '\0';
+		// "all" covers any run
+		if(strcmp(pch_targets, "all")) {
+		    b_covered	= C_adcPack::targetList_parse(pch_targets, v_channels);
+		    for(unsigned c=0; b_covered && c<aps_IO->v_channels.size(); c++)
+			b_covered	= binary_search(v_channels.begin(), v_channels.end(),
+						    aps_IO->v_channels[c]);
+		    if(!b_covered) {
+			close(fd);
+			return -2;
+		    }
+		}
+	    }
+	    if(time(NULL) >= deadline) {
+		close(fd);
+		return -3;
+	    }
+	    usleep(100000);
+	}
+	fd_named	= shm_open(str_lock.c_str(), O_RDWR, 0);
+	if(fd_named >= 0 && !fstat(fd, &st_held) && !fstat(fd_named, &st_named) &&
+	   st_held.st_ino == st_named.st_ino) {
+	    close(fd_named);
+	    return fd;
+	}
+	if(fd_named >= 0)
+	    close(fd_named);
+	flock(fd, LOCK_UN);
+	close(fd);
+    }
 }
 
 void
-volume_preprocess(	
-	int		echoIndex, 		
-	int		echoTarget,
-	int		repetitionIndex, 	
-	int		repetitionTarget) {
-    //
-    // ARGS
-    //	echoIndex		in		current echo loop
-    //	echoTarget		in		target echo passed from system
-    //	repetitionIndex		in		current repetition in loop	
-    //	repetitionTarget	in		target repetition passed from
-    //							system
+shmLock_release() {
     //
     // DESC
-    //	After some earlier design attempts, it was decided to add this
-    //	function as a mechanism to implement some IO-class specific
-    //	ability *before* starting the main reconstruction functions.
+    //	Clears and unlocks the lock object taken by shmLock_acquire().
     //
     // HISTORY
-    // 24 June 2004
+    // 19 October 2026
     //	o Initial design and coding.
     //
-    
-    stringstream        sout("");
-    char		ch;
-    
-    IFPAUSE( "Enter a char to continue" );
-    sout << "\tPreprocessing extracted volume:...\t";
-    COUT(sout.str());    sout.str("");
-    Gpc_measOut->dataMemory_volumePreprocess(	echoIndex,
-    						echoTarget,
-						repetitionIndex,
-						repetitionTarget,
-    						e_normalKSpace);
-    COUTnl("\t[OK]\n"); sout.str("");
-}
 
+    if(G_shmLock < 0)
+	return;
+    ftruncate(G_shmLock, 0);
+    flock(G_shmLock, LOCK_UN);
+    close(G_shmLock);
+    G_shmLock	= -1;
+}
 
-int
-main(
-    int     argc,
-    char    *ppch_argv[]) {
-
+void
+cache_publish(
+    C_container*	apc_cache,
+    string		astr_fileName,
+    bool		ab_ok
+) {
+    //
     // ARGS
-    //  argc        in          number of command line arguments
-    //  ppch_argv   in          char array of command line arguments
+    //	apc_cache		in		cache built by this run (or
+    //						NULL)
+    //	astr_fileName		in		final name of the cache
+    //	ab_ok			in		true if the run completed
+    //						normally
     //
     // DESC
-    //  Somewhat straightforward implementation of example usage of the
-    //  c_adcpack object class.
+    //	Closes a cache built by this run, and renames it into place if
+    //	the run was successful. Otherwise the partial cache is removed.
+    //	A shared memory cache is complete as it is, and only needs to be
+    //	released to the runs waiting for it.
     //
     // HISTORY
-    //  June/July 2003
-    //  o Initial design and development
-    //
-    //  August 2003
-    //  o Deployment and dedicated testing.
-    //
-    // 24 June 2004
-    //	o added volume "preprocess" step
+    // 19 October 2026
+    //	o Factored out of main().
+    //	o Shared memory caches.
     //
 
-    G_SELF              = ppch_argv[0];
-    stringstream        sout("");
-    
-    // Channel data
-    //	The main program processes channel information
-    int				allScanChannels = 0;	// Number of channels spec'd in
-                                                        //	meta file
-    const int			allPackChannels	= 1;	// adcPack will always contain
-                                                        //	1 channel (never more)
-    int				channelIndex	= 0;	// channel loop counter
-    int				totalChannels	= 1;	// number of channels to loop
-                                                        //	over. Set initially to
-                                                        //	1 but is variable.
-    int				echo, repetition; 	// dummy variable to hold current
-    							//	echo and repetition
-    // Some timing-related variables
-    float                       f_totalTimeCPU  = 0.0;
-    float                       f_totalTimeReal = 0.0;
-    float			f_echoTimeCPU	= 0.0;
-    float			f_echoTimeReal	= 0.0;
-    struct tms                  st_start, st_stop;		// CPU time for total
-    struct tms                  st_echoStart, st_echoStop;	// CPU time for echo
-    time_t			tt_start, tt_stop;	        // Real time for total
-    time_t			tt_echoStart, tt_echoStop;	// Real time for echo
-
-    // Parse command line options
-    int         option;
-    int		verbosity;
-    string      str_cfgFile         = "";
-    string	str_measFile	    = "meas.asc";
-    string	str_outDir	    = "/tmp";
-    string	str_logFile	    = "stdout";
-    int		echoTarget	    = -1;		// By default, parse all channels
-    int		repetitionTarget    = -1;		//	echoes, and repetitions 
-    int         channelTarget       = -1;               //      in data
-    bool	b_preprocessSave    = false;
-    bool	b_preprocessLoad    = false;
-    int         ret		    = 0;		// program return value    
-        
-    while(1) {
-        int opt;
-        int optionIndex = 0;
-        opt = getopt_long(argc, ppch_argv, "", longopts, &optionIndex);
-        if( opt == -1)
-            break;
-
-        switch(opt) {
-            case 'i':
-	        Gstr_inDir.assign(optarg, strlen(optarg));
-            break;
-            case 'o':
-	        Gstr_outDir.assign(optarg, strlen(optarg));
-            break;
-            case 'f':
-	        str_cfgFile.assign(optarg, strlen(optarg));
-            break;
-            case 't':
-	        verbosity = atoi(optarg);
-            break;
-            case 'l':
-	        str_logFile.assign(optarg, strlen(optarg));
-            break;
-            case 'm':
-	        str_measFile.assign(optarg, strlen(optarg));
-            break;
-            case 'c':
-	        channelTarget = atoi(optarg);
-            break;
-            case 'e':
-	        echoTarget = atoi(optarg);
-            break;
-            case 'r':
-	        repetitionTarget = atoi(optarg);
-            break;
-            case 'd':
-	        Gstr_runID.assign(optarg, strlen(optarg));
-            break;
-            case 'p':
-	        Gb_syslogPrepend = true;
-            break;
-            case 'L':
-	        b_preprocessLoad = true;
-            break;
-            case 'S':
-	        b_preprocessSave = true;
-            break;
-	    //BEGIN: Added by Mohana R to accomodate Rec File creation
-	    case 'R':
-	        Gstr_recParamFile.assign(optarg, strlen(optarg));
-            break;
-	    //END: Addition by Mohana R
-            case 'v':
-                version_show();
-            break;
-            case '?':
-                synopsis_show();
-                exit(1);
-            break;
-            default:
-                cout << "?? getopt returned character code " << opt << endl;
-        }
+    if(!apc_cache)
+	return;
+    if(apc_cache->b_sharedMemory_get()) {
+	if(!apc_cache->close() || !ab_ok)
+	    shm_unlink(apc_cache->str_fileName_get().c_str());
+	delete apc_cache;
+	shmLock_release();
+	return;
     }
+    if(apc_cache->close() && ab_ok)
+	rename(apc_cache->str_fileName_get().c_str(), astr_fileName.c_str());
+    else
+	unlink(apc_cache->str_fileName_get().c_str());
+    delete apc_cache;
+}
 
-    if((echoTarget!=-1 && repetitionTarget==-1) || (echoTarget==-1 && repetitionTarget!=-1))
-	error_exit("While checking command line options",
-		   "You must specify *both* an echo and repetition target",
-		   -1);
-   
-    //Gstr_inDir="/home/rudolph/proj/recon/data/test/";
-    //Gstr_inDir="/home/rudolph/proj/recon/data/gleek/203610";
-    //Gstr_inDir="/home/rudolph/proj/recon/data/multiChannelTest/2rep";
-    //Gstr_inDir="/home/rudolph/proj/recon/data/Ashok/111150";
-    //Gstr_inDir="/home/rudolph/proj/recon/data/gleek/Marianna/m4";
-    //Gstr_inDir="/home/rudolph/proj/recon/data/multiChannelTest/2rep_float_AF";
-    //Gstr_inDir="/home/rudolph/proj/recon/data/multiChannelTest/2rep_base";
-    //Gstr_inDir="/space/kaos/1/users/rudolph/data/recon/gleek/pfizer/may15_04/140708";
-    //str_cfgFile="measMetaData.asc";
-    //Gb_syslogPrepend = true;
-    //Gstr_runID = "multiTest2";
-    //Gstr_outDir = Gstr_inDir+"/recon";
-    //b_preprocessLoad = true;
-    //b_preprocessSave = true;
-    //echoTarget=0;
-    //repetitionTarget=0;
-    
-    if(str_cfgFile == "")
-	error_exit("parsing command line arguments", "I could not find metaData file spec!", 1);
-    
-    // Create the object that dumps status information
-    Gpcsm	= new C_SMessage("",
-			eSM_raw,	
-			str_logFile,
-			eSM_cpp);
-    Gpcsm->str_syslogID_set(Gstr_runID);
-
-    // and an options file parser
-    C_scanopt                   cso_optionsFile(    Gstr_inDir+"/"+str_cfgFile,
-						    e_EquLink);
-						    
-    // as well as a meas.asc parser for RecFile purposes
-    C_scanopt*			pcso_measFile;
-    if(Gstr_recParamFile.length())
-    	pcso_measFile	= new C_scanopt(	Gstr_inDir+"/"+str_measFile,
-						e_EquLink);
-
-    // Now setup the size of the volumetric space by parsing the options metaData file,
-    //	which will describe the dimension structure of the raw data. Note that the
-    //	unpack object will use this information, and will also create its *own* 
-    //	C_dimensionLists defining the actual data that it unpacked (which may be
-    //	a subset of the larger data set).
+C_container*
+shmCache_open(
+    const string&		astr_name,
+    const s_unpackTargets&	as_IO,
+    C_container*&		apc_build
+) {
     //
-    // The size of memory allocated to the C_adcPack->C_adc objects depends on the 
-    //	dimension structure of the problem space. If a "preprocessLoad" is true, there
-    //	is no need to allocate memory to hold unpacked information since the original
-    //	raw data file is never accessed. In such a case, unity dimension values are
-    //	passed to the C_adcPack object, and the C_adc objects have minimum size. Volumes
-    //	in such a case are read directly into the pVl_extracted variables from file.
+    // ARGS
+    //	astr_name		in		shared memory object name
+    //	as_IO			in		see cache_complete()
+    //	apc_build		out		cache that this run populates,
+    //						or NULL
+    //
+    // DESC
+    //	Opens the --sharedCache. Runs decide under an exclusive lock on
+    //	the (empty) "<name>.lock" object, which the run that populates
+    //	the cache keeps until it is complete: so a run that finds the
+    //	cache being populated waits for it. A cache left invalid by a
+    //	run that failed or died is replaced.
+    //
+    //	Every run using the cache keeps a shared lock on it; see
+    //	shmCache_release().
+    //
+    //	A cache is populated with the channels of the run populating it,
+    //	so runs on other channels do not wait for it (see
+    //	shmLock_acquire()) and fall back to a cache of their own. So do
+    //	runs that wait SHMCACHE_TIMEOUT seconds for it in vain.
+    //
+    // POSTCONDITIONS
+    //	o Returns the cache opened for reading if it is complete for this
+    //	  run. Otherwise returns NULL, with apc_build set if this run is
+    //	  to populate a new cache (through Gpc_cache), or NULL if the
+    //	  cache is another run's, or cannot be used at all.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Runs on other channels do not wait for a populating run.
+    //	o Nor any run for longer than SHMCACHE_TIMEOUT.
     //
-    //  The pCdim_disk describes the dimension structure as parsed from the metaData file.
-    //	The pCdim_unity describes a "unity" dimension structure, used when not accessing
-    //	the original raw data file.
-    C_dimensionLists*	pCdim_disk	= new C_dimensionLists(Gstr_inDir+"/"+str_cfgFile);
-    C_dimensionLists*	pCdim_unity	= new C_dimensionLists();
-    C_dimensionLists*	pCdim;
-
-    // By creating the dimensionLists structure with no arguments we force unity
-    //	dimensions. We still need to set the optionsFileName, though.
-    pCdim_unity->str_optionsFileName_set(Gstr_inDir+"/"+str_cfgFile);
-
-    // Which dimension structure do we use?
-    if(b_preprocessLoad)
-	pCdim	= pCdim_unity;
-    else
-	pCdim	= pCdim_disk;
 
-    // Parse optionsFile for any additional meta data...
-    pCdim->metaData_parse();
+    stringstream	sout("");
+    C_container*	pc_cache	= NULL;
+    int			fd;
+    string		str_channels;
 
-    Gpcsm->timer(eSM_start);
+    apc_build		= NULL;
+    G_shmLock		= shmLock_acquire(astr_name, &as_IO);
+    if(G_shmLock < 0) {
+	if(G_shmLock == -3) {
+	    sout << "\tShared k-space cache " << astr_name << " still locked after "
+		 << SHMCACHE_TIMEOUT << " s; using a cache of this run's own" << endl;
+	    COUT(sout.str()); sout.str("");
+	}
+	G_shmLock	= -1;
+	return NULL;
+    }
 
-    string		str_value   	= "";
-    string		str_dim		= "3D";
-    if(cso_optionsFile.scanFor("3DflagFile", &str_value)) {
-    	CMatrix<int>	bM_3D((char*)str_value.c_str());
-	Gb_is3D		= bM_3D.val(0, 0);
-	if(!Gb_is3D)	str_dim		= "2D";
+    fd	= shm_open(astr_name.c_str(), O_RDONLY, 0);
+    if(fd >= 0) {
+	close(fd);
+	pc_cache	= new C_container(astr_name, e_containerRead, true);
+	if(!pc_cache->b_isOpen()) {
+	    delete pc_cache;
+	    pc_cache	= NULL;
+	    shm_unlink(astr_name.c_str());
+	} else if(!cache_complete(*pc_cache, as_IO)) {
+	    delete pc_cache;
+	    shmLock_release();
+	    return NULL;
+	}
+    }
+    if(!pc_cache) {
+	apc_build	= new C_container(astr_name, e_containerWrite, true);
+	if(!apc_build->b_isOpen()) {
+	    delete apc_build;
+	    apc_build	= NULL;
+	    shmLock_release();
+	    return NULL;
+	}
+	// Tell the runs that come meanwhile which channels it will hold
+	str_channels	= C_adcPack::str_targetList(as_IO.v_channels);
+	if(pwrite(G_shmLock, str_channels.c_str(), str_channels.length(), 0) !=
+	   (ssize_t) str_channels.length())
+	    ftruncate(G_shmLock, 0);
     }
-    COUT("Acquisition dimensionality\t\t\t\t");
-    COUTnl("[" + str_dim + "]\n");
 
-    times(&st_start); time(&tt_start);
-    COUT("allocating memory for unpacked data... ");
+    Gstr_shmCache	= astr_name;
+    G_shmUse		= shm_open(astr_name.c_str(), O_RDONLY, 0);
+    if(G_shmUse >= 0)
+	flock(G_shmUse, LOCK_SH);
+    if(pc_cache)
+	shmLock_release();
+    return pc_cache;
+}
 
-    // The core object that unpacks and stores raw data - remember that by spec'ing a
-    //  non -1 value for the echo/repetitionTargets, the object will "home in" on
-    //  only the spec'd echo/repetition pair.
+void
+shmCache_release() {
+    //
+    // DESC
+    //	Lets go of the --sharedCache at the end of a run. The last run
+    //	using it - the only one that can then lock it exclusively -
+    //	removes it together with its lock object, so that the memory is
+    //	returned once the concurrent runs are over. Runs that still have
+    //	it mapped are not affected.
+    //
+    //	This is decided under the lock object, since runs only take
+    //	their shared lock on the cache while holding it. A run that
+    //	cannot get the lock object just lets go of the cache, and
+    //	leaves it to a later run to remove.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Removes the lock object as well.
+    //	o Removes nothing without the lock object.
+    //
 
-    e_SAVETYPE		e_saveType;
-    if(cso_optionsFile.scanFor("outputFormat", &str_value))
-	Ge_saveType	= (e_SAVETYPE) atoi(str_value.c_str());
-    else
-	error_exit("parsing options file",
-	           "could not find \"outputFormat\" spec in\n" + Gstr_inDir+"/"+str_cfgFile,
-		   1);
-    if(cso_optionsFile.scanFor("channels", &str_value))
-	allScanChannels	= atoi(str_value.c_str());
-    else
-	error_exit("parsing options file",
-	           "could not find \"channels\" spec in\n" + Gstr_inDir+"/"+str_cfgFile,
-		   1);
+    if(G_shmUse >= 0) {
+	if(G_shmLock < 0)
+	    G_shmLock	= shmLock_acquire(Gstr_shmCache, NULL);
+	if(G_shmLock < 0)
+	    G_shmLock	= -1;
+	flock(G_shmUse, LOCK_UN);
+	if(G_shmLock >= 0 && !flock(G_shmUse, LOCK_EX | LOCK_NB)) {
+	    shm_unlink(Gstr_shmCache.c_str());
+	    shm_unlink((Gstr_shmCache + ".lock").c_str());
+	}
+	close(G_shmUse);
+	G_shmUse	= -1;
+    }
+    shmLock_release();
+    Gstr_shmCache	= "";
+}
 
+void
+cache_volumeSave(
+    int		a_channelId,
+    int         a_echoIndex,
+    int         a_repetitionIndex 
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //
+    // DESC
+    //	Adds a freshly extracted volume to the k-space cache. A cache
+    //	that cannot be written is simply dropped: it is an optimisation
+    //	only, and never fails a run.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
 
-    switch(Ge_saveType) {
-	case e_mgh_realImag:
-        case e_mgh_magPhase:
-	    Gpc_measOut		= new C_adcPack_mgh(pCdim->str_ADCfileBaseName_get(),
-                                    &(*pCdim),
-                                    Gb_is3D,
-				    echoTarget,
-				    repetitionTarget);
-	break;
-	case e_analyze75_snorm:
-	    Gpc_measOut		= new C_adcPack_analyze75(pCdim->str_ADCfileBaseName_get(),
-                                    &(*pCdim),
-                                    Gb_is3D,
-				    echoTarget,
-				    repetitionTarget);
-	break;
-        default:
-	    error_exit(	"checking options file " + str_cfgFile, 
-	    		"No valid output save types found", 1);
-        break;
+    if(!Gpc_cache)
+	return;
+    container_configure(Gpc_cache);
+    if(!Gpc_measOut->dataMemory_volumeSave(	*Gpc_cache, a_channelId,
+						a_echoIndex, a_repetitionIndex)) {
+	COUT("\tk-space cache disabled for this run (write failed)\n");
+	cache_publish(Gpc_cache, "", false);
+	Gpc_cache	= NULL;
     }
+}
 
-    COUTnl("\t\t\t[OK]\n");
+void
+image_cacheSave(
+    int		a_channelId,
+    int         a_echoIndex,
+    int         a_repetitionIndex 
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //
+    // DESC
+    //	Adds a reconstructed (post fftshift) volume to the image cache.
+    //	As with the k-space cache, a failing image cache is dropped.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
 
-    //BEGIN: Added by Mohana R to accomodate Rec File cretaion
-    if(Gstr_recParamFile != "") {
-	RecFile::setOptedFor(true);
-	RecFile::getInstance()->setOutDir(Gstr_outDir);
-	RecFile_paramFileData_set(*pcso_measFile);
-	RecFile_flipAngle_set(*pcso_measFile);
+    if(!Gpc_imageCache)
+	return;
+    container_configure(Gpc_imageCache);
+    if(!Gpc_measOut->dataMemory_volumeSave(	*Gpc_imageCache, a_channelId,
+						a_echoIndex, a_repetitionIndex)) {
+	COUT("\timage cache disabled for this run (write failed)\n");
+	unlink(Gpc_imageCache->str_fileName_get().c_str());
+	delete Gpc_imageCache;
+	Gpc_imageCache	= NULL;
     }
-    //END: Addition by Mohana R
-   
-    
-    totalChannels	= allScanChannels;
-    if(channelTarget!=-1)
-	totalChannels	= 1;
+}
 
+void
+volume_imageLoad(
+    int		a_channelId,
+    int         a_echoIndex, 
+    int         a_repetitionIndex
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //
+    // DESC
+    //	Loads a reconstructed volume from the image cache, ready to be
+    //	saved.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
 
-    // Now we process the data. The outer loop is the channel id.
-    for(channelIndex=0; channelIndex<totalChannels; channelIndex++) {
-	Gpc_measOut->channelTarget_set(channelIndex);
-	if(channelTarget!=-1)
-	    Gpc_measOut->channelTarget_set(channelTarget);
-        
-	// Variables spec'ing the particular volume data to process
-	e_KSPACEDATATYPE        e_kspace	= e_normalKSpace;
-	int                     repetitionIndex = 0;
-	int                     echoIndex       = 0;
-    
-	//	allScanEchoes are the echoes in the raw data
-	//	allPackEchoes are the echoes in the unpacked C_adcPack object
-	//	(likewise for the repetition counters).
-	//	NOTE that echoes and repetitions are indexed starting from zero (0)
-	int	                allScanEchoes   = pCdim_disk->M_echoList_get().cols_get();
-	int			allPackEchoes	= Gpc_measOut->pc_dimension_get()->
-						  M_echoList_get().cols_get();
-	int	                allScanReps     = pCdim_disk->M_repetitionList_get().cols_get();
-	int			allPackReps	= Gpc_measOut->pc_dimension_get()->
-						  M_repetitionList_get().cols_get();
-	int			sampleCount	= 0;
+    char		ch;
+
+    IFPAUSE( "Enter a char to continue" );
+    COUT("\tloading cached image volume:...\t\t");
+    container_configure(Gpc_imageCache);
+    Gpc_measOut->dataMemory_volumeConstruct();
+    if(!Gpc_measOut->dataMemory_volumeLoad(	*Gpc_imageCache, a_channelId,
+						a_echoIndex, a_repetitionIndex))
+	error_exit(	"loading cached image volumes",
+			"I could not find the volume in " +
+			Gpc_imageCache->str_fileName_get(), 1);
+    COUTnl("\t[OK]\n");
+}
+
+string
+output_base(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    //
+    // ARGS
+    //	a_channelId		in		channel of the volume
+    //	a_echoIndex		in		echo of the volume
+    //	a_repetitionIndex	in		repetition of the volume
+    //
+    // DESC
+    //	The path of the output files of a volume, less their suffixes.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of the volume_save*() functions.
+    //
+
+    stringstream        sout("");
+
+    sout << Gstr_outDir << "/" << Gstr_runID;
+    sout << "_channel" << a_channelId;
+    sout << "_echo" << a_echoIndex  << "_rep" << a_repetitionIndex;
+    return sout.str();
+}
+
+void
+volume_saveAnalyze75(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //
+    // DESC
+    //	Saves an extracted volume.
+    //
+    // HISTORY
+    // 16 October 2003
+    //	o Initial design and coding.
+    //
+    // 22 October 2003
+    //	o Added repetition parameter
+    //
+    // 06 November 2003
+    //	o Multichannel.
+    //
     
-	times(&st_start); time(&tt_start);
-	// Reading from disk / unpacking into memory
+    stringstream        sout("");
+    char		ch;
     
-	if(!b_preprocessLoad) {
-	    //
-	    // If we are not to load preprocessed volumes, crunch through the
-	    //	original raw data file. This is the default beahviour.
-	    //
-	    sout << "Channel " << (channelTarget==-1?channelIndex:channelTarget) << endl;
-	    COUT(sout.str()); sout.str("");
-	    COUT("Header processing... ");
-	    Gpc_measOut->headerFile_process();         COUTnl("\t\t\t\t\t[OK]\n");
-	    COUT("Data file processing... ");
-	    sampleCount = Gpc_measOut->dataFile_process();
-	    sout << "(" << sampleCount << " samples processed)"; COUTnl(sout.str()); sout.str("");
-	    COUTnl("\t[OK]\n"); sout.str("");
-	    times(&st_stop); time(&tt_stop);
-	    f_totalTimeCPU  = difftime(st_stop.tms_utime, st_start.tms_utime) / 100;
-	    f_totalTimeReal = difftime(tt_stop, tt_start);
-	    sout << "\tTotal CPU time for raw data preprocessing: ";
-	    COUT(sout.str());   sout.str("");
-	    sout <<  f_totalTimeCPU << " seconds." << endl;
-	    COUTnl(sout.str()); sout.str("");
-	    sout << "\tTotal core time for raw data preprocessing: ";
-	    COUT(sout.str());   sout.str("");
-	    sout <<  f_totalTimeReal << " seconds." << endl << endl;
-	    COUTnl(sout.str()); sout.str("");
-	    
-	    if(!sampleCount) {
-		sout << "No samples were found in raw data file corresponding to:" << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "\tChannel\t\t     ";
-		sout << Gpc_measOut->channelTarget_get()                           << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "\tEcho\t\t     ";
-		sout << Gpc_measOut->echoTarget_get()                              << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "\tRepetition\t     ";
-		sout << Gpc_measOut->repetitionTarget_get()                        << endl;
-		COUT(sout.str()); sout.str("");
-		ret = 1;
-		continue;
-	    }
+    IFPAUSE( "Enter a char to continue" );
+    COUT("\tSaving (short norm) of extracted volume... ");
+    sout << output_base(a_channelId, a_echoIndex, a_repetitionIndex);
+    sout << "-snorm";
+    Gpc_measOut->dataMemory_volumeSaveNorm(sout.str());
+    COUTnl("\t[OK]\n"); sout.str("");
+}
+
+void
+volume_saveMGH(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex,
+    int		a_frame,
+    int		a_frames
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //	a_frame			in		frame of the current volume in
+    //							a multi-frame save
+    //	a_frames		in		total frames in a multi-frame
+    //							save
+    //
+    // DESC
+    //	Saves an extracted volume.
+    //
+    //	For the 4D save types, all echoes/repetitions of a channel are
+    //	streamed into a single multi-frame file per component, with the
+    //	current volume written as frame <a_frame>.
+    //
+    // HISTORY
+    // 16 October 2003
+    //	o Initial design and coding.
+    //
+    // 22 October 2003
+    //	o Added repetition parameter
+    //
+    // 06 November 2003
+    //	o Multichannel.
+    //
+    // 19 October 2026
+    //	o Multi-frame (4D) saving.
+    //
+
+    stringstream        sout("");
+    char		ch;
+    string              str_target;
+    e_IOTYPE            e_iotype;
+    bool		b_4D	= (Ge_saveType == e_mgh_realImag4D ||
+				   Ge_saveType == e_mgh_magPhase4D);
+
+    IFPAUSE( "Enter a char to continue" );
+    for(int i=0; i<2; i++) {
+        switch(Ge_saveType) {
+            case e_mgh_realImag:
+            case e_mgh_realImag4D:
+                str_target      = !i ? "real" : "imag";
+                e_iotype        = !i ? e_real : e_imaginary;
+            break;
+            case e_mgh_magPhase:
+            case e_mgh_magPhase4D:
+                str_target      = !i ? "mag" : "phase";
+                e_iotype        = !i ? e_magnitude : e_phase;
+            break;
+        }
+
+        COUT("\tSaving " + str_target + " component of extracted volume...");
+	if(b_4D) {
+	    sout << Gstr_outDir << "/" << Gstr_runID;
+	    sout << "_channel" << a_channelId;
+	    sout << "-" << str_target << ".mgh";
+	    Gpc_measOut->dataMemory_volumeFrameSave( sout.str(), e_iotype,
+						     a_frame, a_frames);
+	} else {
+	    sout << output_base(a_channelId, a_echoIndex, a_repetitionIndex);
+	    sout << "-" << str_target << ".mgh";
+	    Gpc_measOut->dataMemory_volumeSave( sout.str(), e_iotype);
 	}
-	
+        COUTnl("\t[OK]\n"); sout.str("");
+    }
+}
 
-	//
-	// Quick analysis table
-	//
-	sout << "\tData analysis / run summary:-"	<< endl;
-	COUT(sout.str()); sout.str("");
-	sout << "\t\tRaw Data\t\tadcPack"	        << endl;
-	COUT(sout.str()); sout.str("");
-	sout << "Channels\t    "    << allScanChannels  << "\t\t\t    " << allPackChannels  << endl;
-	COUT(sout.str()); sout.str("");
-	sout << "Echoes\t\t    "    << allScanEchoes    << "\t\t\t    " << allPackEchoes    << endl;
-	COUT(sout.str()); sout.str("");
-	sout << "Repetitions\t    " << allScanReps	<< "\t\t\t    " << allPackReps	    << endl;
-	COUT(sout.str()); sout.str("");
-	sout << endl;
-	COUT(sout.str()); sout.str("");
-    
-	//
-	// The main processing loop indices depend on several factors:
-	//	1. Size of internally unpacked objects (if read from raw data)
-	//	2. Target echoes/repetitions if specified
-	//	3. Loading of preprocessed data
-	//
-	// NB! Note that the order of the following 'if' processing is important!
+void
+volume_saveNIfTI(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //
+    // DESC
+    //	Saves an extracted volume as a single complex NIfTI-1 file.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    stringstream        sout("");
+    char		ch;
+
+    IFPAUSE( "Enter a char to continue" );
+    COUT("\tSaving complex extracted volume...");
+    sout << output_base(a_channelId, a_echoIndex, a_repetitionIndex);
+    sout << ".nii";
+    Gpc_measOut->dataMemory_volumeSave( sout.str(), e_complex);
+    COUTnl("\t\t[OK]\n"); sout.str("");
+}
+
+void
+volume_publish(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //
+    // DESC
+    //	Hands an extracted volume to the --shmRing readers.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    char		ch;
+
+    IFPAUSE( "Enter a char to continue" );
+    COUT("\tPublishing extracted volume to " + Gpc_ring->str_ringName_get() + "...");
+    if(!Gpc_ring->volume_publish(a_channelId, a_echoIndex, a_repetitionIndex,
+				 Gpc_measOut->dataMemory_volumeGet(e_normalKSpace),
+				 *GpM_ringVox2ras))
+	error_exit(	"publishing to " + Gpc_ring->str_ringName_get(),
+			"the volume does not fit in a slot of the ring, or the readers\n"
+			"did not take the volumes before it in time", 1);
+    COUTnl("\t[OK]\n");
+}
+
+void
+volume_save(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex,
+    int		a_frame		= 0,
+    int		a_frames	= 1
+) {
+    //
+    // ARGS
+    //	a_channelId		in		current channel being processed
+    //	a_echoIndex		in		current echo being processed
+    //	a_repetitionIndex	in		current rep being processed
+    //	a_frame			in		frame of the current volume
+    //	a_frames		in		total frames per channel
+    //
+    // DESC
+    //	Dispatching layer to saving an extracted volume.
+    //
+    // HISTORY
+    // 16 October 2003
+    //	o Initial design and coding.
+    //
+    // 23 October 2003
+    //	o Initial design and coding.
+    //
+    // 06 November 2003
+    //	o Multichannel.
+    //
+    // 19 October 2026
+    //	o --shmRing replaces the saves.
+    //
+
+    if(Gpc_ring) {
+	volume_publish(a_channelId, a_echoIndex, a_repetitionIndex);
+	return;
+    }
+    switch(Ge_saveType) {
+        case e_mgh_magPhase:
+	case e_mgh_realImag:
+        case e_mgh_magPhase4D:
+	case e_mgh_realImag4D:
+	    volume_saveMGH( a_channelId, a_echoIndex, a_repetitionIndex,
+			    a_frame, a_frames);
+	    break;
+	case e_analyze75_snorm:
+	    volume_saveAnalyze75( a_channelId, a_echoIndex, a_repetitionIndex);
+	    break;
+	case e_nifti_complex:
+	    volume_saveNIfTI( a_channelId, a_echoIndex, a_repetitionIndex);
+	    break;
+    }
+}
+
+void
+volume_destruct() {
+    //
+    // DESC
+    //	Destructs an extracted volume.
+    //
+    // HISTORY
+    // 16 October 2003
+    //	o Initial design and coding.
+    //
+    //
     
-	int totalReps	    = allScanReps;
-	int totalEchoes     = allScanEchoes;
-    	
-	if(echoTarget!=-1 && repetitionTarget !=-1)	{
-	    totalReps       = 1;
-	    totalEchoes	    = 1;
-	}	
-	
-	// 
-	// Set of variables that identifies channels/echoes/repetitions for
-	//	file I/O
-	//
-	int channelIO;
-	int echoIO;
-	int repetitionIO;
+    stringstream        sout("");
+    char		ch;
     
-	// main processing loops: repetitions and echoes
-	for(repetitionIndex=0; repetitionIndex<totalReps; repetitionIndex++) {
-	    for(echoIndex=0; echoIndex<totalEchoes; echoIndex++) {
-	    	if(echoTarget==-1)
-		    echo = echoIndex;
-		else 
-		    echo = echoTarget;
-	    	if(repetitionTarget==-1)
-		    repetition = repetitionIndex;
-		else 
-		    repetition = repetitionTarget;
-		times(&st_echoStart); time(&tt_echoStart);
-		sout << "\tCurrent Processing Loop:"            << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "\t\tRaw Data\t\tadcPack"	        << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "Channel\t\t     ";
-		sout << (channelTarget!=-1?channelTarget:channelIndex);
-		sout << "\t\t\t    "<< allPackChannels     << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "Echo\t\t     ";
-		sout << (echoTarget!=-1?echoTarget:echoIndex);
-		sout << "\t\t\t    " << allPackEchoes      << endl;
-		COUT(sout.str()); sout.str("");
-		sout << "Repetition\t     ";
-		sout << (repetitionTarget!=-1?repetitionTarget:repetitionIndex);
-		sout << "\t\t\t    " << allPackReps	   << endl;
-		COUT(sout.str()); sout.str("");
-		
-		// Determine channel/echo/repetition IO
-		if(channelTarget==-1 && echoTarget==-1 && repetitionTarget==-1) {
-		    channelIO		= channelIndex; 
-		    echoIO 		= echoIndex;
-		    repetitionIO	= repetitionIndex;
-		}
-		if(channelTarget==-1 && echoTarget!=-1 && repetitionTarget!=-1) {
-		    channelIO		= channelIndex;
-		    echoIO		= echoTarget;
-		    repetitionIO	= repetitionTarget;
-		}
-		if(channelTarget!=-1 && echoTarget==-1 && repetitionTarget==-1) {
-		    channelIO		= channelTarget;
-		    echoIO		= echoIndex;
-		    repetitionIO	= repetitionIndex;
-		}
-		if(channelTarget!=-1 && echoTarget!=-1 && repetitionTarget!=-1) {
-		    channelIO		= channelTarget;
-		    echoIO		= echoTarget;
-		    repetitionIO	= repetitionTarget;
-		}
-	    
-		if(!b_preprocessLoad) {
-		    // For the extraction from the C_adcPack object, remember
-		    //	that this object has already parsed the target
-		    //	echo and repetition (if spec'd) from the raw data
-		    //	file. Also, the target channel has already been filtered.
-		    volume_extract(echoIndex, repetitionIndex);
-		}	
-		else {
-		    // In the case when we load a native volume from file, we
-		    //	need to pass the correct target arguments if
-		    //	spec'd (in order to properly create the file name).
-		    volume_extractLoad(channelIO, echoIO, repetitionIO);
+    IFPAUSE( "Enter a char to continue" );
+    sout << "\tDestructing extraced volume:...\t";
+    COUT(sout.str());    sout.str("");
+    Gpc_measOut->dataMemory_volumeDestruct(            e_normalKSpace);
+    COUTnl("\t\t[OK]\n"); sout.str("");
+}
+
+void
+volume_preprocess(	
+	int		echoIndex, 		
+	int		echoTarget,
+	int		repetitionIndex, 	
+	int		repetitionTarget) {
+    //
+    // ARGS
+    //	echoIndex		in		current echo loop
+    //	echoTarget		in		target echo passed from system
+    //	repetitionIndex		in		current repetition in loop	
+    //	repetitionTarget	in		target repetition passed from
+    //							system
+    //
+    // DESC
+    //	After some earlier design attempts, it was decided to add this
+    //	function as a mechanism to implement some IO-class specific
+    //	ability *before* starting the main reconstruction functions.
+    //
+    // HISTORY
+    // 24 June 2004
+    //	o Initial design and coding.
+    //
+    
+    stringstream        sout("");
+    char		ch;
+    
+    IFPAUSE( "Enter a char to continue" );
+    sout << "\tPreprocessing extracted volume:...\t";
+    COUT(sout.str());    sout.str("");
+    Gpc_measOut->dataMemory_volumePreprocess(	echoIndex,
+    						echoTarget,
+						repetitionIndex,
+						repetitionTarget,
+    						e_normalKSpace);
+    COUTnl("\t[OK]\n"); sout.str("");
+}
+
+
+double
+memoryBudget_parse(
+    const char*		apch_size
+) {
+    //
+    // ARGS
+    //	apch_size		in		size, in MB unless suffixed by
+    //							K, M, G or T
+    //
+    // DESC
+    //	Parses a --memoryBudget size into bytes.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    char*		pch_end;
+    double		v_size	= strtod(apch_size, &pch_end);
+
+    switch(toupper(*pch_end)) {
+	case 'K':	v_size	*= 1024.0;			break;
+	case '\0':
+	case 'M':	v_size	*= 1024.0*1024.0;		break;
+	case 'G':	v_size	*= 1024.0*1024.0*1024.0;	break;
+	case 'T':	v_size	*= 1024.0*1024.0*1024.0*1024.0;	break;
+	default:
+	    error_exit("parsing --memoryBudget",
+		       string("could not understand size ") + apch_size, 1);
+    }
+    if(v_size <= 0)
+	error_exit("parsing --memoryBudget",
+		   string("the budget must be positive: ") + apch_size, 1);
+    return v_size;
+}
+
+bool
+shmRing_parse(
+    const char*		apch_spec
+) {
+    //
+    // ARGS
+    //	apch_spec		in		<name>[,<slots>[,<readers>
+    //							[,<timeout>]]]
+    //
+    // DESC
+    //	Parses a --shmRing specification.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    string		str_spec(apch_spec);
+    string		str_field;
+    stringstream	sin(str_spec);
+    int			field	= 0;
+
+    while(getline(sin, str_field, ',')) {
+	switch(field++) {
+	    case 0:	Gstr_shmRing		= str_field;			break;
+	    case 1:	G_shmRingSlots		= atoi(str_field.c_str());	break;
+	    case 2:	G_shmRingReaders	= atoi(str_field.c_str());	break;
+	    case 3:	G_shmRingTimeout	= atoi(str_field.c_str());	break;
+	    default:	return false;
+	}
+    }
+    if(!Gstr_shmRing.length() || Gstr_shmRing.find('/', 1) != string::npos ||
+       G_shmRingSlots < 1 || G_shmRingReaders < 1 || G_shmRingTimeout < 1)
+	return false;
+    if(Gstr_shmRing[0] != '/')
+	Gstr_shmRing	= "/" + Gstr_shmRing;
+    return true;
+}
+
+void
+shmRing_open(
+    const C_options&		ac_options,
+    const s_memoryFootprint&	as_footprint
+) {
+    //
+    // ARGS
+    //	ac_options		in		options of the study
+    //	as_footprint		in		its memory footprint, for the
+    //							volume size
+    //
+    // DESC
+    //	Creates the --shmRing of a study, before any recon worker is
+    //	forked: the workers publish into the mapping they inherit. The
+    //	vox2ras matrix is that of the NIfTI (or else the MGH) output.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    const CMatrix<double>*	pM_vox2ras;
+
+    pM_vox2ras		= ac_options.b_has("NIFTI_vox2ras") ?
+			  ac_options.pMv_get("NIFTI_vox2ras") :
+			  ac_options.pMv_get("MGH_vox2ras");
+    if(pM_vox2ras)
+	GpM_ringVox2ras	= new CMatrix<double>(*pM_vox2ras);
+    else {
+	COUT("No vox2ras in the options file; --shmRing volumes carry the identity\n");
+	GpM_ringVox2ras	= new CMatrix<double>(4, 4);
+	for(int i=0; i<4; i++)
+	    for(int j=0; j<4; j++)
+		(*GpM_ringVox2ras)(i, j)	= i == j;
+    }
+    Gpc_ring		= new C_volumeRing(Gstr_shmRing, G_shmRingSlots,
+					   (long long) as_footprint.imageUnit,
+					   G_shmRingReaders, G_shmRingTimeout);
+    if(!Gpc_ring->b_isOpen())
+	error_exit(	"creating --shmRing " + Gstr_shmRing,
+			"could not create the shared memory object", 1);
+    COUT("Publishing volumes to " + Gstr_shmRing + "\n");
+}
+
+void
+shmRing_close() {
+    //
+    // DESC
+    //	Ends a study's --shmRing, once its readers have released all of
+    //	its volumes.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Fails if the readers do not within the timeout.
+    //
+
+    bool		b_ok	= true;
+
+    if(Gpc_ring) {
+	COUT("Waiting for the readers of " + Gstr_shmRing + "\n");
+	b_ok	= Gpc_ring->close();
+	delete Gpc_ring;
+    }
+    delete GpM_ringVox2ras;
+    Gpc_ring		= NULL;
+    GpM_ringVox2ras	= NULL;
+    if(!b_ok)
+	error_exit(	"closing --shmRing " + Gstr_shmRing,
+			"its readers did not take all of the volumes in time", 1);
+}
+
+void
+memoryPlan_make(
+    s_memoryPlan&		as_plan,
+    const C_dimensionLists*	apC_dimension,
+    double			av_budget,
+    int				a_channels,
+    int				a_echoes,
+    int				a_repetitions,
+    bool			ab_channelList
+) {
+    //
+    // ARGS
+    //	as_plan			out		unpack plan
+    //	apC_dimension		in		dimension lists of the raw data
+    //	av_budget		in		memory budget (0: none)
+    //	a_channels		in		channels, echoes and
+    //	a_echoes				repetitions the run covers
+    //	a_repetitions
+    //	ab_channelList		in		a --channelTarget list was
+    //							given
+    //
+    // DESC
+    //	Without a budget, each pass over the raw data unpacks every
+    //	targeted echo and repetition of a single channel - or of all the
+    //	channels of a --channelTarget list. With a budget, picks the
+    //	cheapest plan that fits:
+    //
+    //	  full		every channel unpacked in a single pass.
+    //	  grouped	as many channels as fit per pass, or, if not even
+    //			one channel fits, passes over groups of
+    //			repetitions (whole repetitions first, then echoes
+    //			of a repetition).
+    //	  minimal	as grouped, with the shifts done in place.
+    //
+    //	If not even one volume per pass fits, that is used anyway (and
+    //	the plan shows the overrun).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Passes over channel groups and over groups of echoes and
+    //	  repetitions.
+    //
+
+    const s_memoryFootprint&	s_f	= as_plan.s_footprint;
+    int				units	= a_echoes*a_repetitions;
+    double			working;
+    long			fit;
+
+    C_adcPack::footprint_estimate(apC_dimension, as_plan.s_footprint);
+    as_plan.e_plan		= e_planFull;
+    as_plan.channelsPerPass	= ab_channelList ? a_channels : 1;
+    as_plan.echoesPerPass	= a_echoes;
+    as_plan.repetitionsPerPass	= a_repetitions;
+    as_plan.b_shiftInPlace	= apC_dimension->b_shiftInPlace_get();
+    working			= as_plan.b_shiftInPlace ? s_f.workingUnitInPlace :
+							   s_f.workingUnit;
+
+    if(av_budget > 0) {
+	if(a_channels*units*s_f.kSpaceUnit + working <= av_budget)
+	    as_plan.channelsPerPass	= a_channels;
+	else {
+	    as_plan.e_plan	= e_planGrouped;
+	    // Volumes that fit in one pass, next to the recon scratch
+	    fit			= (long) ((av_budget - working) / s_f.kSpaceUnit);
+	    if(fit < 1 && !as_plan.b_shiftInPlace) {
+		as_plan.e_plan		= e_planMinimal;
+		as_plan.b_shiftInPlace	= true;
+		working			= s_f.workingUnitInPlace;
+		fit	= (long) ((av_budget - working) / s_f.kSpaceUnit);
+	    }
+	    fit			= max(fit, 1L);
+	    as_plan.channelsPerPass	= max((int) (fit / units), 1);
+	    if(fit < units) {
+		if(fit >= a_echoes)
+		    as_plan.repetitionsPerPass	= fit / a_echoes;
+		else {
+		    as_plan.repetitionsPerPass	= 1;
+		    as_plan.echoesPerPass	= fit;
 		}
-		if(b_preprocessSave) {
-		    // In the case when we save a native volume to file, we
-		    //	need to pass the correct target arguments if
-		    //	spec'd
-		    volume_extractSave(channelIO, echoIO, repetitionIO);
-		    // Processing thread continues with next loop if
-		    //	we are saving extracted volumes
-		} else {
-		    //
-		    // otherwise process the extracted volume and reconstruct
-		    //
-		
-		    // The GpVl pointer is captured as a return from most functions
-		    //	and is used in the volume_selectedValuesShow() function.
-		
-		    GpVl    = Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
-		    //volume_selectedValuesShow("Selected extract coords:");
-	    
-		    if(!Gpc_measOut->b_unpackWpadShift_get()) {
-			// If this flag is false, the meas.out in memory has not
-			//	already been zeroPadded and phase shifted.
-			
-			volume_zeroPad();
-			GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
-			//volume_selectedValuesShow("Selected zeroPadded coords:");
-	    
-			volume_ifftshift();	
-			GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
-			//volume_selectedValuesShow("Selected ifftshift coords:");
-		    }
-		    
-		    volume_preprocess(	echoIndex, 		
-		    			echoTarget,
-		    			repetitionIndex, 	
-					repetitionTarget);
-		    
-		    volume_ifft();
-		    GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
-		    //volume_selectedValuesShow("Selected ifft coords:");
-	    
-		    volume_fftshift();
-		    GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
-		    //volume_selectedValuesShow("Selected fftshift coords:");
-	    
-		    times(&st_echoStop); time(&tt_echoStop);
-		    f_echoTimeCPU  = difftime(st_echoStop.tms_utime, st_echoStart.tms_utime) / 100;
-		    f_echoTimeReal = difftime(tt_echoStop, tt_echoStart);
-		    sout << "\t\tRecon CPU time for echo " << echo << " processing: ";
-		    COUT(sout.str());	sout.str("");	
-		    sout <<  f_echoTimeCPU << " seconds." << endl;
-		    COUTnl(sout.str()); sout.str("");
-		    sout << "\t\tRecon process time for echo " << echo << " processing: ";
-		    COUT(sout.str());	sout.str("");
-		    sout <<  f_echoTimeReal << " seconds." << endl;
-		    COUTnl(sout.str()); sout.str("");
-	 
-		    if(Gstr_recParamFile.length()) 
-		    	RecFile_volumeSave(	channelIO, 	echoIO, 
-						repetitionIO, 	totalEchoes,
-						argc,		ppch_argv);
-		    volume_save(channelIO, echoIO, repetitionIO);
+	    }
+	}
+    }
+
+    as_plan.passes	= ((a_channels + as_plan.channelsPerPass - 1) /
+			   as_plan.channelsPerPass) *
+			  ((a_echoes + as_plan.echoesPerPass - 1) /
+			   as_plan.echoesPerPass) *
+			  ((a_repetitions + as_plan.repetitionsPerPass - 1) /
+			   as_plan.repetitionsPerPass);
+    as_plan.v_peak	= (double) as_plan.channelsPerPass * as_plan.echoesPerPass *
+			  as_plan.repetitionsPerPass * s_f.kSpaceUnit + working;
+}
+
+void
+memoryPlan_show(
+    const s_memoryPlan&		as_plan,
+    double			av_budget
+) {
+    //
+    // ARGS
+    //	as_plan			in		unpack plan
+    //	av_budget		in		memory budget
+    //
+    // DESC
+    //	Prints the plan made by memoryPlan_make().
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    stringstream	sout("");
+    double		MB	= 1024.0*1024.0;
+    const char*		ppch_plan[]	= {"full", "grouped", "minimal"};
+
+    sout.setf(ios::fixed);
+    sout.precision(1);
+    sout << "Memory plan for a budget of " << av_budget/MB << " MB:" << endl;
+    COUT(sout.str()); sout.str("");
+    sout << "\tk-space per volume\t\t" << as_plan.s_footprint.kSpaceUnit/MB
+	 << " MB" << endl;
+    COUT(sout.str()); sout.str("");
+    sout << "\trecon scratch per volume\t"
+	 << (as_plan.b_shiftInPlace ? as_plan.s_footprint.workingUnitInPlace :
+				      as_plan.s_footprint.workingUnit)/MB
+	 << " MB" << endl;
+    COUT(sout.str()); sout.str("");
+    sout << "\tstrategy\t\t\t" << ppch_plan[as_plan.e_plan] << ", "
+	 << as_plan.passes << " pass(es) of " << as_plan.channelsPerPass
+	 << " channel(s) x " << as_plan.repetitionsPerPass << " repetition(s) x "
+	 << as_plan.echoesPerPass << " echo(es)";
+    if(as_plan.b_shiftInPlace)
+	sout << ", shiftInPlace";
+    sout << endl;
+    COUT(sout.str()); sout.str("");
+    sout << "\testimated peak\t\t\t" << as_plan.v_peak/MB << " MB";
+    if(as_plan.v_peak > av_budget)
+	sout << " (over budget)";
+    sout << endl;
+    COUT(sout.str()); sout.str("");
+}
+
+bool
+file_checksum(
+    const string&	astr_fileName,
+    long long&		a_size,
+    string&		astr_checksum
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		file to check
+    //	a_size			out		its size
+    //	astr_checksum		out		64 bit FNV-1a of its contents
+    //
+    // DESC
+    //	Checksums a whole output file for the run journal.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    const int		bufSize		= 1 << 20;
+    unsigned long long	hash		= CONTAINER_HASH_SEED;
+    char*		pch_buf;
+    ssize_t		got;
+    int			fd;
+
+    a_size	= 0;
+    fd		= open(astr_fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+	return false;
+    pch_buf	= new char[bufSize];
+    while((got = read(fd, pch_buf, bufSize)) > 0) {
+	hash	= C_container::hash_update(hash, pch_buf, got);
+	a_size	+= got;
+    }
+    delete [] pch_buf;
+    close(fd);
+    astr_checksum	= C_container::hash_str(hash);
+    return got == 0;
+}
+
+void
+unit_outputs(
+    int			a_channelId,
+    int			a_echoIndex,
+    int			a_repetitionIndex,
+    vector<string>&	av_files
+) {
+    //
+    // ARGS
+    //	a_channelId		in		channel of the volume
+    //	a_echoIndex		in		echo of the volume
+    //	a_repetitionIndex	in		repetition of the volume
+    //	av_files		out		the files volume_save() writes
+    //						for it
+    //
+    // DESC
+    //	Lists the output files of a volume, for the save types that
+    //	write files of their own.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    string		str_base	= output_base(a_channelId, a_echoIndex,
+						      a_repetitionIndex);
+
+    av_files.clear();
+    switch(Ge_saveType) {
+	case e_mgh_realImag:
+	    av_files.push_back(str_base + "-real.mgh");
+	    av_files.push_back(str_base + "-imag.mgh");
+	    break;
+	case e_mgh_magPhase:
+	    av_files.push_back(str_base + "-mag.mgh");
+	    av_files.push_back(str_base + "-phase.mgh");
+	    break;
+	case e_analyze75_snorm:
+	    av_files.push_back(str_base + "-snorm.hdr");
+	    av_files.push_back(str_base + "-snorm.img");
+	    break;
+	case e_nifti_complex:
+	    av_files.push_back(str_base + ".nii");
+	    break;
+	default:
+	    break;
+    }
+}
+
+string
+unit_key(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    stringstream	sout("");
+    sout << a_channelId << "\t" << a_echoIndex << "\t" << a_repetitionIndex;
+    return sout.str();
+}
+
+void
+journal_note(
+    const string&	astr_line
+) {
+    //
+    // ARGS
+    //	astr_line		in		journal line (without '\n')
+    //
+    // DESC
+    //	Appends a line to the run journal. The journal is opened for
+    //	appending, so the single write() of a line is never interleaved
+    //	with those of the other workers.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    string	str_line	= astr_line + "\n";
+
+    if(G_journal < 0)
+	return;
+    if(write(G_journal, str_line.c_str(), str_line.length())
+	    != (ssize_t) str_line.length())
+	cerr << G_SELF << ": could not write to the run journal" << endl;
+    fdatasync(G_journal);
+}
+
+void
+journal_open(
+    const string&	astr_runKey,
+    const string&	astr_cacheState
+) {
+    //
+    // ARGS
+    //	astr_runKey		in		fingerprint of the raw data and
+    //						of all the options
+    //	astr_cacheState		in		"<file>\t<state>" of the
+    //						k-space cache
+    //
+    // DESC
+    //	Starts the run journal in Gstr_outDir. It holds
+    //
+    //		mdhjournal	1
+    //		run		<key>
+    //		cache		<file>	<state>
+    //		unit		<channel> <echo> <rep> <files>
+    //				[<file> <size> <checksum>] ...
+    //
+    //	with tab separated fields. With --resume, the units of an earlier
+    //	journal of the same run whose files are all still there, of the
+    //	same size and checksum, are carried over into G_journalDone.
+    //	The others, and the journals of other runs, are dropped.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Written under a temporary name unique to the run.
+    //
+
+    string		str_journal	= Gstr_outDir + "/" + Gstr_runID + ".mdhjournal";
+    string		str_tmp;
+    string		str_line;
+    string		str_field;
+    vector<string>	v_kept;
+    int			units		= 0;
+    stringstream	sout("");
+
+    G_journalDone.clear();
+    if(Gb_resume) {
+	ifstream	fin(str_journal.c_str());
+	if(fin) {
+	    getline(fin, str_line);
+	    if(str_line != "mdhjournal\t1" || !getline(fin, str_line) ||
+	       str_line != "run\t" + astr_runKey) {
+		COUT("Journal " + str_journal + " is of another run; starting over\n");
+	    } else while(getline(fin, str_line)) {
+		stringstream	sin(str_line);
+		string		str_file, str_checksum, str_check;
+		int		channel, echo, repetition, files;
+		long long	size, sizeCheck;
+		bool		b_ok	= true;
+		getline(sin, str_field, '\t');
+		if(str_field != "unit")
+		    continue;
+		units++;
+		sin >> channel >> echo >> repetition >> files;
+		for(int i=0; i<files && b_ok; i++) {
+		    sin.ignore(1);
+		    getline(sin, str_file, '\t');
+		    sin >> size >> str_checksum;
+		    b_ok	= sin && file_checksum(str_file, sizeCheck, str_check) &&
+				  sizeCheck == size && str_check == str_checksum;
+		}
+		if(b_ok && files > 0) {
+		    G_journalDone.insert(unit_key(channel, echo, repetition));
+		    v_kept.push_back(str_line);
+		}
+	    }
+	    sout << "Resuming: " << G_journalDone.size() << " volumes done (of "
+		 << units << " in the journal)" << endl;
+	    COUT(sout.str()); sout.str("");
+	}
+    }
+
+    // The verified units go into a fresh journal
+    str_tmp		= tmp_reserve(str_journal);
+    if(!str_tmp.length()) {
+	cerr << G_SELF << ": could not write the run journal " << str_journal << endl;
+	return;
+    }
+    ofstream		fout(str_tmp.c_str());
+    fout << "mdhjournal\t1" << endl << "run\t" << astr_runKey << endl;
+    for(unsigned i=0; i<v_kept.size(); i++)
+	fout << v_kept[i] << endl;
+    fout << "cache\t" << astr_cacheState << endl;
+    fout.close();
+    if(!fout || rename(str_tmp.c_str(), str_journal.c_str())) {
+	cerr << G_SELF << ": could not write the run journal " << str_journal << endl;
+	unlink(str_tmp.c_str());
+	return;
+    }
+    G_journal	= open(str_journal.c_str(), O_WRONLY | O_APPEND);
+}
+
+bool
+b_journalDone(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    return G_journalDone.count(unit_key(a_channelId, a_echoIndex, a_repetitionIndex)) > 0;
+}
+
+void
+journal_unitDone(
+    int		a_channelId,
+    int		a_echoIndex,
+    int		a_repetitionIndex
+) {
+    //
+    // ARGS
+    //	a_channelId		in		channel of the saved volume
+    //	a_echoIndex		in		echo of the saved volume
+    //	a_repetitionIndex	in		repetition of the saved volume
+    //
+    // DESC
+    //	Journals a volume once all its files have been written.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    vector<string>	v_files;
+    stringstream	sout("");
+    string		str_checksum;
+    long long		size;
+
+    if(G_journal < 0)
+	return;
+    unit_outputs(a_channelId, a_echoIndex, a_repetitionIndex, v_files);
+    sout << "unit\t" << unit_key(a_channelId, a_echoIndex, a_repetitionIndex)
+	 << "\t" << v_files.size();
+    for(unsigned i=0; i<v_files.size(); i++) {
+	if(!file_checksum(v_files[i], size, str_checksum))
+	    return;
+	sout << "\t" << v_files[i] << "\t" << size << "\t" << str_checksum;
+    }
+    journal_note(sout.str());
+}
+
+void
+journal_close() {
+    if(G_journal >= 0)
+	close(G_journal);
+    G_journal	= -1;
+    G_journalDone.clear();
+}
+
+void
+unit_decode(
+    const s_passUnits&		as_pass,
+    const s_unpackTargets&	as_IO,
+    int				a_unit,
+    int&			a_channelSlot,
+    int&			a_echoIndex,
+    int&			a_repetitionIndex,
+    int&			a_channelIO,
+    int&			a_echoIO,
+    int&			a_repetitionIO,
+    int&			a_frame
+) {
+    //
+    // ARGS
+    //	as_pass			in		volumes of the current pass
+    //	as_IO			in		the run's IO indices
+    //	a_unit			in		volume within the pass
+    //	a_channelSlot		out		channel within the pass
+    //	a_echoIndex		out		echo/repetition within the
+    //	a_repetitionIndex			unpacked data
+    //	a_*IO			out		channel/echo/repetition used to
+    //							name its files
+    //	a_frame			out		frame in a 4D file
+    //
+    // DESC
+    //	Units run over the channels, repetitions and echoes of a pass,
+    //	echoes fastest. 4D frames are numbered over the whole run, so
+    //	that every pass fills in the same file.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    a_echoIndex		= a_unit % as_pass.echoes;
+    a_repetitionIndex	= (a_unit / as_pass.echoes) % as_pass.repetitions;
+    a_channelSlot	= a_unit / (as_pass.echoes*as_pass.repetitions);
+    a_channelIO		= as_IO.v_channels[as_pass.channel0 + a_channelSlot];
+    a_echoIO		= as_IO.v_echoes[as_pass.echo0 + a_echoIndex];
+    a_repetitionIO	= as_IO.v_repetitions[as_pass.repetition0 + a_repetitionIndex];
+    a_frame		= (as_pass.repetition0 + a_repetitionIndex)*as_IO.v_echoes.size() +
+			  as_pass.echo0 + a_echoIndex;
+}
+
+
+int
+study_process(
+    const string&		astr_cfgFile,
+    const string&		astr_measFile,
+    const s_unpackTargets&	as_targets,
+    bool			ab_preprocessSave,
+    bool			ab_preprocessLoad,
+    int				argc,
+    char*			ppch_argv[]
+) {
+    //
+    // ARGS
+    //	astr_cfgFile		in		options (meta data) file, in
+    //						Gstr_inDir
+    //	astr_measFile		in		meas.asc file, in Gstr_inDir
+    //	as_targets		in		--channel/echo/repetitionTarget
+    //	ab_preprocessSave	in		--preprocessSave
+    //	ab_preprocessLoad	in		--preprocessLoad
+    //	argc, ppch_argv		in		command line (for Rec files)
+    //
+    // DESC
+    //	Unpacks and reconstructs the study in Gstr_inDir into
+    //	Gstr_outDir, as Gstr_runID. Returns 0 on success.
+    //
+    // HISTORY
+    //  June/July 2003
+    //  o Initial design and development (as main()).
+    //
+    // 19 October 2026
+    //	o Factored out of main(), so that --batch can run many studies.
+    //
+
+    stringstream        sout("");
+    
+    // Channel data
+    //	The main program processes channel information
+    int				allScanChannels = 0;	// Number of channels spec'd in
+                                                        //	meta file
+    int				echo, repetition; 	// dummy variable to hold current
+    							//	echo and repetition
+    // Some timing-related variables
+    float                       f_totalTimeCPU  = 0.0;
+    float                       f_totalTimeReal = 0.0;
+    float			f_echoTimeCPU	= 0.0;
+    float			f_echoTimeReal	= 0.0;
+    struct tms                  st_start, st_stop;		// CPU time for total
+    struct tms                  st_echoStart, st_echoStop;	// CPU time for echo
+    time_t			tt_start, tt_stop;	        // Real time for total
+    time_t			tt_echoStart, tt_echoStop;	// Real time for echo
+
+    string      str_cfgFile         = astr_cfgFile;
+    string	str_measFile	    = astr_measFile;
+    s_unpackTargets	s_targets	    = as_targets;
+    bool	b_preprocessSave    = ab_preprocessSave;
+    bool	b_preprocessLoad    = ab_preprocessLoad;
+    int         ret		    = 0;		// study return value
+
+    Gpcsm->str_syslogID_set(Gstr_runID);
+
+    // and the options file, parsed once (along with the matrix files it
+    //	names) and shared by everything that needs it
+    C_options                   c_options(	    Gstr_inDir+"/"+str_cfgFile);
+						    
+    // as well as a meas.asc parser for RecFile purposes
+    C_ascconv*			pcso_measFile;
+    if(Gstr_recParamFile.length())
+    	pcso_measFile	= new C_ascconv(	Gstr_inDir+"/"+str_measFile);
+
+    // Now setup the size of the volumetric space by parsing the options metaData file,
+    //	which will describe the dimension structure of the raw data. Note that the
+    //	unpack object will use this information, and will also create its *own* 
+    //	C_dimensionLists defining the actual data that it unpacked (which may be
+    //	a subset of the larger data set).
+    //
+    // The size of memory allocated to the C_adcPack->C_adc objects depends on the 
+    //	dimension structure of the problem space. If a "preprocessLoad" is true, there
+    //	is no need to allocate memory to hold unpacked information since the original
+    //	raw data file is never accessed. In such a case, unity dimension values are
+    //	passed to the C_adcPack object, and the C_adc objects have minimum size. Volumes
+    //	in such a case are read directly into the pVl_extracted variables from file.
+    //
+    //  The pCdim_disk describes the dimension structure as parsed from the metaData file.
+    //	The pCdim_unity describes a "unity" dimension structure, used when not accessing
+    //	the original raw data file.
+    C_dimensionLists*	pCdim_disk	= new C_dimensionLists(&c_options);
+    C_dimensionLists*	pCdim_unity	= new C_dimensionLists();
+    C_dimensionLists*	pCdim;
+
+    // By creating the dimensionLists structure with no arguments we force unity
+    //	dimensions. We still need to set the options, though.
+    pCdim_unity->pC_options_set(&c_options);
+
+    // Size the disk dimensions from the raw data itself. This only reads
+    //	the record headers, so is cheap even for very large files, and
+    //	runs before any cache fingerprint is taken from pCdim_disk.
+    s_measOutExtent	s_extent;
+    memset(&s_extent, 0, sizeof(s_extent));
+    if(Gb_autoDimension && !b_preprocessLoad) {
+	bool	b_3D	= c_options.pMi_get("3DflagFile") ?
+			  c_options.pMi_get("3DflagFile")->val(0, 0) : Gb_is3D;
+	COUT("Pre-scanning raw data headers... ");
+	if(!C_adcPack::measOut_prescan(pCdim_disk->str_ADCfileBaseName_get() + ".out",
+				       s_extent))
+	    error_exit("pre-scanning the raw data",
+		       "could not read " + pCdim_disk->str_ADCfileBaseName_get() + ".out", 1);
+	if(!s_extent.b_complete)
+	    cerr << endl << G_SELF << ": raw data ends before its ACQEND record" << endl;
+	pCdim_disk->extent_apply(s_extent, b_3D);
+	sout << "(" << s_extent.records << " records)";
+	COUT(sout.str()); sout.str("");
+	COUTnl("\t\t[OK]\n");
+    }
+
+    string		str_value   	= "";
+    if(c_options.scanFor("channels", &str_value))
+	allScanChannels	= atoi(str_value.c_str());
+    else if(!s_extent.channels)
+	error_exit("parsing options file",
+	           "could not find \"channels\" spec in\n" + Gstr_inDir+"/"+str_cfgFile,
+		   1);
+    if(s_extent.channels)
+	allScanChannels	= s_extent.channels;
+
+    // The channels, echoes and repetitions of the run: s_IO as they are
+    //	named in files, s_raw as they appear in the raw data.
+    s_unpackTargets	s_IO;
+    s_unpackTargets	s_raw;
+    CMatrix<int>	M_echoList(pCdim_disk->M_echoList_get());
+    CMatrix<int>	M_repetitionList(pCdim_disk->M_repetitionList_get());
+    C_adcPack::targets_resolve(s_targets.v_channels, allScanChannels, NULL,
+		    s_IO.v_channels, s_raw.v_channels);
+    C_adcPack::targets_resolve(s_targets.v_echoes, M_echoList.cols_get(), &M_echoList,
+		    s_IO.v_echoes, s_raw.v_echoes);
+    C_adcPack::targets_resolve(s_targets.v_repetitions, M_repetitionList.cols_get(),
+		    &M_repetitionList, s_IO.v_repetitions, s_raw.v_repetitions);
+
+    // The automatic caches. If a cache matching the fingerprint of this run
+    //	exists, it is loaded instead of parsing the raw data: the k-space
+    //	cache exactly as if --preprocessLoad had been given, and the
+    //	(optional) image cache skipping the reconstruction as well.
+    //	Otherwise the volumes are added to new caches as they are produced;
+    //	these are only published (renamed into place) once the run has
+    //	completed normally. A --sharedCache is published as soon as all
+    //	its volumes have been unpacked.
+    string	str_cacheFile	    = "";
+    string	str_imageFile	    = "";
+    bool	b_imageLoad	    = false;
+    if((Gb_cache || Gb_imageCache) && !b_preprocessLoad && !b_preprocessSave) {
+	string	str_fingerprint;
+	if(!Gstr_cacheDir.length())
+	    Gstr_cacheDir	= Gstr_inDir;
+	str_fingerprint	= cache_fingerprint(c_options, pCdim_disk, allScanChannels,
+					  s_targets);
+	str_cacheFile	= Gstr_cacheDir + "/mdhcache_" + str_fingerprint + ".mdhc";
+	str_imageFile	= Gstr_cacheDir + "/mdhimage_" + C_container::hash_str(
+			    C_container::hash_update(CONTAINER_HASH_SEED,
+						     str_fingerprint + "image")) +
+			  ".mdhc";
+
+	if(Gb_imageCache) {
+	    Gpc_imageCache	= cache_lookup(str_imageFile, s_IO);
+	    if(Gpc_imageCache) {
+		COUT("Using image cache " + str_imageFile + "\n");
+		b_imageLoad	    = true;
+		b_preprocessLoad    = true;
+	    } else
+		Gpc_imageCache	= cache_create(str_imageFile);
+	}
+	if(Gb_cache && !b_imageLoad) {
+	    Gpc_container	= cache_lookup(str_cacheFile, s_IO);
+	    if(Gpc_container) {
+		COUT("Using k-space cache " + str_cacheFile + "\n");
+	    } else if(Gb_sharedCache) {
+		// Channel IO indices are the raw channel ids whatever the
+		//	targets, so runs on other channels can share it
+		s_unpackTargets	s_shmTargets	= s_targets;
+		string		str_shmName;
+		s_shmTargets.v_channels.clear();
+		str_shmName	= "/mdhshm_" + cache_fingerprint(c_options, pCdim_disk,
+								 allScanChannels,
+								 s_shmTargets);
+		Gpc_container	= shmCache_open(str_shmName, s_IO, Gpc_cache);
+		if(Gpc_container) {
+		    COUT("Using shared k-space cache " + str_shmName + "\n");
+		} else if(Gpc_cache) {
+		    COUT("Populating shared k-space cache " + str_shmName + "\n");
+		}
+	    }
+	    if(Gpc_container)
+		b_preprocessLoad    = true;
+	    else if(!Gpc_cache)
+		Gpc_cache	= cache_create(str_cacheFile);
+	}
+    }
+
+    // Which dimension structure do we use?
+    if(b_preprocessLoad)
+	pCdim	= pCdim_unity;
+    else
+	pCdim	= pCdim_disk;
+
+    // Parse optionsFile for any additional meta data...
+    pCdim->metaData_parse();
+
+    Gpcsm->timer(eSM_start);
+
+    string		str_dim		= "3D";
+    if(c_options.pMi_get("3DflagFile")) {
+	Gb_is3D		= c_options.pMi_get("3DflagFile")->val(0, 0);
+	if(!Gb_is3D)	str_dim		= "2D";
+    }
+    COUT("Acquisition dimensionality\t\t\t\t");
+    COUTnl("[" + str_dim + "]\n");
+
+    times(&st_start); time(&tt_start);
+
+    // The core object that unpacks and stores raw data - remember that by spec'ing
+    //  target lists, the object will "home in" on only the spec'd channels/echoes/
+    //  repetitions.
+
+    e_SAVETYPE		e_saveType;
+    if(c_options.scanFor("outputFormat", &str_value))
+	Ge_saveType	= (e_SAVETYPE) atoi(str_value.c_str());
+    else
+	error_exit("parsing options file",
+	           "could not find \"outputFormat\" spec in\n" + Gstr_inDir+"/"+str_cfgFile,
+		   1);
+
+
+    //BEGIN: Added by Mohana R to accomodate Rec File cretaion
+    if(Gstr_recParamFile != "") {
+	RecFile::setOptedFor(true);
+	RecFile::getInstance()->setOutDir(Gstr_outDir);
+	RecFile_paramFileData_set(*pcso_measFile);
+	RecFile_flipAngle_set(*pcso_measFile);
+    }
+    //END: Addition by Mohana R
+
+    // Plan the unpack within the memory budget. Each pass over the raw
+    //	data unpacks a group of channels (one, unless a channel list was
+    //	given or the budget allows more) and a group of the targeted
+    //	echoes and repetitions (all of them, unless the budget is short).
+    s_memoryPlan	s_plan;
+    int			allRunChannels	= s_IO.v_channels.size();
+    int			allRunEchoes	= s_IO.v_echoes.size();
+    int			allRunReps	= s_IO.v_repetitions.size();
+    memoryPlan_make(s_plan, pCdim, b_preprocessLoad ? 0 : Gv_memoryBudget,
+		    allRunChannels, allRunEchoes, allRunReps,
+		    !s_targets.v_channels.empty());
+    if(Gv_memoryBudget > 0 && !b_preprocessLoad)
+	memoryPlan_show(s_plan, Gv_memoryBudget);
+    if(Gstr_shmRing.length())
+	shmRing_open(c_options, s_plan.s_footprint);
+
+    // The run journal, for the save types that write files of their own
+    //	per volume. A resumed run skips the volumes it lists. The caches
+    //	being built would then be incomplete, and are dropped; loaded
+    //	ones are used as usual. Checksumming the outputs costs a read of
+    //	each, so the journal is only kept when asked for.
+    if((Gb_journal || Gb_resume) &&
+       !b_preprocessSave && !Gstr_recParamFile.length() && !Gpc_ring &&
+       Ge_saveType != e_mgh_realImag4D && Ge_saveType != e_mgh_magPhase4D) {
+	string		str_runKey	= cache_fingerprint(c_options, pCdim_disk,
+							    allScanChannels, s_targets);
+	string		str_cacheState	= "-\toff";
+	if(b_imageLoad)
+	    str_cacheState	= str_imageFile + "\tloaded";
+	else if(Gpc_container)
+	    str_cacheState	= (Gpc_container->b_sharedMemory_get() ?
+				   string("shared") : str_cacheFile) + "\tloaded";
+	else if(Gpc_cache)
+	    str_cacheState	= (Gpc_cache->b_sharedMemory_get() ?
+				   string("shared") : str_cacheFile) + "\tbuilding";
+	str_runKey	= C_container::hash_str(C_container::file_fingerprint(
+			    Gstr_inDir + "/" + str_cfgFile,
+			    C_container::hash_update(CONTAINER_HASH_SEED, str_runKey)));
+	journal_open(str_runKey, str_cacheState);
+	if(!G_journalDone.empty()) {
+	    if(Gpc_cache) {
+		cache_publish(Gpc_cache, "", false);
+		Gpc_cache	= NULL;
+		journal_note("cache\t-\tdropped");
+	    }
+	    if(Gpc_imageCache && !b_imageLoad) {
+		cache_publish(Gpc_imageCache, "", false);
+		Gpc_imageCache	= NULL;
+	    }
+	}
+    } else if(Gb_journal || Gb_resume)
+	COUT("--journal: this run's outputs are not journaled; processing all\n");
+
+    int			echoGroups	= (allRunEchoes + s_plan.echoesPerPass - 1) /
+					  s_plan.echoesPerPass;
+    int			repGroups	= (allRunReps + s_plan.repetitionsPerPass - 1) /
+					  s_plan.repetitionsPerPass;
+    for(int group=0; group<echoGroups*repGroups; group++) {
+	s_passUnits	s_pass;
+	s_unpackTargets	s_packTargets;
+	s_pass.echo0		= (group % echoGroups) * s_plan.echoesPerPass;
+	s_pass.echoes		= min(s_plan.echoesPerPass, allRunEchoes - s_pass.echo0);
+	s_pass.repetition0	= (group / echoGroups) * s_plan.repetitionsPerPass;
+	s_pass.repetitions	= min(s_plan.repetitionsPerPass,
+				      allRunReps - s_pass.repetition0);
+	// The unpack object is sized for the largest channel group, and
+	//	targets the echoes and repetitions of the group (unless
+	//	that is all of them).
+	s_packTargets.v_channels.assign(s_raw.v_channels.begin(),
+			s_raw.v_channels.begin() + min(s_plan.channelsPerPass, allRunChannels));
+	if(!b_preprocessLoad) {
+	    if(!s_targets.v_echoes.empty() || s_pass.echoes < allRunEchoes)
+		s_packTargets.v_echoes.assign(
+			s_raw.v_echoes.begin() + s_pass.echo0,
+			s_raw.v_echoes.begin() + s_pass.echo0 + s_pass.echoes);
+	    if(!s_targets.v_repetitions.empty() || s_pass.repetitions < allRunReps)
+		s_packTargets.v_repetitions.assign(
+			s_raw.v_repetitions.begin() + s_pass.repetition0,
+			s_raw.v_repetitions.begin() + s_pass.repetition0 + s_pass.repetitions);
+	}
+	if(echoGroups*repGroups > 1) {
+	    sout << "Pass group " << group+1 << " of " << echoGroups*repGroups
+		 << ": echoes " << C_adcPack::str_targetList(s_packTargets.v_echoes)
+		 << ", repetitions " << C_adcPack::str_targetList(s_packTargets.v_repetitions)
+		 << endl;
+	    COUT(sout.str()); sout.str("");
+	}
+	COUT("allocating memory for unpacked data... ");
+
+	switch(Ge_saveType) {
+	    case e_mgh_realImag:
+	    case e_mgh_magPhase:
+	    case e_mgh_realImag4D:
+	    case e_mgh_magPhase4D:
+		Gpc_measOut		= new C_adcPack_mgh(pCdim->str_ADCfileBaseName_get(),
+					&(*pCdim),
+					Gb_is3D,
+					s_packTargets);
+	    break;
+	    case e_analyze75_snorm:
+		Gpc_measOut		= new C_adcPack_analyze75(pCdim->str_ADCfileBaseName_get(),
+					&(*pCdim),
+					Gb_is3D,
+					s_packTargets);
+	    break;
+	    case e_nifti_complex:
+		Gpc_measOut		= new C_adcPack_nifti(pCdim->str_ADCfileBaseName_get(),
+					&(*pCdim),
+					Gb_is3D,
+					s_packTargets);
+	    break;
+	    default:
+		error_exit(	"checking options file " + str_cfgFile, 
+			    "No valid output save types found", 1);
+	    break;
+	}
+
+	COUTnl("\t\t\t[OK]\n");
+	if(s_plan.b_shiftInPlace)
+	    Gpc_measOut->pc_dimension_get()->b_shiftInPlace_set(true);
+
+	// Now we process the data. The outer loop is over groups of
+	//	channels, unpacked together.
+	for(s_pass.channel0=0; s_pass.channel0<allRunChannels;
+	    s_pass.channel0+=s_plan.channelsPerPass) {
+	    s_pass.channels	= min(s_plan.channelsPerPass,
+				      allRunChannels - s_pass.channel0);
+	    vector<int>		v_channels(s_raw.v_channels.begin() + s_pass.channel0,
+					   s_raw.v_channels.begin() + s_pass.channel0 +
+					   s_pass.channels);
+	    Gpc_measOut->channelTargets_set(v_channels);
+
+	    // A pass with all its volumes in the journal is not even
+	    //	unpacked
+	    if(!G_journalDone.empty()) {
+		int	cs, ei, ri, cio, eio, rio, fr;
+		int	unit;
+		for(unit=0; unit<s_pass.channels*s_pass.repetitions*s_pass.echoes;
+		    unit++) {
+		    unit_decode(s_pass, s_IO, unit, cs, ei, ri, cio, eio, rio, fr);
+		    if(!b_journalDone(cio, eio, rio))
+			break;
+		}
+		if(unit == s_pass.channels*s_pass.repetitions*s_pass.echoes) {
+		    sout << "Channel " << C_adcPack::str_targetList(v_channels)
+			 << ": all volumes done, skipping" << endl;
+		    COUT(sout.str()); sout.str("");
+		    continue;
+		}
+	    }
+        
+	    // Variables spec'ing the particular volume data to process
+	    e_KSPACEDATATYPE        e_kspace	= e_normalKSpace;
+	    int                     repetitionIndex = 0;
+	    int                     echoIndex       = 0;
+	    int                     channelSlot     = 0;
+	    int                     frame           = 0;
+    
+	    //	allScanEchoes are the echoes in the raw data
+	    //	allPackEchoes are the echoes in the unpacked C_adcPack object
+	    //	(likewise for the repetition counters).
+	    //	NOTE that echoes and repetitions are indexed starting from zero (0)
+	    int	                allScanEchoes   = pCdim_disk->M_echoList_get().cols_get();
+	    int			allPackEchoes	= Gpc_measOut->pc_dimension_get()->
+						      M_echoList_get().cols_get();
+	    int	                allScanReps     = pCdim_disk->M_repetitionList_get().cols_get();
+	    int			allPackReps	= Gpc_measOut->pc_dimension_get()->
+						      M_repetitionList_get().cols_get();
+	    int			sampleCount	= 0;
+    
+	    times(&st_start); time(&tt_start);
+	    // Reading from disk / unpacking into memory
+    
+	    if(!b_preprocessLoad) {
+		//
+		// If we are not to load preprocessed volumes, crunch through the
+		//	original raw data file. This is the default beahviour.
+		//
+		sout << "Channel " << C_adcPack::str_targetList(v_channels) << endl;
+		COUT(sout.str()); sout.str("");
+		COUT("Header processing... ");
+		Gpc_measOut->headerFile_process();         COUTnl("\t\t\t\t\t[OK]\n");
+		COUT("Data file processing... ");
+		sampleCount = Gpc_measOut->dataFile_process();
+		sout << "(" << sampleCount << " samples processed)"; COUTnl(sout.str()); sout.str("");
+		COUTnl("\t[OK]\n"); sout.str("");
+		sout << "\tRecords: " << Gpc_measOut->str_recordCounts_get() << endl;
+		COUT(sout.str()); sout.str("");
+		times(&st_stop); time(&tt_stop);
+		f_totalTimeCPU  = difftime(st_stop.tms_utime, st_start.tms_utime) / 100;
+		f_totalTimeReal = difftime(tt_stop, tt_start);
+		sout << "\tTotal CPU time for raw data preprocessing: ";
+		COUT(sout.str());   sout.str("");
+		sout <<  f_totalTimeCPU << " seconds." << endl;
+		COUTnl(sout.str()); sout.str("");
+		sout << "\tTotal core time for raw data preprocessing: ";
+		COUT(sout.str());   sout.str("");
+		sout <<  f_totalTimeReal << " seconds." << endl << endl;
+		COUTnl(sout.str()); sout.str("");
+	    
+		if(!sampleCount) {
+		    sout << "No samples were found in raw data file corresponding to:" << endl;
+		    COUT(sout.str()); sout.str("");
+		    sout << "\tChannel\t\t     ";
+		    sout << C_adcPack::str_targetList(Gpc_measOut->targets_get().v_channels)    << endl;
+		    COUT(sout.str()); sout.str("");
+		    sout << "\tEcho\t\t     ";
+		    sout << C_adcPack::str_targetList(Gpc_measOut->targets_get().v_echoes)      << endl;
+		    COUT(sout.str()); sout.str("");
+		    sout << "\tRepetition\t     ";
+		    sout << C_adcPack::str_targetList(Gpc_measOut->targets_get().v_repetitions) << endl;
+		    COUT(sout.str()); sout.str("");
+		    ret = 1;
+		    continue;
+		}
+	    }
+	
+
+	    //
+	    // Quick analysis table
+	    //
+	    sout << "\tData analysis / run summary:-"	<< endl;
+	    COUT(sout.str()); sout.str("");
+	    sout << "\t\tRaw Data\t\tadcPack"	        << endl;
+	    COUT(sout.str()); sout.str("");
+	    sout << "Channels\t    "    << allScanChannels  << "\t\t\t    " << s_pass.channels  << endl;
+	    COUT(sout.str()); sout.str("");
+	    sout << "Echoes\t\t    "    << allScanEchoes    << "\t\t\t    " << allPackEchoes    << endl;
+	    COUT(sout.str()); sout.str("");
+	    sout << "Repetitions\t    " << allScanReps	<< "\t\t\t    " << allPackReps	    << endl;
+	    COUT(sout.str()); sout.str("");
+	    sout << endl;
+	    COUT(sout.str()); sout.str("");
+    
+	    //
+	    // The main processing loop runs over the volumes of the pass:
+	    //	its channels, and the targeted echoes/repetitions of its
+	    //	group (see unit_decode()).
+	    //
+	
+	    // 
+	    // Set of variables that identifies channels/echoes/repetitions for
+	    //	file I/O
+	    //
+	    int channelIO;
+	    int echoIO;
+	    int repetitionIO;
+    
+	    // The (channel, repetition, echo) volumes of the pass are
+	    //	independent units. With --reconWorkers they are reconstructed by forked
+	    //	workers (see c_scheduler.h): each has its own copy of the
+	    //	current volume state and shares the unpacked k-space. Only
+	    //	plain raw data runs are split; anything that reads or writes
+	    //	a shared file per volume (containers, Rec files, 4D MGH) is
+	    //	reconstructed here in order.
+	    int		units		= s_pass.channels*s_pass.repetitions*s_pass.echoes;
+	    int		workers		= 1;
+	    C_scheduler*	pc_scheduler	= NULL;
+	    C_container*	pc_cacheHeld	= NULL;
+	    if(G_reconWorkers != 1 && !b_preprocessLoad && !b_preprocessSave &&
+	       !Gpc_imageCache && !Gstr_recParamFile.length() &&
+	       Ge_saveType != e_mgh_realImag4D && Ge_saveType != e_mgh_magPhase4D) {
+		// Per unit in flight: its recon scratch, in what the
+		//	unpacked k-space leaves of the budget
+		double		unitBytes	= s_plan.b_shiftInPlace ?
+						  s_plan.s_footprint.workingUnitInPlace :
+						  s_plan.s_footprint.workingUnit;
+		double		budgetBytes	= 0;
+		if(Gv_memoryBudget > 0)
+		    budgetBytes	= max(Gv_memoryBudget -
+				      units*s_plan.s_footprint.kSpaceUnit, 1.0);
+		workers	= C_scheduler::workers_plan(G_reconWorkers, units,
+							unitBytes, budgetBytes);
+	    }
+	    // A shared cache is populated ahead of the reconstruction too,
+	    //	so that the runs waiting for it can go on as soon as
+	    //	possible.
+	    bool	b_cachePrepass	= workers > 1 ||
+					  (Gpc_cache && Gpc_cache->b_sharedMemory_get());
+	    if(b_cachePrepass) {
+		// The k-space cache is a single container, so its volumes are
+		//	written here before the workers start.
+		for(int unit=0; Gpc_cache && unit<units; unit++) {
+		    unit_decode(s_pass,		s_IO,		unit,
+				channelSlot,	echoIndex,	repetitionIndex,
+				channelIO,	echoIO,		repetitionIO,	frame);
+		    volume_extract(Gpc_measOut->kSpaceEcho_get(channelSlot, echoIndex),
+				   repetitionIndex);
+		    cache_volumeSave(channelIO, echoIO, repetitionIO);
+		    volume_destruct();
+		}
+		if(Gpc_cache && Gpc_cache->b_sharedMemory_get() &&
+		   group+1 == echoGroups*repGroups &&
+		   s_pass.channel0 + s_pass.channels >= allRunChannels) {
+		    COUT("\tShared k-space cache complete\n");
+		    cache_publish(Gpc_cache, "", true);
+		    Gpc_cache	= NULL;
+		}
+		pc_cacheHeld	= Gpc_cache;
+		Gpc_cache		= NULL;
+	    }
+	    if(workers > 1) {
+		sout << "\tReconstructing " << units << " volumes on " << workers
+		     << " workers" << endl;
+		COUT(sout.str()); sout.str("");
+		pc_scheduler	= new C_scheduler(units, workers);
+		pc_scheduler->workers_fork();
+	    }
+
+	    // main processing loop: channels, repetitions and echoes
+	    for(int unit = pc_scheduler ? pc_scheduler->unit_next() : 0;
+		unit >= 0 && unit < units;
+		unit = pc_scheduler ? pc_scheduler->unit_next() : unit+1) {
+		// Determine channel/echo/repetition IO
+		unit_decode(s_pass,		s_IO,		unit,
+			    channelSlot,	echoIndex,	repetitionIndex,
+			    channelIO,	echoIO,		repetitionIO,	frame);
+		if(b_journalDone(channelIO, echoIO, repetitionIO)) {
+		    sout << "\tChannel " << channelIO << ", echo " << echoIO
+			 << ", repetition " << repetitionIO << ": done, skipping" << endl;
+		    COUT(sout.str()); sout.str("");
+		    continue;
+		}
+		echo		= echoIO;
+		repetition	= repetitionIO;
+		times(&st_echoStart); time(&tt_echoStart);
+		sout << "\tCurrent Processing Loop:"            << endl;
+		COUT(sout.str()); sout.str("");
+		sout << "\t\tRaw Data\t\tadcPack"	        << endl;
+		COUT(sout.str()); sout.str("");
+		sout << "Channel\t\t     ";
+		sout << channelIO;
+		sout << "\t\t\t    "<< s_pass.channels     << endl;
+		COUT(sout.str()); sout.str("");
+		sout << "Echo\t\t     ";
+		sout << echoIO;
+		sout << "\t\t\t    " << allPackEchoes      << endl;
+		COUT(sout.str()); sout.str("");
+		sout << "Repetition\t     ";
+		sout << repetitionIO;
+		sout << "\t\t\t    " << allPackReps	   << endl;
+		COUT(sout.str()); sout.str("");
+	    
+		if(b_imageLoad)
+		    volume_imageLoad(channelIO, echoIO, repetitionIO);
+		else if(!b_preprocessLoad) {
+		    // For the extraction from the C_adcPack object, remember
+		    //	that this object has already parsed the target
+		    //	echo and repetition (if spec'd) from the raw data
+		    //	file. Also, the target channel has already been filtered.
+		    volume_extract(Gpc_measOut->kSpaceEcho_get(channelSlot, echoIndex),
+				   repetitionIndex);
+		    cache_volumeSave(channelIO, echoIO, repetitionIO);
+		}	
+		else {
+		    // In the case when we load a native volume from file, we
+		    //	need to pass the correct target arguments if
+		    //	spec'd (in order to properly create the file name).
+		    volume_extractLoad(channelIO, echoIO, repetitionIO);
+		}
+		if(b_preprocessSave) {
+		    // In the case when we save a native volume to file, we
+		    //	need to pass the correct target arguments if
+		    //	spec'd
+		    volume_extractSave(channelIO, echoIO, repetitionIO);
+		    // Processing thread continues with next loop if
+		    //	we are saving extracted volumes
+		} else {
+		    //
+		    // otherwise process the extracted volume and reconstruct
+		    //
+		
+		    // The GpVl pointer is captured as a return from most functions
+		    //	and is used in the volume_selectedValuesShow() function.
+		
+		    GpVl    = Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
+		    //volume_selectedValuesShow("Selected extract coords:");
+	    
+		    if(!b_imageLoad && !Gpc_measOut->b_unpackWpadShift_get()) {
+			// If this flag is false, the meas.out in memory has not
+			//	already been zeroPadded and phase shifted.
+			
+			volume_zeroPad();
+			GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
+			//volume_selectedValuesShow("Selected zeroPadded coords:");
+	    
+			volume_ifftshift();	
+			GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
+			//volume_selectedValuesShow("Selected ifftshift coords:");
+		    }
+		    
+		    volume_preprocess(	echoIO, 		
+					-1,
+					repetitionIO, 	
+					-1);
+		    
+		    if(!b_imageLoad) {
+			volume_ifft();
+			GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
+			//volume_selectedValuesShow("Selected ifft coords:");
+	    
+			volume_fftshift();
+			GpVl 	= Gpc_measOut->dataMemory_volumeGet(	e_normalKSpace);
+			//volume_selectedValuesShow("Selected fftshift coords:");
+
+			image_cacheSave(channelIO, echoIO, repetitionIO);
+		    }
+	    
+		    times(&st_echoStop); time(&tt_echoStop);
+		    f_echoTimeCPU  = difftime(st_echoStop.tms_utime, st_echoStart.tms_utime) / 100;
+		    f_echoTimeReal = difftime(tt_echoStop, tt_echoStart);
+		    sout << "\t\tRecon CPU time for echo " << echo << " processing: ";
+		    COUT(sout.str());	sout.str("");	
+		    sout <<  f_echoTimeCPU << " seconds." << endl;
+		    COUTnl(sout.str()); sout.str("");
+		    sout << "\t\tRecon process time for echo " << echo << " processing: ";
+		    COUT(sout.str());	sout.str("");
+		    sout <<  f_echoTimeReal << " seconds." << endl;
+		    COUTnl(sout.str()); sout.str("");
+	 
+		    if(Gstr_recParamFile.length()) 
+			RecFile_volumeSave(	channelIO, 	echoIO, 
+						repetitionIO, 	allRunEchoes,
+						argc,		ppch_argv);
+		    // 4D frames are numbered over the targeted echoes and
+		    //	repetitions, so that all the passes fill in the
+		    //	same file
+		    volume_save(channelIO, echoIO, repetitionIO,
+				frame, allRunReps*allRunEchoes);
+		    journal_unitDone(channelIO, echoIO, repetitionIO);
+
+		}
+		
+		// Common "tail-end" operations
+		
+		volume_destruct();
+	    
+		times(&st_echoStop); time(&tt_echoStop);
+		f_echoTimeCPU  = difftime(st_echoStop.tms_utime, st_echoStart.tms_utime) / 100;
+		f_echoTimeReal = difftime(tt_echoStop, tt_echoStart);
+		sout << "Total CPU time for echo " << echo << " processing: ";
+		COUT(sout.str());   sout.str("");
+		sout <<  f_echoTimeCPU << " seconds." << endl;
+		COUTnl(sout.str()); sout.str("");
+		sout << "Total process time for echo " << echo << " processing: ";
+		COUT(sout.str());   sout.str("");
+		sout <<  f_echoTimeReal << " seconds." << endl << endl;
+		COUTnl(sout.str()); sout.str("");
+	    }
+
+	    if(pc_scheduler) {
+		// Workers other than this process end here.
+		if(!pc_scheduler->workers_join(ret))
+		    ret	= 1;
+		for(int w=0; w<workers; w++) {
+		    sout << "\tWorker " << w << ": " << pc_scheduler->done_get(w)
+			 << " volumes (" << pc_scheduler->stolen_get(w) << " stolen)" << endl;
+		    COUT(sout.str()); sout.str("");
+		}
+		delete pc_scheduler;
+	    }
+	    if(b_cachePrepass)
+		Gpc_cache		= pc_cacheHeld;
+	}
+
+	if(group+1 < echoGroups*repGroups) {
+	    delete Gpc_measOut;
+	    Gpc_measOut	= NULL;
+	}
+    }
+    times(&st_stop); time(&tt_stop);
+    f_totalTimeCPU  = difftime(st_stop.tms_utime, st_start.tms_utime) / 100;
+    f_totalTimeReal = difftime(tt_stop, tt_start);
+    sout << "Total CPU time for data processing (including file I/O): ";
+    COUT(sout.str()); sout.str("");
+    sout <<  f_totalTimeCPU << " seconds." << endl;
+    COUTnl(sout.str()); sout.str("");
+    sout << "Total process time for all echo processing: ";
+    COUT(sout.str()); sout.str("");
+    sout <<  f_totalTimeReal << " seconds." << endl << endl;
+    COUTnl(sout.str()); sout.str("");
+
+/*    
+    // Compare with same indices in MatLab script
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(0, 0, 0, 0, 0)   << endl;
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(1, 1, 1, 0, 0)   << endl;
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(2, 2, 2, 0, 0)   << endl;
+*/    
+    /*
+    // Test for multi-repetition sequences...
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(0, 0, 0, 1, 0)   << endl;
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(1, 1, 1, 1, 0)   << endl;
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(2, 2, 2, 1, 0)   << endl;
+    */
+            
+/*
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(50, 50, 50, 0, 0)   << endl;
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(100, 100, 100, 0, 0)   << endl;
+    cout << c_measOut.pCadc_kSpace_get()->Az_data()(127, 191, 511, 0, 0)   << endl;
+*/
+    
+    if(Gpc_container) {
+	Gpc_container->close();
+	delete Gpc_container;
+	Gpc_container	= NULL;
+    }
+    if(!C_IO_mgh::frameFiles_close()) {
+	cerr << G_SELF << ": could not close the multi-frame output files" << endl;
+	ret	= 1;
+    }
+    if(Gpc_cache && ret==0 && !Gpc_cache->b_sharedMemory_get())
+	journal_note("cache\t" + str_cacheFile + "\tpublished");
+    cache_publish(Gpc_cache, str_cacheFile, ret==0);
+    if(!b_imageLoad)
+	cache_publish(Gpc_imageCache, str_imageFile, ret==0);
+    else if(Gpc_imageCache)
+	delete Gpc_imageCache;
+    Gpc_cache		= NULL;
+    Gpc_imageCache	= NULL;
+    shmCache_release();
+    shmRing_close();
+    journal_close();
+
+    Gpcsm->timer(eSM_stop);
+
+    
+    char*   pch_audio   = "progcomp.sh 2>/dev/null >/dev/null";
+    system(pch_audio);
+
+    if(ret==0)
+	COUT("Normal termination.\n");
+    if(ret!=0)
+	COUT("Some error has occured.\n");
+
+    delete pCdim_disk;
+    delete pCdim_unity;
+    
+    //delete Gpcsm;
+    //delete pcso_measFile;
+
+    // A single run leaves the k-space to the exit, rather than spend
+    //	time freeing it; a batch needs the memory for the next study.
+    if(Gb_batchStudy) {
+	delete Gpc_measOut;
+	Gpc_measOut	= NULL;
+    }
+
+    //BEGIN: Addition by Mohana R
+    if (RecFile::getOptedFor() && !RecFile::isNull())
+	RecFile::Destroy();
+    //END: Addition by Mohana R
+    
+    return ret;
+}
+
+int
+study_parse(
+    const string&		astr_line,
+    s_study&			as_study
+) {
+    //
+    // ARGS
+    //	astr_line		in		"<inDir> <optionsFile> <outDir>
+    //						<runID> [<key>=<list> ...]"
+    //						(a --batch manifest line, or a
+    //						--serve request)
+    //	as_study		out		the study
+    //
+    // DESC
+    //	The optional fields are target lists (channels=, echoes= and
+    //	repetitions=) for the study.
+    //
+    // POSTCONDITIONS
+    //	o Returns 1 for a study, 0 for a blank or '#' comment line, and
+    //	  -1 if the line does not hold all four fields, or an optional
+    //	  field is not understood.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Optional target list fields.
+    //
+
+    istringstream	sin(astr_line);
+    string		str_field;
+    string		str_key;
+    vector<int>*	pv_list;
+    size_t		equals;
+
+    as_study.s_targets	= s_unpackTargets();
+    if(!(sin >> as_study.str_inDir) || as_study.str_inDir[0] == '#')
+	return 0;
+    if(!(sin >> as_study.str_cfgFile >> as_study.str_outDir >> as_study.str_runID))
+	return -1;
+    while(sin >> str_field && str_field[0] != '#') {
+	equals	= str_field.find('=');
+	str_key	= str_field.substr(0, equals);
+	if(str_key == "channels")
+	    pv_list	= &as_study.s_targets.v_channels;
+	else if(str_key == "echoes")
+	    pv_list	= &as_study.s_targets.v_echoes;
+	else if(str_key == "repetitions")
+	    pv_list	= &as_study.s_targets.v_repetitions;
+	else
+	    return -1;
+	if(equals == string::npos ||
+	   !C_adcPack::targetList_parse(str_field.substr(equals+1), *pv_list))
+	    return -1;
+    }
+    return 1;
+}
+
+string
+study_str(
+    const s_study&		as_study
+) {
+    //
+    // ARGS
+    //	as_study		in		study
+    //
+    // DESC
+    //	The study as a study_parse() line (without the '\n').
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    stringstream	sout("");
+
+    sout << as_study.str_inDir << " " << as_study.str_cfgFile << " "
+	 << as_study.str_outDir << " " << as_study.str_runID;
+    if(as_study.s_targets.v_channels.size())
+	sout << " channels="
+	     << C_adcPack::str_targetList(as_study.s_targets.v_channels);
+    if(as_study.s_targets.v_echoes.size())
+	sout << " echoes="
+	     << C_adcPack::str_targetList(as_study.s_targets.v_echoes);
+    if(as_study.s_targets.v_repetitions.size())
+	sout << " repetitions="
+	     << C_adcPack::str_targetList(as_study.s_targets.v_repetitions);
+    return sout.str();
+}
+
+bool
+batch_read(
+    const string&		astr_batchFile,
+    vector<s_study>&		av_studies
+) {
+    //
+    // ARGS
+    //	astr_batchFile		in		--batch manifest
+    //	av_studies		out		its studies, in order
+    //
+    // DESC
+    //	Reads a manifest of study_parse() lines.
+    //
+    // POSTCONDITIONS
+    //	o Returns false if the file cannot be read, or a line does not
+    //	  hold all four fields (av_studies then holds the studies up to
+    //	  that line).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    ifstream		fin(astr_batchFile.c_str());
+    string		str_line;
+    s_study		s_entry;
+
+    av_studies.clear();
+    if(!fin)
+	return false;
+    while(getline(fin, str_line)) {
+	switch(study_parse(str_line, s_entry)) {
+	    case 1:
+		av_studies.push_back(s_entry);
+	    break;
+	    case -1:
+		return false;
+	}
+    }
+    return true;
+}
+
+int
+study_run(
+    const s_study&		as_study,
+    const s_studyOptions&	as_options
+) {
+    //
+    // ARGS
+    //	as_study		in		study to process
+    //	as_options		in		options shared by all studies
+    //
+    // DESC
+    //	Runs study_process() for one study of a batch or a daemon. A
+    //	study that fails (error_exit(), or an exception out of one of the
+    //	classes) returns its code instead of ending the process. Target
+    //	lists of the study replace those of the command line.
+    //
+    // POSTCONDITIONS
+    //	o A reconstruction worker forked by the study never returns
+    //	  from here.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of batch_process().
+    //
+
+    pid_t		pid	= getpid();
+    int			ret	= 0;
+    s_unpackTargets	s_targets	= as_options.s_targets;
+
+    if(as_study.s_targets.v_channels.size())
+	s_targets.v_channels	= as_study.s_targets.v_channels;
+    if(as_study.s_targets.v_echoes.size())
+	s_targets.v_echoes	= as_study.s_targets.v_echoes;
+    if(as_study.s_targets.v_repetitions.size())
+	s_targets.v_repetitions	= as_study.s_targets.v_repetitions;
+
+    Gstr_inDir		= as_study.str_inDir;
+    Gstr_outDir		= as_study.str_outDir;
+    Gstr_runID		= as_study.str_runID;
+
+    Gb_batchStudy	= true;
+    try {
+	ret	= study_process(as_study.str_cfgFile,	as_options.str_measFile,
+				s_targets,
+				as_options.b_preprocessSave,
+				as_options.b_preprocessLoad,
+				as_options.argc,	as_options.ppch_argv);
+    }
+    catch(int code) {
+	ret	= code ? code : 1;
+    }
+    catch(...) {
+	ret	= 1;
+    }
+    Gb_batchStudy	= false;
+    // A reconstruction worker that failed must not go on with the
+    //	batch.
+    if(getpid() != pid)
+	_exit(ret);
+    return ret;
+}
+
+pid_t
+study_prefetch(
+    const s_study&		as_study
+) {
+    //
+    // ARGS
+    //	as_study		in		study that will run next
+    //
+    // DESC
+    //	Starts reading the raw data of a study into the page cache, so
+    //	that its unpack finds them there instead of waiting on the disk.
+    //	The read ahead runs in a child process, and so overlaps the
+    //	reconstruction of the current study.
+    //
+    // POSTCONDITIONS
+    //	o Returns the pid of the child (to be reaped with waitpid()), or
+    //	  -1 if nothing was started. A study whose options file cannot be
+    //	  read is simply not prefetched; it fails in its own turn.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Finds the raw data as study_process() does.
+    //
+
+    string		str_measOut;
+    pid_t		pid;
+    int			fd;
+
+    C_options		c_options(as_study.str_inDir + "/" + as_study.str_cfgFile);
+    if(!c_options.b_read_get() || !c_options.str_ADCbaseDirectory_get().length())
+	return -1;
+    str_measOut	= C_dimensionLists::str_ADCfileBaseName_resolve(c_options) + ".out";
+
+    cout.flush();
+    cerr.flush();
+    fflush(NULL);
+    pid		= fork();
+    if(pid)
+	return pid;
+    fd		= open(str_measOut.c_str(), O_RDONLY);
+    if(fd >= 0) {
+	posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+	close(fd);
+    }
+    _exit(0);
+}
+
+void
+study_abandon() {
+    //
+    // DESC
+    //	Releases what a study that failed part way left open, so that
+    //	the next study of a batch starts from a clean slate. Partial
+    //	caches are removed, as cache_publish() does for failed runs.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    if(Gpc_container) {
+	Gpc_container->close();
+	delete Gpc_container;
+	Gpc_container	= NULL;
+    }
+    cache_publish(Gpc_cache, "", false);
+    if(Gpc_imageCache && Gpc_imageCache->e_mode_get() == e_containerRead)
+	delete Gpc_imageCache;
+    else
+	cache_publish(Gpc_imageCache, "", false);
+    Gpc_cache		= NULL;
+    Gpc_imageCache	= NULL;
+    delete Gpc_measOut;
+    Gpc_measOut		= NULL;
+    shmCache_release();
+    shmRing_close();
+    journal_close();
+    C_IO_mgh::frameFiles_close();
+    if (RecFile::getOptedFor() && !RecFile::isNull())
+	RecFile::Destroy();
+}
+
+int
+batch_process(
+    const s_studyOptions&	as_options
+) {
+    //
+    // ARGS
+    //	as_options		in		options shared by all studies
+    //
+    // DESC
+    //	Runs every study of the Gstr_batchFile manifest in this process,
+    //	one after the other, with the command line options shared by all
+    //	of them. The raw data of the next study are prefetched while the
+    //	current one is processed.
+    //
+    //	A study that fails (error_exit(), or an exception out of one of
+    //	the classes) is abandoned and the batch continues.
+    //
+    // POSTCONDITIONS
+    //	o Returns the code of the last failed study, or 0.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    stringstream	sout("");
+    vector<s_study>	v_studies;
+    vector<int>		v_ret;
+    string		str_cacheDir	= Gstr_cacheDir;
+    string		str_flipAngle	= Gstr_flipAngle;
+    string		str_recFileData	= Gstr_recFileData;
+    bool		b_is3D		= Gb_is3D;
+    e_SAVETYPE		e_saveType	= Ge_saveType;
+    pid_t		pid_prefetch	= -1;
+    int			ret		= 0;
+    unsigned		i;
+
+    if(!batch_read(Gstr_batchFile, v_studies))
+	error_exit("reading the --batch manifest",
+		   "could not read all the studies of " + Gstr_batchFile, 1);
+    if(!v_studies.size())
+	error_exit("reading the --batch manifest",
+		   "found no studies in " + Gstr_batchFile, 1);
+
+    if(v_studies.size() > 1)
+	pid_prefetch	= study_prefetch(v_studies[0]);
+    for(i=0; i<v_studies.size(); i++) {
+	if(pid_prefetch > 0)
+	    waitpid(pid_prefetch, NULL, 0);
+	pid_prefetch	= -1;
+	if(i+1 < v_studies.size())
+	    pid_prefetch	= study_prefetch(v_studies[i+1]);
+
+	// Every study starts from the command line defaults
+	Gstr_cacheDir		= str_cacheDir;
+	Gstr_flipAngle		= str_flipAngle;
+	Gstr_recFileData	= str_recFileData;
+	Gb_is3D			= b_is3D;
+	Ge_saveType		= e_saveType;
+
+	sout << "Batch study " << i+1 << " of " << v_studies.size() << ": "
+	     << v_studies[i].str_runID << " (" << v_studies[i].str_inDir << ")" << endl;
+	COUT(sout.str()); sout.str("");
+
+	v_ret.push_back(study_run(v_studies[i], as_options));
+	if(v_ret.back()) {
+	    study_abandon();
+	    ret		= v_ret.back();
+	}
+    }
+
+    COUT("Batch summary:\n");
+    for(i=0; i<v_studies.size(); i++) {
+	sout << "\t" << v_studies[i].str_runID << "\t"
+	     << (v_ret[i] ? "failed" : "ok") << endl;
+	COUT(sout.str()); sout.str("");
+    }
+    return ret;
+}
+
+void
+serve_stop(
+    int				a_signal
+) {
+    //
+    // DESC
+    //	SIGINT/SIGTERM handler of a --serve daemon.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    Gb_serveStop	= 1;
+}
+
+int
+serve_process(
+    const s_studyOptions&	as_options
+) {
+    //
+    // ARGS
+    //	as_options		in		options shared by all jobs
+    //
+    // DESC
+    //	The --serve daemon. Listens on Gstr_serveAddress for job
+    //	requests (study_parse() lines), queues them, and runs up to
+    //	G_serveJobs of them at once.
+    //
+    //	Each job runs in a process forked from the daemon, with its
+    //	standard output and error connected to the client. The job thus
+    //	starts warm, from the daemon's address space (loaded libraries,
+    //	FFT state, the allocator's heap), and a job that fails or crashes
+    //	cannot take the daemon down.
+    //
+    //	The daemon replies to a request with a "queued <position>" line,
+    //	and to a finished job with a "done <code>" line (both tagged
+    //	with SERVE_TAG).
+    //
+    //	The daemon has a single thread: it never waits on one client.
+    //	Clients still sending their request sit in the poll set next to
+    //	the listening socket, and each request is collected piecemeal
+    //	into that client's line buffer.
+    //
+    // POSTCONDITIONS
+    //	o Returns once SIGINT or SIGTERM has been received and the
+    //	  running jobs have finished. Queued jobs are told they were
+    //	  dropped.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Requests are read without blocking, from all the waiting
+    //	  clients at once, and job processes no longer hold the other
+    //	  clients' connections open.
+    //
+
+    stringstream		sout("");
+    deque<s_serveJob>		q_jobs;
+    map<pid_t, s_serveJob>	map_running;
+    map<pid_t, s_serveJob>::iterator	running;
+    deque<s_serveJob>::iterator		queued;
+    vector<s_serveRequest>	v_requests;
+    vector<struct pollfd>	v_poll;
+    C_streamSocket*		pc_client;
+    s_serveJob			s_job;
+    s_serveRequest		s_request;
+    string			str_line;
+    struct pollfd		s_poll;
+    struct sigaction		s_action;
+    pid_t			pid;
+    time_t			now;
+    int				status, code;
+    size_t			i;
+    bool			b_ended;
+
+    C_streamSocket		c_listen(Gstr_serveAddress, e_socketListen);
+    if(!c_listen.b_isOpen())
+	error_exit("starting the recon daemon",
+		   "could not listen on " + Gstr_serveAddress, 1);
+
+    memset(&s_action, 0, sizeof(s_action));
+    s_action.sa_handler	= serve_stop;
+    sigaction(SIGINT,	&s_action, NULL);
+    sigaction(SIGTERM,	&s_action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    sout << "Serving recon jobs on " << Gstr_serveAddress
+	 << " (" << G_serveJobs << " at once)" << endl;
+    COUT(sout.str()); sout.str("");
+
+    while(!Gb_serveStop || map_running.size()) {
+	// Finished jobs
+	while((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+	    running	= map_running.find(pid);
+	    if(running == map_running.end())
+		continue;
+	    code	= WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+	    sout << SERVE_TAG << "done " << code << endl;
+	    running->second.pc_client->str_send(sout.str()); sout.str("");
+	    sout << "Job " << running->second.s_job.str_runID << " done (code "
+		 << code << ")" << endl;
+	    COUT(sout.str()); sout.str("");
+	    delete running->second.pc_client;
+	    map_running.erase(running);
+	}
+
+	// Queued jobs, while there is room
+	while(!Gb_serveStop && q_jobs.size() && (int) map_running.size() < G_serveJobs) {
+	    s_job	= q_jobs.front();
+	    q_jobs.pop_front();
+	    sout << "Job " << s_job.s_job.str_runID << " started ("
+		 << s_job.s_job.str_inDir << ")" << endl;
+	    COUT(sout.str()); sout.str("");
+	    cout.flush();
+	    cerr.flush();
+	    fflush(NULL);
+	    pid		= fork();
+	    if(!pid) {
+		// The job only talks to its own client
+		close(c_listen.fd_get());
+		for(i=0; i<v_requests.size(); i++)
+		    close(v_requests[i].pc_client->fd_get());
+		for(queued=q_jobs.begin(); queued!=q_jobs.end(); queued++)
+		    close(queued->pc_client->fd_get());
+		for(running=map_running.begin(); running!=map_running.end(); running++)
+		    close(running->second.pc_client->fd_get());
+		signal(SIGINT,	SIG_DFL);
+		signal(SIGTERM,	SIG_DFL);
+		dup2(s_job.pc_client->fd_get(), STDOUT_FILENO);
+		dup2(s_job.pc_client->fd_get(), STDERR_FILENO);
+		Gpcsm	= new C_SMessage("", eSM_raw, "stdout", eSM_cpp);
+		code	= study_run(s_job.s_job, as_options);
+		cout.flush();
+		cerr.flush();
+		fflush(NULL);
+		_exit(code);
+	    }
+	    if(pid < 0) {
+		sout << SERVE_TAG << "done 1" << endl;
+		s_job.pc_client->str_send(sout.str()); sout.str("");
+		delete s_job.pc_client;
+		continue;
+	    }
+	    map_running[pid]	= s_job;
+	}
+
+	if(Gb_serveStop) {
+	    // Stop accepting, and let the running jobs finish
+	    c_listen.close();
+	    for(i=0; i<v_requests.size(); i++) {
+		v_requests[i].pc_client->str_send(SERVE_TAG + "dropped (daemon stopping)\n");
+		delete v_requests[i].pc_client;
+	    }
+	    v_requests.clear();
+	    for(; q_jobs.size(); q_jobs.pop_front()) {
+		sout << SERVE_TAG << "dropped (daemon stopping)" << endl;
+		q_jobs.front().pc_client->str_send(sout.str()); sout.str("");
+		delete q_jobs.front().pc_client;
+	    }
+	    if(map_running.size())
+		poll(NULL, 0, 200);
+	    continue;
+	}
+
+	// New connections, and the requests of waiting clients
+	v_poll.clear();
+	s_poll.fd	= c_listen.fd_get();
+	s_poll.events	= POLLIN;
+	s_poll.revents	= 0;
+	v_poll.push_back(s_poll);
+	for(i=0; i<v_requests.size(); i++) {
+	    s_poll.fd	= v_requests[i].pc_client->fd_get();
+	    v_poll.push_back(s_poll);
+	}
+	if(poll(&v_poll[0], v_poll.size(), 200) < 0)
+	    continue;
+	now	= time(NULL);
+
+	// v_poll[i+1] is v_requests[i]; walk backwards so that erasing
+	//	a request leaves the rest in step
+	for(i=v_requests.size(); i-- > 0; ) {
+	    pc_client	= v_requests[i].pc_client;
+	    b_ended	= false;
+	    if(v_poll[i+1].revents)
+		b_ended	= !pc_client->pending_receive();
+	    if(!b_ended && !pc_client->b_lineBuffered()) {
+		if(now - v_requests[i].since < SERVE_REQUESTTIMEOUT &&
+		   pc_client->pendingLength_get() < SERVE_REQUESTMAX)
+		    continue;
+		str_line	= "";
+	    } else if(!pc_client->line_read(str_line))
+		str_line	= "";
+	    v_requests.erase(v_requests.begin() + i);
+	    if(study_parse(str_line, s_job.s_job) != 1) {
+		pc_client->str_send(SERVE_TAG +
+		    "error: expected \"<inDir> <optionsFile> <outDir> <runID> [<key>=<list> ...]\"\n");
+		delete pc_client;
+		continue;
+	    }
+	    s_job.pc_client	= pc_client;
+	    q_jobs.push_back(s_job);
+	    sout << SERVE_TAG << "queued " << q_jobs.size() << endl;
+	    pc_client->str_send(sout.str()); sout.str("");
+	}
+
+	if(v_poll[0].revents & POLLIN) {
+	    pc_client	= c_listen.connection_accept();
+	    if(pc_client) {
+		s_request.pc_client	= pc_client;
+		s_request.since		= now;
+		v_requests.push_back(s_request);
+	    }
+	}
+    }
+
+    COUT("Recon daemon stopped.\n");
+    return 0;
+}
+
+int
+submit_process(
+    const s_study&		as_study
+) {
+    //
+    // ARGS
+    //	as_study		in		study to submit
+    //
+    // DESC
+    //	The --submit client. Sends the study to the --serve daemon at
+    //	Gstr_submitAddress, and copies the job's output to stdout as it
+    //	arrives. Relative directories are made absolute first, since the
+    //	daemon runs elsewhere.
+    //
+    // POSTCONDITIONS
+    //	o Returns the job's code, or 1 if the daemon could not be
+    //	  reached, refused the job, or went away.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    s_study		s_job		= as_study;
+    string		str_line;
+    char		pch_cwd[PATH_MAX];
+
+    if(getcwd(pch_cwd, sizeof(pch_cwd))) {
+	if(s_job.str_inDir[0] != '/')
+	    s_job.str_inDir	= string(pch_cwd) + "/" + s_job.str_inDir;
+	if(s_job.str_outDir[0] != '/')
+	    s_job.str_outDir	= string(pch_cwd) + "/" + s_job.str_outDir;
+    }
+
+    C_streamSocket	c_daemon(Gstr_submitAddress, e_socketConnect);
+    if(!c_daemon.b_isOpen() || !c_daemon.str_send(study_str(s_job) + "\n"))
+	return 1;
+    while(c_daemon.line_read(str_line)) {
+	if(str_line.compare(0, SERVE_TAG.length(), SERVE_TAG)) {
+	    cout << str_line << endl;
+	    continue;
+	}
+	str_line	= str_line.substr(SERVE_TAG.length());
+	if(!str_line.compare(0, 5, "done "))
+	    return atoi(str_line.c_str() + 5);
+	if(str_line.compare(0, 7, "queued "))
+	    cerr << G_SELF << ": " << str_line << endl;
+	if(!str_line.compare(0, 6, "error:") || !str_line.compare(0, 7, "dropped"))
+	    return 1;
+    }
+    cerr << G_SELF << ": lost the connection to " << Gstr_submitAddress << endl;
+    return 1;
+}
+
+double
+seconds_now() {
+    //
+    // DESC
+    //	Wall clock time in seconds, for throughput reports.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    struct timeval	s_now;
+
+    gettimeofday(&s_now, NULL);
+    return s_now.tv_sec + s_now.tv_usec / 1e6;
+}
+
+bool
+distribute_dispatch(
+    s_distributeSlot&		as_slot,
+    const s_study&		as_job,
+    int				a_job
+) {
+    //
+    // ARGS
+    //	as_slot			in/out		idle connection slot
+    //	as_job			in		channel job
+    //	a_job			in		its index
+    //
+    // DESC
+    //	Sends a job to the daemon of a slot.
+    //
+    // POSTCONDITIONS
+    //	o Returns false (and marks the slot dead) if the daemon could
+    //	  not be reached.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
 
-		}
-		
-		// Common "tail-end" operations
-		
-		volume_destruct();
-	    
-		times(&st_echoStop); time(&tt_echoStop);
-		f_echoTimeCPU  = difftime(st_echoStop.tms_utime, st_echoStart.tms_utime) / 100;
-		f_echoTimeReal = difftime(tt_echoStop, tt_echoStart);
-		sout << "Total CPU time for echo " << echo << " processing: ";
-		COUT(sout.str());   sout.str("");
-		sout <<  f_echoTimeCPU << " seconds." << endl;
-		COUTnl(sout.str()); sout.str("");
-		sout << "Total process time for echo " << echo << " processing: ";
-		COUT(sout.str());   sout.str("");
-		sout <<  f_echoTimeReal << " seconds." << endl << endl;
-		COUTnl(sout.str()); sout.str("");
-	    }	
+    as_slot.pc_daemon	= new C_streamSocket(as_slot.str_address, e_socketConnect);
+    if(!as_slot.pc_daemon->b_isOpen() ||
+       !as_slot.pc_daemon->str_send(study_str(as_job) + "\n")) {
+	delete as_slot.pc_daemon;
+	as_slot.pc_daemon	= NULL;
+	as_slot.b_dead		= true;
+	return false;
+    }
+    as_slot.job		= a_job;
+    as_slot.str_output	= "";
+    as_slot.v_start	= seconds_now();
+    return true;
+}
+
+int
+distribute_process(
+    const s_study&		as_study
+) {
+    //
+    // ARGS
+    //	as_study		in		study to reconstruct
+    //
+    // DESC
+    //	The --distribute coordinator. Splits the channels of the study
+    //	into channel targeted jobs, and keeps every daemon connection of
+    //	Gstr_distribute busy with them until all are done. Each daemon
+    //	makes a single pass over the raw data per job, picking out the
+    //	records of its channels.
+    //
+    //	A job whose daemon cannot be reached, goes away or is stopping
+    //	is put back in the queue for another connection. A job that
+    //	fails has its output shown.
+    //
+    // POSTCONDITIONS
+    //	o Returns the code of the last failed job, or 0.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Pre-scans the raw data file the jobs unpack.
+    //
+
+    stringstream		sout("");
+    vector<s_distributeSlot>	v_slots;
+    vector<s_study>		v_jobs;
+    vector<int>			v_channels	= as_study.s_targets.v_channels;
+    deque<int>			q_pending;
+    vector<struct pollfd>	v_poll;
+    vector<int>			v_polled;
+    s_distributeSlot		s_slot;
+    s_study			s_job;
+    string			str_address;
+    string			str_line;
+    double			v_start		= seconds_now();
+    double			v_seconds;
+    int				jobs, done	= 0;
+    int				groupSize, code;
+    int				ret		= 0;
+    unsigned			i, slot;
+    bool			b_over;
+
+    // The daemons
+    istringstream		sin(Gstr_distribute);
+    s_slot.pc_daemon	= NULL;
+    s_slot.job		= -1;
+    s_slot.b_dead	= false;
+    s_slot.v_start	= 0.0;
+    s_slot.jobs		= 0;
+    s_slot.channels	= 0;
+    s_slot.v_busy	= 0.0;
+    while(getline(sin, str_address, ',')) {
+	if(!str_address.length())
+	    continue;
+	s_slot.str_address	= str_address;
+	v_slots.push_back(s_slot);
+    }
+    if(!v_slots.size())
+	error_exit("parsing --distribute", "no daemon addresses in " + Gstr_distribute, 1);
+
+    // The channels
+    if(!v_channels.size()) {
+	int		channels	= 0;
+	C_options	c_options(as_study.str_inDir + "/" + as_study.str_cfgFile);
+	if(!c_options.b_read_get())
+	    error_exit("reading the options file",
+		       "could not read " + as_study.str_inDir + "/" + as_study.str_cfgFile, 1);
+	channels	= c_options.i_get("channels", 0);
+	if(Gb_autoDimension) {
+	    s_measOutExtent	s_extent;
+	    memset(&s_extent, 0, sizeof(s_extent));
+	    // The raw data file the jobs will unpack (as study_process()
+	    //	finds it)
+	    if(C_adcPack::measOut_prescan(
+		    C_dimensionLists::str_ADCfileBaseName_resolve(c_options) + ".out",
+		    s_extent) && s_extent.channels)
+		channels	= s_extent.channels;
 	}
+	if(channels <= 0)
+	    error_exit("parsing options file",
+		       "could not find \"channels\" spec in\n" +
+		       as_study.str_inDir + "/" + as_study.str_cfgFile, 1);
+	for(int c=0; c<channels; c++)
+	    v_channels.push_back(c);
     }
-    times(&st_stop); time(&tt_stop);
-    f_totalTimeCPU  = difftime(st_stop.tms_utime, st_start.tms_utime) / 100;
-    f_totalTimeReal = difftime(tt_stop, tt_start);
-    sout << "Total CPU time for data processing (including file I/O): ";
+
+    // About two jobs per connection, so that a fast daemon can take on
+    //	more of the channels than a slow one
+    groupSize	= max((int) ((v_channels.size() + 2*v_slots.size() - 1) /
+			     (2*v_slots.size())), 1);
+    for(i=0; i<v_channels.size(); i+=groupSize) {
+	s_job			= as_study;
+	s_job.s_targets.v_channels.assign(v_channels.begin() + i,
+			v_channels.begin() + min((size_t) i+groupSize, v_channels.size()));
+	q_pending.push_back(v_jobs.size());
+	v_jobs.push_back(s_job);
+    }
+    jobs	= v_jobs.size();
+
+    sout << "Distributing " << v_channels.size() << " channel(s) of " << as_study.str_runID
+	 << " as " << jobs << " job(s) over " << v_slots.size() << " connection(s)" << endl;
     COUT(sout.str()); sout.str("");
-    sout <<  f_totalTimeCPU << " seconds." << endl;
-    COUTnl(sout.str()); sout.str("");
-    sout << "Total process time for all echo processing: ";
+
+    while(done < jobs) {
+	// Idle connections take the next jobs
+	for(slot=0; slot<v_slots.size() && q_pending.size(); slot++) {
+	    if(v_slots[slot].b_dead || v_slots[slot].job >= 0)
+		continue;
+	    if(!distribute_dispatch(v_slots[slot], v_jobs[q_pending.front()],
+				    q_pending.front())) {
+		sout << "Could not reach " << v_slots[slot].str_address << endl;
+		COUT(sout.str()); sout.str("");
+		continue;
+	    }
+	    sout << "Channel(s) "
+		 << C_adcPack::str_targetList(v_jobs[q_pending.front()].s_targets.v_channels)
+		 << " sent to " << v_slots[slot].str_address << endl;
+	    COUT(sout.str()); sout.str("");
+	    q_pending.pop_front();
+	}
+
+	// The running jobs
+	v_poll.clear();
+	v_polled.clear();
+	for(slot=0; slot<v_slots.size(); slot++) {
+	    if(v_slots[slot].job < 0)
+		continue;
+	    struct pollfd	s_poll;
+	    s_poll.fd		= v_slots[slot].pc_daemon->fd_get();
+	    s_poll.events	= POLLIN;
+	    s_poll.revents	= 0;
+	    v_poll.push_back(s_poll);
+	    v_polled.push_back(slot);
+	}
+	if(!v_poll.size()) {
+	    if(q_pending.size())
+		error_exit("distributing the channel jobs",
+			   "none of the daemons of " + Gstr_distribute + " can be reached", 1);
+	    break;
+	}
+	if(poll(&v_poll[0], v_poll.size(), 200) <= 0)
+	    continue;
+
+	for(i=0; i<v_poll.size(); i++) {
+	    if(!v_poll[i].revents)
+		continue;
+	    s_distributeSlot&	s_busy	= v_slots[v_polled[i]];
+	    b_over	= false;
+	    do {
+		if(!s_busy.pc_daemon->line_read(str_line)) {
+		    sout << "Lost " << s_busy.str_address << "; channel(s) "
+			 << C_adcPack::str_targetList(v_jobs[s_busy.job].s_targets.v_channels)
+			 << " queued again" << endl;
+		    COUT(sout.str()); sout.str("");
+		    q_pending.push_back(s_busy.job);
+		    s_busy.b_dead	= true;
+		    b_over		= true;
+		    break;
+		}
+		if(str_line.compare(0, SERVE_TAG.length(), SERVE_TAG)) {
+		    s_busy.str_output	+= str_line + "\n";
+		    continue;
+		}
+		str_line	= str_line.substr(SERVE_TAG.length());
+		if(!str_line.compare(0, 7, "queued "))
+		    continue;
+		b_over		= true;
+		if(!str_line.compare(0, 7, "dropped")) {
+		    q_pending.push_back(s_busy.job);
+		    s_busy.b_dead	= true;
+		    break;
+		}
+		code		= str_line.compare(0, 5, "done ") ? 1 :
+				  atoi(str_line.c_str() + 5);
+		v_seconds	= seconds_now() - s_busy.v_start;
+		s_busy.jobs++;
+		s_busy.channels	+= v_jobs[s_busy.job].s_targets.v_channels.size();
+		s_busy.v_busy	+= v_seconds;
+		done++;
+		sout << "Channel(s) "
+		     << C_adcPack::str_targetList(v_jobs[s_busy.job].s_targets.v_channels)
+		     << " on " << s_busy.str_address << ": "
+		     << (code ? "failed" : "done") << " in " << v_seconds << " s" << endl;
+		COUT(sout.str()); sout.str("");
+		if(code) {
+		    cerr << s_busy.str_output;
+		    if(str_line.compare(0, 5, "done "))
+			cerr << str_line << endl;
+		    ret		= code;
+		}
+	    } while(!b_over && s_busy.pc_daemon->b_lineBuffered());
+	    if(b_over) {
+		delete s_busy.pc_daemon;
+		s_busy.pc_daemon	= NULL;
+		s_busy.job		= -1;
+	    }
+	}
+    }
+
+    // Throughput
+    v_seconds	= seconds_now() - v_start;
+    for(slot=0; slot<v_slots.size(); slot++) {
+	sout << "\t" << v_slots[slot].str_address << ":\t" << v_slots[slot].jobs
+	     << " job(s), " << v_slots[slot].channels << " channel(s) in "
+	     << v_slots[slot].v_busy << " s";
+	if(v_slots[slot].v_busy > 0)
+	    sout << " (" << v_slots[slot].channels / v_slots[slot].v_busy
+		 << " channels/s)";
+	if(v_slots[slot].b_dead)
+	    sout << ", lost";
+	sout << endl;
+	COUT(sout.str()); sout.str("");
+    }
+    sout << "Distributed reconstruction of " << v_channels.size() << " channel(s): "
+	 << v_seconds << " s" << endl;
     COUT(sout.str()); sout.str("");
-    sout <<  f_totalTimeReal << " seconds." << endl << endl;
-    COUTnl(sout.str()); sout.str("");
+    return ret;
+}
 
-/*    
-    // Compare with same indices in MatLab script
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(0, 0, 0, 0, 0)   << endl;
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(1, 1, 1, 0, 0)   << endl;
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(2, 2, 2, 0, 0)   << endl;
-*/    
-    /*
-    // Test for multi-repetition sequences...
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(0, 0, 0, 1, 0)   << endl;
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(1, 1, 1, 1, 0)   << endl;
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(2, 2, 2, 1, 0)   << endl;
-    */
-            
-/*
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(50, 50, 50, 0, 0)   << endl;
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(100, 100, 100, 0, 0)   << endl;
-    cout << c_measOut.pCadc_kSpace_get()->Az_data()(127, 191, 511, 0, 0)   << endl;
-*/
-    
-    Gpcsm->timer(eSM_stop);
+int
+main(
+    int     argc,
+    char    *ppch_argv[]) {
 
-    
-    char*   pch_audio   = "progcomp.sh 2>/dev/null >/dev/null";
-    system(pch_audio);
+    // ARGS
+    //  argc        in          number of command line arguments
+    //  ppch_argv   in          char array of command line arguments
+    //
+    // DESC
+    //  Somewhat straightforward implementation of example usage of the
+    //  c_adcpack object class.
+    //
+    // HISTORY
+    //  June/July 2003
+    //  o Initial design and development
+    //
+    //  August 2003
+    //  o Deployment and dedicated testing.
+    //
+    // 24 June 2004
+    //	o added volume "preprocess" step
+    //
+    // 19 October 2026
+    //	o (repetition, echo) units optionally reconstructed by a
+    //	  work-stealing set of worker processes.
+    //	o Channel/echo/repetition targets are lists; the listed channels
+    //	  unpack together in one pass over the raw data.
+    //	o Studies processed by study_process(); --batch runs many.
+    //	o --serve daemon and --submit client.
+    //	o --distribute coordinator.
+    //	o --sharedCache.
+    //	o --shmRing volume sink.
+    //	o Run journal (--journal) and --resume.
+    //
 
-    if(ret==0)
-	COUT("Normal termination.\n");
-    if(ret!=0)
-	COUT("Some error has occured.\n");
+    G_SELF              = ppch_argv[0];
 
-    delete pCdim_disk;
-    delete pCdim_unity;
-    
-    //delete Gpcsm;
-    //delete Gpc_measOut;
-    //delete pcso_measFile;
+    // Parse command line options
+    int         option;
+    int		verbosity;
+    string      str_cfgFile         = "";
+    string	str_measFile	    = "meas.asc";
+    string	str_outDir	    = "/tmp";
+    string	str_logFile	    = "stdout";
+    s_unpackTargets	s_targets;			// By default, parse all channels
+    							//	echoes, and repetitions
+    							//	in data
+    bool	b_preprocessSave    = false;
+    bool	b_preprocessLoad    = false;
+    int         ret		    = 0;		// program return value    
+        
+    while(1) {
+        int opt;
+        int optionIndex = 0;
+        opt = getopt_long(argc, ppch_argv, "", longopts, &optionIndex);
+        if( opt == -1)
+            break;
 
-    //BEGIN: Addition by Mohana R
-    if (RecFile::getOptedFor() && !RecFile::isNull())
-	RecFile::Destroy();
-    //END: Addition by Mohana R
+        switch(opt) {
+            case 'i':
+	        Gstr_inDir.assign(optarg, strlen(optarg));
+            break;
+            case 'o':
+	        Gstr_outDir.assign(optarg, strlen(optarg));
+            break;
+            case 'f':
+	        str_cfgFile.assign(optarg, strlen(optarg));
+            break;
+            case 't':
+	        verbosity = atoi(optarg);
+            break;
+            case 'l':
+	        str_logFile.assign(optarg, strlen(optarg));
+            break;
+            case 'm':
+	        str_measFile.assign(optarg, strlen(optarg));
+            break;
+            case 'c':
+	        if(!C_adcPack::targetList_parse(optarg, s_targets.v_channels))
+		    error_exit("parsing --channelTarget",
+			       string("could not understand ") + optarg, 1);
+            break;
+            case 'e':
+	        if(!C_adcPack::targetList_parse(optarg, s_targets.v_echoes))
+		    error_exit("parsing --echoTarget",
+			       string("could not understand ") + optarg, 1);
+            break;
+            case 'r':
+	        if(!C_adcPack::targetList_parse(optarg, s_targets.v_repetitions))
+		    error_exit("parsing --repetitionTarget",
+			       string("could not understand ") + optarg, 1);
+            break;
+            case 'd':
+	        Gstr_runID.assign(optarg, strlen(optarg));
+            break;
+            case 'p':
+	        Gb_syslogPrepend = true;
+            break;
+            case 'L':
+	        b_preprocessLoad = true;
+            break;
+            case 'S':
+	        b_preprocessSave = true;
+            break;
+            case 'C':
+	        Gstr_cacheDir.assign(optarg, strlen(optarg));
+            break;
+            case 'N':
+	        Gb_cache = false;
+            break;
+            case 'Z':
+	        Gb_cacheCompress = true;
+            break;
+            case 'H':
+	        Gb_sharedCache = true;
+            break;
+            case 'I':
+	        Gb_imageCache = true;
+            break;
+            case 'A':
+	        Gb_autoDimension = true;
+            break;
+            case 'W':
+	        G_reconWorkers = atoi(optarg);
+            break;
+            case 'B':
+	        Gv_memoryBudget = memoryBudget_parse(optarg);
+            break;
+            case 'b':
+	        Gstr_batchFile.assign(optarg, strlen(optarg));
+            break;
+            case 'Q':
+	        Gstr_serveAddress.assign(optarg, strlen(optarg));
+            break;
+            case 'J':
+	        G_serveJobs = max(atoi(optarg), 1);
+            break;
+            case 'E':
+	        Gb_resume = true;
+            break;
+            case 'j':
+	        Gb_journal = true;
+            break;
+            case 'G':
+	        if(!shmRing_parse(optarg))
+		    error_exit(	"parsing --shmRing",
+				"expected <name>[,<slots>[,<readers>[,<timeout>]]]", 1);
+            break;
+            case 'U':
+	        Gstr_submitAddress.assign(optarg, strlen(optarg));
+            break;
+            case 'D':
+	        Gstr_distribute.assign(optarg, strlen(optarg));
+            break;
+	    //BEGIN: Added by Mohana R to accomodate Rec File creation
+	    case 'R':
+	        Gstr_recParamFile.assign(optarg, strlen(optarg));
+            break;
+	    //END: Addition by Mohana R
+            case 'v':
+                version_show();
+            break;
+            case '?':
+                synopsis_show();
+                exit(1);
+            break;
+            default:
+                cout << "?? getopt returned character code " << opt << endl;
+        }
+    }
+
+    //Gstr_inDir="/home/rudolph/proj/recon/data/test/";
+    //Gstr_inDir="/home/rudolph/proj/recon/data/gleek/203610";
+    //Gstr_inDir="/home/rudolph/proj/recon/data/multiChannelTest/2rep";
+    //Gstr_inDir="/home/rudolph/proj/recon/data/Ashok/111150";
+    //Gstr_inDir="/home/rudolph/proj/recon/data/gleek/Marianna/m4";
+    //Gstr_inDir="/home/rudolph/proj/recon/data/multiChannelTest/2rep_float_AF";
+    //Gstr_inDir="/home/rudolph/proj/recon/data/multiChannelTest/2rep_base";
+    //Gstr_inDir="/space/kaos/1/users/rudolph/data/recon/gleek/pfizer/may15_04/140708";
+    //str_cfgFile="measMetaData.asc";
+    //Gb_syslogPrepend = true;
+    //Gstr_runID = "multiTest2";
+    //Gstr_outDir = Gstr_inDir+"/recon";
+    //b_preprocessLoad = true;
+    //b_preprocessSave = true;
+    //echoTarget=0;
+    //repetitionTarget=0;
     
+    // Create the object that dumps status information
+    Gpcsm	= new C_SMessage("",
+			eSM_raw,	
+			str_logFile,
+			eSM_cpp);
+    Gpcsm->str_syslogID_set(Gstr_runID);
+
+    s_studyOptions	s_options;
+    s_options.str_measFile	= str_measFile;
+    s_options.s_targets		= s_targets;
+    s_options.b_preprocessSave	= b_preprocessSave;
+    s_options.b_preprocessLoad	= b_preprocessLoad;
+    s_options.argc		= argc;
+    s_options.ppch_argv		= ppch_argv;
+
+    if(Gstr_serveAddress.length())
+	return serve_process(s_options);
+    if(Gstr_batchFile.length())
+	return batch_process(s_options);
+
+    if(str_cfgFile == "")
+	error_exit("parsing command line arguments", "I could not find metaData file spec!", 1);
+    if(Gstr_submitAddress.length() || Gstr_distribute.length()) {
+	s_study		s_job;
+	s_job.str_inDir		= Gstr_inDir;
+	s_job.str_cfgFile	= str_cfgFile;
+	s_job.str_outDir	= Gstr_outDir;
+	s_job.str_runID		= Gstr_runID;
+	s_job.s_targets		= s_targets;
+	if(Gstr_distribute.length())
+	    return distribute_process(s_job);
+	return submit_process(s_job);
+    }
+    ret	= study_process(str_cfgFile,	str_measFile,	s_targets,
+			b_preprocessSave, b_preprocessLoad,
+			argc,		ppch_argv);
     return ret;
 }
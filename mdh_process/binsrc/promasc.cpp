@@ -60,6 +60,12 @@
 //   matrix is output to the filesystem. This file, '3D.cmt' contains
 //   a '1' if the sequence is a 3D scan, or a '0' if it is a 2D scan.
 //
+// 19 October 2026
+// o The meas.asc file is tokenized once by a C_ascconv object, instead
+//   of being rescanned for every key.
+// o All meta data is also written to one binary bundle, meta.mdhb.
+// o The orientation is edited into the meta file without a shell escape.
+//
 
 #ifdef HAVE_CONFIG_H
 #include <config.h>
@@ -70,10 +76,12 @@
 #include <sstream>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 #include <getopt.h>
 
 #include <sys/times.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <stdlib.h>
 
@@ -81,10 +89,13 @@
 // Siemens header for Partial Fourier flag lookups
 
 #include "scanopt.h"
+#include "c_ascconv.h"
+#include "c_metabundle.h"
 #include "cmatrix.h"
 #include "c_SMessage.h"
 
 using namespace std;
+using namespace mdh;
 
 // Using a pseudo-class type structuring, the following "global" variables
 //	should really be interpreted as class members, where the class
@@ -336,7 +347,7 @@ partialFourier_scale(
 
 void
 sliceNormal_parse(
-	C_scanopt&	cso_meas
+	C_ascconv&	cso_meas
 )
 {
 //
@@ -357,8 +368,6 @@ sliceNormal_parse(
 // POSTCONDITIONS
 // o Changes the "global" member GV_sliceNormal vector
 // o Changes the "global" Gstr_orientation and G_orientationA75 values.
-// o Writes (by shell escape) G_orientationA75 to meta file.
-// o Uses the "global" Gstr_meta value.
 //
 // HISTORY
 // 18 June 2004
@@ -369,10 +378,14 @@ sliceNormal_parse(
 //
 // 22 July 2004
 // o Changed error_exit to warn for "sNormal"
+//
+// 19 October 2026
+// o The orientation is edited into the meta file by orientation_edit(),
+//   rather than by a shell escape to awk.
 //
 
     string	str_value;		// for scanopt
-    char	pch_value[32];		// for awk cmd string
+    char	pch_value[32];		// for orientation string
     
     float	f_sag	= 0.0;
     float	f_cor	= 0.0;
@@ -435,30 +448,83 @@ sliceNormal_parse(
 	break;
     } 
     
-    // and parse the meta file, writing the correct orientation
-    sprintf(pch_value, "%d", G_orientationA75);
-    string	str_orientation(pch_value);
-    string	str_cmd = "cat ";
-    str_cmd 		+= Gstr_meta + "| awk '";
-    str_cmd		+= "{";
-    str_cmd		+=     "if($1==\"orientation\")";
-    str_cmd		+=	"{printf(\"\torientation\t\t= %d #edited by promasc\\n\",";
-    str_cmd		+=		str_orientation + ");";
-    str_cmd		+=      "} else ";
-    str_cmd		+=  	    "print;";
-    str_cmd		+= "}'";
-    str_cmd 	+= ">meta.bak ; mv meta.bak " + Gstr_meta;
     COUT("\tDominant slab orientation:...");
     COUTnl("\t\t["+Gstr_orientation+"]\n");
-    COUT("\tEditing Analyze75 orientation:...");
-    system(str_cmd.c_str());
-    COUTnl("\t["+str_orientation+"]\n");
+    sprintf(pch_value, "%d", G_orientationA75);
+    COUT("\tAnalyze75 orientation:...");
+    COUTnl("\t\t["+string(pch_value)+"]\n");
     
 }
 
+void
+orientation_edit(
+	const string&	astr_metaFile
+)
+{
+//
+// ARGS
+//	astr_metaFile	in		meta (options) file to edit
+//
+// DESC
+//	Writes G_orientationA75 into the "orientation" line of the meta
+//	file, so that the meta file and the meta data bundle agree. The
+//	file is rewritten under a temporary name and renamed into place.
+//
+// PRECONDITIONS
+// o sliceNormal_parse() has set G_orientationA75.
+//
+// HISTORY
+// 19 October 2026
+// o Replaces the shell escape to awk formerly in sliceNormal_parse().
+//
+
+    ifstream		fin(astr_metaFile.c_str());
+    string		str_line;
+    string		str_key;
+    stringstream	sout("");
+    string		str_template	= astr_metaFile + ".tmp.XXXXXX";
+    vector<char>	v_tmp(str_template.begin(), str_template.end());
+    int			fd;
+
+    if(!fin) {
+	warn(	"editing the Analyze75 orientation",
+		"I couldn't read " + astr_metaFile, 3);
+	return;
+    }
+    while(getline(fin, str_line)) {
+	stringstream	sin(str_line);
+	str_key		= "";
+	sin >> str_key;
+	if(str_key == "orientation")
+	    sout << "\torientation\t\t= " << G_orientationA75
+		 << " #edited by promasc" << endl;
+	else
+	    sout << str_line << endl;
+    }
+    fin.close();
+
+    v_tmp.push_back('\0');
+    fd	= mkstemp(&v_tmp[0]);
+    string		str_tmp(fd >= 0 ? &v_tmp[0] : "");
+    string		str_out		= sout.str();
+    if(fd < 0 ||
+       write(fd, str_out.c_str(), str_out.length()) != (ssize_t) str_out.length() ||
+       fchmod(fd, 0644) || close(fd) ||
+       rename(str_tmp.c_str(), astr_metaFile.c_str())) {
+	if(str_tmp.length())
+	    unlink(str_tmp.c_str());
+	warn(	"editing the Analyze75 orientation",
+		"I couldn't rewrite " + astr_metaFile, 3);
+	return;
+    }
+    COUT("\tEditing Analyze75 orientation:...");
+    sprintf(Gpch_msg, "%d", G_orientationA75);
+    COUTnl("\t["+string(Gpch_msg)+"]\n");
+}
+
 void
 slicePosition_parse(
-	C_scanopt&	cso_meas
+	C_ascconv&	cso_meas
 )
 {
 //
@@ -600,7 +666,7 @@ vox2ras_ksolve(
 
 CMatrix<float>
 vox2ras_rsolveAA(
-	C_scanopt&	cso_meas
+	C_ascconv&	cso_meas
 )
 {
 //
@@ -714,7 +780,7 @@ vox2ras_rsolveAA(
 
 CMatrix<float>
 vox2ras_dfmeas(
-	C_scanopt&	cso_meas,
+	C_ascconv&	cso_meas,
 	C_scanopt&	cso_meta
 )
 {
@@ -889,6 +955,7 @@ main(int argc, char** ppch_argv) {
     string	str_rotationFile	= "vox2ras.cmt";
     string	str_ROpePCFile		= "ROpePC.cmt";
     string 	str_3DFile		= "3D.cmt";
+    string	str_bundleFile		= METABUNDLE_FILENAME;
     string	str_baseDir		= "./";
     string	str_runID		= G_SELF;
     
@@ -964,8 +1031,10 @@ main(int argc, char** ppch_argv) {
     COUT(G_SELF+" startup\n");
     stringstream        sout("");
 
-    // Create scanopt objects to parse the meas and meta files
-    C_scanopt   cso_measAscFile(str_baseDir+"/"+Gstr_meas, e_EquLink);
+    // Create parsers for the meas and meta files. The meas.asc protocol
+    //	is tokenized once into a hashed C_ascconv, since it is queried for
+    //	many keys.
+    C_ascconv   cso_measAscFile(str_baseDir+"/"+Gstr_meas);
     C_scanopt   cso_metaAscFile(str_baseDir+"/"+Gstr_meta, e_EquLink);
     string	str_value;
 
@@ -1191,6 +1260,7 @@ main(int argc, char** ppch_argv) {
     COUT("Parsing for Siemens normal vector:...");
     COUTnl("\t\t[..]\n");
     sliceNormal_parse(cso_measAscFile);
+    orientation_edit(str_baseDir+"/"+Gstr_meta);
     
     COUT("Parsing for Siemens position vector:...");
     COUTnl("\t\t[..]\n");
@@ -1246,6 +1316,44 @@ main(int argc, char** ppch_argv) {
     			"TR[0],dFlipAngleDegree,alTI[0],alTE[0],...,alTE[echoes-1],");
     COUTnl("\t\t\t[OK]\n");
     
+    // Finally, everything above in one bundle, which mdh_process reads
+    //	in preference to the individual files
+    COUT("Writing " + str_bundleFile + ":...");
+    s_metaBundle	bundle;
+    memset(&bundle.data, 0, sizeof(bundle.data));
+    bundle.data.is3D			= (int) Gb_3D;
+    bundle.data.orientationA75		= G_orientationA75;
+    for(i=0; i<2; i++) {
+	bundle.data.pi_echoList[i]	= M_echoList(i);
+	bundle.data.pi_repList[i]	= M_repList(i);
+	bundle.data.pi_kList[i]		= M_kList(i);
+    }
+    for(i=0; i<3; i++) {
+	bundle.data.pi_ROpePC[i]	= M_ROpePC(i);
+	bundle.data.pv_voxelDimension[i]	= GV_voxelDimension(i);
+    }
+    for(i=0; i<16; i++)
+	bundle.data.pv_vox2ras[i]	= GM_vox2ras(i/4, i%4);
+    for(i=0; i<M_mriParam.cols_get(); i++)
+	bundle.v_mriParams.push_back(M_mriParam(i));
+    // The sources, in METABUNDLE_SOURCES order
+    vector<string>	v_sources;
+    v_sources.push_back(str_baseDir+"/"+Gstr_meta);
+    v_sources.push_back(str_baseDir+"/"+str_3DFile);
+    v_sources.push_back(str_baseDir+"/"+str_echoListFile);
+    v_sources.push_back(str_baseDir+"/"+str_repListFile);
+    v_sources.push_back(str_baseDir+"/"+str_kListFile);
+    v_sources.push_back(str_baseDir+"/"+str_ROpePCFile);
+    v_sources.push_back(str_baseDir+"/"+str_rotationFile);
+    v_sources.push_back(str_baseDir+"/"+str_voxelDimFile);
+    v_sources.push_back(str_baseDir+"/"+str_mriParamFile);
+    bundle.data.sourcesHash		= metaBundle_sourcesHash(v_sources);
+    if(!metaBundle_write(str_baseDir+"/"+str_bundleFile, bundle))
+	error_exit("writing the meta data bundle",
+		   "I could not write " + str_baseDir+"/"+str_bundleFile,
+		   4);
+    COUTnl("\t\t\t\t[OK]\n");
+
     COUT("normal termination\n");
     
     return 0;    
@@ -13,7 +13,7 @@
 #include <string>
 #include <asch.h>
 
-#include <scanopt.h>
+#include "c_ascconv.h"
 
 using namespace std;
 using namespace mdh;
@@ -264,90 +264,121 @@ C_asch::C_asch(
     // 03 May 2003
     //  o Initial design and coding.
     //
+    // 19 October 2026
+    //  o Read through a C_ascconv: the file is tokenized once rather than
+    //    rescanned for each of the (13 per slice) keys.
+    //
+
+    stackDepth = 0;
+    debug_push("C_asch");
+
+    // The protocol is tokenized once; all lookups below are hashed.
+    C_ascconv   asc_measAscFile(astr_aschFileName);
+    protocol_read(asc_measAscFile);
+
+    debug_pop();
+
+}
+
+C_asch::C_asch(
+        const C_ascconv&        ac_protocol
+) {
+    //
+    // ARGS
+    //  ac_protocol             in              tokenized protocol
+    //
+    // DESC
+    //  C_asch constructor, from a protocol that has already been
+    //  tokenized - typically the ASCCONV block of a meas.out preamble.
+    //
+    // POSTCONDITIONS
+    //  o As C_asch(string).
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
 
     stackDepth = 0;
     debug_push("C_asch");
 
-    C_scanopt   cso_measAscFile(astr_aschFileName, e_EquLink);
-    string      str_token;
-    string      str_value;
+    protocol_read(ac_protocol);
+
+    debug_pop();
+
+}
 
-    //cout << "Scanning..." << endl;
+void
+C_asch::protocol_read(
+        const C_ascconv&        asc_measAscFile
+) {
+    //
+    // ARGS
+    //  asc_measAscFile         in              tokenized protocol
+    //
+    // DESC
+    //  Fills the class fields from the protocol. Shared by the
+    //  constructors.
+    //
+    // PRECONDITIONS
+    //  o Called once, from a constructor.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Split out of C_asch(string).
+    //  o No debug_push|pop here: core_construct() resets the stack.
+    //
 
-    sliceArraySize = 0;
     // First, scan for the slice array size and then call a core_construct
-    if(cso_measAscFile.scanFor("sSliceArray.lSize",     &str_value))
-        sliceArraySize  = atoi(str_value.c_str());
+    sliceArraySize = asc_measAscFile.i_get("sSliceArray.lSize");
 
     if(sliceArraySize <= 0)
         error("Invalid sliceArraySize!", 1);
     core_construct(sliceArraySize);
 
-    if(cso_measAscFile.scanFor("tSequenceFileName",     &str_value))
-        str_sequenceFileName    = str_value;
-    if(cso_measAscFile.scanFor("sTXSPEC.lfrequency",    &str_value))
-        TXFrequency             = atoi(str_value.c_str());
+    str_sequenceFileName    = asc_measAscFile.str_get("tSequenceFileName",
+                                                      str_sequenceFileName);
+    TXFrequency             = asc_measAscFile.i_get("sTXSPEC.lfrequency");
 
     for(int slice=0; slice<sliceArraySize; slice++) {
-        char    pch_slice[1024];
-	sprintf(pch_slice, "[%d]", slice);
-	string  str_suffix      = pch_slice;
-	string  str_token       = "alTR" + str_suffix;
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMi_TR->val(0, slice) =             atoi(str_value.c_str());
-	str_token      = "alTI" + str_suffix;
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMi_TI->val(0, slice) =             atoi(str_value.c_str());
-	str_token      = "alTE" + str_suffix;
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMi_TE->val(0, slice) =             atoi(str_value.c_str());
-
-	sprintf(pch_slice, "sSliceArray.asSlice[%d].", slice);
-	string  str_prefix      = pch_slice;
-        str_token               = str_prefix + "sPosition.dSag";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_slicePositionSag->val(0, slice) =       atof(str_value.c_str());
-	str_token               = str_prefix + "sPosition.dCor";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_slicePositionCor->val(0, slice) =       atof(str_value.c_str());
-	str_token               = str_prefix + "sPosition.dTra";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_slicePositionTra->val(0, slice) =       atof(str_value.c_str());
-
-	str_token               = str_prefix + "sNormal.dSag";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_sliceNormalSag->val(0, slice)   =         atof(str_value.c_str());
-	str_token               = str_prefix + "sNormal.dCor";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_sliceNormalCor->val(0, slice)   =         atof(str_value.c_str());
-	str_token               = str_prefix + "sNormal.dTra";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_sliceNormalTra->val(0, slice)   =         atof(str_value.c_str());
-
-	str_token               = str_prefix + "dThickness";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_thickness->val(0, slice)        =       atof(str_value.c_str());
-	str_token               = str_prefix + "dPhaseFOV";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_phaseFOV->val(0, slice)         =       atof(str_value.c_str());
-	str_token               = str_prefix + "dReadoutFOV";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_readoutFOV->val(0, slice)       =       atof(str_value.c_str());
-	str_token               = str_prefix + "dInPlaneRot";
-	if(cso_measAscFile.scanFor(str_token,           &str_value))
-	    pMv_inPlaneRot->val(0, slice)       =       atof(str_value.c_str());
+        string  str_prefix      = C_ascconv::str_key("sSliceArray.asSlice", slice, ".");
+
+        pMi_TR->val(0, slice) =
+            asc_measAscFile.i_get(C_ascconv::str_key("alTR", slice));
+        pMi_TI->val(0, slice) =
+            asc_measAscFile.i_get(C_ascconv::str_key("alTI", slice));
+        pMi_TE->val(0, slice) =
+            asc_measAscFile.i_get(C_ascconv::str_key("alTE", slice));
+
+        pMv_slicePositionSag->val(0, slice) =
+            asc_measAscFile.v_get(str_prefix + "sPosition.dSag");
+        pMv_slicePositionCor->val(0, slice) =
+            asc_measAscFile.v_get(str_prefix + "sPosition.dCor");
+        pMv_slicePositionTra->val(0, slice) =
+            asc_measAscFile.v_get(str_prefix + "sPosition.dTra");
+
+        pMv_sliceNormalSag->val(0, slice)   =
+            asc_measAscFile.v_get(str_prefix + "sNormal.dSag");
+        pMv_sliceNormalCor->val(0, slice)   =
+            asc_measAscFile.v_get(str_prefix + "sNormal.dCor");
+        pMv_sliceNormalTra->val(0, slice)   =
+            asc_measAscFile.v_get(str_prefix + "sNormal.dTra");
+
+        pMv_thickness->val(0, slice)        =
+            asc_measAscFile.v_get(str_prefix + "dThickness");
+        pMv_phaseFOV->val(0, slice)         =
+            asc_measAscFile.v_get(str_prefix + "dPhaseFOV");
+        pMv_readoutFOV->val(0, slice)       =
+            asc_measAscFile.v_get(str_prefix + "dReadoutFOV");
+        pMv_inPlaneRot->val(0, slice)       =
+            asc_measAscFile.v_get(str_prefix + "dInPlaneRot");
     }
 
-    if(cso_measAscFile.scanFor("sKSpace.lBaseResolution",       &str_value))
-        baseResolution                          =       atoi(str_value.c_str());
-    if(cso_measAscFile.scanFor("sKSpace.lPhaseEncodingLines",   &str_value))
-        phaseEncodingLines                      =       atoi(str_value.c_str());
-    if(cso_measAscFile.scanFor("sKSpace.dPhaseResolution",      &str_value))
-        v_phaseResolution                       =       atof(str_value.c_str());
-    if(cso_measAscFile.scanFor("sKSpace.lPartitions",           &str_value))
-        partitions                              =       atoi(str_value.c_str());
-    if(cso_measAscFile.scanFor("dFlipAngleDegree",              &str_value))
-        v_flipAngleDegree                       =       atof(str_value.c_str());
+    baseResolution      = asc_measAscFile.i_get("sKSpace.lBaseResolution");
+    phaseEncodingLines  = asc_measAscFile.i_get("sKSpace.lPhaseEncodingLines");
+    v_phaseResolution   = asc_measAscFile.v_get("sKSpace.dPhaseResolution");
+    partitions          = asc_measAscFile.i_get("sKSpace.lPartitions");
+    v_flipAngleDegree   = asc_measAscFile.v_get("dFlipAngleDegree");
 
     // Determine center of slice position
     double      v_sag   = (pMv_slicePositionSag->val(0,0) +
@@ -360,9 +391,6 @@ C_asch::C_asch(
     pMv_centerSlicePosition->val(0, 0)  = v_sag;
     pMv_centerSlicePosition->val(0, 1)  = v_cor;
     pMv_centerSlicePosition->val(0, 2)  = v_tra;
-
-    debug_pop();
-
 }
 
 void
@@ -23,6 +23,8 @@ namespace mdh {
 
 const int       C_asch_STACKDEPTH      = 64;
 
+class C_ascconv;
+
 
 class C_asch {
 
@@ -87,6 +89,9 @@ class C_asch {
         //
         C_asch(         string          astr_aschFileName);
                 // constructor reading options from file
+        C_asch(         const C_ascconv&        ac_protocol);
+                // constructor from an already tokenized protocol, e.g.
+                //      the preamble of a meas.out
 
         void    core_construct( int     a_sliceArraySize,
                                 string  astr_name               = "unnamed",
@@ -97,6 +102,7 @@ class C_asch {
                                 int     a_stackDepth            = 0,
                                 string  astr_proc               = "noproc");
         ~C_asch();
+        void    protocol_read(  const C_ascconv&        ac_protocol);
 
         //
         // error / warn / print block
@@ -558,6 +558,28 @@ C_adc::load(
 {
     // This "reconstruct" is necessary to keep memory handling clean
     pCIO->volume_reconstruct(pVl_extracted);
+    return pCIO->load(astr_fileName);
+}
+
+bool
+C_adc::frameSave(
+    string		astr_fileName,
+    int			a_frame,
+    int			a_frames)
+{
+    // This "reconstruct" is necessary to keep memory handling clean
+    pCIO->volume_reconstruct(pVl_extracted);
+    return pCIO->frameSave(astr_fileName, a_frame, a_frames);
+}
+
+bool
+C_adc::frameLoad(
+    string		astr_fileName,
+    int			a_frame)
+{
+    // This "reconstruct" is necessary to keep memory handling clean
+    pCIO->volume_reconstruct(pVl_extracted);
+    return pCIO->frameLoad(astr_fileName, a_frame);
 }
 
 void
@@ -802,7 +824,88 @@ C_adc_analyze75::volume_preprocess(
     
 }
 
+//
+//\\\***
+// C_adc_nifti definitions ****>>>>
+/////***
+//
+
+//
+// constructor / destructor block
+//
+
+C_adc_nifti::C_adc_nifti(
+    C_adcPack*			apParent,
+    CMatrix<int>&               aM_spaceVolume,
+    CMatrix<double>&            M_vox2ras,
+    CMatrix<double>&            V_MRIParams
+) :
+C_adc(apParent,
+      aM_spaceVolume)
+{
+    //
+    // ARGS
+    //  apParent			in		pointer back to parent
+    //  aM_kSpaceVolume                 in              dimensions of data space
+    //                                                          see
+    //                                                          e_SCANDIMENSION
+    //                                                          for enumeration
+    //	M_vox2ras			in		vox2ras transformation
+    //								matrix
+    //	V_MRIParams			in		MRI parameters
+    //
+    // DESC
+    //  C_adc_nifti constructor.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    str_obj             = "C_adc_nifti";
+    pCIO		= new C_IO_nifti(M_vox2ras, V_MRIParams);
+
+}
+
+C_adc_nifti::~C_adc_nifti() {
+}
 
+void
+C_adc_nifti::volume_preprocess(
+	int		    a_echoIndex,
+    	int		    a_echoTarget,
+	int		    a_repetitionIndex,
+	int		    a_repetitionTarget) {
+    //
+    // ARGS
+    //	a_echoIndex		in		current echo in loop
+    //	a_echoTarget		in		target echo passed by system
+    //	a_repetitionIndex	in		current repetition in loop
+    //	a_repetitionTarget	in		target rep. passed by system
+    //
+    // DESC
+    //	Selects the MRI parameters for the current echo, exactly as
+    //	C_adc_mgh::volume_preprocess(). Only the TR is currently written
+    //	to the NIfTI header (as pixdim[4]).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
 
+    CMatrix<double>*	pV_MRIparams;
+    pV_MRIparams	= ((C_IO_nifti*)pCIO)->pV_MRIParams_get();
+    CMatrix<double>	V_MRIParamsEcho(1, 4);
+    int	echo		= 0;
+
+    if(a_echoTarget == -1)
+    	echo	= a_echoIndex;
+    else
+    	echo	= a_echoTarget;
 
+    V_MRIParamsEcho(0)	= pV_MRIparams->val(0);
+    V_MRIParamsEcho(1)	= pV_MRIparams->val(1);
+    V_MRIParamsEcho(3)	= pV_MRIparams->val(2);
+    V_MRIParamsEcho(2)	= pV_MRIparams->val(3+echo);
 
+    ((C_IO_nifti*)pCIO)->pV_MRIParamsEcho_copy(V_MRIParamsEcho);
+}
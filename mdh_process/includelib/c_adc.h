@@ -229,6 +229,13 @@ class C_adc {
 		
 	bool   save(    string          astr_fileName);
 	bool   load(    string          astr_fileName);
+	bool   frameSave(
+			string          astr_fileName,
+			int		a_frame,
+			int		a_frames);
+	bool   frameLoad(
+			string          astr_fileName,
+			int		a_frame);
 };
 
 class C_adc_mgh : public C_adc {
@@ -308,6 +315,40 @@ class C_adc_analyze75 : public C_adc {
 };
 
 
+class C_adc_nifti : public C_adc {
+
+    //
+    // This class really only implements a "thin interface", providing
+    //	a "bridge" between the top level API (C_adcPack) and the C_IO
+    //	classes of a particular C_adc.
+    //
+
+    protected:
+
+    public:
+
+    //
+    // constructor / destructor block
+    //
+    C_adc_nifti(
+	C_adcPack*			pParent,
+	CMatrix<int>&                   aM_spaceVolume,
+	CMatrix<double>&                M_vox2ras,
+	CMatrix<double>&                V_MRIParams
+		  );
+
+    ~C_adc_nifti();
+
+    //
+    // Misc access block
+    //
+    virtual	void	volume_preprocess(
+				int		    a_echoIndex,
+    				int		    a_echoTarget,
+				int		    a_repetitionIndex,
+				int		    a_repetitionTarget);
+};
+
 }
 
 #endif //__C_ADCPACK_H__
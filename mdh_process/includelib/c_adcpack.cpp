@@ -11,6 +11,17 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
 
 #include <c_adc.h>
 #include <c_adcpack.h>
@@ -18,11 +29,24 @@
 
 #include "cmatrix.h"
 #include "math_misc.h"
+#include "c_ascconv.h"
 
 using namespace std;
 using namespace mdh;
 
 #define MDH_ACQEND_MASK (1)
+#define MDH_RTFEEDBACK_MASK	(1<<1)
+#define MDH_HPFEEDBACK_MASK	(1<<2)
+#define MDH_ONLINE_MASK		(1<<3)
+#define MDH_SYNCDATA_MASK	(1<<5)
+#define MDH_PHASCOR_MASK	(1<<21)
+#define MDH_REFLECT_MASK	(1<<24)
+#define MDH_NOISEADJSCAN_MASK	(1<<25)
+
+// Records that are never k-space data: what "recordReject = auxiliary"
+//	skips. Nothing is skipped unless recordReject asks for it.
+#define C_ADCPACK_RECORDREJECT	(MDH_RTFEEDBACK_MASK | MDH_HPFEEDBACK_MASK | \
+				 MDH_SYNCDATA_MASK | MDH_NOISEADJSCAN_MASK)
 
 //
 //\\\***
@@ -187,6 +211,10 @@ C_dimensionLists::core_construct(
     str_proc[stackDepth]        = astr_proc;
     
     e_byteOrder			= e_littleEndian;
+    IOthreads			= 0;
+    parseThreads		= 1;
+    recordReject		= 0;
+    pC_options			= NULL;
 
     str_obj                     = "C_dimensionLists";
     pV_dimensionStructure       = new CMatrix<int>(1, 5, 1);
@@ -262,111 +290,98 @@ C_dimensionLists::C_dimensionLists(
     pM_ROpePC->val(0, 2)    = a_linesPhaseCorrect;
 };
 
+string
+C_dimensionLists::str_ADCfileBaseName_resolve(
+        const C_options&        ac_options) {
+    //
+    // ARGS
+    //  ac_options              in              parsed options (meta data)
+    //                                                  file
+    //
+    // DESC
+    //  The base name ("<ADCbaseDirectory>/meas") of the Siemens raw data
+    //  that ac_options describe. The one place this is worked out, so
+    //  that everything reading the raw data reads the same file.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    return ac_options.str_ADCbaseDirectory_get() + "/meas";
+}
+
 C_dimensionLists::C_dimensionLists(
-        string                  astr_optionsFileName) {
+        const C_options*        apC_options) {
     //
     // ARGS
-    //  astr_optionsFileName    in              filename containing meta data
-    //                                                  options
+    //  apC_options             in              parsed options (meta data)
+    //                                                  file
     //
     // DESC
     //  File-based meta constructor
     //
-    //  This constructor accepts as argument a filename that contains
-    //  meta data about the various dimensions.
+    //  This constructor accepts as argument the parsed options file that
+    //  contains meta data about the various dimensions.
     //
     // HISTORY
     //  14 August 2003
     //  o Initial design and coding.
     //
+    // 19 October 2026
+    //  o Takes a (shared) C_options instead of a file name: neither the
+    //    options file nor the dimension files are re-read here.
+    //
 
 
     core_construct();
-    debug_push("C_dimensionLists(string astr_optionsFileName)");
+    debug_push("C_dimensionLists(const C_options* apC_options)");
 
     int i, j;
     
-    str_optionsFileName			= astr_optionsFileName;
-
-    string  str_ADCbaseDirectory        = "";
-    string  str_kListDimensionFile      = "";
-    string  str_ROpePCDimensionFile     = "";
-    string  str_repListDimensionFile    = "";
-    string  str_echoListDimensionFile   = "";
-
-    C_scanopt                   cso_optionsFile(    astr_optionsFileName, e_EquLink);
-    string                      str_value;
-    string                      str_parsing     = "While parsing " + astr_optionsFileName;
-
-    // Now parse the optionsFile itself
-    if(cso_optionsFile.scanFor("ADCbaseDirectory",      &str_value))
-        str_ADCbaseDirectory        = str_value;
-    else error(str_parsing + ", no ADCbaseDirectory variable found", 2);
-    str_ADCfileBaseName = str_ADCbaseDirectory + "/meas";
+    pC_options				= apC_options;
+
+    string                      str_parsing     = "While parsing " +
+						  pC_options->str_fileName_get();
+    const char*                 ppch_lists[]    = {
+	"kListDimensionFile",	"repListDimensionFile",	"echoListDimensionFile"
+    };
+    CMatrix<int>**              ppM_lists[]     = {
+	&pM_sliceSelectList,	&pM_repetitionList,	&pM_echoList
+    };
+
+    // Now check the options themselves
+    if(!pC_options->b_has("ADCbaseDirectory"))
+	error(str_parsing + ", no ADCbaseDirectory variable found", 2);
+    str_ADCfileBaseName = str_ADCfileBaseName_resolve(*pC_options);
     
-    if(cso_optionsFile.scanFor("ROpePCDimensionFile",     &str_value))
-        str_ROpePCDimensionFile         = str_value;
-    else error(str_parsing + ",\n\tno ROpePCDimensionFile variable found", 2);
-    str_ROpePCDimensionFile = str_ADCbaseDirectory + "/" + str_ROpePCDimensionFile;
-    pM_ROpePC       = new CMatrix<int>((char*)str_ROpePCDimensionFile.c_str());
-
-    if(cso_optionsFile.scanFor("kListDimensionFile",    &str_value))
-        str_kListDimensionFile      = str_value;
-    else error(str_parsing + ",\n\tno kListDimensionFile variable found", 2);
-    str_kListDimensionFile = str_ADCbaseDirectory + "/" + str_kListDimensionFile;
-
-    if(cso_optionsFile.scanFor("repListDimensionFile",  &str_value))
-        str_repListDimensionFile    = str_value;
-    else error(str_parsing + ",\n\tno repListDimensionFile variable found", 2);
-    str_repListDimensionFile = str_ADCbaseDirectory + "/" + str_repListDimensionFile;
-
-    if(cso_optionsFile.scanFor("echoListDimensionFile",  &str_value))
-        str_echoListDimensionFile   = str_value;
-    else error(str_parsing + ",\n\tno echoListDimensionFile variable found", 2);
-    str_echoListDimensionFile = str_ADCbaseDirectory + "/" + str_echoListDimensionFile;
-    
-    // Define the base directory
-    string          str_fileBaseName    = str_ADCbaseDirectory + "/meas";
-
-    CMatrix<int>*   pM_listData;        // 1x2 matrix of list endpoints
+    if(!pC_options->pMi_get("ROpePCDimensionFile"))
+	error(str_parsing + (pC_options->b_has("ROpePCDimensionFile") ?
+	      ",\n\tcould not read " + pC_options->str_path_get("ROpePCDimensionFile") :
+	      string(",\n\tno ROpePCDimensionFile variable found")), 2);
+    pM_ROpePC       = new CMatrix<int>(1, 3);
+    pM_ROpePC->copy(*pC_options->pMi_get("ROpePCDimensionFile"));
+
+    const CMatrix<int>*   pM_listData;  // 1x2 matrix of list endpoints
     int start, end;
 
-    pM_listData                 = new CMatrix<int>((char*)str_kListDimensionFile.c_str());
-    start   = pM_listData->val(0, 0);   end = pM_listData->val(0, 1); j = start;
-    if(end==0)
-        pM_sliceSelectList      = new CMatrix<int>(1, 1, 0);
-    else {
-        pM_sliceSelectList      = new CMatrix<int>(1, end-start+1);
-        for(i=0; i<=end-start; i++) {
-            pM_sliceSelectList->val(0, i)    = j++;
-        }
-    }
-
-    delete pM_listData;
-    pM_listData                 = new CMatrix<int>((char*)str_repListDimensionFile.c_str());
-    start   = pM_listData->val(0, 0);   end = pM_listData->val(0, 1); j = start;
-    if(end==0)
-        pM_repetitionList       = new CMatrix<int>(1, 1, 0);
-    else {
-        pM_repetitionList       = new CMatrix<int>(1, end-start+1);
-        for(i=0; i<=end-start; i++) {
-            pM_repetitionList->val(0, i)    = j++;
-        }
-    }
-    
-    delete pM_listData;
-    pM_listData                 = new CMatrix<int>((char*)str_echoListDimensionFile.c_str());
-    start   = pM_listData->val(0, 0);   end = pM_listData->val(0, 1); j = start;
-    if(end==0)
-        pM_echoList             = new CMatrix<int>(1, 1, 0);
-    else {
-        pM_echoList             = new CMatrix<int>(1, end-start+1);
-        for(i=0; i<=end-start; i++) {
-            pM_echoList->val(0, i)          = j++;
-        }
+    for(int list=0; list<3; list++) {
+	pM_listData	= pC_options->pMi_get(ppch_lists[list]);
+	if(!pM_listData)
+	    error(str_parsing + (pC_options->b_has(ppch_lists[list]) ?
+		  ",\n\tcould not read " + pC_options->str_path_get(ppch_lists[list]) :
+		  ",\n\tno " + string(ppch_lists[list]) + " variable found"), 2);
+	start   = pM_listData->val(0, 0);   end = pM_listData->val(0, 1); j = start;
+	if(end==0)
+	    *ppM_lists[list]	= new CMatrix<int>(1, 1, 0);
+	else {
+	    *ppM_lists[list]	= new CMatrix<int>(1, end-start+1);
+	    for(i=0; i<=end-start; i++) {
+		(*ppM_lists[list])->val(0, i)    = j++;
+	    }
+	}
     }
 
-    delete pM_listData;
     debug_pop();
 }
 
@@ -391,7 +406,8 @@ C_dimensionLists::metaData_parse() {
     //	non-dimensional information, such as byteOrder, saveFormats, etc.
     //
     // PRECONDITIONS
-    //	o meta data file must exist and be defined in str_optionsFileName.
+    //	o the parsed meta data file must have been set with
+    //	  pC_options_set(). Without it, only defaults are set.
     //
     // HISTORY
     // 04 November 2003
@@ -400,10 +416,12 @@ C_dimensionLists::metaData_parse() {
     // 25 February 2004
     //	o Added several boolean flags.
     //
-    
-    C_scanopt                   cso_optionsFile(    str_optionsFileName, e_EquLink);
-    string                      str_value;
-    string                      str_parsing     = "While parsing " + str_optionsFileName;
+    // 19 October 2026
+    //	o Added IOthreads, parseThreads, recordReject.
+    //	o Reads the shared C_options rather than re-parsing the file.
+    //	o recordReject filters nothing unless set ("auxiliary" for
+    //	  the records that are never k-space data).
+    //
     
     e_byteOrder			= e_littleEndian;
     b_unpackWpadShift		= true;
@@ -411,19 +429,99 @@ C_dimensionLists::metaData_parse() {
     b_readOutCrop		= true;
     b_phaseCorrect		= false;
     b_shiftInPlace		= false;
+    IOthreads			= 0;
+    parseThreads		= 1;
+    recordReject		= 0;
     
-    if(cso_optionsFile.scanFor("byteOrder",  &str_value))
-	e_byteOrder		= (e_BYTEORDER) atoi(str_value.c_str());
-    if(cso_optionsFile.scanFor("unpackWpadShift",	&str_value))
-	b_unpackWpadShift	= (bool) atoi(str_value.c_str());
-    if(cso_optionsFile.scanFor("packAdditionalData",    &str_value))
-	b_packAdditionalData    = (bool) atoi(str_value.c_str());
-    if(cso_optionsFile.scanFor("readOutCrop",  &str_value))
-	b_readOutCrop		= (bool) atoi(str_value.c_str());
-    if(cso_optionsFile.scanFor("phaseCorrect",  &str_value))
-	b_phaseCorrect		= (bool) atoi(str_value.c_str());
-    if(cso_optionsFile.scanFor("shiftInPlace",  &str_value))
-	b_shiftInPlace		= (bool) atoi(str_value.c_str());
+    if(!pC_options)
+	return;
+
+    e_byteOrder		= (e_BYTEORDER) pC_options->i_get("byteOrder", e_byteOrder);
+    b_unpackWpadShift	= (bool) pC_options->i_get("unpackWpadShift", b_unpackWpadShift);
+    b_packAdditionalData	= (bool) pC_options->i_get("packAdditionalData",
+						   b_packAdditionalData);
+    b_readOutCrop	= (bool) pC_options->i_get("readOutCrop", b_readOutCrop);
+    b_phaseCorrect	= (bool) pC_options->i_get("phaseCorrect", b_phaseCorrect);
+    b_shiftInPlace	= (bool) pC_options->i_get("shiftInPlace", b_shiftInPlace);
+    IOthreads		= pC_options->i_get("IOthreads", IOthreads);
+    parseThreads	= pC_options->i_get("parseThreads", parseThreads);
+    // A mask, so hex (0x...) is accepted as well
+    if(pC_options->str_get("recordReject") == "auxiliary")
+	recordReject	= C_ADCPACK_RECORDREJECT;
+    else if(pC_options->b_has("recordReject"))
+	recordReject	= strtoul(pC_options->str_get("recordReject").c_str(), NULL, 0);
+}
+
+bool
+C_dimensionLists::extent_apply(
+    const s_measOutExtent&	as_extent,
+    bool			ab_3D
+) {
+    //
+    // ARGS
+    //	as_extent		in		extents found in the raw data
+    //	ab_3D			in		if true, the slice select list
+    //							runs over partitions,
+    //							else over slices
+    //
+    // DESC
+    //	Resizes the dimension lists to exactly the extents of the raw
+    //	data, as opposed to those named in the meta data files. The
+    //	lists are rebuilt as 0 ... N-1; the phase correct lines are kept.
+    //
+    // POSTCONDITIONS
+    //	o Returns true if anything was changed. Each changed dimension is
+    //	  reported with a warning.
+    //	o Nothing is changed for an empty extent.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    int			sliceSelect	= ab_3D ? as_extent.partitions : as_extent.slices;
+    const int		pa_found[]	= {
+	sliceSelect,	as_extent.repetitions,	as_extent.echoes
+    };
+    const char*		ppch_lists[]	= {
+	"slice select",	"repetition",		"echo"
+    };
+    CMatrix<int>**	ppM_lists[]	= {
+	&pM_sliceSelectList,	&pM_repetitionList,	&pM_echoList
+    };
+    stringstream	sout("");
+    bool		b_changed	= false;
+
+    if(!as_extent.records)
+	return false;
+
+    for(int list=0; list<3; list++) {
+	if(pa_found[list] <= 0 || pa_found[list] == (*ppM_lists[list])->cols_get())
+	    continue;
+	sout << "Raw data has " << pa_found[list] << " " << ppch_lists[list]
+	     << " lines; the meta data files give " << (*ppM_lists[list])->cols_get();
+	warn(sout.str(), 1); sout.str("");
+	delete *ppM_lists[list];
+	*ppM_lists[list]	= new CMatrix<int>(1, pa_found[list]);
+	for(int i=0; i<pa_found[list]; i++)
+	    (*ppM_lists[list])->val(0, i)	= i;
+	b_changed		= true;
+    }
+    if(as_extent.samplesInScan > 0 && as_extent.samplesInScan != linesReadOut_get()) {
+	sout << "Raw data has " << as_extent.samplesInScan
+	     << " read out samples; the meta data files give " << linesReadOut_get();
+	warn(sout.str(), 1); sout.str("");
+	pM_ROpePC->val(0, 0)	= as_extent.samplesInScan;
+	b_changed		= true;
+    }
+    if(as_extent.lines > 0 && as_extent.lines != linesPhaseEncode_get()) {
+	sout << "Raw data has " << as_extent.lines
+	     << " phase encode lines; the meta data files give " << linesPhaseEncode_get();
+	warn(sout.str(), 1); sout.str("");
+	pM_ROpePC->val(0, 1)	= as_extent.lines;
+	b_changed		= true;
+    }
+    return b_changed;
 }
 
 int
@@ -688,6 +786,9 @@ C_adcPack::core_construct(
     // 25 February 2004
     //	o b_unpackWpadShift moved to pC_dimension class
     //
+    // 19 October 2026
+    //	o pch_measOut, pcasch_measASCfile, record counts
+    //
 
     str_name                    = astr_name;
     id                          = a_id;
@@ -697,12 +798,19 @@ C_adcPack::core_construct(
     stackDepth                  = a_stackDepth;
     str_proc[stackDepth]        = astr_proc;
 
-    echoTarget			= -1;		// default is *all* echoes and
-    repetitionTarget		= -1;		//	repetitions.
+    channelSlots		= 1;		// default is *all* channels,
+    echoSlots			= 1;		//	echoes and repetitions.
     
     zeroPad_row			= 0;
     zeroPad_column		= 0;
     zeroPad_slice		= 0;
+
+    pch_measOut			= NULL;
+    measOutSize			= 0;
+    pcasch_measASCfile		= NULL;
+    for(int i=0; i<e_recordClasses; i++)
+	pl_recordCount[i]	= 0;
+    recordsRejected		= 0;
     
     str_obj                     = "C_adcPack";
 
@@ -720,6 +828,12 @@ C_adcPack::~C_adcPack() {
    // 01 September 2004
    //	o Added pV_echoesUnpacked
    //
+   // 19 October 2026
+   //	o meas.out mapping and header object released
+   //
+
+   measOut_unmap();
+   delete pcasch_measASCfile;
 
    delete pCadc_kSpace;
    delete pCadc_phaseCorrected;
@@ -734,9 +848,7 @@ C_adcPack::C_adcPack(
         const string            astr_baseFileName,
         C_dimensionLists*       apC_dimension,
         const bool              a_isData3D,
-	int                     a_echoTarget,
-	int                     a_repetitionTarget,
-	int                     a_channelTarget) {
+	const s_unpackTargets&	as_targets) {
     //
     // ARGS
     //  astr_baseFilename               in              path and base name of
@@ -747,23 +859,22 @@ C_adcPack::C_adcPack(
     //                                                          the scan
     //                                                          space
     //  a_isData3D                      in              is this a 3D scan?
-    //	a_echoTarget			in/optional	force the unpacking of a
-    //								subset of echoes
-    //	a_repetitionTarget		in/optional	force the unpacking of a
-    //								subset of repetitions.
-    //	a_channelTarget		        in/optional	force the unpacking of a
-    //								subset of channels.
+    //	as_targets			in/optional	force the unpacking of a
+    //								subset of
+    //								channels, echoes
+    //								and repetitions
     //
     // DESC
     //  C_adcPack constructor.
     //
-    //	In some cases it is more desirable to only unpack a specific echo/repetition/channel
-    //	from a data set - particularly in the case when a given raw data set is
+    //	In some cases it is more desirable to only unpack specific echoes/repetitions/
+    //	channels from a data set - particularly in the case when a given raw data set is
     //	physically too large to fit into active memory. Under such a case the 
-    //	a_echoTarget/a_repetitionTarget/a_channelTarget arguments specify a 
-    //  desired target coordinate tuple.
+    //	as_targets lists specify the desired target coordinates, all of which
+    //	are unpacked in a single pass over the raw data.
     //
-    //	The default values for these variables are both -1.
+    //	The default (empty) lists unpack all echoes and repetitions of a
+    //	single channel.
     //
     // PRECONDITIONS
     //  o astr_aschFileName *must* be a valid and complete filename
@@ -797,6 +908,10 @@ C_adcPack::C_adcPack(
     // 01 September 2004
     //	o Added pV_echoesUnpacked
     //
+    // 19 October 2026
+    //	o Target lists. The channels of a target list share the echo
+    //	  dimension of the k-space, so that they are unpacked together.
+    //
 
     stackDepth = 0;
     debug_push("C_adcPack");
@@ -809,25 +924,36 @@ C_adcPack::C_adcPack(
     // "Unpack" the data from the C_dimensionLists structure
     //	The C_dimensionLists structure is essentially read from
     //	disk. The echoList and repetitionList values, however,
-    //	can be overwritten by passing non-default values to the
-    //	a_echoTarget and a_repetitionTarget variables.
+    //	can be overwritten by passing target lists in as_targets.
 
     CMatrix<int>*               pM_sliceSelectList      = new CMatrix<int>(1,1);
     pM_sliceSelectList->copy(apC_dimension->M_sliceSelectionList_get());
     
     CMatrix<int>*               pM_repetitionList       = new CMatrix<int>(1,1);
-    if(a_repetitionTarget == -1)
+    if(as_targets.v_repetitions.empty())
 	pM_repetitionList->copy(apC_dimension->M_repetitionList_get());
+    else {
+	delete pM_repetitionList;
+	pM_repetitionList	= new CMatrix<int>(1, as_targets.v_repetitions.size());
+	for(unsigned i=0; i<as_targets.v_repetitions.size(); i++)
+	    pM_repetitionList->val(0, i)	= as_targets.v_repetitions[i];
+    }
     CMatrix<int>*               pM_echoList             = new CMatrix<int>(1,1);
-    if(a_echoTarget == -1)
+    if(as_targets.v_echoes.empty())
 	pM_echoList->copy(apC_dimension->M_echoList_get());
+    else {
+	delete pM_echoList;
+	pM_echoList		= new CMatrix<int>(1, as_targets.v_echoes.size());
+	for(unsigned i=0; i<as_targets.v_echoes.size(); i++)
+	    pM_echoList->val(0, i)		= as_targets.v_echoes[i];
+    }
     
-    echoTarget			= a_echoTarget;
-    repetitionTarget		= a_repetitionTarget;
-    channelTarget		= a_channelTarget;
+    s_targets			= as_targets;
+    channelSlots		= max((int) as_targets.v_channels.size(), 1);
 
     int numRepetitions          = pM_repetitionList->cols_get();
     int numEchoes               = pM_echoList->cols_get();
+    echoSlots			= numEchoes;
     
     int linesReadOut            = apC_dimension->linesReadOut_get();
     int linesPhaseEncode        = apC_dimension->linesPhaseEncode_get();
@@ -839,8 +965,8 @@ C_adcPack::C_adcPack(
     M_dimensions(0, e_phaseEncode)      = linesPhaseEncode;
     M_dimensions(0, e_sliceSelect)      = linesSliceSelect;
     M_dimensions(0, e_numRepetitions)   = numRepetitions;
-    M_dimensions(0, e_numEchoes)        = numEchoes;
-    pV_echoesUnpacked			= new CMatrix<int>(1, numEchoes, 0);
+    M_dimensions(0, e_numEchoes)        = channelSlots*numEchoes;
+    pV_echoesUnpacked			= new CMatrix<int>(1, channelSlots*numEchoes, 0);
     
     // The following code is used if "intelligent" unpack is selected.
     //	If true, we pre-calculate the final size (with possible zeroPadding)
@@ -888,13 +1014,438 @@ C_adcPack::C_adcPack(
     // The internal dimension structure contains data relevant to the particular
     //	objects contained in the process. Copy some misc final values from the
     //	external dimension structure to the internal.
-    pC_dimension->str_optionsFileName_set(apC_dimension->str_optionsFileName_get());
+    pC_dimension->pC_options_set(apC_dimension->pC_options_get());
     pC_dimension->metaData_parse();
     pC_dimension->pV_dimensionStructure_set(&M_dimensions);
+
+    slots_build(*pM_repetitionList,	v_repetitionSlot);
+    slots_build(*pM_echoList,		v_echoSlot);
+    slots_build(*pM_sliceSelectList,	v_sliceSlot);
+    channelTargets_set(as_targets.v_channels);
     
+    delete pM_sliceSelectList;
+    delete pM_repetitionList;
+    delete pM_echoList;
     debug_pop();
 }
 
+void
+C_adcPack::channelTargets_set(
+    const vector<int>&		av_channels
+) {
+    //
+    // ARGS
+    //	av_channels		in		raw data channel ids to unpack
+    //							(empty: all, mixed)
+    //
+    // DESC
+    //	Selects the channels of the next pass over the raw data. The
+    //	i-th channel of the list is unpacked into the i-th block of
+    //	echoSlots along the k-space echo dimension.
+    //
+    // PRECONDITIONS
+    //	o No more channels than given to the constructor.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding (replacing the single channelTarget).
+    //
+
+    if((int) av_channels.size() > channelSlots)
+	error("More target channels than were allocated for.");
+    s_targets.v_channels	= av_channels;
+    v_channelSlot.clear();
+    for(unsigned i=0; i<av_channels.size(); i++) {
+	if(av_channels[i] < 0)
+	    continue;
+	if(av_channels[i] >= (int) v_channelSlot.size())
+	    v_channelSlot.resize(av_channels[i]+1, -1);
+	if(v_channelSlot[av_channels[i]] == -1)
+	    v_channelSlot[av_channels[i]]	= i;
+    }
+}
+
+void
+C_adcPack::slots_build(
+    const CMatrix<int>&		aM_list,
+    vector<int>&		av_slot
+) {
+    //
+    // ARGS
+    //	aM_list			in		row vector of raw data indices
+    //	av_slot			out		slot table
+    //
+    // DESC
+    //	Compiles a dimension list into a table from raw data index to
+    //	ordinal position in the list (-1 if absent), with the same first
+    //	match semantics as the C_dimensionLists::*Index_find() methods,
+    //	but without a search per record.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    CMatrix<int>	M_list(aM_list);
+    int			value;
+
+    av_slot.clear();
+    for(int i=0; i<M_list.cols_get(); i++) {
+	value	= M_list.val(0, i);
+	if(value < 0)
+	    continue;
+	if(value >= (int) av_slot.size())
+	    av_slot.resize(value+1, -1);
+	if(av_slot[value] == -1)
+	    av_slot[value]	= i;
+    }
+}
+
+bool
+C_adcPack::targetList_parse(
+    const string&		astr_list,
+    vector<int>&		av_targets
+) {
+    //
+    // ARGS
+    //	astr_list		in		comma separated indices and
+    //							ranges, e.g. "0,3,7"
+    //							or "0-7,9"
+    //	av_targets		out		the indices, ascending and
+    //							unique
+    //
+    // DESC
+    //	Parses a command line target list.
+    //
+    // POSTCONDITIONS
+    //	o Returns false (with av_targets empty) on a syntax error, a
+    //	  negative index or a reversed range.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    const char*		pch	= astr_list.c_str();
+    char*		pch_end;
+    long		first, last;
+
+    av_targets.clear();
+    while(*pch) {
+	first	= strtol(pch, &pch_end, 10);
+	if(pch_end == pch || first < 0)
+	    break;
+	last	= first;
+	pch	= pch_end;
+	if(*pch == '-') {
+	    last	= strtol(pch+1, &pch_end, 10);
+	    if(pch_end == pch+1 || last < first)
+		break;
+	    pch	= pch_end;
+	}
+	for(long i=first; i<=last; i++)
+	    av_targets.push_back(i);
+	if(!*pch) {
+	    sort(av_targets.begin(), av_targets.end());
+	    av_targets.erase(unique(av_targets.begin(), av_targets.end()),
+			     av_targets.end());
+	    return true;
+	}
+	if(*pch++ != ',')
+	    break;
+    }
+    av_targets.clear();
+    return false;
+}
+
+void
+C_adcPack::targets_resolve(
+    const vector<int>&	av_targets,
+    int			a_count,
+    const CMatrix<int>*	apM_list,
+    vector<int>&	av_IO,
+    vector<int>&	av_raw
+) {
+    //
+    // ARGS
+    //	av_targets		in		command line targets (empty:
+    //							none)
+    //	a_count			in		size of the dimension
+    //	apM_list		in		its dimension list (NULL: the
+    //							raw indices are
+    //							0 ... a_count-1)
+    //	av_IO			out		indices used to name files
+    //	av_raw			out		the matching raw data indices
+    //
+    // DESC
+    //	Resolves a dimension for the caller's loops (mdh_process,
+    //	libmdh): a targeted dimension is named after its targets, any
+    //	other after the position in its dimension list.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Moved here from mdh_process, for libmdh.
+    //
+
+    av_IO.clear();
+    av_raw.clear();
+    if(!av_targets.empty()) {
+	av_IO	= av_targets;
+	av_raw	= av_targets;
+	return;
+    }
+    for(int i=0; i<a_count; i++) {
+	av_IO.push_back(i);
+	av_raw.push_back(apM_list ? apM_list->val(0, i) : i);
+    }
+}
+
+string
+C_adcPack::str_targetList(
+    const vector<int>&		av_targets
+) {
+    //
+    // ARGS
+    //	av_targets		in		ascending target indices
+    //
+    // DESC
+    //	The canonical form of a target list, with runs folded into
+    //	ranges ("0-7,9"), or "all" for an empty list.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    stringstream	sout("");
+    unsigned		i, j;
+
+    if(av_targets.empty())
+	return "all";
+    for(i=0; i<av_targets.size(); i=j+1) {
+	for(j=i; j+1<av_targets.size() && av_targets[j+1] == av_targets[j]+1; j++) ;
+	if(i)
+	    sout << ",";
+	sout << av_targets[i];
+	if(j > i)
+	    sout << "-" << av_targets[j];
+    }
+    return sout.str();
+}
+
+bool
+C_adcPack::measOut_map() {
+    //
+    // DESC
+    //  Maps the meas.out read-only into memory. The protocol preamble
+    //  and the raw data are then both read from the same mapping, and
+    //  the sMDH records and ADC samples are used in place rather than
+    //  copied through a stream buffer.
+    //
+    // POSTCONDITIONS
+    //	o Returns false (and leaves pch_measOut NULL) if the file could
+    //	  not be mapped.
+    //	o A second call is a no-op.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    struct stat		st_measOut;
+    int			fd;
+    void*		p_map;
+
+    if(pch_measOut)
+	return true;
+    str_adcFileName	= str_baseFileName + ".out";
+    fd			= open(str_adcFileName.c_str(), O_RDONLY);
+    if(fd < 0)
+	return false;
+    if(fstat(fd, &st_measOut) || st_measOut.st_size <= 0) {
+	close(fd);
+	return false;
+    }
+    p_map		= mmap(NULL, st_measOut.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(p_map == MAP_FAILED)
+	return false;
+    // The data are read once, front to back
+    madvise(p_map, st_measOut.st_size, MADV_SEQUENTIAL);
+    pch_measOut		= (char*) p_map;
+    measOutSize		= st_measOut.st_size;
+    return true;
+}
+
+void
+C_adcPack::measOut_unmap() {
+    //
+    // DESC
+    //  Releases the meas.out mapping, if any.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    if(pch_measOut)
+	munmap(pch_measOut, measOutSize);
+    pch_measOut		= NULL;
+    measOutSize		= 0;
+}
+
+bool
+C_adcPack::measOut_prescan(
+    const string&		astr_measOut,
+    s_measOutExtent&		as_extent
+) {
+    //
+    // ARGS
+    //	astr_measOut		in		meas.out file name
+    //	as_extent		out		extents of the raw data
+    //
+    // DESC
+    //	Walks the sMDH record chain of a meas.out, reading only the
+    //	headers: each one gives the size of its payload, which is
+    //	skipped without being read. Even for multi-GB files this touches
+    //	a few MB, so that the data can be dimensioned exactly before
+    //	anything is allocated.
+    //
+    //	Phase correction records, and records that are not k-space data
+    //	(feedback, sync data, noise adjust), are counted separately and
+    //	do not add to the extents.
+    //
+    // POSTCONDITIONS
+    //	o Returns false if the file could not be opened or holds no
+    //	  preamble. A truncated file gives the extents up to the damage,
+    //	  with b_complete false.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    sMDH		s_header;
+    int			l_adcStartOffset	= 0;
+    off_t		offset;
+    int			fd;
+
+    memset(&as_extent, 0, sizeof(as_extent));
+    fd		= open(astr_measOut.c_str(), O_RDONLY);
+    if(fd < 0)
+	return false;
+    // Payloads are jumped over: read ahead would only fetch them anyway
+    posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+    if(pread(fd, &l_adcStartOffset, sizeof(int), 0) != sizeof(int) ||
+       l_adcStartOffset < (int) sizeof(int)) {
+	close(fd);
+	return false;
+    }
+
+    offset	= l_adcStartOffset;
+    while(pread(fd, &s_header, sizeof(sMDH), offset) == sizeof(sMDH)) {
+	if(s_header.aulEvalInfoMask[0] & MDH_ACQEND_MASK) {
+	    as_extent.b_complete	= true;
+	    break;
+	}
+	if(!s_header.ushSamplesInScan)
+	    break;
+	offset	+= sizeof(sMDH) + sizeof(float)*2*s_header.ushSamplesInScan;
+
+	switch(record_classify(s_header)) {
+	    case e_recordImaging:
+	    break;
+	    case e_recordPhaseCorrect:
+		as_extent.phaseCorrectRecords++;
+	    continue;
+	    default:
+		as_extent.otherRecords++;
+	    continue;
+	}
+	as_extent.records++;
+	as_extent.samplesInScan	= max(as_extent.samplesInScan,
+				      (int) s_header.ushSamplesInScan);
+	as_extent.lines		= max(as_extent.lines, s_header.sLC.ushLine + 1);
+	as_extent.partitions	= max(as_extent.partitions, s_header.sLC.ushPartition + 1);
+	as_extent.slices	= max(as_extent.slices, s_header.sLC.ushSlice + 1);
+	as_extent.echoes	= max(as_extent.echoes, s_header.sLC.ushEcho + 1);
+	as_extent.repetitions	= max(as_extent.repetitions,
+				      s_header.sLC.ushRepetition + 1);
+	as_extent.channels	= max(as_extent.channels,
+				      (int) s_header.ulChannelId + 1);
+    }
+    close(fd);
+    return true;
+}
+
+void
+C_adcPack::footprint_estimate(
+    const C_dimensionLists*	apC_dimension,
+    s_memoryFootprint&		as_footprint
+) {
+    //
+    // ARGS
+    //	apC_dimension		in		dimension lists of the raw
+    //							data, with their meta
+    //							data parsed
+    //	as_footprint		out		memory estimate
+    //
+    // DESC
+    //	Estimates the memory needed to unpack and reconstruct one channel,
+    //	using the same dimensioning as the constructor: the k-space holds
+    //	every (repetition, echo) volume of the channel, zero padded to
+    //	powers of 2 if b_unpackWpadShift is set, along with the phase
+    //	correction lines.
+    //
+    //	While a volume is reconstructed, the zero padding holds the
+    //	extracted and the padded copy as well as a temporary, and the
+    //	shift holds three padded volumes (one with shiftInPlace). When
+    //	the k-space is unpacked already padded and shifted, only the
+    //	extracted volume remains.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Size of the reconstructed volume.
+    //
+
+    double	pv_length[3];
+    double	pv_padded[3];
+    double*	pv_kSpace;
+    double	volume, padded;
+    double	scalar		= sizeof(GSL_complex_float);
+    long	power;
+
+    pv_length[0]	= apC_dimension->linesReadOut_get();
+    pv_length[1]	= apC_dimension->linesPhaseEncode_get();
+    pv_length[2]	= apC_dimension->linesSliceSelect_get();
+    for(int i=0; i<3; i++) {
+	for(power=1; power < pv_length[i]; power <<= 1) ;
+	pv_padded[i]	= pv_length[i] + 2*(long)((power - pv_length[i])/2);
+    }
+    volume		= pv_length[0] * pv_length[1] * pv_length[2];
+    padded		= pv_padded[0] * pv_padded[1] * pv_padded[2];
+    as_footprint.imageUnit	= scalar * padded;
+
+    as_footprint.units	= apC_dimension->M_repetitionList_get().cols_get() *
+			  apC_dimension->M_echoList_get().cols_get();
+    pv_kSpace		= pv_length;
+    if(apC_dimension->b_unpackWpadShift_get()) {
+	pv_kSpace			= pv_padded;
+	as_footprint.kSpaceUnit		= scalar * padded;
+	as_footprint.workingUnit	= scalar * padded;
+	as_footprint.workingUnitInPlace	= scalar * padded;
+    } else {
+	as_footprint.kSpaceUnit		= scalar * volume;
+	as_footprint.workingUnit	= scalar * max(volume + 2*padded, 3*padded);
+	as_footprint.workingUnitInPlace	= scalar * (volume + 2*padded);
+    }
+    if(apC_dimension->b_phaseCorrect_get())
+	as_footprint.kSpaceUnit	+= scalar * apC_dimension->linesPhaseCorrect_get() *
+				   pv_kSpace[1] * pv_kSpace[2];
+}
+
 void
 C_adcPack::headerFile_process(
         bool            b_headerDump    /* = false */) {
@@ -909,18 +1460,35 @@ C_adcPack::headerFile_process(
     // PRECONDITIONS
     //
     // POSTCONDITIONS
-    //
+    //	o The protocol is taken from the meas.out preamble if it carries
+    //	  one; the separate meas.asc is only read as a fallback.
     //
     // HISTORY
     // 07 May 2003
     //  o Initial design and coding.
     //
+    // 19 October 2026
+    //	o Protocol read from the (mapped) meas.out preamble.
+    //
 
     debug_push("headerFile_process");
 
-    str_ascFileName = str_baseFileName + ".asc";
+    size_t		offset, length;
 
-    pcasch_measASCfile  = new C_asch(str_ascFileName);
+    delete pcasch_measASCfile;
+    pcasch_measASCfile	= NULL;
+
+    if(measOut_map() &&
+       C_ascconv::preamble_find(pch_measOut, measOutSize, offset, length)) {
+	C_ascconv	c_protocol(pch_measOut + offset, length, str_adcFileName);
+	if(c_protocol.b_has("sSliceArray.lSize"))
+	    pcasch_measASCfile	= new C_asch(c_protocol);
+    }
+
+    if(!pcasch_measASCfile) {
+	str_ascFileName	= str_baseFileName + ".asc";
+	pcasch_measASCfile  = new C_asch(str_ascFileName);
+    }
     if(b_headerDump)
         pcasch_measASCfile->print();
 
@@ -936,7 +1504,8 @@ C_adcPack::disk2memory_voxelMap(
     int		        loopCounter,
     int&		slicePartitionIndex,
     int&		repetitionIndex,
-    int&		echoIndex
+    int&		echoIndex,
+    vector<string>*	apv_warnings	/*= NULL*/
 ) {
     //
     // ARGS
@@ -952,6 +1521,10 @@ C_adcPack::disk2memory_voxelMap(
     //							slicePartitionIndex
     //							repetitionIndex
     //							echoIndex
+    //	apv_warnings		in/out/opt	if not NULL, warnings are
+    //							appended here (as
+    //							message, details)
+    //							instead of printed
     //
     // DESC
     //	This method is called by dataFile_process() and is part of an attempt
@@ -974,79 +1547,104 @@ C_adcPack::disk2memory_voxelMap(
     // 04 March 2004
     //	o Initial design and coding
     //
+    // 19 October 2026
+    //	o Target lists, looked up in slot tables.
+    //	o Warnings can be collected, for callers on parser threads.
+    //
     
-    bool	b_canUnpack	        = true;
-    
+    int		channelSlot		= 0;
+    stringstream	sout("");
+
+    // The target lists are compiled into slot tables (see slots_build()),
+    //	so that each record is placed with a few table lookups.
+    //
     // For multi-channel data, check channel indices. Targetted channel
     //	data can be thought of as a simple binary decision on whether
     //	or not to unpack echo/repetition data. The channelId is the 
     //	most significant differentiator.
-    if(channelTarget>=0)
-	if(indexChannel!=channelTarget)
+    if(!v_channelSlot.empty()) {
+	if(indexChannel < 0 || indexChannel >= (int) v_channelSlot.size())
 	    return false;
-	
-    // Check repetition target
-    if(repetitionTarget>=0) {
-	if(indexRepetition!=repetitionTarget) {
-	    // Since we have spec'd a particular repetition, and since
-	    //  the current repetition is *not* our target, break
-	    //  out of the surrounding while loop
+	if((channelSlot = v_channelSlot[indexChannel]) < 0)
 	    return false;
-	} else {
-	    repetitionIndex = 0;
-	}
-    } else {
-	repetitionIndex     =   pC_dimension->repetitionIndex_find(
-                                                indexRepetition);
-	if(repetitionIndex  == -1) {
-	    char pch_msg[1024];
-	    warn("Invalid repetitionIndex. Make sure that the repetitionlist variable is correct.");
-	    cout << "\t\tindexRepetition\t= " 	<<	indexRepetition	<< endl;
-	    cout << "\t\tindexEcho\t= "		<< 	indexEcho	<< endl;
-	    cout << "\t\tindexChannel\t= " 	<<	indexChannel	<< endl;
-	    cout << "\t\tloopCounter\t= " 	<<	loopCounter	<< endl;
+    }
+	
+    // Check repetition
+    repetitionIndex	= slot_find(v_repetitionSlot, indexRepetition);
+    if(repetitionIndex == -1) {
+	// Not one of our targets
+	if(!s_targets.v_repetitions.empty())
 	    return false;
-	}
+	sout << "\t\tindexRepetition\t= " 	<<	indexRepetition	<< endl;
+	sout << "\t\tindexEcho\t= "		<< 	indexEcho	<< endl;
+	sout << "\t\tindexChannel\t= " 	<<	indexChannel	<< endl;
+	sout << "\t\tloopCounter\t= " 	<<	loopCounter	<< endl;
+	voxelMap_warn("Invalid repetitionIndex. Make sure that the repetitionlist variable is correct.",
+		      sout.str(), apv_warnings);
+	return false;
     }
 
-    // Check echo target
-    if(echoTarget>=0) {
-	if(indexEcho!=echoTarget) {
-	    // Since we have spec'd a particular echo, and since
-	    //  the current echo is *not* our target, break
-	    //  out of the surrounding while loop
+    // Check echo
+    echoIndex		= slot_find(v_echoSlot, indexEcho);
+    if(echoIndex == -1) {
+	// Not one of our targets
+	if(!s_targets.v_echoes.empty())
 	    return false;
-	} else {
-	    echoIndex   = 0;
-	}
-    } else {
-	echoIndex       =   pC_dimension->echoIndex_find(indexEcho);
-	if(echoIndex    == -1) {
-	    char pch_msg[1024];
-	    warn("Invalid echoIndex. Make sure that the echolist variable is correct.");
-	    cout << "\t\tindexRepetition\t= " 	<<	indexRepetition	<< endl;
-	    cout << "\t\tindexEcho\t= "		<< 	indexEcho	<< endl;
-	    cout << "\t\tindexChannel\t= " 	<<	indexChannel	<< endl;
-	    cout << "\t\tloopCounter\t= " 	<<	loopCounter	<< endl;
-	    return  false;
-	}	
+	sout << "\t\tindexRepetition\t= " 	<<	indexRepetition	<< endl;
+	sout << "\t\tindexEcho\t= "		<< 	indexEcho	<< endl;
+	sout << "\t\tindexChannel\t= " 	<<	indexChannel	<< endl;
+	sout << "\t\tloopCounter\t= " 	<<	loopCounter	<< endl;
+	voxelMap_warn("Invalid echoIndex. Make sure that the echolist variable is correct.",
+		      sout.str(), apv_warnings);
+	return  false;
     }
+    echoIndex		= kSpaceEcho_get(channelSlot, echoIndex);
     
     // Check slice
-    slicePartitionIndex =       pC_dimension->sliceSelectIndex_find(
-                                                            indexSlicePartition);
+    slicePartitionIndex	= slot_find(v_sliceSlot, indexSlicePartition);
     if(slicePartitionIndex  == -1) {
-	char pch_msg[1024];
-	warn("Invalid indexSlicePartition.");
-	cout << "\t\tindexRepetition\t= " 	<<	indexRepetition	<< endl;
-	cout << "\t\tindexEcho\t= "		<< 	indexEcho	<< endl;
-	cout << "\t\tslicePartition\t= " 	<<	indexSlicePartition << endl;
-	cout << "\t\tloopCounter\t= " 		<<	loopCounter	<< endl;
+	sout << "\t\tindexRepetition\t= " 	<<	indexRepetition	<< endl;
+	sout << "\t\tindexEcho\t= "		<< 	indexEcho	<< endl;
+	sout << "\t\tslicePartition\t= " 	<<	indexSlicePartition << endl;
+	sout << "\t\tloopCounter\t= " 		<<	loopCounter	<< endl;
+	voxelMap_warn("Invalid indexSlicePartition.", sout.str(), apv_warnings);
 	return false;
     }
     return true;
 }
 
+void
+C_adcPack::voxelMap_warn(
+    const string&	astr_msg,
+    const string&	astr_details,
+    vector<string>*	apv_warnings
+) {
+    //
+    // ARGS
+    //	astr_msg		in		warning
+    //	astr_details		in		indices of the offending record
+    //	apv_warnings		in/out		NULL, or where to collect the
+    //							warning
+    //
+    // DESC
+    //	Either prints a warning of disk2memory_voxelMap() or, on a parser
+    //	thread where warn() may not be called, keeps it for later (see
+    //	dataFile_parallelProcess()).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    if(apv_warnings) {
+	apv_warnings->push_back(astr_msg);
+	apv_warnings->push_back(astr_details);
+    } else {
+	warn(astr_msg);
+	cout << astr_details;
+    }
+}
+
 int
 C_adcPack::phaseCorrect_unpack(
     CMatrix<GSL_complex_float>&		Mz_adc,
@@ -1257,26 +1855,23 @@ C_adcPack::dataFile_process()
 {
     //
     // DEPENDENCIES
-    //  repetitionTarget    in/opt          specific repetition to filter out
-    //  echoTarget          in/opt          specific echo number to filter out
+    //  s_targets           in/opt          channels, echoes and repetitions
+    //                                      to filter out
     //
     // DESC
     //  Process the actual raw data.
     //
-    //  Note that specific echoes and/or repetitions can be selected by setting
-    //  the corresponding *Target arguments to values >= 0. This is useful for
-    //  instances when the raw data file contains the results of several echoes/
-    //  repetitions and might be too large to process in memory in its
-    //  entirety.
+    //  Note that specific echoes and/or repetitions can be selected by giving
+    //  the constructor target lists. This is useful for instances when the
+    //  raw data file contains the results of several echoes/repetitions and
+    //  might be too large to process in memory in its entirety.
     //
     // PRECONDITIONS
     //  o Corresponding header file must have been processed.
-    //	o Member variables, echoTarget and repetitionTarget, define either
-    //    *all* samples (in which case both are -1), or a *specific*
-    //	  repetition/echo combination.
-    //  o If *Targets are specified, make sure that they are valid for the
-    //    data set being unpacked! Also, only *single* (as opposed to vector)
-    //    target sets can be specified.
+    //	o The member s_targets lists define either *all* samples (in which
+    //    case they are empty), or the targeted channels/echoes/repetitions.
+    //  o If targets are specified, make sure that they are valid for the
+    //    data set being unpacked!
     //
     // POSTCONDITIONS
     //	o Returns the number of samples processed.
@@ -1315,205 +1910,743 @@ C_adcPack::dataFile_process()
     //	o Assume that all 2D volumes are interleaved. This should probably
     //	  be abstracted to a higher level and user specified.
     //
+    // 19 October 2026
+    //	o Records read from the meas.out mapping (shared with the
+    //	  protocol preamble) rather than through an ifstream.
+    //	o Optional parallel decode (parseThreads).
+    //	o Record filter (recordReject) ahead of the payload.
+    //
 
     debug_push("dataFile_process()");
 
     int            	l_adcStartOffset        = -1;
+    int			threads			= pC_dimension->parseThreads_get();
+    long		echoCount		= -1;
 
-    int                 i                       = -1;
+    if(!measOut_map())
+        error("Some error occurred while accessing input file: " + str_baseFileName + ".out");
 
-    // The following variables are mostly read from the Siemens mdh structure
+    // Read in the offset to the actual data...
+    if(measOutSize < sizeof(int))
+        error("Could not access first record");
+    memcpy(&l_adcStartOffset, pch_measOut, sizeof(int));
+    //  ... and start from this location
+    size_t		cursor		= l_adcStartOffset;
 
-    // Current indices into the volumetric space as read from meas.out 
-    // (from s_MDH.sLC)...
-    int                 indexSlicePartition     = 0;
-    int			indexSlice2D		= 0;
-    int                 indexLine               = 0;
-    int                 indexEcho               = 0;
-    int                 indexRepetition         = 0;
-    int                 samplesInScan           = 0;
-    unsigned long	indexChannel		= 0;
+    // Read in first record
+    if(l_adcStartOffset < 0 || cursor + sizeof(sMDH) > measOutSize)
+        error("Could not access first record");
 
-    // Corresponding indices into adc class space (in some cases these will
-    //  be identical to the volumetric indices) that we maintain in memory
-    int                 slicePartitionIndex     = 0;
-    int			phaseEncodeIndex        = 0;
-    int			readOutIndex		= 0;
-    int                 echoIndex               = 0;
-    int                 repetitionIndex         = 0;
-    
+    for(int i=0; i<e_recordClasses; i++)
+	pl_recordCount[i]	= 0;
+    recordsRejected	= 0;
+
+    if(threads <= 0)
+	threads		= (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads > 1)
+	echoCount	= dataFile_parallelProcess(cursor, threads);
+
+    // Sequential decode; also the fallback if the file could not be split
+    if(echoCount < 0) {
+	memcpy(&s_MDH, pch_measOut + cursor, sizeof(sMDH));
+	cursor		+= sizeof(sMDH);
+
+	long int    loopCounter     = 0;
+	echoCount		    = 0;
+	while(      !(s_MDH.aulEvalInfoMask[0] & MDH_ACQEND_MASK)) {
+	    loopCounter++;
+	    if(s_MDH.ushSamplesInScan <= 0)
+		error("Error in processing samplesInScan: readSamples were <= 0");
+
+	    // The ADC data corresponding to the current MDH structure
+	    if(cursor + sizeof(float)*s_MDH.ushSamplesInScan*2 > measOutSize)
+		error("Problems accessing record. Unexpected end of file reached.");
+	    if(record_accept(s_MDH, pl_recordCount, recordsRejected) &&
+	       record_unpack(s_MDH, pch_measOut + cursor, loopCounter,
+			     *pV_echoesUnpacked))
+		echoCount++;
+	    cursor		+= sizeof(float)*s_MDH.ushSamplesInScan*2;
+
+	    // Read in next record
+	    if(cursor + sizeof(sMDH) > measOutSize)
+		error("Problems accessing record. Unexpected end of file reached.");
+	    memcpy(&s_MDH, pch_measOut + cursor, sizeof(sMDH));
+	    cursor		+= sizeof(sMDH);
+	}
+    }
+    int allEchoesUnpacked	= pV_echoesUnpacked->innerProd();
+    if(!allEchoesUnpacked && s_targets.v_echoes.empty()) {
+    	string str_echoesUnpacked;
+    	warn("The raw data contains less echoes than the configuration file suggests.\n\tRecon will continue, but please verify. ");
+	str_echoesUnpacked = pV_echoesUnpacked->sprint("pV_echoesUnpacked");
+	cerr << str_echoesUnpacked << endl;
+    }
+    debug_pop();
+    return echoCount;
+}
+
+bool
+C_adcPack::record_unpack(
+    const sMDH&		as_MDH,
+    const char*		apch_adc,
+    long		a_loopCounter,
+    CMatrix<int>&	aV_echoesUnpacked,
+    vector<string>*	apv_warnings	/*= NULL*/
+) {
+    //
+    // ARGS
+    //	as_MDH			in		header of the record
+    //	apch_adc		in		its ADC samples (interleaved
+    //							re/im floats, not
+    //							necessarily aligned)
+    //	a_loopCounter		in		ordinal of the record (for
+    //							messages)
+    //	aV_echoesUnpacked	in/out		echoes seen so far
+    //	apv_warnings		in/out/opt	where to collect warnings,
+    //							if not printed (see
+    //							disk2memory_voxelMap())
+    //
+    // DESC
+    //	Unpacks a single raw data record into k-space.
+    //
+    // PRECONDITIONS
+    //	o as_MDH.ushSamplesInScan > 0, and that many samples are available
+    //	  at apch_adc.
+    //
+    // POSTCONDITIONS
+    //	o Returns true if the record belonged to the unpacked volume(s).
+    //	o Records of different record_partition() keys touch different
+    //	  k-space elements, so those may be unpacked at once as long as
+    //	  each caller has its own aV_echoesUnpacked and apv_warnings.
+    //	  Records of the same key (e.g. averages, or the additional data
+    //	  of all lines of a slice) overwrite each other and have to be
+    //	  unpacked in file order.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Split out of dataFile_process().
+    //
+
+    int			i;
+
+    // The following variables are mostly read from the Siemens mdh structure
+
+    // Current indices into the volumetric space as read from meas.out 
+    // (from s_MDH.sLC)...
+    int                 indexSlicePartition     = 0;
+    int			indexSlice2D		= 0;
+    int                 indexLine               = as_MDH.sLC.ushLine;
+    int                 indexEcho               = as_MDH.sLC.ushEcho;
+    int                 indexRepetition         = as_MDH.sLC.ushRepetition;
+    int                 samplesInScan           = as_MDH.ushSamplesInScan;
+    unsigned long	indexChannel		= as_MDH.ulChannelId;
+
+    // Corresponding indices into adc class space (in some cases these will
+    //  be identical to the volumetric indices) that we maintain in memory
+    int                 slicePartitionIndex     = 0;
+    int			phaseEncodeIndex        = 0;
+    int			readOutIndex		= 0;
+    int                 echoIndex               = 0;
+    int                 repetitionIndex         = 0;
+    
     int			linesReadOut		= pC_dimension->linesReadOut_get();
     int			linesPhaseEncode	= pC_dimension->linesPhaseEncode_get();
     int			linesSliceSelect	= pC_dimension->linesSliceSelect_get();
 
-    //cout << linesReadOut << "\t" << linesPhaseEncode << "\t" << linesSliceSelect << endl;
-    
     // Some bits masked out of evalInfoMask
-    bool                bit_online              = false;
-    bool                bit_phaseCorrection     = false;
-    bool                bit_reflect             = false;
-    const bool          bit_true                = true;
-    bool                b_canUnpack             = true;     // flag for echo- and
-
-    unsigned long       pul_evalInfoMask[2];
-
-    str_adcFileName         = str_baseFileName + ".out";
-    ifstream    istream_adcFile(str_adcFileName.c_str(), ios::in | ios::binary);
-    //ifstream    istream_adcFile(str_adcFileName.c_str(), ios::in);
-    if(!istream_adcFile) {
-	cout << "\n\tgoodbit:\t" << (istream_adcFile.rdstate() == ios::goodbit) << endl;
-	cout << "\teofbit:\t\t"  << (istream_adcFile.rdstate() == ios::eofbit)  << endl;
-	cout << "\tfailbit:\t"   << (istream_adcFile.rdstate() == ios::failbit) << endl;
-	cout << "\tbadbit:\t\t"  << (istream_adcFile.rdstate() == ios::badbit)  << endl;
-        error("Some error occurred while accessing input file: " + str_adcFileName);
-    }
-
-    // Read in the offset to the actual data
-    istream_adcFile.read((char*) &l_adcStartOffset, sizeof(int));
-    //  ... and jump to this location
-    istream_adcFile.seekg(l_adcStartOffset, ios::beg);
+    bool                bit_phaseCorrection     = as_MDH.aulEvalInfoMask[0] & MDH_PHASCOR_MASK;
+    bool                bit_reflect             = as_MDH.aulEvalInfoMask[0] & MDH_REFLECT_MASK;
 
-    // Read in first record
-    if(!istream_adcFile.read((char*) &s_MDH, sizeof(sMDH)))
-        error("Could not access first record");
-
-    long int    loopCounter     = 0;
-    long int    echoCount       = 0;
-    while(      !(s_MDH.aulEvalInfoMask[0] & MDH_ACQEND_MASK)) {
-        loopCounter++;
-        samplesInScan   = s_MDH.ushSamplesInScan;
-        indexLine       = s_MDH.sLC.ushLine;
-        if(samplesInScan <= 0)
-            error("Error in processing samplesInScan: readSamples were <= 0");
-        //cout << samplesInScan << endl;
-
-        // Read the ADC data corresponding to the current MDH structure
-	CMatrix<GSL_complex_float>	Mz_adc(1, samplesInScan);
-        float*                          pf_adc  = new float[samplesInScan*2];
-
-        istream_adcFile.read((char*) pf_adc, sizeof(float)*samplesInScan*2);
-
-        for(i=0; i<samplesInScan; i++) {
-	    GSL_complex_float	z(pf_adc[i*2], pf_adc[i*2+1]);
-	    Mz_adc(i)		= z;
-        }
-
-        if(flag3D)
-            indexSlicePartition = s_MDH.sLC.ushPartition;
-        else {
-            indexSlice2D 	= s_MDH.sLC.ushSlice;
-	    // Correct for interleaving
-	    if(indexSlice2D < (linesSliceSelect-2*zeroPad_slice) / 2)
-		indexSlicePartition	= indexSlice2D*2 + 1;
-	    else {
-            	indexSlicePartition 	= (indexSlice2D-(linesSliceSelect-2*zeroPad_slice)/2)*2;
-		}
-	}
+    if(flag3D)
+	indexSlicePartition = as_MDH.sLC.ushPartition;
+    else {
+	indexSlice2D 	= as_MDH.sLC.ushSlice;
+	// Correct for interleaving
+	if(indexSlice2D < (linesSliceSelect-2*zeroPad_slice) / 2)
+	    indexSlicePartition	= indexSlice2D*2 + 1;
+	else
+	    indexSlicePartition	= (indexSlice2D-(linesSliceSelect-2*zeroPad_slice)/2)*2;
+    }
 
-        indexRepetition         =       s_MDH.sLC.ushRepetition;
-        indexEcho               =       s_MDH.sLC.ushEcho;
-	indexChannel		= 	s_MDH.ulChannelId;
-
-	//cout << "k space index: " << indexSlicePartition << endl;
-
-        pul_evalInfoMask[0]     =       s_MDH.aulEvalInfoMask[0];
-        pul_evalInfoMask[1]     =       s_MDH.aulEvalInfoMask[1];
-        bit_online              =       pul_evalInfoMask[0] & (bit_true << 3);
-        bit_phaseCorrection     =       pul_evalInfoMask[0] & (bit_true << 21);
-        bit_reflect             =       pul_evalInfoMask[0] & (bit_true << 24);
-
-        // Now, based on the indices read from the MDH structure, find
-        //      corresponding indices in the dimension lists of the
-        //      sequences used to construct the core adc components.
-	//
-	// Since we might only be interested in a single volume (and not
-	//	everything in the meas.out), we need to map the disk
-	//	voxel indices to corresponding indices for our memory
-	//	structure.
-		
-	b_canUnpack = disk2memory_voxelMap(
+    // Now, based on the indices read from the MDH structure, find
+    //      corresponding indices in the dimension lists of the
+    //      sequences used to construct the core adc components.
+    //
+    // Since we might only be interested in a single volume (and not
+    //	everything in the meas.out), we need to map the disk
+    //	voxel indices to corresponding indices for our memory
+    //	structure.
+    if(!disk2memory_voxelMap(
 	    indexChannel,
 	    indexSlicePartition,
 	    indexRepetition,
 	    indexEcho,
-	    loopCounter,
+	    a_loopCounter,
 	    slicePartitionIndex,
 	    repetitionIndex,
-	    echoIndex
-	    );
-	            
-	if(b_canUnpack) {
-	
-	    // Record this echo-index in the pV_echoesUnpacked vector
-	    pV_echoesUnpacked->val(0, echoIndex)	= 1;
+	    echoIndex,
+	    apv_warnings
+	    ))
+	return false;
+
+    // Read the ADC data, reversing the order of the samples of reflected
+    //	lines
+    CMatrix<GSL_complex_float>	Mz_adc(1, samplesInScan);
+    float*                      pf_adc  = new float[samplesInScan*2];
+    memcpy(pf_adc, apch_adc, sizeof(float)*samplesInScan*2);
+    for(i=0; i<samplesInScan; i++) {
+	GSL_complex_float	z(pf_adc[i*2], pf_adc[i*2+1]);
+	Mz_adc(bit_reflect ? samplesInScan-i-1 : i)	= z;
+    }
+    delete  []      pf_adc;
+
+    // Record this echo-index in the pV_echoesUnpacked vector
+    aV_echoesUnpacked.val(0, echoIndex)	= 1;
 	    
-	    // Before we do anything, we need to offset volume indices for
-	    //	possible zeroPadding. This is controlled by the b_unpackWpadShift
-	    //	boolean flag. If false, the offset vector is zero; if true, the
-	    //	offset vector has been set by a prior call to dimension_zeroPad()
-	    slicePartitionIndex += zeroPad_slice;
-	    indexLine		+= zeroPad_row;
-	    // Since a phase encoded line (i.e. column dimension) is the pf_adc
-	    //	array, each element needs to be offset with zeroPad_column
-
-            if(bit_reflect) {
-                // Reverse the order of elements in pz_adc
-		//cout << "Entering bit reflect..." << endl;
-		CMatrix<GSL_complex_float>	Mz_adcCopy(1, samplesInScan);
-		Mz_adcCopy.copy(Mz_adc);
-                // Remember that Az_adcCopy has its "base" counting from 1
-                for(i=0; i<samplesInScan; i++)
-		    Mz_adc(i)		= Mz_adcCopy(samplesInScan-i-1);
-		//cout << "Leaving bit reflect..." << endl;
-            }
-	        
-            echoCount++;
-            
-	    //cout << "About to enter kSpace_unpack()" << endl;   
-	        
-            if(bit_phaseCorrection) {
-		phaseCorrect_unpack(
-		    Mz_adc,
-		    bit_reflect,
-		    s_MDH.ulTimeStamp,
-		    linesSliceSelect,	
-		    linesPhaseEncode,
-		    readOutIndex,
-		    phaseEncodeIndex,
-		    slicePartitionIndex,
-		    repetitionIndex,
-		    echoIndex
-		    );		
-            } else {
-		kSpace_unpack(
-		    Mz_adc,
-		    bit_reflect,
-		    s_MDH.ulTimeStamp,
-		    indexLine,
-		    linesReadOut,
-		    linesPhaseEncode,
-		    linesSliceSelect,	
-		    readOutIndex,
-		    phaseEncodeIndex,
-		    slicePartitionIndex,
-		    repetitionIndex,
-		    echoIndex
-		    ); 
-            }
-        }
+    // Before we do anything, we need to offset volume indices for
+    //	possible zeroPadding. This is controlled by the b_unpackWpadShift
+    //	boolean flag. If false, the offset vector is zero; if true, the
+    //	offset vector has been set by a prior call to dimension_zeroPad()
+    slicePartitionIndex += zeroPad_slice;
+    indexLine		+= zeroPad_row;
+    // Since a phase encoded line (i.e. column dimension) is the pf_adc
+    //	array, each element needs to be offset with zeroPad_column
+
+    if(bit_phaseCorrection) {
+	phaseCorrect_unpack(
+	    Mz_adc,
+	    bit_reflect,
+	    as_MDH.ulTimeStamp,
+	    linesSliceSelect,	
+	    linesPhaseEncode,
+	    readOutIndex,
+	    phaseEncodeIndex,
+	    slicePartitionIndex,
+	    repetitionIndex,
+	    echoIndex
+	    );		
+    } else {
+	kSpace_unpack(
+	    Mz_adc,
+	    bit_reflect,
+	    as_MDH.ulTimeStamp,
+	    indexLine,
+	    linesReadOut,
+	    linesPhaseEncode,
+	    linesSliceSelect,	
+	    readOutIndex,
+	    phaseEncodeIndex,
+	    slicePartitionIndex,
+	    repetitionIndex,
+	    echoIndex
+	    ); 
+    }
+    return true;
+}
+
+e_RECORDCLASS
+C_adcPack::record_classify(
+    const sMDH&		as_MDH
+) {
+    //
+    // ARGS
+    //	as_MDH			in		record header
+    //
+    // DESC
+    //	Tells the class of a record from its evalInfoMask alone.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    unsigned		mask	= as_MDH.aulEvalInfoMask[0];
+
+    if(mask & MDH_SYNCDATA_MASK)	return e_recordSyncData;
+    if(mask & MDH_NOISEADJSCAN_MASK)	return e_recordNoiseAdjust;
+    if(mask & MDH_RTFEEDBACK_MASK)	return e_recordRTFeedback;
+    if(mask & MDH_HPFEEDBACK_MASK)	return e_recordHPFeedback;
+    if(mask & MDH_PHASCOR_MASK)		return e_recordPhaseCorrect;
+    return e_recordImaging;
+}
+
+const char*
+C_adcPack::str_recordClass(
+    e_RECORDCLASS	ae_class
+) {
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    const char*		ppch_names[]	= {
+	"imaging",	"phase correction",	"RT feedback",
+	"HP feedback",	"sync data",		"noise adjust"
+    };
+    return (ae_class >= 0 && ae_class < e_recordClasses) ?
+		ppch_names[ae_class] : "unknown";
+}
+
+bool
+C_adcPack::record_accept(
+    const sMDH&		as_MDH,
+    long*		apl_count,
+    long&		a_rejected
+) const {
+    //
+    // ARGS
+    //	as_MDH			in		record header
+    //	apl_count		in/out		records by class
+    //	a_rejected		in/out		records rejected
+    //
+    // DESC
+    //	The record filter: decides from the header alone whether a
+    //	record is unpacked. Records with any of the recordReject
+    //	evalInfoMask bits set are skipped - their samples are never
+    //	read - and counted.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
 
-        delete  []      pf_adc;
-        // Read in next record
-        if(!istream_adcFile.read((char*) &s_MDH, sizeof(sMDH)))
-            error("Problems accessing record. Unexpected end of file reached.");
+    apl_count[record_classify(as_MDH)]++;
+    if(as_MDH.aulEvalInfoMask[0] & pC_dimension->recordReject_get()) {
+	a_rejected++;
+	return false;
     }
-    int allEchoesUnpacked	= pV_echoesUnpacked->innerProd();
-    if(!allEchoesUnpacked && echoTarget==-1) {
-    	string str_echoesUnpacked;
-    	warn("The raw data contains less echoes than the configuration file suggests.\n\tRecon will continue, but please verify. ");
-	str_echoesUnpacked = pV_echoesUnpacked->sprint("pV_echoesUnpacked");
-	cerr << str_echoesUnpacked << endl;
+    return true;
+}
+
+string
+C_adcPack::str_recordCounts_get() const {
+    //
+    // DESC
+    //	The record counts of the last dataFile_process(), e.g.
+    //
+    //	  imaging 8192, phase correction 64, RT feedback 128 (rejected 128)
+    //
+    //	Classes that did not occur are left out.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    stringstream	sout("");
+
+    for(int i=0; i<e_recordClasses; i++) {
+	if(!pl_recordCount[i])
+	    continue;
+	if(sout.str().length())
+	    sout << ", ";
+	sout << str_recordClass((e_RECORDCLASS) i) << " " << pl_recordCount[i];
     }
+    sout << " (rejected " << recordsRejected << ")";
+    return sout.str();
+}
+
+//
+// Parallel meas.out decoding.
+//
+// Records are variable length and only the previous header says where
+//	the next one starts, so the file is cut into byte ranges and each
+//	range's first record boundary is found again by validating the
+//	headers around a candidate offset. Since a false resync would
+//	decode garbage into k-space, nothing is decoded until every range
+//	has been walked and found to end exactly on its successor's start.
+//
+
+const size_t	MDH_DMALENGTH_MASK	= 0x01FFFFFF;	// length bits of
+							//	ulDMALength
+const int	C_ADCPACK_RESYNCCHAIN	= 4;	// records a resync must
+						//	chain through
+
+typedef enum {
+    e_parseResync,
+    e_parseWalk,
+    e_parseDecode
+} e_PARSEPHASE;
+
+//
+// The per-thread argument of the parallel parser.
+//
+typedef struct _parseJob {
+    C_adcPack*		pC_adcPack;	// object unpacking
+    e_PARSEPHASE	e_phase;	// what to do
+    size_t		begin;		// first byte (resync) / record
+    size_t		end;		// end of range / next job's begin,
+					//	or 0 if the job runs to ACQEND
+    size_t		acqEnd;		// offset of the ACQEND record
+    vector<size_t>	v_records;	// record offsets of the range
+    vector<int>		v_partition;	// and their record_partition()
+    struct _parseJob*	pjobs;		// all jobs, for the decode
+    int			jobs;		//	phase
+    int			partition;	// records decoded by this job
+    long		loopCounter;	// ordinal of the first record
+    long		echoCount;	// records unpacked
+    CMatrix<int>*	pV_echoes;	// echoes seen
+    vector<string>	v_warnings;	// of the decode, for the caller
+    long		pl_count[e_recordClasses];
+					// records walked, by class
+    long		rejected;	// records filtered out
+    bool		b_ok;		// false if the walk failed
+} s_parseJob;
+
+bool
+C_adcPack::record_plausible(
+    const char*		apch_data,
+    size_t		a_size,
+    size_t		a_offset
+) {
+    //
+    // ARGS
+    //	apch_data, a_size	in		meas.out
+    //	a_offset		in		candidate record offset
+    //
+    // DESC
+    //	A record is plausible if its header fits, it has a sane sample
+    //	count and its DMA length matches that count. An ACQEND record
+    //	only has to fit.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    sMDH		s_header;
+    size_t		length;
+
+    if(a_offset + sizeof(sMDH) > a_size)
+	return false;
+    memcpy(&s_header, apch_data + a_offset, sizeof(sMDH));
+    if(s_header.aulEvalInfoMask[0] & MDH_ACQEND_MASK)
+	return true;
+    if(!s_header.ushSamplesInScan || !s_header.ushUsedChannels)
+	return false;
+    length	= sizeof(sMDH) + sizeof(float)*2*s_header.ushSamplesInScan;
+    if((s_header.ulDMALength & MDH_DMALENGTH_MASK) != length)
+	return false;
+    return a_offset + length <= a_size;
+}
+
+size_t
+C_adcPack::record_resync(
+    const char*		apch_data,
+    size_t		a_size,
+    size_t		a_begin,
+    size_t		a_end
+) {
+    //
+    // ARGS
+    //	apch_data, a_size	in		meas.out
+    //	a_begin, a_end		in		range to search; a_begin is
+    //							on the 8 byte grid
+    //							of the records
+    //
+    // DESC
+    //	Finds the first offset in [a_begin, a_end) from which
+    //	C_ADCPACK_RESYNCCHAIN plausible records follow each other (or
+    //	which reaches ACQEND first).
+    //
+    // POSTCONDITIONS
+    //	o Returns a_size if there is none.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    sMDH		s_header;
+    size_t		offset, next;
+    int			chain;
+
+    // sMDH and the samples are multiples of 8 bytes
+    for(offset = a_begin; offset < a_end; offset += 8) {
+	next	= offset;
+	for(chain=0; chain<C_ADCPACK_RESYNCCHAIN; chain++) {
+	    if(!record_plausible(apch_data, a_size, next))
+		break;
+	    memcpy(&s_header, apch_data + next, sizeof(sMDH));
+	    if(s_header.aulEvalInfoMask[0] & MDH_ACQEND_MASK) {
+		chain	= C_ADCPACK_RESYNCCHAIN;
+		break;
+	    }
+	    next	+= sizeof(sMDH) + sizeof(float)*2*s_header.ushSamplesInScan;
+	}
+	if(chain == C_ADCPACK_RESYNCCHAIN)
+	    return offset;
+    }
+    return a_size;
+}
+
+int
+C_adcPack::record_partition(
+    const sMDH&		as_MDH,
+    int			a_partitions
+) const {
+    //
+    // ARGS
+    //	as_MDH			in		header of a record
+    //	a_partitions		in		number of partitions
+    //
+    // DESC
+    //	Assigns a record to one of <a_partitions> decode jobs, by the
+    //	indices that decide where record_unpack() puts it: channel,
+    //	slice or partition, repetition and echo. The disk to memory
+    //	mapping is one to one on these (except for the channel, which is
+    //	ignored when all channels share the k-space), so records
+    //	writing the same k-space elements always share a partition.
+    //	The line is left out on purpose, since the additional data of
+    //	all lines of a slice goes to the same element.
+    //
+    // POSTCONDITIONS
+    //	o Phase correction records all go to partition 0.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    unsigned long long	key	= 0;
+
+    if(as_MDH.aulEvalInfoMask[0] & MDH_PHASCOR_MASK)
+	return 0;
+    if(!v_channelSlot.empty())
+	key	= as_MDH.ulChannelId;
+    key	= key*65537 + (flag3D ? as_MDH.sLC.ushPartition : as_MDH.sLC.ushSlice);
+    key	= key*65537 + as_MDH.sLC.ushRepetition;
+    key	= key*65537 + as_MDH.sLC.ushEcho;
+    key	*= 0x9E3779B97F4A7C15ULL;
+    return (int) ((key >> 32) % a_partitions);
+}
+
+void*
+C_adcPack::parse_thread(
+    void*		apv_job
+) {
+    //
+    // ARGS
+    //	apv_job			in/out		s_parseJob of this thread
+    //
+    // DESC
+    //	Body of a single parser thread, for one of the three phases:
+    //
+    //	  e_parseResync:	find the first record at or after begin
+    //	  e_parseWalk:		collect the offsets of the records
+    //				from begin to end that pass the record
+    //				filter, failing unless the chain lands
+    //				exactly on end (or on ACQEND, for the
+    //				last job)
+    //	  e_parseDecode:	unpack the collected records of this
+    //				job's partition, from all ranges in
+    //				file order
+    //
+    // NOTE
+    //	o No debug_push()/error()/warn() calls are made from here, since
+    //	  those are not thread safe. Failures are flagged in the job
+    //	  instead, and warnings kept in it.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    s_parseJob*		pjob		= (s_parseJob*) apv_job;
+    C_adcPack*		pC		= pjob->pC_adcPack;
+    const char*		pch_data	= pC->pch_measOut;
+    size_t		size		= pC->measOutSize;
+    size_t		offset;
+    sMDH		s_header;
+
+    switch(pjob->e_phase) {
+	case e_parseResync:
+	    pjob->begin	= record_resync(pch_data, size, pjob->begin, pjob->end);
+	break;
+	case e_parseWalk:
+	    pjob->b_ok	= false;
+	    pjob->v_records.clear();
+	    pjob->v_partition.clear();
+	    for(int i=0; i<e_recordClasses; i++)
+		pjob->pl_count[i]	= 0;
+	    pjob->rejected	= 0;
+	    offset	= pjob->begin;
+	    while(offset + sizeof(sMDH) <= size) {
+		if(pjob->end && offset >= pjob->end) {
+		    pjob->b_ok	= (offset == pjob->end);
+		    break;
+		}
+		memcpy(&s_header, pch_data + offset, sizeof(sMDH));
+		if(s_header.aulEvalInfoMask[0] & MDH_ACQEND_MASK) {
+		    pjob->acqEnd	= offset;
+		    pjob->b_ok		= !pjob->end;
+		    break;
+		}
+		if(!s_header.ushSamplesInScan ||
+		   offset + sizeof(sMDH) +
+		   sizeof(float)*2*s_header.ushSamplesInScan > size)
+		    break;
+		if(pC->record_accept(s_header, pjob->pl_count, pjob->rejected)) {
+		    pjob->v_records.push_back(offset);
+		    pjob->v_partition.push_back(
+			pC->record_partition(s_header, pjob->jobs));
+		}
+		offset	+= sizeof(sMDH) + sizeof(float)*2*s_header.ushSamplesInScan;
+	    }
+	break;
+	case e_parseDecode:
+	    for(int j=0; j<pjob->jobs; j++) {
+		s_parseJob*	prange	= &pjob->pjobs[j];
+		for(size_t r=0; r<prange->v_records.size(); r++) {
+		    if(prange->v_partition[r] != pjob->partition)
+			continue;
+		    offset	= prange->v_records[r];
+		    memcpy(&s_header, pch_data + offset, sizeof(sMDH));
+		    if(pC->record_unpack(s_header, pch_data + offset + sizeof(sMDH),
+					 prange->loopCounter + r, *pjob->pV_echoes,
+					 &pjob->v_warnings))
+			pjob->echoCount++;
+		}
+	    }
+	break;
+    }
+    return NULL;
+}
+
+long
+C_adcPack::dataFile_parallelProcess(
+    size_t		a_start,
+    int			a_threads
+) {
+    //
+    // ARGS
+    //	a_start			in		offset of the first record
+    //	a_threads		in		number of parser threads
+    //
+    // DESC
+    //	Decodes the records of the mapped meas.out on <a_threads>
+    //	threads (see parse_thread()).
+    //
+    // POSTCONDITIONS
+    //	o Returns the number of records unpacked, or -1 (with nothing
+    //	  unpacked) if the file could not be split, in which case the
+    //	  caller decodes it sequentially.
+    //	o s_MDH holds the ACQEND record.
+    //	o The result does not depend on <a_threads>: records are decoded
+    //	  by record_partition(), so that records overwriting each other
+    //	  are decoded by the same thread in file order, and warnings are
+    //	  only printed once the threads have been joined.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("dataFile_parallelProcess(...)");
+
+    size_t		span	= (measOutSize - a_start) / a_threads;
+    int			jobs	= a_threads;
+    int			i, j;
+    long		echoCount	= 0;
+    long		loopCounter	= 1;
+
+    // Too little data to bother
+    if(span < (size_t) 1 << 20) {
+	debug_pop();
+	return -1;
+    }
+    span	-= span % 8;
+
+    s_parseJob*		pjobs		= new s_parseJob [jobs];
+    pthread_t*		pthreads	= new pthread_t [jobs];
+    bool*		pb_started	= new bool [jobs];
+
+    for(i=0; i<jobs; i++) {
+	pjobs[i].pC_adcPack	= this;
+	pjobs[i].begin		= a_start + i*span;
+	pjobs[i].end		= i<jobs-1 ? a_start + (i+1)*span : measOutSize;
+	pjobs[i].acqEnd		= 0;
+	pjobs[i].loopCounter	= 0;
+	pjobs[i].echoCount	= 0;
+	pjobs[i].pV_echoes	= NULL;
+	pjobs[i].b_ok		= true;
+	pjobs[i].pjobs		= pjobs;
+	pjobs[i].jobs		= jobs;
+	pjobs[i].partition	= i;
+    }
+
+    for(int phase=e_parseResync; phase<=e_parseDecode; phase++) {
+	for(i=0; i<jobs; i++)
+	    pjobs[i].e_phase	= (e_PARSEPHASE) phase;
+	// The first job starts on a known record
+	int	first	= (phase == e_parseResync) ? 1 : 0;
+	for(i=first; i<jobs-1; i++)
+	    pb_started[i]	= !pthread_create(&pthreads[i], NULL,
+					  C_adcPack::parse_thread, &pjobs[i]);
+	if(jobs > first)
+	    parse_thread(&pjobs[jobs-1]);
+	for(i=first; i<jobs-1; i++) {
+	    if(pb_started[i])
+		pthread_join(pthreads[i], NULL);
+	    else
+		parse_thread(&pjobs[i]);
+	}
+
+	if(phase == e_parseResync) {
+	    // Ranges without a record boundary are merged into their
+	    //	predecessor; each job then ends where the next begins.
+	    for(i=1, j=1; i<jobs; i++)
+		if(pjobs[i].begin < measOutSize && pjobs[i].begin > pjobs[j-1].begin)
+		    pjobs[j++]	= pjobs[i];
+	    jobs	= j;
+	    for(i=0; i<jobs; i++) {
+		pjobs[i].end		= i<jobs-1 ? pjobs[i+1].begin : 0;
+		pjobs[i].pjobs		= pjobs;
+		pjobs[i].jobs		= jobs;
+		pjobs[i].partition	= i;
+	    }
+	}
+	if(phase == e_parseWalk) {
+	    bool	b_ok	= true;
+	    for(i=0; i<jobs; i++) {
+		b_ok			= b_ok && pjobs[i].b_ok;
+		pjobs[i].loopCounter	= loopCounter;
+		loopCounter		+= pjobs[i].v_records.size();
+		pjobs[i].pV_echoes	= new CMatrix<int>(1, pV_echoesUnpacked->cols_get(), 0);
+	    }
+	    if(!b_ok) {
+		cerr << "\n\tCould not split the raw data at record boundaries;"
+		     << " decoding sequentially." << endl;
+		echoCount	= -1;
+		break;
+	    }
+	}
+    }
+
+    if(echoCount >= 0) {
+	for(i=0; i<jobs; i++) {
+	    for(size_t w=0; w+1<pjobs[i].v_warnings.size(); w+=2) {
+		warn(pjobs[i].v_warnings[w]);
+		cout << pjobs[i].v_warnings[w+1];
+	    }
+	    echoCount	+= pjobs[i].echoCount;
+	    for(j=0; j<e_recordClasses; j++)
+		pl_recordCount[j]	+= pjobs[i].pl_count[j];
+	    recordsRejected	+= pjobs[i].rejected;
+	    for(j=0; j<pV_echoesUnpacked->cols_get(); j++)
+		if(pjobs[i].pV_echoes->val(0, j))
+		    pV_echoesUnpacked->val(0, j)	= 1;
+	}
+	memcpy(&s_MDH, pch_measOut + pjobs[jobs-1].acqEnd, sizeof(sMDH));
+    }
+
+    for(i=0; i<jobs; i++)
+	delete pjobs[i].pV_echoes;
+    delete [] pjobs;
+    delete [] pthreads;
+    delete [] pb_started;
+
     debug_pop();
     return echoCount;
 }
@@ -2035,6 +3168,32 @@ C_adcPack::dataMemory_volumeSave(
     pCadc_kSpace->save(astr_fileName);
 }
 
+bool
+C_adcPack::dataMemory_volumeFrameSave(
+        string          astr_fileName,
+        e_IOTYPE        e_iotype,
+	int		a_frame,
+	int		a_frames) {
+    //
+    // ARGS
+    //	astr_fileName	in		multi-frame file to write to
+    //  e_iotype        in              type of save operation to perform
+    //	a_frame		in		frame index of the current volume
+    //	a_frames	in		total frames in the file
+    //
+    // DESC
+    //  Front end to saving the current kSpace volume as a single frame
+    //	of a multi-frame output file.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    pCadc_kSpace->e_iotype_set(e_iotype);
+    return pCadc_kSpace->frameSave(astr_fileName, a_frame, a_frames);
+}
+
 bool
 C_adcPack::dataMemory_volumeSave(
     string	        astr_fileName
@@ -2075,6 +3234,118 @@ C_adcPack::dataMemory_volumeLoad(
     return true;
 }
 
+bool
+C_adcPack::dataMemory_volumeLoad(
+        string          astr_fileName,
+        e_IOTYPE        e_iotype) {
+    //
+    // ARGS
+    //	astr_fileName	in		file to process
+    //  e_iotype        in              component held by the file
+    //
+    // DESC
+    //  The load counterpart of dataMemory_volumeSave(): reads a previously
+    //	saved output (in the format of the C_IO object of this pack) back
+    //	into the extracted kSpace volume, so that post-processing can run
+    //	on earlier outputs without reconstructing again.
+    //
+    // PRECONDITIONS
+    //  o The kSpace volume must be extracted/constructed with the
+    //	  dimensions of the saved volume.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    pCadc_kSpace->e_iotype_set(e_iotype);
+    return pCadc_kSpace->load(astr_fileName);
+}
+
+bool
+C_adcPack::dataMemory_volumeFrameLoad(
+        string          astr_fileName,
+        e_IOTYPE        e_iotype,
+	int		a_frame) {
+    //
+    // ARGS
+    //	astr_fileName	in		multi-frame file to read from
+    //  e_iotype        in              component held by the file
+    //	a_frame		in		frame to load
+    //
+    // DESC
+    //  Front end to loading a single frame of a multi-frame output file
+    //	into the current kSpace volume.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    pCadc_kSpace->e_iotype_set(e_iotype);
+    return pCadc_kSpace->frameLoad(astr_fileName, a_frame);
+}
+
+bool
+C_adcPack::dataMemory_volumeSave(
+	C_container&	ac_container,
+	int		a_channel,
+	int		a_echo,
+	int		a_repetition) {
+    //
+    // ARGS
+    //	ac_container	in		container open for writing
+    //	a_channel	in		channel of the current volume
+    //	a_echo		in		echo of the current volume
+    //	a_repetition	in		repetition of the current volume
+    //
+    // DESC
+    //  Appends the extracted kSpace volume to a preprocess container.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    return ac_container.volume_write(	a_channel, a_echo, a_repetition,
+					pCadc_kSpace->volume_get());
+}
+
+bool
+C_adcPack::dataMemory_volumeLoad(
+	C_container&	ac_container,
+	int		a_channel,
+	int		a_echo,
+	int		a_repetition) {
+    //
+    // ARGS
+    //	ac_container	in		container open for reading
+    //	a_channel	in		channel of the volume to load
+    //	a_echo		in		echo of the volume to load
+    //	a_repetition	in		repetition of the volume to load
+    //
+    // DESC
+    //  Replaces the extracted kSpace volume with a volume from a
+    //	preprocess container.
+    //
+    // PRECONDITIONS
+    //	o The kSpace volume must have been constructed, typically with
+    //	  dataMemory_volumeConstruct().
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    CVol<GSL_complex_float>*	pVl	= ac_container.volume_read(
+						a_channel, a_echo, a_repetition);
+    if(!pVl)
+	return false;
+    pCadc_kSpace->volume_destruct();
+    pCadc_kSpace->volume_set(pVl);
+    return true;
+}
+
 bool
 C_adcPack::dataMemory_volumeSaveReal(
     string	        astr_fileName
@@ -2153,11 +3424,9 @@ C_adcPack_mgh::C_adcPack_mgh(
 	const string            astr_baseFileName,
 	C_dimensionLists*       apC_dimension,
         const bool              a_isData3D,
-	int                     a_echoTarget,
-	int                     a_repetitionTarget,
-	int                     a_channelTarget) :
+	const s_unpackTargets&	as_targets) :
     C_adcPack(astr_baseFileName, apC_dimension, a_isData3D, 
-	      a_echoTarget, a_repetitionTarget, a_channelTarget)
+	      as_targets)
 {
     //
     // ARGS
@@ -2193,38 +3462,27 @@ C_adcPack_mgh::C_adcPack_mgh(
     // 07 October 2003
     //	o Initial design and coding.
     //
+    // 19 October 2026
+    //	o Matrices come from the shared C_options object.
+    //
     
         
     debug_push("C_adcPack_mgh(...)");
 
-    CMatrix<double>*			pM_vox2ras;
-    CMatrix<double>*			pV_MRIParams;
-    
-    string  str_vox2rasFileName         = "";
-    string  str_ADCbaseDirectory        = "";
-    string  str_mriParamsFileName       = "";
-    string  str_optionsFileName	        = apC_dimension->str_optionsFileName_get();
-    
-    C_scanopt                   cso_optionsFile(    str_optionsFileName, e_EquLink);
-    string                      str_value;
-
-    // Parse the optionsFile for MGH_vox2ras
-    if(cso_optionsFile.scanFor("ADCbaseDirectory",      &str_value))
-        str_ADCbaseDirectory        = str_value;
-    if(cso_optionsFile.scanFor("MGH_vox2ras",    &str_value)) {
-        str_vox2rasFileName        = str_value;
-	pM_vox2ras	= new CMatrix<double>((char*)	
-	                 (str_ADCbaseDirectory+"/"+str_vox2rasFileName).c_str());
-    } else 
+    const C_options*			pC_options  = apC_dimension->pC_options_get();
+
+    if(!pC_options)
+	error("No options have been set in the dimension lists.");
+
+    // The vox2ras and MRI parameter files have already been read
+    if(!pC_options->pMv_get("MGH_vox2ras"))
 	error("Could not find MGH_vox2ras variable in options file.");
-    
-    // Parse the optionsFile for MGH_MRIParameters
-    if(cso_optionsFile.scanFor("MGH_MRIParameters",    &str_value)) {
-        str_mriParamsFileName       = str_value;
-	pV_MRIParams	= new CMatrix<double>((char*)	
-	                 (str_ADCbaseDirectory+"/"+str_mriParamsFileName).c_str());
-    } else 
+    if(!pC_options->pMv_get("MGH_MRIParameters"))
 	error("Could not find MGH_MRIParameters variable in options file.");
+    CMatrix<double>			M_vox2ras(*pC_options->pMv_get("MGH_vox2ras"));
+    CMatrix<double>			V_MRIParams(*pC_options->pMv_get("MGH_MRIParameters"));
+    CMatrix<double>*			pM_vox2ras	= &M_vox2ras;
+    CMatrix<double>*			pV_MRIParams	= &V_MRIParams;
     
     CMatrix<int>		M_dimensionStructure(1, 5);
     CMatrix<int>                M_unity(1, 5, 1);
@@ -2286,11 +3544,9 @@ C_adcPack_analyze75::C_adcPack_analyze75(
 	const string            astr_baseFileName,
 	C_dimensionLists*       apC_dimension,
         const bool              a_isData3D,
-	int                     a_echoTarget,
-	int                     a_repetitionTarget,
-	int                     a_channelTarget) :
+	const s_unpackTargets&	as_targets) :
     C_adcPack(astr_baseFileName, apC_dimension, a_isData3D, 
-	      a_echoTarget, a_repetitionTarget, a_channelTarget)
+	      as_targets)
 {
     //
     // ARGS
@@ -2327,48 +3583,36 @@ C_adcPack_analyze75::C_adcPack_analyze75(
     // 24 October 2003
     //	o Added intensity scale factor to core class definition.
     //
+    // 19 October 2026
+    //	o Matrices and values come from the shared C_options object.
+    //
     
         
     debug_push("C_adcPack_analyze75(...)");
 
-    CMatrix<double>*			pV_voxelDimensions;
-    short				s_orientation           = 0;;
-    double				v_intensityScale	= 1e12;
-    bool				b_readOutFlip		= false;
-    
-    string  str_voxelDimensionFileName  = "";
-    string  str_ADCbaseDirectory        = "";
-    string  str_optionsFileName	        = apC_dimension->str_optionsFileName_get();
-    
-    C_scanopt                   cso_optionsFile(    str_optionsFileName, e_EquLink);
-    string                      str_value;
-
-    // Parse the optionsFile for A75_voxelDimensions
-    if(cso_optionsFile.scanFor("ADCbaseDirectory",      &str_value))
-        str_ADCbaseDirectory        = str_value;
-    if(cso_optionsFile.scanFor("A75_voxelDimensions",    &str_value)) {
-        str_voxelDimensionFileName  = str_value;
-	pV_voxelDimensions	    = new CMatrix<double>((char*)	
-	                 (str_ADCbaseDirectory+"/"+str_voxelDimensionFileName).c_str());
-    } else 
+    const C_options*			pC_options  = apC_dimension->pC_options_get();
+
+    if(!pC_options)
+	error("No options have been set in the dimension lists.");
+
+    if(!pC_options->pMv_get("A75_voxelDimensions"))
 	error("Could not find A75_voxelDImensions variable in options file.");
-    
-    // Parse the optionsFile for orientation
-    if(cso_optionsFile.scanFor("orientation",    &str_value)) {
-	s_orientation		    = atoi(str_value.c_str());
-    } else 
+    CMatrix<double>			V_voxelDimensions(
+					    *pC_options->pMv_get("A75_voxelDimensions"));
+    CMatrix<double>*			pV_voxelDimensions	= &V_voxelDimensions;
+
+    if(!pC_options->b_has("orientation"))
 	error("Could not find orientation variable in options file.");
+    short				s_orientation		=
+					    pC_options->i_get("orientation");
     
-    // Parse the optionsFile for intensityScale
-    if(cso_optionsFile.scanFor("intensityScale",    &str_value)) {
-	v_intensityScale	    = atof(str_value.c_str());
-    } else 
+    if(!pC_options->b_has("intensityScale"))
 	error("Could not find intensityScale variable in options file.");
+    double				v_intensityScale	=
+					    pC_options->v_get("intensityScale");
 
-    // Parse the optionsFile for readOutFlip
-    if(cso_optionsFile.scanFor("readOutFlip",    &str_value)) {
-	b_readOutFlip	= atoi(str_value.c_str());
-    }     
+    bool				b_readOutFlip		=
+					    pC_options->i_get("readOutFlip");
     
     CMatrix<int>		M_dimensionStructure(1, 5);
     CMatrix<int>                M_unity(1, 5, 1);
@@ -2427,3 +3671,129 @@ C_adcPack_analyze75::~C_adcPack_analyze75() {
     
     
 }
+
+//
+//\\\***
+// C_adcPack_nifti definitions ****>>>>
+/////***
+//
+
+//
+// constructor / destructor block
+//
+C_adcPack_nifti::C_adcPack_nifti(
+	const string            astr_baseFileName,
+	C_dimensionLists*       apC_dimension,
+        const bool              a_isData3D,
+	const s_unpackTargets&	as_targets) :
+    C_adcPack(astr_baseFileName, apC_dimension, a_isData3D,
+	      as_targets)
+{
+    //
+    // ARGS
+    //  astr_baseFilename               in              path and base name of
+    //                                                          raw data
+    //  apC_dimension                   in              an amalgamated class
+    //                                                          describing the
+    //                                                          dimensions of
+    //                                                          the scan
+    //                                                          space
+    //  a_isData3D                      in              is this a 3D scan?
+    //
+    // DESC
+    //  C_adcPack_nifti constructor.
+    //
+    // 	Falls through to the base class constructor, with the additional
+    //	sub class parsing of the meta options file for the vox2ras and
+    //	MRIParams data.
+    //
+    // PRECONDITIONS
+    // o The options file contains the name of the vox2ras file under
+    //	 "NIFTI_vox2ras". If absent, the "MGH_vox2ras" spec is used, since
+    //	 both formats share the same voxel ordering. Likewise for
+    //	 "NIFTI_MRIParameters" / "MGH_MRIParameters".
+    //
+    // POSTCONDITIONS
+    // o Note that this method will create an underlying IO class.
+    // o If no vox2ras or MRI parameters are found, construction aborts
+    //	 with an error.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Matrices come from the shared C_options object.
+    //
+
+    debug_push("C_adcPack_nifti(...)");
+
+    const C_options*			pC_options  = apC_dimension->pC_options_get();
+    const CMatrix<double>*		pM_vox2rasFile;
+    const CMatrix<double>*		pV_MRIParamsFile;
+
+    if(!pC_options)
+	error("No options have been set in the dimension lists.");
+
+    pM_vox2rasFile	= pC_options->b_has("NIFTI_vox2ras") ?
+			  pC_options->pMv_get("NIFTI_vox2ras") :
+			  pC_options->pMv_get("MGH_vox2ras");
+    if(!pM_vox2rasFile)
+	error("Could not find NIFTI_vox2ras (or MGH_vox2ras) variable in options file.");
+
+    pV_MRIParamsFile	= pC_options->b_has("NIFTI_MRIParameters") ?
+			  pC_options->pMv_get("NIFTI_MRIParameters") :
+			  pC_options->pMv_get("MGH_MRIParameters");
+    if(!pV_MRIParamsFile)
+	error("Could not find NIFTI_MRIParameters (or MGH_MRIParameters) variable in options file.");
+
+    CMatrix<double>*			pM_vox2ras	= new CMatrix<double>(*pM_vox2rasFile);
+    CMatrix<double>*			pV_MRIParams	= new CMatrix<double>(*pV_MRIParamsFile);
+
+    CMatrix<int>		M_dimensionStructure(1, 5);
+    CMatrix<int>                M_unity(1, 5, 1);
+
+    //
+    // Create the actual data holding objects (nifti specialisation)
+    //
+
+    M_dimensionStructure	= *(pC_dimension->pV_dimensionStructure_get());
+    int linesPhaseCorrect       = pC_dimension->linesPhaseCorrect_get();
+    pCadc_kSpace                = new C_adc_nifti(this,
+	                                        M_dimensionStructure,
+						*pM_vox2ras,
+						*pV_MRIParams);
+    if(b_phaseCorrect_get()) {
+	if(linesPhaseCorrect>0) {
+	    M_dimensionStructure(0, e_readOut)      = linesPhaseCorrect;
+	    pCadc_phaseCorrected    = new C_adc_nifti(this,
+	                                        M_dimensionStructure,
+						*pM_vox2ras,
+						*pV_MRIParams);
+	} else {
+	    pCadc_phaseCorrected    = new C_adc_nifti(this,
+	                                        M_unity,
+						*pM_vox2ras,
+						*pV_MRIParams);
+	}
+    }
+    // Synchronise any relevant variables with the IO object
+    pCadc_kSpace->pCIO_get()->envSynchronise(this);
+
+    delete	pM_vox2ras;
+    delete	pV_MRIParams;
+
+    debug_pop();
+
+}
+
+C_adcPack_nifti::~C_adcPack_nifti() {
+    //
+    // Destructor
+    //
+    //	Basically falls through to the base class destructor.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+}
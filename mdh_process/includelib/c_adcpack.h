@@ -15,6 +15,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include <complex>
 using namespace std;
 
@@ -33,6 +34,8 @@ using namespace ltl;
 
 #include "c_adc.h"
 #include "c_io.h"
+#include "c_container.h"
+#include "c_options.h"
 
 namespace mdh {
         
@@ -44,6 +47,58 @@ const int       C_dimensionLists_STACKDEPTH     = 64;       //  for debugging
         e_phaseCorrectedKSpace
     } e_KSPACEDATATYPE;
 
+    // Classes of raw data records, as told by their evalInfoMask (in
+    //	order of precedence)
+    typedef enum {
+	e_recordImaging,		// k-space lines
+	e_recordPhaseCorrect,		// phase correction lines
+	e_recordRTFeedback,		// real time feedback (navigators)
+	e_recordHPFeedback,		// high performance feedback
+	e_recordSyncData,		// PMU / sync data
+	e_recordNoiseAdjust,		// noise adjust scans
+	e_recordClasses
+    } e_RECORDCLASS;
+
+
+    // Extents of a meas.out, as found by a header-only pre-scan
+    //	(see C_adcPack::measOut_prescan()). The counts are the
+    //	largest index seen + 1.
+    typedef struct _measOutExtent {
+	long		records;		// imaging records
+	long		phaseCorrectRecords;	// phase correction records
+	long		otherRecords;		// feedback, sync, noise adjust
+	int		samplesInScan;		// largest samples per line
+	int		lines;
+	int		partitions;
+	int		slices;
+	int		echoes;
+	int		repetitions;
+	int		channels;
+	bool		b_complete;		// ACQEND record was reached
+    } s_measOutExtent;
+
+    // Memory needed to reconstruct a channel, as estimated from its
+    //	dimension lists (see C_adcPack::footprint_estimate()). A unit is
+    //	one (repetition, echo) volume.
+    typedef struct _memoryFootprint {
+	int		units;			// (repetition, echo) volumes
+	double		kSpaceUnit;		// unpacked k-space per unit,
+						//	phase correction included
+	double		workingUnit;		// recon scratch per unit in
+						//	flight
+	double		workingUnitInPlace;	// the same with shiftInPlace
+	double		imageUnit;		// a reconstructed (zero
+						//	padded) volume
+    } s_memoryFootprint;
+
+    // The channels, echoes and repetitions to unpack, as raw data (sMDH)
+    //	indices, e.g. from --echoTarget=0,3,7. An empty list selects every
+    //	index of its dimension.
+    typedef struct _unpackTargets {
+	vector<int>	v_channels;
+	vector<int>	v_echoes;
+	vector<int>	v_repetitions;
+    } s_unpackTargets;
 
 // Some forward declarations
 //class C_dimensioLists;
@@ -116,7 +171,8 @@ class C_dimensionLists {
         string          str_ADCfileBaseName;    // Base fully qualified name for
                                                 //      Siemens raw data, i.e.
 	                                        //      "/some/path/meas"
-	string		str_optionsFileName;	// The options file itself
+	const C_options*	pC_options;	// The parsed options file itself
+						//	(not owned)
 	e_BYTEORDER     e_byteOrder;            // byte order for binary save data.
                                                 //  On x86:                 little endian
                                                 //  everything else:        big endian
@@ -160,6 +216,16 @@ class C_dimensionLists {
 	                                        //	containing phase corrected
 	                                        //	information (not implemented in
 	                                        //	recon yet: 2/25/04).
+	int		IOthreads;		// Number of threads used by the
+	                                        //	C_IO slab writer. If 0, one
+	                                        //	thread per online CPU.
+	unsigned	recordReject;		// evalInfoMask[0] bits of records
+	                                        //	that are skipped unread
+	                                        //	(default 0: none)
+	int		parseThreads;		// Number of threads that decode
+	                                        //	meas.out. If 1 (default),
+	                                        //	sequential; if 0, one per
+	                                        //	online CPU.
 	
 
     public:
@@ -172,7 +238,7 @@ class C_dimensionLists {
                         int                     a_linesPhaseEncode,
                         int                     a_linesPhaseCorrect);
 
-        C_dimensionLists(           string      astr_optionsFileName);
+        C_dimensionLists(           const C_options*    apC_options);
 
         void    core_construct(     string  astr_name               = "unnamed",
                                     int     a_id                    = -1,
@@ -247,11 +313,17 @@ class C_dimensionLists {
             { str_ADCfileBaseName = astr_name;};
         string  str_ADCfileBaseName_get()
             const {return   str_ADCfileBaseName;};
-
-        void    str_optionsFileName_set(    string  astr_name)
-            { str_optionsFileName = astr_name;};
+	// The raw data base name an options file gives (what the
+	//	file-based constructor sets), for callers that need the
+	//	raw data without the dimension lists
+	static string str_ADCfileBaseName_resolve( const C_options& ac_options);
+
+        void    pC_options_set(             const C_options*    apC)
+            { pC_options = apC;};
+        const C_options*    pC_options_get()
+            const {return   pC_options;};
         string  str_optionsFileName_get()
-            const {return   str_optionsFileName;};
+            const {return   pC_options ? pC_options->str_fileName_get() : "";};
 	
 	int     repetitionIndex_find(   int     a_index);
         int     sliceSelectIndex_find(  int     a_index);
@@ -278,8 +350,18 @@ class C_dimensionLists {
 	                    const {return b_phaseCorrect;};
 	bool		b_shiftInPlace_get()
 	                    const {return b_shiftInPlace;};
+	void		b_shiftInPlace_set(bool ab_shiftInPlace)
+	                    { b_shiftInPlace = ab_shiftInPlace;};
+	int		IOthreads_get()
+	                    const {return IOthreads;};
+	int		parseThreads_get()
+	                    const {return parseThreads;};
+	unsigned	recordReject_get()
+	                    const {return recordReject;};
 	
 	void		metaData_parse();
+	bool		extent_apply(	const s_measOutExtent&	as_extent,
+					bool			ab_3D);
 
 };
 
@@ -309,6 +391,9 @@ class C_adcPack {
         string                          str_baseFileName;       // base file
         string                          str_ascFileName;        // the ascii header
         string                          str_adcFileName;        // the binary data
+	char*				pch_measOut;		// read-only mapping of
+	size_t				measOutSize;		//	str_adcFileName, or
+								//	NULL
 
         // some meta data
         bool                            flag3D;                 // is this a 3D scan?
@@ -321,6 +406,12 @@ class C_adcPack {
 
         // Siemens data structures
         sMDH                            s_MDH;
+	long				pl_recordCount[e_recordClasses];
+								// records seen, by
+								//	class (accepted or
+								//	not)
+	long				recordsRejected;	// records skipped by the
+								//	recordReject filter
 
         // Scanner raw data classes and support structures
         C_dimensionLists*               pC_dimension;           // lists and dimensions
@@ -343,11 +434,19 @@ class C_adcPack {
         C_adc*                          pCadc_phaseCorrected;   // Phase corrected data
 	
 	// The following variables are used to specify if *all* channels/echoes/repetitions
-	//	have been unpacked (all are -1) or if a specific channel/echo/repetition
-	//	combination has been filtered out
-	int				channelTarget;
-	int				echoTarget;
-	int				repetitionTarget;
+	//	have been unpacked (empty lists) or if a set of channel/echo/repetition
+	//	targets has been filtered out
+	s_unpackTargets			s_targets;
+	// ... compiled into slot tables: for each raw data index, its index
+	//	in memory, or -1 if it is not unpacked. The channels of a pass
+	//	share the echo dimension of the k-space, in blocks of
+	//	echoSlots.
+	vector<int>			v_channelSlot;
+	vector<int>			v_echoSlot;
+	vector<int>			v_repetitionSlot;
+	vector<int>			v_sliceSlot;
+	int				channelSlots;
+	int				echoSlots;
 	
         // methods
 
@@ -359,9 +458,7 @@ class C_adcPack {
         C_adcPack(      const string            astr_baseFileName,
                         C_dimensionLists*       apC_dimension,
                         const bool              isData3D,
-			int                     a_echoTarget        = -1,
-			int                     a_repetitionTarget  = -1,
-			int			a_channelTarget	    = -1
+			const s_unpackTargets&	as_targets	    = s_unpackTargets()
 			);
                 // constructor reading options from file
 
@@ -372,7 +469,7 @@ class C_adcPack {
                                     int     a_warnings              = 0,
                                     int     a_stackDepth            = 0,
                                     string  astr_proc               = "noproc");
-        ~C_adcPack();
+        virtual ~C_adcPack();
 
         //
         // error / warn / print block
@@ -417,14 +514,17 @@ class C_adcPack {
                         { str_proc[depth] = astr;};
 	
 	void	channelTarget_set(	int	val)
-	                { channelTarget = val;};
+	                { channelTargets_set(vector<int>(1, val));};
+	void	channelTargets_set(	const vector<int>&	av_channels);
 	
-	int	channelTarget_get() 	const
-	                { return channelTarget;};
-	int	echoTarget_get() 	const
-	                { return echoTarget;};
-	int	repetitionTarget_get() 	const
-	                { return repetitionTarget;};
+	const s_unpackTargets&	targets_get()	const
+	                { return s_targets;};
+	int	channelSlots_get()	const
+	                { return channelSlots;};
+	// Index along the k-space echo dimension of an echo of a channel
+	int	kSpaceEcho_get(		int	a_channelSlot,
+					int	a_echoIndex)	const
+	                { return a_channelSlot*echoSlots + a_echoIndex;};
 	
 	bool	flag3D_get()		        const
                    	{ return flag3D;};
@@ -441,6 +541,11 @@ class C_adcPack {
 
         sMDH*                   ps_MDH_get()
 	          {return &s_MDH;};
+	long			recordCount_get(e_RECORDCLASS ae_class)
+	    const {return pl_recordCount[ae_class];};
+	long			recordsRejected_get()
+	    const {return recordsRejected;};
+	string			str_recordCounts_get() const;
         C_adc*                  pCadc_kSpace_get()              
 	    const {return pCadc_kSpace;};
 	C_adc*                  pCadc_phaseCorrected_get()      
@@ -453,8 +558,53 @@ class C_adcPack {
         //
         // Scanner data processing
         //
+        bool    measOut_map();
+        void    measOut_unmap();
+        static bool measOut_prescan(    const string&           astr_measOut,
+                                        s_measOutExtent&        as_extent);
+        static void footprint_estimate( const C_dimensionLists* apC_dimension,
+                                        s_memoryFootprint&      as_footprint);
+        static bool targetList_parse(   const string&           astr_list,
+                                        vector<int>&            av_targets);
+        static string str_targetList(   const vector<int>&      av_targets);
+        static void targets_resolve(    const vector<int>&      av_targets,
+                                        int                     a_count,
+                                        const CMatrix<int>*     apM_list,
+                                        vector<int>&            av_IO,
+                                        vector<int>&            av_raw);
+        static void slots_build(        const CMatrix<int>&     aM_list,
+                                        vector<int>&            av_slot);
+        static int  slot_find(          const vector<int>&      av_slot,
+                                        int                     a_index)
+                        { return a_index >= 0 && a_index < (int) av_slot.size() ?
+                                 av_slot[a_index] : -1;};
+        static e_RECORDCLASS record_classify(   const sMDH&     as_MDH);
+        static const char* str_recordClass( e_RECORDCLASS       ae_class);
+        bool    record_accept(          const sMDH&             as_MDH,
+                                        long*                   apl_count,
+                                        long&                   a_rejected)
+                                        const;
+        static bool record_plausible(   const char*             apch_data,
+                                        size_t                  a_size,
+                                        size_t                  a_offset);
+        static size_t record_resync(    const char*             apch_data,
+                                        size_t                  a_size,
+                                        size_t                  a_begin,
+                                        size_t                  a_end);
+        int     record_partition(       const sMDH&             as_MDH,
+                                        int                     a_partitions)
+                                        const;
+        static void* parse_thread(      void*                   apv_job);
         void    headerFile_process(     bool    b_headerDump = false);
         int     dataFile_process();
+        long    dataFile_parallelProcess(       size_t          a_start,
+                                                int             a_threads);
+        bool    record_unpack(
+            const sMDH&                         as_MDH,
+            const char*                         apch_adc,
+            long                                a_loopCounter,
+            CMatrix<int>&                       aV_echoesUnpacked,
+            vector<string>*                     apv_warnings = NULL);
 	bool    disk2memory_voxelMap(
 	    int			                indexChannel,
 	    int			                indexSlicePartition,
@@ -463,8 +613,13 @@ class C_adcPack {
 	    int		                        loopCounter,
 	    int&		                slicePartitionIndex,
 	    int&		                repetitionIndex,
-	    int&		                echoIndex
+	    int&		                echoIndex,
+	    vector<string>*		        apv_warnings = NULL
 	    );	
+	void    voxelMap_warn(
+	    const string&			astr_msg,
+	    const string&			astr_details,
+	    vector<string>*			apv_warnings);
 	int     phaseCorrect_unpack(
 	    CMatrix<GSL_complex_float>&		Mz_adc,
 	    bool				b_reflect,
@@ -551,7 +706,24 @@ class C_adcPack {
         bool    dataMemory_volumeSave(          string          astr_fileName,
                                                 e_IOTYPE        e_iotype);
 	bool    dataMemory_volumeSave(          string          astr_fileName);
+	bool    dataMemory_volumeFrameSave(     string          astr_fileName,
+                                                e_IOTYPE        e_iotype,
+						int		a_frame,
+						int		a_frames);
 	bool    dataMemory_volumeLoad(          string          astr_fileName);
+	bool    dataMemory_volumeLoad(          string          astr_fileName,
+                                                e_IOTYPE        e_iotype);
+	bool    dataMemory_volumeFrameLoad(     string          astr_fileName,
+                                                e_IOTYPE        e_iotype,
+						int		a_frame);
+	bool    dataMemory_volumeSave(          C_container&    ac_container,
+						int		a_channel,
+						int		a_echo,
+						int		a_repetition);
+	bool    dataMemory_volumeLoad(          C_container&    ac_container,
+						int		a_channel,
+						int		a_echo,
+						int		a_repetition);
 	bool    dataMemory_volumeSaveReal(      string          astr_fileName);
 	bool    dataMemory_volumeSaveImag(      string          astr_fileName);
 	bool    dataMemory_volumeSaveNorm(      string          astr_fileName);
@@ -577,9 +749,7 @@ class C_adcPack_mgh : public C_adcPack {
 	const string            astr_baseFileName,
 	C_dimensionLists*       apC_dimension,
 	const bool              isData3D,
-	int                     a_echoTarget            = -1,
-	int                     a_repetitionTarget      = -1,
-        int			a_channelTarget	        = -1
+	const s_unpackTargets&	as_targets		= s_unpackTargets()
 	);		
  
     ~C_adcPack_mgh();
@@ -608,9 +778,7 @@ class C_adcPack_analyze75 : public C_adcPack {
 	const string            astr_baseFileName,
 	C_dimensionLists*       apC_dimension,
 	const bool              isData3D,
-	int                     a_echoTarget            = -1,
-	int                     a_repetitionTarget      = -1,
-	int			a_channelTarget         = -1
+	const s_unpackTargets&	as_targets		= s_unpackTargets()
 	);
  
     ~C_adcPack_analyze75();
@@ -620,6 +788,35 @@ class C_adcPack_analyze75 : public C_adcPack {
     //	
 };
 
+class C_adcPack_nifti : public C_adcPack {
+
+    //
+    // This class really only implements a "thin interface" allowing the
+    //	end user to control the C_IO_nifti object. It keeps no state
+    //	information.
+    //
+
+    protected:
+
+    public:
+
+    //
+    // constructor / destructor block
+    //
+    C_adcPack_nifti(
+	const string            astr_baseFileName,
+	C_dimensionLists*       apC_dimension,
+	const bool              isData3D,
+	const s_unpackTargets&	as_targets		= s_unpackTargets()
+	);
+
+    ~C_adcPack_nifti();
+
+    //
+    // Misc access block
+    //
+};
+
 } // namespace
 
 #endif //__ADCPACK_H__
@@ -0,0 +1,571 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+using namespace std;
+
+#include "c_ascconv.h"
+using namespace mdh;
+
+//
+//\\\***
+// C_ascconv definitions ****>>>>
+/////***
+//
+
+void
+C_ascconv::debug_push(
+        string                          astr_currentProc) {
+    //
+    // ARGS
+    //  astr_currentProc        in      method name to
+    //                                          "push" on the "stack"
+    //
+    // DESC
+    //  This attempts to keep a simple record of methods that
+    //  are called. Note that this "stack" is severely crippled in
+    //  that it has no "memory" - names pushed on overwrite those
+    //  currently there.
+    //
+
+    if(stackDepth_get() >= C_ASCCONV_STACKDEPTH-1)
+        error(  "Out of str_proc stack depth");
+    stackDepth_set(stackDepth_get()+1);
+    str_proc_set(stackDepth_get(), astr_currentProc);
+}
+
+void
+C_ascconv::debug_pop() {
+    //
+    // DESC
+    //  "pop" the stack. Since the previous name has been
+    //  overwritten, there is no restoration, per se. The
+    //  only important parameter really is the stackDepth.
+    //
+
+    stackDepth_set(stackDepth_get()-1);
+}
+
+void
+C_ascconv::error(
+        string          astr_msg        /*= "Some error has occured"    */,
+        int             code            /*= -1                          */)
+{
+    //
+    // ARGS
+    //  atr_msg                 in              message to dump to stderr
+    //  code                    in              error code
+    //
+    // DESC
+    //  Print error related information. This routine throws an exception
+    //  to the class itself, allowing for coarse grained, but simple
+    //  error flagging.
+    //
+
+    cerr << "\nFatal error encountered.\n";
+    cerr << "\tC_ascconv object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "\n";
+    cerr << "Throwing an exception to (this) with code " << code << "\n\n";
+    throw(this);
+}
+
+void
+C_ascconv::warn(
+        string          astr_msg,
+	int             code            /*= -1                  */
+) {
+    //
+    // ARGS
+    //  atr_msg          in              message to dump to stderr
+    //  code             in              error code
+    //
+    // DESC
+    //  Print error related information. Conceptually identical to
+    //  the `error' method, but no expection is thrown.
+    //
+
+    cerr << "\nWarning.\n";
+    cerr << "\tC_ascconv object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "(code: " << code << ")\n";
+}
+
+void
+C_ascconv::core_construct(
+        string          astr_name       /*= "unnamed"           */,
+        int             a_id            /*= -1                  */,
+        int             a_iter          /*= 0                   */,
+        int             a_verbosity     /*= 0                   */,
+        int             a_warnings      /*= 0                   */,
+        int             a_stackDepth    /*= 0                   */,
+        string          astr_proc       /*= "noproc"            */
+) {
+    //
+    // ARGS
+    //  astr_name        in              name of object
+    //  a_id             in              id of object
+    //  a_iter           in              current iteration in arbitrary scheme
+    //  a_verbosity      in              verbosity of object
+    //  a_stackDepth     in              stackDepth
+    //  astr_proc        in              current that has been "debug_push"ed
+    //
+    // DESC
+    //  Simply fill in the core values of the object with some defaults
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding
+    //
+
+    str_name                    = astr_name;
+    id                          = a_id;
+    iter                        = a_iter;
+    verbosity                   = a_verbosity;
+    warnings                    = a_warnings;
+    stackDepth                  = a_stackDepth;
+    str_proc[stackDepth]        = astr_proc;
+
+    b_read			= false;
+
+    str_obj                     = "C_ascconv";
+}
+
+C_ascconv::C_ascconv(
+    string		astr_fileName
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		meas.asc protocol file
+    //
+    // DESC
+    //	Reads the protocol file in one go, and tokenizes and indexes it.
+    //
+    // POSTCONDITIONS
+    //	o If the file cannot be read, a warning is shown, b_read_get() is
+    //	  false and all lookups fail - as with a C_scanopt around a
+    //	  missing file.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o A *.out file name selects the meas.out preamble.
+    //
+
+    core_construct();
+    debug_push("C_ascconv");
+
+    str_fileName	= astr_fileName;
+
+    bool		b_measOut	= str_fileName.length() > 4 &&
+			str_fileName.compare(str_fileName.length()-4, 4, ".out") == 0;
+    ifstream		ifs_protocol(str_fileName.c_str(), ios::in | ios::binary);
+    if(!ifs_protocol)
+	warn("Could not open protocol file " + str_fileName, 1);
+    else if(b_measOut) {
+	// Only the preamble is read, not the raw data behind it
+	int		l_adcStartOffset	= 0;
+	size_t		offset, length;
+	ifs_protocol.read((char*) &l_adcStartOffset, sizeof(int));
+	if(ifs_protocol && l_adcStartOffset > (int) sizeof(int)) {
+	    vector<char>	v_preamble(l_adcStartOffset);
+	    memcpy(&v_preamble[0], &l_adcStartOffset, sizeof(int));
+	    ifs_protocol.read(&v_preamble[sizeof(int)], l_adcStartOffset - sizeof(int));
+	    if(ifs_protocol && preamble_find(&v_preamble[0], v_preamble.size(),
+					     offset, length)) {
+		protocol_parse(&v_preamble[offset], length);
+		b_read	= true;
+	    }
+	}
+	if(!b_read)
+	    warn("No protocol preamble found in " + str_fileName, 1);
+    } else {
+	stringstream	sin("");
+	sin << ifs_protocol.rdbuf();
+	string		str_text	= sin.str();
+	text_parse(str_text.c_str(), str_text.length());
+	b_read		= true;
+    }
+    index_build();
+
+    debug_pop();
+}
+
+C_ascconv::C_ascconv(
+    const char*		apch_text,
+    size_t		a_length,
+    string		astr_sourceName
+) {
+    //
+    // ARGS
+    //	apch_text		in		protocol text
+    //	a_length		in		length of the text
+    //	astr_sourceName		in		where the text came from
+    //						(for messages)
+    //
+    // DESC
+    //	Tokenizes protocol text that is already in memory. Only the
+    //	ASCCONV block(s) are parsed, if there are any.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    debug_push("C_ascconv");
+
+    str_fileName	= astr_sourceName;
+    protocol_parse(apch_text, a_length);
+    b_read		= true;
+    index_build();
+
+    debug_pop();
+}
+
+C_ascconv::~C_ascconv() {
+    //
+    // DESC
+    //	Destructor.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+}
+
+unsigned int
+C_ascconv::hash(
+    const char*		apch_key,
+    size_t		a_length
+) {
+    //
+    // DESC
+    //	32 bit FNV-1a hash of a key.
+    //
+
+    unsigned int	h	= 2166136261U;
+    for(size_t i=0; i<a_length; i++) {
+	h	^= (unsigned char) apch_key[i];
+	h	*= 16777619U;
+    }
+    return h;
+}
+
+void
+C_ascconv::text_parse(
+    const char*		apch_text,
+    size_t		a_length
+) {
+    //
+    // ARGS
+    //	apch_text		in		protocol text
+    //	a_length		in		length of the text
+    //
+    // DESC
+    //	Splits the text into (key, value) pairs in a single pass, and
+    //	appends them to v_entries (in file order, duplicates included -
+    //	see index_build()).
+    //
+    //	A line is a pair if it contains a `=' and the text to the left of
+    //	it is a single, non-empty word. Both key and value are stripped of
+    //	surrounding white space; a value is also stripped of a trailing
+    //	`#' comment that is not inside double quotes.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    const char*		pch_line	= apch_text;
+    const char*		pch_end		= apch_text + a_length;
+
+    while(pch_line < pch_end) {
+	const char*	pch_eol		= (const char*) memchr(pch_line, '\n',
+							pch_end - pch_line);
+	if(!pch_eol)
+	    pch_eol	= pch_end;
+
+	const char*	pch		= pch_line;
+	const char*	pch_next	= pch_eol + 1;
+	while(pch < pch_eol && isspace((unsigned char) *pch))
+	    pch++;
+	if(pch == pch_eol || *pch == '#') {
+	    pch_line	= pch_next;
+	    continue;
+	}
+
+	// key
+	const char*	pch_key		= pch;
+	while(pch < pch_eol && *pch != '=' && !isspace((unsigned char) *pch))
+	    pch++;
+	const char*	pch_keyEnd	= pch;
+	while(pch < pch_eol && isspace((unsigned char) *pch))
+	    pch++;
+	if(pch == pch_eol || *pch != '=' || pch_keyEnd == pch_key) {
+	    pch_line	= pch_next;
+	    continue;
+	}
+
+	// value
+	pch++;
+	while(pch < pch_eol && isspace((unsigned char) *pch))
+	    pch++;
+	const char*	pch_value	= pch;
+	const char*	pch_valueEnd	= pch_eol;
+	bool		b_quoted	= false;
+	for(; pch < pch_eol; pch++) {
+	    if(*pch == '"')
+		b_quoted	= !b_quoted;
+	    else if(*pch == '#' && !b_quoted) {
+		pch_valueEnd	= pch;
+		break;
+	    }
+	}
+	while(pch_valueEnd > pch_value &&
+	      isspace((unsigned char) pch_valueEnd[-1]))
+	    pch_valueEnd--;
+
+	s_ascconvEntry	entry;
+	entry.str_key.assign(pch_key, pch_keyEnd - pch_key);
+	entry.str_value.assign(pch_value, pch_valueEnd - pch_value);
+	entry.next	= -1;
+	v_entries.push_back(entry);
+
+	pch_line	= pch_next;
+    }
+}
+
+void
+C_ascconv::protocol_parse(
+    const char*		apch_text,
+    size_t		a_length
+) {
+    //
+    // ARGS
+    //	apch_text		in		text holding a protocol
+    //	a_length		in		length of the text
+    //
+    // DESC
+    //	Parses only the ASCCONV block(s) in the text, or all of it if
+    //	there are none. A meas.out preamble holds more than the ASCCONV
+    //	protocol (XProtocol trees, binary buffer headers), which should
+    //	not be mistaken for key/value pairs.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    const char*		pch		= apch_text;
+    const char*		pch_end		= apch_text + a_length;
+    bool		b_block		= false;
+
+    while(pch < pch_end) {
+	const char*	pch_begin	= (const char*) memmem(pch, pch_end - pch,
+						ASCCONV_BEGIN, strlen(ASCCONV_BEGIN));
+	if(!pch_begin)
+	    break;
+	const char*	pch_blockEnd	= (const char*) memmem(pch_begin, pch_end - pch_begin,
+						ASCCONV_END, strlen(ASCCONV_END));
+	if(!pch_blockEnd)
+	    pch_blockEnd	= pch_end;
+	text_parse(pch_begin, pch_blockEnd - pch_begin);
+	b_block		= true;
+	pch		= pch_blockEnd;
+	if(pch < pch_end)
+	    pch		+= strlen(ASCCONV_END);
+    }
+    if(!b_block)
+	text_parse(apch_text, a_length);
+}
+
+bool
+C_ascconv::preamble_find(
+    const char*		apch_data,
+    size_t		a_size,
+    size_t&		a_offset,
+    size_t&		a_length
+) {
+    //
+    // ARGS
+    //	apch_data		in		start of a meas.out
+    //	a_size			in		bytes available at apch_data
+    //	a_offset		out		offset of the protocol text
+    //	a_length		out		length of the protocol text
+    //
+    // DESC
+    //	The first int of a meas.out is the offset of the first sMDH,
+    //	i.e. the size of the preamble (including the int itself).
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    int			l_adcStartOffset;
+
+    if(a_size < sizeof(int))
+	return false;
+    memcpy(&l_adcStartOffset, apch_data, sizeof(int));
+    if(l_adcStartOffset <= (int) sizeof(int) || (size_t) l_adcStartOffset > a_size)
+	return false;
+    a_offset	= sizeof(int);
+    a_length	= l_adcStartOffset - sizeof(int);
+    return true;
+}
+
+void
+C_ascconv::index_build() {
+    //
+    // DESC
+    //	(Re)builds the hash table over v_entries. Repeated keys are
+    //	dropped, so that only the first occurrence of a key remains.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    unsigned int	buckets	= 64;
+    while(buckets < 2*v_entries.size())
+	buckets	<<= 1;
+    v_buckets.assign(buckets, -1);
+
+    unsigned int	unique	= 0;
+    for(unsigned int i=0; i<v_entries.size(); i++) {
+	const string&	str_key	= v_entries[i].str_key;
+	unsigned int	bucket	= hash(str_key.data(), str_key.length()) &
+				  (buckets - 1);
+	int		e;
+	for(e = v_buckets[bucket]; e >= 0; e = v_entries[e].next)
+	    if(v_entries[e].str_key == str_key)
+		break;
+	if(e >= 0)
+	    continue;			// not the first occurrence
+	if(unique != i)
+	    v_entries[unique]	= v_entries[i];
+	v_entries[unique].next	= v_buckets[bucket];
+	v_buckets[bucket]	= unique++;
+    }
+    v_entries.resize(unique);
+}
+
+const s_ascconvEntry*
+C_ascconv::entry_find(
+    const string&	astr_key
+) const {
+    //
+    // ARGS
+    //	astr_key		in		key to look up
+    //
+    // DESC
+    //	Returns the entry for astr_key, or NULL if the key is not in the
+    //	protocol.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    unsigned int	bucket	= hash(astr_key.data(), astr_key.length()) &
+				  (v_buckets.size() - 1);
+    for(int e = v_buckets[bucket]; e >= 0; e = v_entries[e].next)
+	if(v_entries[e].str_key == astr_key)
+	    return &v_entries[e];
+    return NULL;
+}
+
+bool
+C_ascconv::scanFor(
+    string		astr_key,
+    string*		apstr_value
+) const {
+    //
+    // ARGS
+    //	astr_key		in		key to look up
+    //	apstr_value		out		value of the key, if found
+    //
+    // DESC
+    //	Drop-in replacement for C_scanopt::scanFor().
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    const s_ascconvEntry*	pentry	= entry_find(astr_key);
+    if(!pentry)
+	return false;
+    *apstr_value	= pentry->str_value;
+    return true;
+}
+
+string
+C_ascconv::str_get(
+    const string&	astr_key,
+    const string&	astr_default
+) const {
+    const s_ascconvEntry*	pentry	= entry_find(astr_key);
+    return pentry ? pentry->str_value : astr_default;
+}
+
+int
+C_ascconv::i_get(
+    const string&	astr_key,
+    int			a_default
+) const {
+    const s_ascconvEntry*	pentry	= entry_find(astr_key);
+    return pentry ? atoi(pentry->str_value.c_str()) : a_default;
+}
+
+double
+C_ascconv::v_get(
+    const string&	astr_key,
+    double		a_default
+) const {
+    const s_ascconvEntry*	pentry	= entry_find(astr_key);
+    return pentry ? atof(pentry->str_value.c_str()) : a_default;
+}
+
+string
+C_ascconv::str_key(
+    const string&	astr_prefix,
+    int			a_index,
+    const string&	astr_suffix
+) {
+    //
+    // ARGS
+    //	astr_prefix		in		key text before the index
+    //	a_index			in		array index
+    //	astr_suffix		in		key text after the index
+    //
+    // DESC
+    //	Builds an array key, e.g.
+    //
+    //		str_key("sSliceArray.asSlice", 2, ".dThickness")
+    //
+    //	returns "sSliceArray.asSlice[2].dThickness".
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    stringstream	sout("");
+    sout << astr_prefix << "[" << a_index << "]" << astr_suffix;
+    return sout.str();
+}
@@ -0,0 +1,192 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_ascconv.h
+//
+// DESCRIPTION
+//
+//  `c_ascconv.h' declares the C_ascconv class, a one-pass tokenizer for
+//   Siemens meas.asc (### ASCCONV) protocol text.
+//
+//   The protocol is a long list of
+//
+//	<key>		= <value>
+//
+//   lines, where keys may carry array indices, e.g.
+//
+//	sSliceArray.asSlice[3].sPosition.dSag	 = -12.5
+//
+//   The file is read and split into (key, value) pairs exactly once, and
+//   the pairs are indexed in a hash table. Lookups then cost O(1) instead
+//   of a rescan of the whole text per key, as with C_scanopt::scanFor().
+//   scanFor() keeps C_scanopt's calling convention so that callers can
+//   switch over directly.
+//
+//   Lines starting with `#' (including the ### ASCCONV BEGIN/END markers)
+//   are ignored, as are `#' comments trailing a value outside of quotes.
+//   If a key occurs more than once, the first occurrence is used.
+//
+//   The protocol can also be read from the preamble of a meas.out raw
+//   data file: its first 4 bytes hold the offset of the first sMDH, and
+//   the bytes in between carry the protocol text. Only the ASCCONV
+//   block(s) of a preamble are parsed.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//  o meas.out preamble parsing.
+//
+
+#ifndef __C_ASCCONV_H__
+#define __C_ASCCONV_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace mdh {
+
+const int	C_ASCCONV_STACKDEPTH	= 64;
+const char	ASCCONV_BEGIN[]		= "### ASCCONV BEGIN";
+const char	ASCCONV_END[]		= "### ASCCONV END";
+
+    typedef struct _ascconvEntry {
+	string		str_key;
+	string		str_value;
+	int		next;			// next entry in the hash
+						//	bucket, or -1
+    } s_ascconvEntry;
+
+class C_ascconv {
+
+        // data structures
+
+    protected:
+        //
+        // generic object structures - used for internal bookkeeping
+        // and debugging / automated tracing methods. The stackDepth
+        // and str_proc[] variables are maintained by the debug_push|pop
+        // methods
+        //
+        string  str_obj;                    // name of object class
+        string  str_name;                   // name of object variable
+        int     id;                         // id of agent
+        int     iter;                       // current iteration in an
+                                            //      arbitrary processing scheme
+        int     verbosity;                  // debug related value for object
+        int     warnings;                   // show warnings (and warnings level)
+        int     stackDepth;                 // current pseudo stack depth
+
+        string  str_proc[C_ASCCONV_STACKDEPTH];    // execution procedure stack
+
+	string			str_fileName;	// parsed protocol file
+	bool			b_read;		// true if the file was read
+	vector<s_ascconvEntry>	v_entries;	// unique keys, in file order
+	vector<int>		v_buckets;	// hash table of entry indices
+						//	(size is a power of 2)
+
+    // methods
+
+    public:
+        //
+        // constructor / destructor block
+        //
+	// A meas.asc file, or the preamble of a file named *.out
+	C_ascconv(	string			astr_fileName);
+	// Protocol text already in memory, e.g. a mapped meas.out preamble
+	C_ascconv(	const char*		apch_text,
+			size_t			a_length,
+			string			astr_sourceName);
+        void    core_construct( string  astr_name               = "unnamed",
+                                int     a_id                    = -1,
+                                int     a_iter                  = 0,
+                                int     a_verbosity             = 0,
+                                int     a_warnings              = 0,
+                                int     a_stackDepth            = 0,
+                                string  astr_proc               = "noproc");
+        ~C_ascconv();
+
+        //
+        // error / warn / print block
+        //
+        void        debug_push(         string astr_currentProc);
+        void        debug_pop();
+
+        void        error(              string  astr_msg        = "Some error has occured",
+                                        int     code            = -1);
+        void        warn(               string  astr_msg        = "",
+                                        int     code            = -1);
+
+        //
+        // access block
+        //
+        int     stackDepth_get()        const {return stackDepth;};
+        void    stackDepth_set(int anum)
+                        { stackDepth = anum;};
+        string  str_proc_get()          const {return str_proc[stackDepth_get()];};
+        void    str_proc_set(int depth, string astr)
+                        { str_proc[depth] = astr;};
+
+	string	str_fileName_get()	const {return str_fileName;};
+	bool	b_read_get()		const {return b_read;};
+	int	entries_get()		const {return v_entries.size();};
+
+	//
+	// lookup block
+	//
+	const s_ascconvEntry*	entry_find(	const string&	astr_key) const;
+	bool			b_has(		const string&	astr_key) const
+					{return entry_find(astr_key) != NULL;};
+
+	// As C_scanopt::scanFor(): returns false (and leaves *apstr_value
+	//	untouched) if the key is not found.
+	bool			scanFor(	string		astr_key,
+						string*		apstr_value) const;
+
+	// Typed accessors, returning a_default if the key is not found.
+	string			str_get(	const string&	astr_key,
+						const string&	astr_default = "") const;
+	int			i_get(		const string&	astr_key,
+						int		a_default = 0) const;
+	double			v_get(		const string&	astr_key,
+						double		a_default = 0.0) const;
+
+	// Builds an array key, i.e. <prefix>[<index>]<suffix>
+	static string		str_key(	const string&	astr_prefix,
+						int		a_index,
+						const string&	astr_suffix = "");
+
+	//
+	// parse block
+	//
+	void			text_parse(	const char*	apch_text,
+						size_t		a_length);
+	void			protocol_parse(	const char*	apch_text,
+						size_t		a_length);
+	void			index_build();
+
+	// Locates the protocol text in the first a_size bytes of a meas.out
+	//	(a_size may be just the start of the file). Returns false if
+	//	the data does not start with a plausible preamble.
+	static bool		preamble_find(	const char*	apch_data,
+						size_t		a_size,
+						size_t&		a_offset,
+						size_t&		a_length);
+	static unsigned int	hash(		const char*	apch_key,
+						size_t		a_length);
+
+};
+
+}
+
+#endif //__C_ASCCONV_H__
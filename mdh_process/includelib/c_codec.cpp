@@ -0,0 +1,287 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <cstring>
+
+#include "c_codec.h"
+using namespace mdh;
+
+//
+//\\\***
+// byte shuffle definitions ****>>>>
+/////***
+//
+
+void
+mdh::bytes_shuffle(
+    const unsigned char*	apch_src,
+    unsigned char*		apch_dst,
+    size_t			a_words
+) {
+    //
+    // ARGS
+    //	apch_src		in		4*a_words bytes of data
+    //	apch_dst		out		4*a_words shuffled bytes
+    //	a_words			in		number of 4 byte words
+    //
+    // DESC
+    //	Byte n of word i is moved to apch_dst[n*a_words + i].
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    for(size_t i=0; i<a_words; i++) {
+	apch_dst[i]		= apch_src[4*i];
+	apch_dst[a_words+i]	= apch_src[4*i+1];
+	apch_dst[2*a_words+i]	= apch_src[4*i+2];
+	apch_dst[3*a_words+i]	= apch_src[4*i+3];
+    }
+}
+
+void
+mdh::bytes_unshuffle(
+    const unsigned char*	apch_src,
+    unsigned char*		apch_dst,
+    size_t			a_words
+) {
+    //
+    // DESC
+    //	Inverse of bytes_shuffle().
+    //
+
+    for(size_t i=0; i<a_words; i++) {
+	apch_dst[4*i]		= apch_src[i];
+	apch_dst[4*i+1]		= apch_src[a_words+i];
+	apch_dst[4*i+2]		= apch_src[2*a_words+i];
+	apch_dst[4*i+3]		= apch_src[3*a_words+i];
+    }
+}
+
+//
+//\\\***
+// LZ block codec definitions ****>>>>
+/////***
+//
+// A block is a series of sequences, each of which is
+//
+//	[token]		high nibble: literal count, low nibble: match length
+//			minus LZ_MINMATCH. A nibble of 15 is followed by
+//			extension bytes of 255 and a final byte < 255 that
+//			are added to it.
+//	[literals]	the literal bytes
+//	[offset]	2 byte little endian match distance (>0)
+//	[match ext]	match length extension bytes, if any
+//
+// The last sequence holds only literals (no offset / match).
+//
+
+size_t
+mdh::lz_bound(
+    size_t			a_bytes
+) {
+    return a_bytes + a_bytes/255 + 16;
+}
+
+static unsigned int
+lz_hash(
+    const unsigned char*	apch
+) {
+    unsigned int	v;
+
+    memcpy(&v, apch, 4);
+    return (v * 2654435761U) >> (32 - LZ_HASHLOG);
+}
+
+static unsigned char*
+lz_lengthWrite(
+    unsigned char*		apch_dst,
+    size_t			a_length
+) {
+    // Writes the extension bytes for a length whose nibble is 15.
+    while(a_length >= 255) {
+	*apch_dst++	= 255;
+	a_length	-= 255;
+    }
+    *apch_dst++	= (unsigned char) a_length;
+    return apch_dst;
+}
+
+size_t
+mdh::lz_compress(
+    const unsigned char*	apch_src,
+    size_t			a_bytes,
+    unsigned char*		apch_dst
+) {
+    //
+    // ARGS
+    //	apch_src		in		data to compress
+    //	a_bytes			in		size of data
+    //	apch_dst		out		compressed block, at least
+    //						lz_bound(a_bytes) bytes
+    //
+    // DESC
+    //	Greedy LZ77 compression with a single entry hash table of the
+    //	last position of each 4 byte sequence.
+    //
+    // POSTCONDITIONS
+    //	o Returns the size of the compressed block.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    const unsigned char*	pch_anchor	= apch_src;	// start of literals
+    const unsigned char*	pch_ip		= apch_src;
+    const unsigned char*	pch_end		= apch_src + a_bytes;
+    const unsigned char*	pch_matchLimit	= a_bytes > LZ_LASTLITERALS ?
+						  pch_end - LZ_LASTLITERALS : apch_src;
+    unsigned char*		pch_op		= apch_dst;
+    unsigned int*		p_table		= new unsigned int[1 << LZ_HASHLOG];
+
+    memset(p_table, 0xff, sizeof(unsigned int) << LZ_HASHLOG);
+
+    while(a_bytes > LZ_LASTLITERALS + LZ_MINMATCH &&
+	  pch_ip + LZ_MINMATCH <= pch_matchLimit) {
+	unsigned int		h	= lz_hash(pch_ip);
+	unsigned int		pos	= p_table[h];
+	const unsigned char*	pch_ref	= apch_src + pos;
+
+	p_table[h]	= pch_ip - apch_src;
+	if(pos == 0xffffffffU || pch_ip - pch_ref > LZ_MAXOFFSET ||
+		memcmp(pch_ref, pch_ip, LZ_MINMATCH)) {
+	    pch_ip++;
+	    continue;
+	}
+
+	// Extend the match, stopping short of the final literals
+	const unsigned char*	pch_match	= pch_ip + LZ_MINMATCH;
+	const unsigned char*	pch_refMatch	= pch_ref + LZ_MINMATCH;
+	while(pch_match < pch_matchLimit && *pch_match == *pch_refMatch) {
+	    pch_match++;
+	    pch_refMatch++;
+	}
+
+	size_t		literals	= pch_ip - pch_anchor;
+	size_t		matchLength	= pch_match - pch_ip - LZ_MINMATCH;
+	unsigned char*	pch_token	= pch_op++;
+	unsigned short	offset		= (unsigned short) (pch_ip - pch_ref);
+
+	*pch_token	= (unsigned char) ((literals >= 15 ? 15 : literals) << 4);
+	if(literals >= 15)
+	    pch_op	= lz_lengthWrite(pch_op, literals - 15);
+	memcpy(pch_op, pch_anchor, literals);
+	pch_op		+= literals;
+	*pch_op++	= (unsigned char) (offset & 0xff);
+	*pch_op++	= (unsigned char) (offset >> 8);
+	*pch_token	|= (unsigned char) (matchLength >= 15 ? 15 : matchLength);
+	if(matchLength >= 15)
+	    pch_op	= lz_lengthWrite(pch_op, matchLength - 15);
+
+	// Index a position inside the match too, to help the next search
+	if(pch_match - 2 > pch_ip)
+	    p_table[lz_hash(pch_match - 2)]	= pch_match - 2 - apch_src;
+	pch_ip		= pch_match;
+	pch_anchor	= pch_ip;
+    }
+
+    // Final literals
+    size_t	literals	= pch_end - pch_anchor;
+    *pch_op++	= (unsigned char) ((literals >= 15 ? 15 : literals) << 4);
+    if(literals >= 15)
+	pch_op	= lz_lengthWrite(pch_op, literals - 15);
+    if(literals)
+	memcpy(pch_op, pch_anchor, literals);
+    pch_op	+= literals;
+
+    delete [] p_table;
+    return pch_op - apch_dst;
+}
+
+bool
+mdh::lz_decompress(
+    const unsigned char*	apch_src,
+    size_t			a_bytes,
+    unsigned char*		apch_dst,
+    size_t			a_rawBytes
+) {
+    //
+    // ARGS
+    //	apch_src		in		compressed block
+    //	a_bytes			in		size of the block
+    //	apch_dst		out		decompressed data
+    //	a_rawBytes		in		expected decompressed size
+    //
+    // DESC
+    //	Decompresses a block written by lz_compress().
+    //
+    // POSTCONDITIONS
+    //	o Returns true only if the block decodes to exactly a_rawBytes.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    const unsigned char*	pch_ip		= apch_src;
+    const unsigned char*	pch_end		= apch_src + a_bytes;
+    unsigned char*		pch_op		= apch_dst;
+    unsigned char*		pch_opEnd	= apch_dst + a_rawBytes;
+    size_t			length;
+    unsigned char		ext;
+
+    while(pch_ip < pch_end) {
+	unsigned char	token	= *pch_ip++;
+
+	// literals
+	length	= token >> 4;
+	if(length == 15)
+	    do {
+		if(pch_ip >= pch_end)	return false;
+		ext	= *pch_ip++;
+		length	+= ext;
+	    } while(ext == 255);
+	if(length > (size_t) (pch_end - pch_ip) ||
+	   length > (size_t) (pch_opEnd - pch_op))
+	    return false;
+	memcpy(pch_op, pch_ip, length);
+	pch_op	+= length;
+	pch_ip	+= length;
+
+	if(pch_ip == pch_end)
+	    break;			// last sequence: literals only
+
+	// match
+	if(pch_end - pch_ip < 2)
+	    return false;
+	size_t	offset	= pch_ip[0] | (pch_ip[1] << 8);
+	pch_ip	+= 2;
+	length	= token & 0x0f;
+	if(length == 15)
+	    do {
+		if(pch_ip >= pch_end)	return false;
+		ext	= *pch_ip++;
+		length	+= ext;
+	    } while(ext == 255);
+	length	+= LZ_MINMATCH;
+	if(!offset || offset > (size_t) (pch_op - apch_dst) ||
+	   length > (size_t) (pch_opEnd - pch_op))
+	    return false;
+
+	// Byte-wise copy: source and destination may overlap
+	const unsigned char*	pch_ref	= pch_op - offset;
+	for(size_t i=0; i<length; i++)
+	    pch_op[i]	= pch_ref[i];
+	pch_op	+= length;
+    }
+    return pch_op == pch_opEnd;
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_codec.h
+//
+// DESCRIPTION
+//
+//  `c_codec.h' declares a small, dependency free lossless codec for
+//   float data, used by the compressed container encoding:
+//
+//	o byte plane shuffling: the n-th bytes of all 4 byte words are
+//	  grouped together. Exponent and high mantissa bytes of
+//	  neighbouring k-space samples are strongly correlated, so the
+//	  shuffled planes compress far better than the interleaved floats.
+//
+//	o a byte oriented LZ77 block codec (LZ4 style sequences of
+//	  [token][literals][offset][match]). It is tuned for speed rather
+//	  than ratio: a single hash probe per position and no entropy
+//	  coding.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//
+
+#ifndef __C_CODEC_H__
+#define __C_CODEC_H__
+
+#include <cstddef>
+
+namespace mdh {
+
+const int	LZ_MINMATCH	= 4;		// shortest encoded match
+const int	LZ_HASHLOG	= 14;		// log2 of the hash table size
+const int	LZ_MAXOFFSET	= 65535;	// 16 bit match offsets
+const int	LZ_LASTLITERALS	= 8;		// a block always ends in at
+						//	least this many literals
+
+// Reorders a_words 4 byte words into 4 byte planes (and back).
+void	bytes_shuffle(		const unsigned char*	apch_src,
+				unsigned char*		apch_dst,
+				size_t			a_words);
+void	bytes_unshuffle(	const unsigned char*	apch_src,
+				unsigned char*		apch_dst,
+				size_t			a_words);
+
+// Worst case size of the compressed form of a_bytes bytes.
+size_t	lz_bound(		size_t			a_bytes);
+
+// Returns the size of the compressed block in apch_dst, which must hold
+//	at least lz_bound(a_bytes) bytes.
+size_t	lz_compress(		const unsigned char*	apch_src,
+				size_t			a_bytes,
+				unsigned char*		apch_dst);
+
+// Decompresses a block into exactly a_rawBytes bytes. Returns false if
+//	the block is corrupt (all reads and writes are bounds checked).
+bool	lz_decompress(		const unsigned char*	apch_src,
+				size_t			a_bytes,
+				unsigned char*		apch_dst,
+				size_t			a_rawBytes);
+
+}
+
+#endif //__C_CODEC_H__
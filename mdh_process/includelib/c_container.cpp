@@ -0,0 +1,938 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+using namespace std;
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "c_container.h"
+#include "c_codec.h"
+using namespace mdh;
+
+// State shared by the chunk encode/decode threads
+typedef struct _chunkJobs {
+    C_container*		pc_container;
+    CVol<GSL_complex_float>*	pVl;
+    vector<s_containerChunk>*	pv_chunks;
+    vector<unsigned char*>*	pv_buffers;	// encoded chunks (encode)
+    const char*			pch_payload;	// mapped payload (decode), or
+						//	NULL to encode
+    int				next;		// next chunk to hand out
+    bool			b_ok;
+    pthread_mutex_t		mutex;
+} s_chunkJobs;
+
+//
+//\\\***
+// C_container definitions ****>>>>
+/////***
+//
+
+void
+C_container::debug_push(
+        string                          astr_currentProc) {
+    //
+    // ARGS
+    //  astr_currentProc        in      method name to
+    //                                          "push" on the "stack"
+    //
+    // DESC
+    //  This attempts to keep a simple record of methods that
+    //  are called. Note that this "stack" is severely crippled in
+    //  that it has no "memory" - names pushed on overwrite those
+    //  currently there.
+    //
+
+    if(stackDepth_get() >= C_CONTAINER_STACKDEPTH-1)
+        error(  "Out of str_proc stack depth");
+    stackDepth_set(stackDepth_get()+1);
+    str_proc_set(stackDepth_get(), astr_currentProc);
+}
+
+void
+C_container::debug_pop() {
+    //
+    // DESC
+    //  "pop" the stack. Since the previous name has been
+    //  overwritten, there is no restoration, per se. The
+    //  only important parameter really is the stackDepth.
+    //
+
+    stackDepth_set(stackDepth_get()-1);
+}
+
+void
+C_container::error(
+        string          astr_msg        /*= "Some error has occured"    */,
+        int             code            /*= -1                          */)
+{
+    //
+    // ARGS
+    //  atr_msg                 in              message to dump to stderr
+    //  code                    in              error code
+    //
+    // DESC
+    //  Print error related information. This routine throws an exception
+    //  to the class itself, allowing for coarse grained, but simple
+    //  error flagging.
+    //
+
+    cerr << "\nFatal error encountered.\n";
+    cerr << "\tC_container object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "\n";
+    cerr << "Throwing an exception to (this) with code " << code << "\n\n";
+    throw(this);
+}
+
+void
+C_container::warn(
+        string          astr_msg,
+	int             code            /*= -1                  */
+) {
+    //
+    // ARGS
+    //  atr_msg          in              message to dump to stderr
+    //  code             in              error code
+    //
+    // DESC
+    //  Print error related information. Conceptually identical to
+    //  the `error' method, but no expection is thrown.
+    //
+
+    cerr << "\nWarning.\n";
+    cerr << "\tC_container object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "(code: " << code << ")\n";
+}
+
+void
+C_container::core_construct(
+        string          astr_name       /*= "unnamed"           */,
+        int             a_id            /*= -1                  */,
+        int             a_iter          /*= 0                   */,
+        int             a_verbosity     /*= 0                   */,
+        int             a_warnings      /*= 0                   */,
+        int             a_stackDepth    /*= 0                   */,
+        string          astr_proc       /*= "noproc"            */
+) {
+    //
+    // ARGS
+    //  astr_name        in              name of object
+    //  a_id             in              id of object
+    //  a_iter           in              current iteration in arbitrary scheme
+    //  a_verbosity      in              verbosity of object
+    //  a_stackDepth     in              stackDepth
+    //  astr_proc        in              current that has been "debug_push"ed
+    //
+    // DESC
+    //  Simply fill in the core values of the object with some defaults
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding
+    //
+
+    str_name                    = astr_name;
+    id                          = a_id;
+    iter                        = a_iter;
+    verbosity                   = a_verbosity;
+    warnings                    = a_warnings;
+    stackDepth                  = a_stackDepth;
+    str_proc[stackDepth]        = astr_proc;
+
+    fd				= -1;
+    writeOffset			= 0;
+    pch_map			= NULL;
+    mapSize			= 0;
+    e_encoding			= e_encodingRaw;
+    threads			= 1;
+    b_sharedMemory		= false;
+
+    str_obj                     = "C_container";
+}
+
+C_container::C_container(
+    string		astr_fileName,
+    e_CONTAINERMODE	ae_mode,
+    bool		ab_sharedMemory		/*= false		*/
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		container file
+    //	ae_mode			in		e_containerRead or
+    //						e_containerWrite
+    //	ab_sharedMemory		in		astr_fileName names a POSIX
+    //						shared memory object
+    //						("/<name>") instead
+    //
+    // DESC
+    //	Opens a container.
+    //
+    //	In write mode the file is (re)created and the header space is
+    //	reserved; volumes are then appended with volume_write() and the
+    //	index is written by close().
+    //
+    //	In read mode the whole file is mmap()ed and its index validated.
+    //
+    //	A container in shared memory is otherwise the same: readers in
+    //	other processes map the very pages the writer filled in.
+    //
+    // POSTCONDITIONS
+    //	o If the container could not be opened, a warning is shown and
+    //	  b_isOpen() is false.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o POSIX shared memory containers.
+    //
+
+    core_construct();
+    debug_push("C_container");
+
+    struct stat		st_file;
+    s_containerHeader	header;
+
+    str_fileName	= astr_fileName;
+    e_mode		= ae_mode;
+    b_sharedMemory	= ab_sharedMemory;
+
+    if(e_mode == e_containerWrite) {
+	if(b_sharedMemory)
+	    fd	= shm_open(str_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	else
+	    fd	= open(str_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+	    warn("Could not create container " + str_fileName, 1);
+	writeOffset	= sizeof(s_containerHeader);
+    } else {
+	int	fd_read	= b_sharedMemory ? shm_open(str_fileName.c_str(), O_RDONLY, 0) :
+					   open(str_fileName.c_str(), O_RDONLY);
+	if(fd_read >= 0) {
+	    if(!fstat(fd_read, &st_file) &&
+		    st_file.st_size >= (off_t) sizeof(s_containerHeader)) {
+		pch_map	= (char*) mmap(NULL, st_file.st_size, PROT_READ,
+				       MAP_SHARED, fd_read, 0);
+		if(pch_map == MAP_FAILED)
+		    pch_map	= NULL;
+		else
+		    mapSize	= st_file.st_size;
+	    }
+	    ::close(fd_read);
+	}
+	if(pch_map) {
+	    memcpy(&header, pch_map, sizeof(s_containerHeader));
+	    if(	strncmp(header.pch_magic, CONTAINER_MAGIC, 8)	||
+		header.version != CONTAINER_VERSION		||
+		header.entries < 0				||
+		header.indexOffset < (long long) sizeof(s_containerHeader) ||
+		header.indexOffset + (long long) header.entries *
+		    sizeof(s_containerEntry) > (long long) mapSize) {
+		warn("Not a valid (or not a completed) container: " + str_fileName, 1);
+		munmap(pch_map, mapSize);
+		pch_map	= NULL;
+		mapSize	= 0;
+	    } else {
+		v_index.resize(header.entries);
+		if(header.entries)
+		    memcpy(&v_index[0], pch_map + header.indexOffset,
+			   header.entries * sizeof(s_containerEntry));
+		madvise(pch_map, mapSize, MADV_WILLNEED);
+	    }
+	} else
+	    warn("Could not map container " + str_fileName, 1);
+    }
+
+    debug_pop();
+}
+
+C_container::~C_container() {
+    //
+    // DESC
+    //	Destructor. A container still open for writing is closed, i.e.
+    //	its index is written.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    close();
+}
+
+const s_containerEntry*
+C_container::entry_find(
+    int			a_channel,
+    int			a_echo,
+    int			a_repetition
+) const {
+    //
+    // ARGS
+    //	a_channel		in		channel of the volume
+    //	a_echo			in		echo of the volume
+    //	a_repetition		in		repetition of the volume
+    //
+    // DESC
+    //	Looks up the index entry of a volume. Returns NULL if the volume
+    //	is not in the container.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    for(unsigned int i=0; i<v_index.size(); i++)
+	if(	v_index[i].channel	== a_channel	&&
+		v_index[i].echo		== a_echo	&&
+		v_index[i].repetition	== a_repetition)
+	    return &v_index[i];
+    return NULL;
+}
+
+bool
+C_container::volume_write(
+    int				a_channel,
+    int				a_echo,
+    int				a_repetition,
+    CVol<GSL_complex_float>*	apVl
+) {
+    //
+    // ARGS
+    //	a_channel		in		channel of the volume
+    //	a_echo			in		echo of the volume
+    //	a_repetition		in		repetition of the volume
+    //	apVl			in		volume to store
+    //
+    // DESC
+    //	Appends a volume at the next CONTAINER_ALIGN boundary, and adds
+    //	its entry to the (in memory) index. The volume is written one
+    //	slice at a time to keep the staging buffer small.
+    //
+    //	If the container encoding is e_encodingShuffleLZ, the payload is
+    //	encoded by payload_encode() instead.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o Compressed encoding.
+    //
+
+    debug_push("volume_write(...)");
+
+    if(e_mode != e_containerWrite || fd < 0)
+	error("Container " + str_fileName + " is not open for writing", 1);
+    if(entry_find(a_channel, a_echo, a_repetition))
+	warn("Duplicate volume in container " + str_fileName, 1);
+
+    s_containerEntry	entry;
+    int			i, j, k;
+    int			rows		= apVl->rows_get();
+    int			cols		= apVl->cols_get();
+    int			slices		= apVl->slices_get();
+    long		sliceBytes	= (long) rows * cols * 2 * sizeof(float);
+    float*		pf_slice;
+    long		bufCount;
+    bool		b_ret		= true;
+
+    memset(&entry, 0, sizeof(s_containerEntry));
+    entry.channel	= a_channel;
+    entry.echo		= a_echo;
+    entry.repetition	= a_repetition;
+    entry.rows		= rows;
+    entry.cols		= cols;
+    entry.slices	= slices;
+    entry.encoding	= e_encodingRaw;
+    entry.offset	= (writeOffset + CONTAINER_ALIGN - 1) /
+			  CONTAINER_ALIGN * CONTAINER_ALIGN;
+    entry.bytes		= (long long) sliceBytes * slices;
+    entry.rawBytes	= entry.bytes;
+
+    if(e_encoding == e_encodingShuffleLZ)
+	b_ret	= payload_encode(entry, apVl);
+    else {
+	pf_slice	= new float[(long) rows * cols * 2];
+	for(k=0; k<slices && b_ret; k++) {
+	    bufCount	= 0;
+	    for(i=0; i<rows; i++)
+		for(j=0; j<cols; j++) {
+		    pf_slice[bufCount++]	= GSL_REAL(apVl->val(i, j, k));
+		    pf_slice[bufCount++]	= GSL_IMAG(apVl->val(i, j, k));
+		}
+	    if(pwrite(fd, pf_slice, sliceBytes, entry.offset + (off_t) k*sliceBytes)
+		    != sliceBytes)
+		b_ret	= false;
+	}
+	delete [] pf_slice;
+    }
+
+    if(b_ret) {
+	v_index.push_back(entry);
+	writeOffset	= entry.offset + entry.bytes;
+    } else
+	warn("Some error encountered writing volume to " + str_fileName, 1);
+
+    debug_pop();
+    return b_ret;
+}
+
+CVol<GSL_complex_float>*
+C_container::volume_read(
+    int			a_channel,
+    int			a_echo,
+    int			a_repetition
+) {
+    //
+    // ARGS
+    //	a_channel		in		channel of the volume
+    //	a_echo			in		echo of the volume
+    //	a_repetition		in		repetition of the volume
+    //
+    // DESC
+    //	Constructs a new volume from the container mapping.
+    //
+    // POSTCONDITIONS
+    //	o Returns the new volume (to be deleted by the caller), or NULL if
+    //	  the volume is not in the container.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o Compressed encoding.
+    //
+
+    debug_push("volume_read(...)");
+
+    if(e_mode != e_containerRead || !pch_map)
+	error("Container " + str_fileName + " is not open for reading", 1);
+
+    const s_containerEntry*	pentry	= entry_find(a_channel, a_echo, a_repetition);
+    CVol<GSL_complex_float>*	pVl	= NULL;
+    GSL_complex_float		zv_val;
+    int				i, j, k;
+    long			bufCount	= 0;
+
+    if(!pentry) {
+	warn("Volume not found in container " + str_fileName, 1);
+	debug_pop();
+	return NULL;
+    }
+    if(pentry->offset + pentry->bytes > (long long) mapSize ||
+	    (pentry->encoding == e_encodingRaw && pentry->bytes != pentry->rawBytes))
+	error("Corrupt container entry in " + str_fileName, 1);
+
+    pVl	= new CVol<GSL_complex_float>(pentry->rows, pentry->cols, pentry->slices);
+    switch(pentry->encoding) {
+	case e_encodingRaw: {
+	    const float*	pf_data	= (const float*) (pch_map + pentry->offset);
+	    for(k=0; k<pentry->slices; k++)
+		for(i=0; i<pentry->rows; i++)
+		    for(j=0; j<pentry->cols; j++) {
+			GSL_SET_COMPLEX(&zv_val, pf_data[bufCount], pf_data[bufCount+1]);
+			pVl->val(i, j, k)	= zv_val;
+			bufCount	+= 2;
+		    }
+	}
+	break;
+	case e_encodingShuffleLZ:
+	    if(!payload_decode(pentry, pVl))
+		error("Corrupt compressed payload in " + str_fileName, 1);
+	break;
+	default:
+	    error("Unknown payload encoding in " + str_fileName, 1);
+	break;
+    }
+
+    debug_pop();
+    return pVl;
+}
+
+bool
+C_container::close() {
+    //
+    // DESC
+    //	Closes the container. In write mode, the index is appended after
+    //	the last payload and the header is written; a container only
+    //	becomes readable once it has been closed. Closing an already
+    //	closed container is a no-op.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    debug_push("close()");
+
+    bool		b_ret	= true;
+    s_containerHeader	header;
+    long		indexBytes;
+
+    if(e_mode == e_containerWrite && fd >= 0) {
+	memset(&header, 0, sizeof(s_containerHeader));
+	memcpy(header.pch_magic, CONTAINER_MAGIC, sizeof(header.pch_magic));
+	header.version		= CONTAINER_VERSION;
+	header.entries		= v_index.size();
+	header.indexOffset	= (writeOffset + CONTAINER_ALIGN - 1) /
+				  CONTAINER_ALIGN * CONTAINER_ALIGN;
+	indexBytes		= v_index.size() * sizeof(s_containerEntry);
+	if(indexBytes && pwrite(fd, &v_index[0], indexBytes, header.indexOffset)
+		!= indexBytes)
+	    b_ret	= false;
+	if(pwrite(fd, &header, sizeof(s_containerHeader), 0)
+		!= (ssize_t) sizeof(s_containerHeader))
+	    b_ret	= false;
+	if(::close(fd))
+	    b_ret	= false;
+	fd	= -1;
+	if(!b_ret)
+	    warn("Some error encountered closing container " + str_fileName, 1);
+    }
+    if(pch_map) {
+	munmap(pch_map, mapSize);
+	pch_map	= NULL;
+	mapSize	= 0;
+    }
+
+    debug_pop();
+    return b_ret;
+}
+
+void*
+C_container::chunk_thread(
+    void*		apv_jobs
+) {
+    //
+    // ARGS
+    //	apv_jobs		in/out		shared s_chunkJobs
+    //
+    // DESC
+    //	Thread body of chunks_process(). Chunks are handed out one at a
+    //	time until none are left.
+    //
+    //	Encoding: the slices of a chunk are gathered into (real, imag)
+    //	float pairs, byte shuffled and LZ compressed into a new buffer
+    //	(or kept shuffled only if they do not compress).
+    //
+    //	Decoding: the reverse, scattering into the (pre-constructed)
+    //	volume. Each chunk covers distinct slices, so no locking is needed
+    //	on the volume itself.
+    //
+    //	No debug_push()/pop() here: the pseudo stack is not thread safe.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    s_chunkJobs*		pjobs		= (s_chunkJobs*) apv_jobs;
+    CVol<GSL_complex_float>*	pVl		= pjobs->pVl;
+    int				rows		= pVl->rows_get();
+    int				cols		= pVl->cols_get();
+    long			sliceBytes	= (long) rows * cols * 2 * sizeof(float);
+    long			maxBytes	= 0;
+    unsigned char*		pch_raw;
+    unsigned char*		pch_shuffled;
+    GSL_complex_float		zv_val;
+    int				c, i, j, k;
+    long			bufCount;
+
+    for(c=0; c<(int) pjobs->pv_chunks->size(); c++)
+	if((*pjobs->pv_chunks)[c].slices * sliceBytes > maxBytes)
+	    maxBytes	= (*pjobs->pv_chunks)[c].slices * sliceBytes;
+    pch_raw		= new unsigned char[maxBytes];
+    pch_shuffled	= new unsigned char[maxBytes];
+
+    while(1) {
+	pthread_mutex_lock(&pjobs->mutex);
+	c	= pjobs->next++;
+	pthread_mutex_unlock(&pjobs->mutex);
+	if(c >= (int) pjobs->pv_chunks->size())
+	    break;
+
+	s_containerChunk&	chunk		= (*pjobs->pv_chunks)[c];
+	long			rawBytes	= chunk.slices * sliceBytes;
+	float*			pf_raw		= (float*) pch_raw;
+
+	bufCount	= 0;
+	if(!pjobs->pch_payload) {
+	    for(k=chunk.sliceStart; k<chunk.sliceStart+chunk.slices; k++)
+		for(i=0; i<rows; i++)
+		    for(j=0; j<cols; j++) {
+			pf_raw[bufCount++]	= GSL_REAL(pVl->val(i, j, k));
+			pf_raw[bufCount++]	= GSL_IMAG(pVl->val(i, j, k));
+		    }
+	    bytes_shuffle(pch_raw, pch_shuffled, rawBytes / 4);
+
+	    unsigned char*	pch_out	= new unsigned char[lz_bound(rawBytes)];
+	    chunk.bytes	= lz_compress(pch_shuffled, rawBytes, pch_out);
+	    if(chunk.bytes >= rawBytes) {
+		memcpy(pch_out, pch_shuffled, rawBytes);
+		chunk.bytes	= rawBytes;
+	    }
+	    (*pjobs->pv_buffers)[c]	= pch_out;
+	} else {
+	    const unsigned char*	pch_in	= (const unsigned char*)
+						  pjobs->pch_payload + chunk.offset;
+	    bool			b_ok	= true;
+
+	    if(chunk.bytes == rawBytes)
+		memcpy(pch_shuffled, pch_in, rawBytes);
+	    else
+		b_ok	= lz_decompress(pch_in, chunk.bytes, pch_shuffled, rawBytes);
+	    if(!b_ok) {
+		pthread_mutex_lock(&pjobs->mutex);
+		pjobs->b_ok	= false;
+		pthread_mutex_unlock(&pjobs->mutex);
+		continue;
+	    }
+	    bytes_unshuffle(pch_shuffled, pch_raw, rawBytes / 4);
+	    for(k=chunk.sliceStart; k<chunk.sliceStart+chunk.slices; k++)
+		for(i=0; i<rows; i++)
+		    for(j=0; j<cols; j++) {
+			GSL_SET_COMPLEX(&zv_val, pf_raw[bufCount], pf_raw[bufCount+1]);
+			pVl->val(i, j, k)	= zv_val;
+			bufCount	+= 2;
+		    }
+	}
+    }
+
+    delete [] pch_raw;
+    delete [] pch_shuffled;
+    return NULL;
+}
+
+bool
+C_container::chunks_process(
+    CVol<GSL_complex_float>*	apVl,
+    vector<s_containerChunk>&	av_chunks,
+    vector<unsigned char*>&	av_buffers,
+    const char*			apch_payload
+) {
+    //
+    // ARGS
+    //	apVl			in/out		volume to encode/decode
+    //	av_chunks		in/out		chunk table
+    //	av_buffers		out		encoded chunks (encode only)
+    //	apch_payload		in		mapped payload to decode, or
+    //						NULL to encode
+    //
+    // DESC
+    //	Runs chunk_thread() on <threads> threads (the caller being one of
+    //	them) until all chunks are processed.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    debug_push("chunks_process(...)");
+
+    s_chunkJobs		jobs;
+    int			nthreads	= threads;
+    int			started		= 0;
+
+    if(nthreads > (int) av_chunks.size())
+	nthreads	= av_chunks.size();
+    if(nthreads < 1)
+	nthreads	= 1;
+
+    jobs.pc_container	= this;
+    jobs.pVl		= apVl;
+    jobs.pv_chunks	= &av_chunks;
+    jobs.pv_buffers	= &av_buffers;
+    jobs.pch_payload	= apch_payload;
+    jobs.next		= 0;
+    jobs.b_ok		= true;
+    pthread_mutex_init(&jobs.mutex, NULL);
+
+    pthread_t*		pthreads	= new pthread_t[nthreads];
+    for(int i=0; i<nthreads-1; i++)
+	if(!pthread_create(&pthreads[started], NULL, chunk_thread, &jobs))
+	    started++;
+    chunk_thread(&jobs);
+    for(int i=0; i<started; i++)
+	pthread_join(pthreads[i], NULL);
+
+    delete [] pthreads;
+    pthread_mutex_destroy(&jobs.mutex);
+
+    debug_pop();
+    return jobs.b_ok;
+}
+
+bool
+C_container::payload_encode(
+    s_containerEntry&		a_entry,
+    CVol<GSL_complex_float>*	apVl
+) {
+    //
+    // ARGS
+    //	a_entry			in/out		entry of the volume; offset is
+    //						set, bytes/encoding are
+    //						filled in
+    //	apVl			in		volume to store
+    //
+    // DESC
+    //	Writes a volume as an e_encodingShuffleLZ payload. The volume is
+    //	split into chunks of whole slices of about CONTAINER_CHUNKBYTES,
+    //	which are encoded in parallel and then written in order.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    debug_push("payload_encode(...)");
+
+    vector<s_containerChunk>	v_chunks;
+    vector<unsigned char*>	v_buffers;
+    s_containerChunk		chunk;
+    long			sliceBytes	= (long) a_entry.rows * a_entry.cols *
+						  2 * sizeof(float);
+    int				chunkSlices	= CONTAINER_CHUNKBYTES / sliceBytes;
+    int				pi_count[2];
+    long long			offset;
+    long			tableBytes;
+    bool			b_ret		= true;
+
+    if(chunkSlices < 1)
+	chunkSlices	= 1;
+    for(int k=0; k<a_entry.slices; k+=chunkSlices) {
+	memset(&chunk, 0, sizeof(s_containerChunk));
+	chunk.sliceStart	= k;
+	chunk.slices		= k+chunkSlices > a_entry.slices ?
+				  a_entry.slices-k : chunkSlices;
+	v_chunks.push_back(chunk);
+    }
+    v_buffers.resize(v_chunks.size(), NULL);
+
+    chunks_process(apVl, v_chunks, v_buffers, NULL);
+
+    tableBytes	= v_chunks.size() * sizeof(s_containerChunk);
+    offset	= sizeof(pi_count) + tableBytes;
+    for(unsigned int c=0; c<v_chunks.size(); c++) {
+	v_chunks[c].offset	= offset;
+	offset			+= v_chunks[c].bytes;
+    }
+
+    pi_count[0]	= v_chunks.size();
+    pi_count[1]	= 0;
+    if(pwrite(fd, pi_count, sizeof(pi_count), a_entry.offset)
+	    != (ssize_t) sizeof(pi_count))
+	b_ret	= false;
+    if(tableBytes && pwrite(fd, &v_chunks[0], tableBytes,
+			    a_entry.offset + sizeof(pi_count)) != tableBytes)
+	b_ret	= false;
+    for(unsigned int c=0; c<v_chunks.size(); c++) {
+	if(b_ret && pwrite(fd, v_buffers[c], v_chunks[c].bytes,
+			   a_entry.offset + v_chunks[c].offset)
+		!= (ssize_t) v_chunks[c].bytes)
+	    b_ret	= false;
+	delete [] v_buffers[c];
+    }
+
+    a_entry.encoding	= e_encodingShuffleLZ;
+    a_entry.bytes	= offset;
+
+    debug_pop();
+    return b_ret;
+}
+
+bool
+C_container::payload_decode(
+    const s_containerEntry*	apentry,
+    CVol<GSL_complex_float>*	apVl
+) {
+    //
+    // ARGS
+    //	apentry			in		entry of the volume
+    //	apVl			out		constructed volume to fill
+    //
+    // DESC
+    //	Decodes an e_encodingShuffleLZ payload straight from the mapping.
+    //	The chunk table is validated against the entry before any chunk
+    //	is touched.
+    //
+    // POSTCONDITIONS
+    //	o Returns false if the payload is corrupt.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    debug_push("payload_decode(...)");
+
+    const char*			pch_payload	= pch_map + apentry->offset;
+    vector<s_containerChunk>	v_chunks;
+    vector<unsigned char*>	v_buffers;
+    int				chunks;
+    int				sliceNext	= 0;
+    long			sliceBytes	= (long) apentry->rows * apentry->cols *
+						  2 * sizeof(float);
+    bool			b_ret		= apentry->bytes >= 8;
+
+    if(b_ret) {
+	memcpy(&chunks, pch_payload, sizeof(int));
+	b_ret	= chunks >= 0 && 8 + (long long) chunks * sizeof(s_containerChunk)
+				<= apentry->bytes;
+    }
+    if(b_ret) {
+	v_chunks.resize(chunks);
+	if(chunks)
+	    memcpy(&v_chunks[0], pch_payload + 8, chunks * sizeof(s_containerChunk));
+	for(int c=0; c<chunks && b_ret; c++) {
+	    s_containerChunk&	chunk	= v_chunks[c];
+	    if(	chunk.sliceStart != sliceNext || chunk.slices < 1	||
+		chunk.offset < 0 || chunk.bytes < 0			||
+		chunk.bytes > chunk.slices * sliceBytes			||
+		chunk.offset + chunk.bytes > apentry->bytes)
+		b_ret	= false;
+	    sliceNext	+= chunk.slices;
+	}
+	if(sliceNext != apentry->slices)
+	    b_ret	= false;
+    }
+    if(b_ret)
+	b_ret	= chunks_process(apVl, v_chunks, v_buffers, pch_payload);
+
+    debug_pop();
+    return b_ret;
+}
+
+unsigned long long
+C_container::hash_update(
+    unsigned long long	a_hash,
+    const void*		apv_data,
+    size_t		a_bytes
+) {
+    //
+    // ARGS
+    //	a_hash			in		running hash (start with
+    //						CONTAINER_HASH_SEED)
+    //	apv_data		in		data to fold into the hash
+    //	a_bytes			in		size of data
+    //
+    // DESC
+    //	64 bit FNV-1a. Not a cryptographic hash, but more than good enough
+    //	to tell apart the inputs of different runs.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    const unsigned char*	pch	= (const unsigned char*) apv_data;
+
+    for(size_t i=0; i<a_bytes; i++) {
+	a_hash	^= pch[i];
+	a_hash	*= 1099511628211ULL;
+    }
+    return a_hash;
+}
+
+unsigned long long
+C_container::hash_update(
+    unsigned long long	a_hash,
+    string		astr
+) {
+    // Strings are hashed with their terminating '\0', so that
+    //	consecutive strings cannot run into each other.
+    return hash_update(a_hash, astr.c_str(), astr.length()+1);
+}
+
+unsigned long long
+C_container::file_fingerprint(
+    string		astr_fileName,
+    unsigned long long	a_hash
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		file to fingerprint
+    //	a_hash			in		running hash
+    //
+    // DESC
+    //	Folds the size, modification time and a sample of the contents of
+    //	a file into a hash. Small files are hashed completely; large files
+    //	(such as a multi-GB meas.out) are sampled in CONTAINER_HASH_BLOCKS
+    //	evenly spaced blocks, including the first and the last.
+    //
+    //	A file that cannot be accessed folds in only its name, so that
+    //	the fingerprint is still well defined.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    struct stat		st_file;
+    long long		size;
+    long long		mtime;
+    long long		offset;
+    ssize_t		bytes;
+    int			fd;
+    char*		pch_block;
+
+    a_hash	= hash_update(a_hash, astr_fileName);
+    fd		= open(astr_fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+	return a_hash;
+    if(fstat(fd, &st_file)) {
+	::close(fd);
+	return a_hash;
+    }
+
+    size	= st_file.st_size;
+    mtime	= st_file.st_mtime;
+    a_hash	= hash_update(a_hash, &size, sizeof(size));
+    a_hash	= hash_update(a_hash, &mtime, sizeof(mtime));
+
+    pch_block	= new char[CONTAINER_HASH_BLOCKSIZE];
+    if(size <= (long long) CONTAINER_HASH_BLOCKS * CONTAINER_HASH_BLOCKSIZE) {
+	for(offset=0; offset<size; offset+=bytes) {
+	    bytes	= pread(fd, pch_block, CONTAINER_HASH_BLOCKSIZE, offset);
+	    if(bytes <= 0)
+		break;
+	    a_hash	= hash_update(a_hash, pch_block, bytes);
+	}
+    } else {
+	for(int i=0; i<CONTAINER_HASH_BLOCKS; i++) {
+	    offset	= (size - CONTAINER_HASH_BLOCKSIZE) / (CONTAINER_HASH_BLOCKS-1) * i;
+	    bytes	= pread(fd, pch_block, CONTAINER_HASH_BLOCKSIZE, offset);
+	    if(bytes > 0)
+		a_hash	= hash_update(a_hash, pch_block, bytes);
+	}
+    }
+    delete [] pch_block;
+    ::close(fd);
+    return a_hash;
+}
+
+string
+C_container::hash_str(
+    unsigned long long	a_hash
+) {
+    //
+    // DESC
+    //	Returns a hash as 16 hex digits, e.g. for use in a file name.
+    //
+
+    stringstream	sout("");
+    sout << hex << setw(16) << setfill('0') << a_hash;
+    return sout.str();
+}
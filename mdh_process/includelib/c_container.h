@@ -0,0 +1,267 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_container.h
+//
+// DESCRIPTION
+//
+//  `c_container.h' declares the C_container class, a single-file indexed
+//   store of extracted (channel, echo, repetition) volumes. It replaces the
+//   one-file-per-volume `.mdh' saves of --preprocessSave/--preprocessLoad.
+//
+//   File layout:
+//
+//	[header]		CONTAINER_ALIGN bytes, see s_containerHeader
+//	[payload 0]		each payload starts on a CONTAINER_ALIGN
+//	[payload 1]		boundary and holds the volume as
+//	...			[slice][row][col] (real, imag) float pairs
+//	[index]			<entries> x s_containerEntry
+//
+//   A payload with the e_encodingShuffleLZ encoding instead holds
+//
+//	[chunks]		int, followed by an int of padding
+//	[chunk table]		<chunks> x s_containerChunk
+//	[chunk 0] ...		each chunk is a run of whole slices, byte
+//				shuffled (see c_codec.h) and LZ compressed.
+//				Chunks that do not compress are stored as
+//				shuffled bytes only (bytes == raw size).
+//
+//   Chunks are encoded and decoded in parallel.
+//
+//   The index is written when the container is closed, and its offset
+//   patched into the header. Containers are read by mmap()ing the whole
+//   file, so that any volume can be picked without further file I/O.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//  o Fingerprinting for the automatic k-space cache.
+//  o Compressed (byte shuffle + LZ) payload encoding.
+//  o Containers in POSIX shared memory.
+//
+
+#ifndef __C_CONTAINER_H__
+#define __C_CONTAINER_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#include "cmatrix.h"
+
+namespace mdh {
+
+const int	C_CONTAINER_STACKDEPTH	= 64;
+const int	CONTAINER_ALIGN		= 64;		// payload alignment (bytes)
+const int	CONTAINER_VERSION	= 1;
+const char	CONTAINER_MAGIC[]	= "MDHCONT";	// 8 bytes with the '\0'
+const unsigned long long
+		CONTAINER_HASH_SEED	= 14695981039346656037ULL;
+						// FNV-1a 64 bit offset basis
+const int	CONTAINER_HASH_BLOCKS	= 16;		// sampled blocks per file
+const int	CONTAINER_HASH_BLOCKSIZE	= 65536;
+const long	CONTAINER_CHUNKBYTES	= 1 << 20;	// target raw bytes per
+							//	compressed chunk
+
+    typedef enum _containerMode {
+	e_containerRead		= 0,
+	e_containerWrite	= 1
+    } e_CONTAINERMODE;
+
+    typedef enum _containerEncoding {
+	e_encodingRaw		= 0,		// native complex float pairs
+	e_encodingShuffleLZ	= 1		// chunked, shuffled and LZ
+						//	compressed
+    } e_CONTAINERENCODING;
+
+    // Both on-disk structures are exactly CONTAINER_ALIGN bytes, and are
+    //	stored in native byte order: containers are scratch data and are
+    //	not meant to be moved between architectures.
+    typedef struct _containerHeader {
+	char		pch_magic[8];		// CONTAINER_MAGIC
+	int		version;		// CONTAINER_VERSION
+	int		entries;		// number of index entries
+	long long	indexOffset;		// file offset of the index
+	char		pch_reserved[40];
+    } s_containerHeader;
+
+    typedef struct _containerEntry {
+	int		channel;
+	int		echo;
+	int		repetition;
+	int		rows;
+	int		cols;
+	int		slices;
+	int		encoding;		// e_CONTAINERENCODING
+	int		reserved;
+	long long	offset;			// payload file offset
+	long long	bytes;			// payload size on disk
+	long long	rawBytes;		// decoded payload size
+	long long	reserved2;
+    } s_containerEntry;
+
+    typedef struct _containerChunk {
+	int		sliceStart;		// first slice of the chunk
+	int		slices;
+	long long	offset;			// relative to the payload
+	long long	bytes;			// encoded size
+    } s_containerChunk;
+
+class C_container {
+
+        // data structures
+
+    protected:
+        //
+        // generic object structures - used for internal bookkeeping
+        // and debugging / automated tracing methods. The stackDepth
+        // and str_proc[] variables are maintained by the debug_push|pop
+        // methods
+        //
+        string  str_obj;                    // name of object class
+        string  str_name;                   // name of object variable
+        int     id;                         // id of agent
+        int     iter;                       // current iteration in an
+                                            //      arbitrary processing scheme
+        int     verbosity;                  // debug related value for object
+        int     warnings;                   // show warnings (and warnings level)
+        int     stackDepth;                 // current pseudo stack depth
+
+        string  str_proc[C_CONTAINER_STACKDEPTH];  // execution procedure stack
+
+	string			str_fileName;	// container file
+	e_CONTAINERMODE		e_mode;		// read or write
+	int			fd;		// open file (write mode)
+	off_t			writeOffset;	// end of the last payload
+	char*			pch_map;	// whole file mapping (read mode)
+	size_t			mapSize;
+	vector<s_containerEntry>
+				v_index;	// one entry per volume
+	e_CONTAINERENCODING	e_encoding;	// encoding of new payloads
+	int			threads;	// chunk encode/decode threads
+	bool			b_sharedMemory;	// str_fileName is a POSIX
+						//	shared memory object
+
+    // methods
+
+    public:
+        //
+        // constructor / destructor block
+        //
+	C_container(	string			astr_fileName,
+			e_CONTAINERMODE		ae_mode,
+			bool			ab_sharedMemory	= false);
+        void    core_construct( string  astr_name               = "unnamed",
+                                int     a_id                    = -1,
+                                int     a_iter                  = 0,
+                                int     a_verbosity             = 0,
+                                int     a_warnings              = 0,
+                                int     a_stackDepth            = 0,
+                                string  astr_proc               = "noproc");
+        ~C_container();
+
+        //
+        // error / warn / print block
+        //
+        void        debug_push(         string astr_currentProc);
+        void        debug_pop();
+
+        void        error(              string  astr_msg        = "Some error has occured",
+                                        int     code            = -1);
+        void        warn(               string  astr_msg        = "",
+                                        int     code            = -1);
+
+        //
+        // access block
+        //
+        int     stackDepth_get()        const {return stackDepth;};
+        void    stackDepth_set(int anum)
+                        { stackDepth = anum;};
+        string  str_proc_get()          const {return str_proc[stackDepth_get()];};
+        void    str_proc_set(int depth, string astr)
+                        { str_proc[depth] = astr;};
+
+	string	str_fileName_get()	const {return str_fileName;};
+	e_CONTAINERMODE	e_mode_get()	const {return e_mode;};
+	bool	b_sharedMemory_get()	const {return b_sharedMemory;};
+	int	entries_get()		const {return v_index.size();};
+	bool	b_isOpen()		const
+			{return e_mode==e_containerWrite ? fd>=0 : pch_map!=NULL;};
+	e_CONTAINERENCODING	e_encoding_get()	const {return e_encoding;};
+	void	e_encoding_set(e_CONTAINERENCODING ae_encoding)
+			{ e_encoding = ae_encoding;};
+	int	threads_get()		const {return threads;};
+	void	threads_set(int a_threads)
+			{ threads = a_threads > 0 ? a_threads : 1;};
+
+        //
+        // miscellaneous block
+        //
+	const s_containerEntry*	entry_find(	int		a_channel,
+						int		a_echo,
+						int		a_repetition) const;
+
+	bool			volume_write(	int		a_channel,
+						int		a_echo,
+						int		a_repetition,
+						CVol<GSL_complex_float>*
+								apVl);
+	CVol<GSL_complex_float>*
+				volume_read(	int		a_channel,
+						int		a_echo,
+						int		a_repetition);
+	bool			close();
+
+	//
+	// Compressed payloads
+	//
+	bool			payload_encode(	s_containerEntry&	a_entry,
+						CVol<GSL_complex_float>*
+									apVl);
+	bool			payload_decode(	const s_containerEntry*	apentry,
+						CVol<GSL_complex_float>*
+									apVl);
+	bool			chunks_process(	CVol<GSL_complex_float>*
+									apVl,
+						vector<s_containerChunk>&
+									av_chunks,
+						vector<unsigned char*>&
+									av_buffers,
+						const char*		apch_payload);
+	static void*		chunk_thread(	void*			apv_jobs);
+
+	//
+	// Fingerprinting, used to key caches of unpacked data. Hashes are
+	//	64 bit FNV-1a.
+	//
+	static unsigned long long
+				hash_update(	unsigned long long	a_hash,
+						const void*		apv_data,
+						size_t			a_bytes);
+	static unsigned long long
+				hash_update(	unsigned long long	a_hash,
+						string			astr);
+	static unsigned long long
+				file_fingerprint(
+						string			astr_fileName,
+						unsigned long long	a_hash);
+	static string		hash_str(	unsigned long long	a_hash);
+
+};
+
+}
+
+#endif //__C_CONTAINER_H__
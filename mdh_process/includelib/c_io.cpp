@@ -11,9 +11,16 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <cerrno>
 #include <c_io.h>
 using namespace std;
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "c_adcpack.h"
 using namespace mdh;
 
@@ -177,6 +184,9 @@ C_IO::core_construct(
     // 04 November 2003
     //  o Added e_byteOrder
     //
+    // 19 October 2026
+    //  o Added slab writer state.
+    //
 
     str_name                    = astr_name;
     id                          = a_id;
@@ -188,6 +198,12 @@ C_IO::core_construct(
 
     e_byteOrder                 = e_littleEndian;
 
+    IOthreads			= 1;
+    slabSlices			= 1;
+    slabNext			= 0;
+    slabTotal			= 0;
+    pthread_mutex_init(&mutex_slab, NULL);
+
     str_obj                     = "C_IO";
     
 }
@@ -264,6 +280,7 @@ C_IO::~C_IO() {
 
 //    cout << "In base C_IO destructor" << endl;
     delete	pVl_extracted;
+    pthread_mutex_destroy(&mutex_slab);
 }
 
 void
@@ -367,7 +384,368 @@ C_IO::envSynchronise(
     
     pCadcPack		= apCadcPack;
     e_byteOrder		= pCadcPack->pc_dimension_get()->e_byteOrder_get();
+    IOthreads		= pCadcPack->pc_dimension_get()->IOthreads_get();
+    if(IOthreads <= 0)
+	IOthreads	= (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(IOthreads <= 0)
+	IOthreads	= 1;
+
+}
+
+//
+// The per-thread argument of the slab writer.
+//
+typedef struct _slabJob {
+    C_IO*		pCIO;		// object being saved
+    int			fd;		// file descriptor to pwrite() to
+    off_t		offset;		// file offset of output slice 0
+    bool		b_ok;		// false if any write failed
+} s_slabJob;
+
+long
+C_IO::slab_convert(
+    char*		apch_buffer,
+    int			a_sliceStart,
+    int			a_sliceEnd
+) {
+    //
+    // DESC
+    //	Default slab conversion: formats that want to use the slab writer
+    //	must override this (and slice_size()).
+    //
+    // POSTCONDITIONS
+    //	o Returns -1. This runs on the writer threads, so the failure is
+    //	  only flagged here, and reported by slabs_write().
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Flags the failure rather than error()ing from a writer thread.
+    //
+
+    return -1;
+}
+
+bool
+C_IO::slab_next(
+    int&		a_sliceStart,
+    int&		a_sliceEnd
+) {
+    //
+    // ARGS
+    //	a_sliceStart		out		first output slice of the slab
+    //	a_sliceEnd		out		one past the last slice
+    //
+    // DESC
+    //	Hands out the next slab of the current slabs_write() to a writer
+    //	thread.
+    //
+    // POSTCONDITIONS
+    //	o Returns false if there are no more slabs.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    bool	b_ret	= false;
+
+    pthread_mutex_lock(&mutex_slab);
+    if(slabNext < slabTotal) {
+	a_sliceStart	= slabNext;
+	a_sliceEnd	= slabNext + slabSlices;
+	if(a_sliceEnd > slabTotal)
+	    a_sliceEnd	= slabTotal;
+	slabNext	= a_sliceEnd;
+	b_ret		= true;
+    }
+    pthread_mutex_unlock(&mutex_slab);
+    return b_ret;
+}
+
+void*
+C_IO::slab_thread(
+    void*		apv_job
+) {
+    //
+    // ARGS
+    //	apv_job			in/out		s_slabJob of this thread
+    //
+    // DESC
+    //	Body of a single slab writer thread. Slabs are pulled off the
+    //	shared queue, converted into a private buffer and pwrite()n
+    //	to their final offset until the queue is empty.
+    //
+    // NOTE
+    //	o No debug_push()/error() calls are made from here, since those
+    //	  are not thread safe. Failures are flagged in the job instead.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    s_slabJob*	pjob		= (s_slabJob*) apv_job;
+    C_IO*	pCIO		= pjob->pCIO;
+    long	sliceBytes	= pCIO->slice_size();
+    char*	pch_buffer	= new char [sliceBytes * pCIO->slabSlices];
+    int		sliceStart, sliceEnd;
+    long	bytes, written;
+    ssize_t	ret;
+
+    while(pCIO->slab_next(sliceStart, sliceEnd)) {
+	bytes	= pCIO->slab_convert(pch_buffer, sliceStart, sliceEnd);
+	if(bytes < 0) {
+	    pjob->b_ok	= false;
+	    break;
+	}
+	written	= 0;
+	while(written < bytes) {
+	    ret	= pwrite(pjob->fd, pch_buffer + written, bytes - written,
+			 pjob->offset + (off_t) sliceStart * sliceBytes + written);
+	    if(ret <= 0)
+		break;
+	    written	+= ret;
+	}
+	if(written != bytes) {
+	    pjob->b_ok	= false;
+	    break;
+	}
+    }
+
+    delete [] pch_buffer;
+    return NULL;
+}
+
+bool
+C_IO::slabs_write(
+    int			a_fd,
+    off_t		a_offset,
+    int			a_slices
+) {
+    //
+    // ARGS
+    //	a_fd			in		open file to write to
+    //	a_offset		in		file offset of output slice 0
+    //	a_slices		in		number of output slices
+    //
+    // DESC
+    //	Converts and writes <a_slices> output slices of the current volume
+    //	to <a_fd>, starting at <a_offset>.
+    //
+    //	The slices are split into slabs, and IOthreads threads each convert
+    //	slabs into a private buffer and pwrite() them at their precomputed
+    //	offset. Since every slab has a fixed position in the file there is
+    //	no ordering between threads, and no shared file position.
+    //
+    // PRECONDITIONS
+    //	o slice_size() and slab_convert() are implemented by the derived
+    //	  class.
+    //
+    // POSTCONDITIONS
+    //	o Returns false if any slab could not be converted or written.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("slabs_write(...)");
+
+    int		threads		= IOthreads;
+    int		i;
+    bool	b_ret		= true;
+
+    if(slice_size() <= 0) {
+	warn("Slab writing is not supported by " + str_obj, 1);
+	debug_pop();
+	return false;
+    }
+
+    if(threads < 1)
+	threads		= 1;
+    if(threads > a_slices)
+	threads		= a_slices > 0 ? a_slices : 1;
+
+    slabNext		= 0;
+    slabTotal		= a_slices;
+    slabSlices		= a_slices / (threads * C_IO_SLABSPERTHREAD);
+    if(slabSlices < 1)
+	slabSlices	= 1;
+
+    // One job per thread. The calling thread is the last of the
+    //	<threads> workers, so only threads-1 are spawned.
+    s_slabJob*	pjobs		= new s_slabJob [threads];
+    pthread_t*	pthreads	= new pthread_t [threads];
+    bool*	pb_started	= new bool [threads];
+
+    for(i=0; i<threads; i++) {
+	pjobs[i].pCIO		= this;
+	pjobs[i].fd		= a_fd;
+	pjobs[i].offset		= a_offset;
+	pjobs[i].b_ok		= true;
+	pb_started[i]		= false;
+    }
+    for(i=0; i<threads-1; i++)
+	pb_started[i]	= !pthread_create(&pthreads[i], NULL,
+					  C_IO::slab_thread, &pjobs[i]);
+    // If some threads could not be started, the calling thread simply
+    //	drains more of the slab queue itself.
+    slab_thread(&pjobs[threads-1]);
+
+    for(i=0; i<threads; i++) {
+	if(pb_started[i])
+	    pthread_join(pthreads[i], NULL);
+	if(!pjobs[i].b_ok)
+	    b_ret	= false;
+    }
+
+    delete [] pjobs;
+    delete [] pthreads;
+    delete [] pb_started;
+
+    debug_pop();
+    return b_ret;
+}
+
+bool
+C_IO::frameSave(
+    string		astr_fileName,
+    int			a_frame,
+    int			a_frames
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		multi-frame file to write to
+    //	a_frame			in		frame index of the current volume
+    //	a_frames		in		total frames in the file
+    //
+    // DESC
+    //	Default for formats that have no notion of frames.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("frameSave(...)");
+    warn("Multi-frame save is not supported by " + str_obj, 1);
+    debug_pop();
+    return false;
+}
+
+bool
+C_IO::frameLoad(
+    string		astr_fileName,
+    int			a_frame
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		multi-frame file to read from
+    //	a_frame			in		frame index to load
+    //
+    // DESC
+    //	Default for formats that have no notion of frames.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("frameLoad(...)");
+    warn("Multi-frame load is not supported by " + str_obj, 1);
+    debug_pop();
+    return false;
+}
+
+void
+C_IO::readOut_range(
+    int&		a_readOutStart,
+    int&		a_readOutEnd
+) {
+    //
+    // ARGS
+    //	a_readOutStart		out		first readOut line to save
+    //	a_readOutEnd		out		one past the last readOut line
+    //
+    // DESC
+    //	Determines the readOut range that the writers save (and the
+    //	loaders read back), taking into account the readOut crop.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of save().
+    //	o Moved up from C_IO_mgh and C_IO_analyze75, for all formats.
+    //
+
+    a_readOutStart	= 0;
+    a_readOutEnd	= pVl_extracted->rows_get();
+    if(pCadcPack->b_readOutCrop_get()) {
+	a_readOutStart	= a_readOutEnd / 4;
+	a_readOutEnd	= (int) (0.75 * a_readOutEnd);
+    }
+}
+
+char*
+C_IO::file_map(
+    string		astr_fileName,
+    size_t&		a_size
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		file to map
+    //	a_size			out		size of the mapping
+    //
+    // DESC
+    //	Maps an existing file read-only into memory. The loaders decode
+    //	voxels directly from the mapping, so no intermediate read buffer
+    //	(and no extra copy of the file) is needed.
+    //
+    // POSTCONDITIONS
+    //	o Returns the start of the mapping, or NULL if the file could not
+    //	  be accessed. Release with file_unmap().
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("file_map(...)");
+
+    char*		pch_map		= NULL;
+    struct stat		st_file;
+
+    a_size	= 0;
+    int	fd	= open(astr_fileName.c_str(), O_RDONLY);
+    if(fd < 0) {
+	warn("Could not open " + astr_fileName, 1);
+	debug_pop();
+	return NULL;
+    }
+    if(!fstat(fd, &st_file) && st_file.st_size > 0) {
+	pch_map	= (char*) mmap(NULL, st_file.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(pch_map == MAP_FAILED)
+	    pch_map	= NULL;
+	else {
+	    a_size	= st_file.st_size;
+	    madvise(pch_map, a_size, MADV_SEQUENTIAL);
+	}
+    }
+    close(fd);
+    if(!pch_map)
+	warn("Could not map " + astr_fileName, 1);
+
+    debug_pop();
+    return pch_map;
+}
 
+void
+C_IO::file_unmap(
+    char*		apch_map,
+    size_t		a_size
+) {
+    if(apch_map)
+	munmap(apch_map, a_size);
 }
 
 //
@@ -456,170 +834,78 @@ C_IO_mgh::~C_IO_mgh() {
 // Misc access block
 //
 
-bool	
-C_IO_mgh::save(string astr_fileName) 
+long
+C_IO_mgh::frame_size()
 {
-    //
-    // ARGS
-    //	astr_fileName			in		fileName to save volume to
     //
     // DESC
-    //	This method is pretty much a direct port of Doug Greve's save_mgh.m matlab
-    //	script. It's main purpose is to save a volume to disk in "MGH" format.
-    //
-    // PRECONDITIONS
-    //	pM_vox2ras			member		4x4 transformation matrix
-    //	pM_MRIParams			member		MRI parameters:
-    //								[tr flipangle te ti]
-    //	b_realImag			member		flag defining whether or not
-    //								to save real or imag
-    //								component of the volume.
-    //
-    //	o The vox2ras and MRIParams matrices are calculated externally to this
-    //	  method and simply accessed as class members
-    //	o Note that within this class, volumes are spec'd as
-    //		[row col slice]
-    //	o Eventhough MatLAB saves matrices in COLUMN-order, data is saved by this
-    //	  method in ROW-order - the assumption being that data streaming directly
-    //	  off the scanner is in ROW-order.
-    //	o The b_realImag flag denotes which part of the complex volume to save.
-    //		false:	save the real part
-    //		true:	save the imag part
-    //	  
-    //
-    // POSTCONDITIONS
-    //	o The "current" volume class is saved to disk in MGH format. Note that, unlike
-    //	  the original MatLAB script, this method only saves individual 3D volumes. To
-    //	  save an entire pAz_data type MArray class, extract target repetitions/echoes into
-    //	  volumes and save the volumes individually.
-    //
-    // NOTE
-    //	o fwrite is used instead of fprintf since fwrite streams BINARY while fprintf
-    //	  would stream formatted (human readable).
-    //	o Linux on intel is *little endian*!
-    //
-    // SEE ALSO
-    //	save_mgh.m under /space/repo/1/dev/dev/matlab/save_mgh.m
+    //	Returns the size in bytes of the voxel data of a single frame.
     //
     // HISTORY
-    // 22 September 2003
+    // 19 October 2026
     //	o Initial design and coding.
     //
-    // 25 September 2003
-    //	o Added byte swap code (from machine.h/c). Each data value is either individually swapped 
-    //	  or a whole buffer is swapped using the ByteSwapN(..) functions. Be aware that the number
-    //	  of items refers to the actual single byte count!
-    //
-    // 05 October 2003
-    //	o Encapsulation within C_IO_mgh class.
-    //
-    // 20 October 2003
-    //	o After a long and labourious debugging effort, the indices of the "vol unpack"
-    //	  loops were tweaked until the final mgh files were practically byte compatible
-    //	  with the same files as filtered by MatLAB. There are minor differences, though.
-    //	  In a typical test example (of say a 55 MB raw data file), about 12 bytes might be
-    //	  different between two 4.1 MB output mgh files (one generated by MatLAB, one by
-    //    the C++ unpack code). This is most likely to small rounding errors/differences
-    //	  between MatLAB fft code and MKL code.
+
+    int		readOutStart, readOutEnd;
+
+    readOut_range(readOutStart, readOutEnd);
+    return (long) pVl_extracted->cols_get() * (readOutEnd - readOutStart) *
+		  pVl_extracted->slices_get() * sizeof(float);
+}
+
+int
+C_IO_mgh::header_build(
+    char*		apch_header,
+    int			a_nframes	/*= 1	*/
+) {
     //
-    // 12 December 2003
-    //  o Added magnitude / phase saving capability.
+    // ARGS
+    //	apch_header		out		buffer of at least MGH_HEADER_SIZE
+    //						bytes
+    //	a_nframes		in		number of frames in the file
     //
-    // 25 February 2004
-    //	o Added readOut crop capability - NB! dimensions need to be changed if cropped!
+    // DESC
+    //	Builds the (big endian) MGH header, i.e. everything that precedes
+    //	the voxel data, in memory.
     //
+    // POSTCONDITIONS
+    //	o Returns the number of header bytes, i.e. MGH_HEADER_SIZE.
     //
-    // NOTES
-    //	NB! NB! NB!
-    //	tkmedit assumes a very specific dimension ordering when parsing the mgh files!
-    //	as well as the dimension labelling:
-    //	o ndim1:	slices		( partitions )
-    //	o ndim2:	rows		( ReadOut )
-    //	o ndim3:	cols		( PhaseEncode )
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of save(), with the addition of a_nframes.
     //
 
-    debug_push("save(...)");
-    
+    debug_push("header_build(...)");
+
     if(!pM_vox2ras->compatible(4, 4))
 	error("Passed vox2ras matrix is not 4x4! Has it been properly initialised?", 1);
-    
-    FILE*	pFILE_stream;
-    const	int		MRI_UCHAR	= 0;
-    const	int		MRI_INT	        = 1;
-    const	int		MRI_LONG	= 2;
+
     const	int		MRI_FLOAT	= 3;
-    const	int		MRI_SHORT	= 4;
-    const	int		MRI_BITMAP	= 5;
-    const	int		MRI_TENSOR	= 6;
-    
-    const	int		UNUSED_SPACE_SIZE	= 256;
     const	int 		USED_SPACE_SIZE		= (3*4 + 4*3*4);
-    
+
     int				ndim1, ndim2, ndim3;
-    int				i, j, k;
-    
+    int				i, j;
+    int				readOutStart, readOutEnd;
+    int*			p_header	= (int*) apch_header;
+    float			pf_buffer[16];
+    short			s_rasGood;
 
-    // Note that the "binary" spec is ignored in POSIX systems
-    //	from fopen(3):
-    //	This is strictly for compatibility with ANSI X3.159-1989 (``ANSI C'') and has 
-    //  no effect; the ``b'' is ignored on all POSIX conforming systems, including Linux.
-    if((pFILE_stream = fopen(astr_fileName.c_str(), "wb")) == NULL) 
-	error("Could not open MGH file:spaceVolume " + astr_fileName, 1);
-    
-    // Allocate an int buffer
-    char*	pch_buffer	= new char      [1024];
-    short*	ps_buffer	= new short	[1024];
-    int*	p_buffer	= new int       [1024];
-    float*	pf_buffer	= new float     [1024];
-    double*	pv_buffer	= new double    [1024];
-        
-    //	Dump a magic number
-    p_buffer[0]		= 1;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-    fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
-    
-    int			readOutStart	= 0;
-    int			readOutEnd	= pVl_extracted->rows_get();
-    float               f_readOutScale  = 1.0;
-    if(pCadcPack->b_readOutCrop_get()) {
-	readOutStart	= readOutEnd / 4;
-	readOutEnd	= (int) (0.75 * readOutEnd);
-	f_readOutScale  = 0.5;
-    }
-        
-    // dimension 0
+    readOut_range(readOutStart, readOutEnd);
     ndim1		= pVl_extracted->cols_get();
-    p_buffer[0]		= ndim1;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-        fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
-        
-    // dimension 1
-    ndim2		= (int) (pVl_extracted->rows_get() * f_readOutScale);
-    p_buffer[0]		= ndim2;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-    fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
-    
-    // dimension 2
+    ndim2		= readOutEnd - readOutStart;
     ndim3		= pVl_extracted->slices_get();
-    p_buffer[0]		= ndim3;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-    fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
-
-    // dimension 3 - not used. Write a '1' to tell MatLAB this is a singleton
-    //	dimension
-    p_buffer[0]		= 1;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-    fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
-
-    // Float data to follow...
-    p_buffer[0]		= MRI_FLOAT;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-    fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
-
-    // dof
-    p_buffer[0]		= 1;
-    p_buffer[0]		= swapInt(p_buffer[0]);
-    fwrite(p_buffer, sizeof(int), 1, pFILE_stream);
+
+    memset(apch_header, 0, MGH_HEADER_SIZE);
+
+    // magic number, dimensions, nframes, data type and dof
+    p_header[0]		= swapInt(1);
+    p_header[1]		= swapInt(ndim1);
+    p_header[2]		= swapInt(ndim2);
+    p_header[3]		= swapInt(ndim3);
+    p_header[4]		= swapInt(a_nframes);
+    p_header[5]		= swapInt(MRI_FLOAT);
+    p_header[6]		= swapInt(1);
 
     CMatrix<double>*    pM_trns3x3              = new CMatrix<double>(3, 3);
     CMatrix<double>*    pM_trns3x3sq            = new CMatrix<double>(3, 3);
@@ -651,89 +937,103 @@ C_IO_mgh::save(string astr_fileName)
     V_xyzC.matrix_remove(	pV_xyz,
 				0, 0,
 				3, 1);
-								
-    /*
-    M_delta.print("M_delta");
-    M_trns3x3Scaled.print("M_trns3x3Scaled");
-    V_xyzC.print("V_xyzC");
-    */
 
     // ras_good_flag
-    ps_buffer[0]		= 1;
-    ps_buffer[0]		= swapShort(ps_buffer[0]);
-    fwrite(ps_buffer, sizeof(short), 1, pFILE_stream);
+    s_rasGood		= swapShort(1);
+    memcpy(apch_header + 7*sizeof(int), &s_rasGood, sizeof(short));
 
-    // M_delta matrix: Only the first three values along the first row
+    // M_delta matrix: Only the first three values along the first row,
+    //	followed by M_trns3x3Scaled (column order) and V_xyzC
     for(i=0; i<3; i++)
 	pf_buffer[i]    = M_delta(0, i);
-    ByteSwap4(pf_buffer, 3*4);
-    fwrite(pf_buffer, sizeof(float), 3, pFILE_stream);
-
-    // M_trns3x3Scaled
-    int	 rows	= M_trns3x3Scaled.rows_get();
-    int	 cols	= M_trns3x3Scaled.cols_get();
-    for(j=0; j<cols; j++)
-	for(i=0; i<rows; i++)
-	    pf_buffer[j*rows+i]	= M_trns3x3Scaled(i, j);
-    ByteSwap4(pf_buffer, rows*cols*4);
-    fwrite(pf_buffer, sizeof(float), rows*cols, pFILE_stream);
-
-    // V_xyzC
-    rows	= pV_xyz->rows_get();
-    for(i=0; i<rows; i++)
-	pf_buffer[i]		= pV_xyz->val(i, 0);
-    ByteSwap4(pf_buffer, rows*4);
-    fwrite(pf_buffer, sizeof(float), rows, pFILE_stream);
-
-    // Unused space
-    for(i=0; i<(UNUSED_SPACE_SIZE-2)-USED_SPACE_SIZE; i++)
-	pch_buffer[i]	= 0;
-    fwrite(pch_buffer, sizeof(char), i, pFILE_stream);
-
-    int bk = 0;
+    for(j=0; j<3; j++)
+	for(i=0; i<3; i++)
+	    pf_buffer[3+j*3+i]	= M_trns3x3Scaled(i, j);
+    for(i=0; i<3; i++)
+	pf_buffer[12+i]		= pV_xyz->val(i, 0);
+    ByteSwap4(pf_buffer, USED_SPACE_SIZE);
+    memcpy(apch_header + 7*sizeof(int) + sizeof(short), pf_buffer, USED_SPACE_SIZE);
 
-    // Now, finally, the actual volume itself!
-    //	These indices were selected to be as byte-identical as possible to
-    //	the same files as produced by MatLAB.
-    delete [] pf_buffer;
-    int	                bufCount        = 0;
-    double              v_mag           = 0.0;
-    double              v_phase         = 0.0;
-    pf_buffer           = new float [ndim1 * ndim2 * ndim3];
+    // The remainder of the header is unused space, already zeroed.
+
+    delete      pM_trns3x3;
+    delete	pM_trns3x3sq;
+    delete 	pV_xyz;
 
+    debug_pop();
+    return MGH_HEADER_SIZE;
+}
+
+int
+C_IO_mgh::voxels_convert(
+    float*		apf_buffer,
+    int			a_sliceStart,
+    int			a_sliceEnd
+) {
     //
-    // The core "write" loop. The nesting order of the loops, as well as the order
-    //  in which the dimension sizes (ndim1, ndim2, ndim3) are written to disk, is
-    //  of *critical* importance.
-    //  
-    //          o Whichever order is used in this nested looping, the dimension
-    //            sizes should be saved in inverse order. Thus, if the loop ordering  
-    //            from outer to inner is 'k, i, j', the dimension size spec is 
+    // ARGS
+    //	apf_buffer		out		buffer to receive (big endian)
+    //						voxel data
+    //	a_sliceStart		in		first *output* slice to convert
+    //	a_sliceEnd		in		one past the last output slice
+    //
+    // DESC
+    //	Converts a range of slices of the volume to the e_iotype component
+    //	in MGH voxel order.
+    //
+    //	Output slices are numbered in the order in which they appear in the
+    //	file, i.e. output slice 0 is volume slice (slices-1) - see below.
+    //
+    // POSTCONDITIONS
+    //	o Returns the number of floats written to apf_buffer.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of save(), with the addition of the slice range.
+    //
+
+    int			i, j, k;
+    int			readOutStart, readOutEnd;
+    int			bufCount	= 0;
+    double		v_mag		= 0.0;
+    double		v_phase		= 0.0;
+    int			slices		= pVl_extracted->slices_get();
+
+    readOut_range(readOutStart, readOutEnd);
+
+    //
+    // The core "write" loop. The nesting order of the loops, as well as the order
+    //  in which the dimension sizes (ndim1, ndim2, ndim3) are written to disk, is
+    //  of *critical* importance.
+    //
+    //          o Whichever order is used in this nested looping, the dimension
+    //            sizes should be saved in inverse order. Thus, if the loop ordering
+    //            from outer to inner is 'k, i, j', the dimension size spec is
     //            written in  'j, i, k' order.
     //
     //          o The slice 'k' and column 'j' data is written in "inverse" order.
     //            This is because the scanner operates in LPS coordinates, while
-    //            we are interested in RAS order. Thus, L becomes -R (i.e. the 
+    //            we are interested in RAS order. Thus, L becomes -R (i.e. the
     //            slices, k, are inverted) and P becomes -A (posterior/anterior,
     //            i.e. the columns, j, are inverted).
     //
-        
-    for(k=pVl_extracted->slices_get()-1; k>=0; k--) {
+
+    for(k=slices-1-a_sliceStart; k>slices-1-a_sliceEnd; k--) {
         for(i=readOutStart; i<readOutEnd; i++) {
             for(j=pVl_extracted->cols_get()-1; j>=0; j--) {
                 switch(e_iotype) {
                     case e_imaginary:
-		        pf_buffer[bufCount++]	=	GSL_IMAG(pVl_extracted->val(i, j, k));
+		        apf_buffer[bufCount++]	=	GSL_IMAG(pVl_extracted->val(i, j, k));
                         break;
                     case e_real:
-		        pf_buffer[bufCount++]	= 	GSL_REAL(pVl_extracted->val(i, j, k));
+		        apf_buffer[bufCount++]	= 	GSL_REAL(pVl_extracted->val(i, j, k));
                         break;
                     case e_magnitude:
                         v_mag = sqrt(
 		            GSL_REAL(pVl_extracted->val(i, j, k)) * GSL_REAL(pVl_extracted->val(i, j, k)) +
 		            GSL_IMAG(pVl_extracted->val(i, j, k)) * GSL_IMAG(pVl_extracted->val(i, j, k))
 		        );
-                        pf_buffer[bufCount++]   = (float) v_mag;
+                        apf_buffer[bufCount++]   = (float) v_mag;
                         break;
                     case e_phase:
                         if(GSL_REAL(pVl_extracted->val(i, j, k))) {
@@ -743,51 +1043,496 @@ C_IO_mgh::save(string astr_fileName)
                             );
                         } else
                             v_phase     = 0.0;
-                        pf_buffer[bufCount++]   = (float) v_phase;
+                        apf_buffer[bufCount++]   = (float) v_phase;
                         break;
                 }
 	    }
 	}
     }
 
-    ByteSwap4(pf_buffer, bufCount*4);
-    fwrite(pf_buffer, sizeof(float), bufCount, pFILE_stream);
+    ByteSwap4(apf_buffer, bufCount*4);
+    return bufCount;
+}
+
+long
+C_IO_mgh::slice_size()
+{
+    //
+    // DESC
+    //	Size in bytes of a single converted output slice.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    return frame_size() / pVl_extracted->slices_get();
+}
+
+long
+C_IO_mgh::slab_convert(
+    char*		apch_buffer,
+    int			a_sliceStart,
+    int			a_sliceEnd
+) {
+    //
+    // ARGS
+    //	apch_buffer		out		buffer to receive the slab
+    //	a_sliceStart		in		first output slice of the slab
+    //	a_sliceEnd		in		one past the last slice
+    //
+    // DESC
+    //	Slab writer hook: simply voxels_convert() on a range of slices.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    return voxels_convert((float*) apch_buffer, a_sliceStart, a_sliceEnd)
+		* sizeof(float);
+}
+
+int
+C_IO_mgh::MRIParams_build(
+    float*		apf_buffer
+) {
+    //
+    // ARGS
+    //	apf_buffer		out		buffer of at least 4 floats
+    //
+    // DESC
+    //	Builds the (big endian) MRI parameter block that trails the
+    //	voxel data.
+    //
+    // POSTCONDITIONS
+    //	o Returns the number of floats written.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Factored out of save().
+    //
+
+    int		i;
 
-    // And at the very end, the MRIParams
     for(i=0; i<pV_MRIParamsEcho->cols_get(); i++) {
-	pf_buffer[i] = pV_MRIParamsEcho->val(0, i);
+	apf_buffer[i] = pV_MRIParamsEcho->val(0, i);
         // Need to convert units, as well as do a degrees->radian
         switch(i) {
             case 0:
             case 2:
             case 3:
-                pf_buffer[i] /= 1000.0;
+                apf_buffer[i] /= 1000.0;
             break;
             case 1:
-                pf_buffer[i]*=M_PI/180;
+                apf_buffer[i]*=M_PI/180;
             break;
         }
     }
-    ByteSwap4(pf_buffer, i*4);
-    fwrite(pf_buffer, sizeof(float), i, pFILE_stream);
+    ByteSwap4(apf_buffer, i*4);
+    return i;
+}
 
-    fflush(pFILE_stream);
-    fclose(pFILE_stream);
+bool
+C_IO_mgh::save(string astr_fileName)
+{
+    //
+    // ARGS
+    //	astr_fileName			in		fileName to save volume to
+    //
+    // DESC
+    //	This method is pretty much a direct port of Doug Greve's save_mgh.m matlab
+    //	script. It's main purpose is to save a volume to disk in "MGH" format.
+    //
+    // PRECONDITIONS
+    //	pM_vox2ras			member		4x4 transformation matrix
+    //	pM_MRIParams			member		MRI parameters:
+    //								[tr flipangle te ti]
+    //	b_realImag			member		flag defining whether or not
+    //								to save real or imag
+    //								component of the volume.
+    //
+    //	o The vox2ras and MRIParams matrices are calculated externally to this
+    //	  method and simply accessed as class members
+    //	o Note that within this class, volumes are spec'd as
+    //		[row col slice]
+    //	o Eventhough MatLAB saves matrices in COLUMN-order, data is saved by this
+    //	  method in ROW-order - the assumption being that data streaming directly
+    //	  off the scanner is in ROW-order.
+    //	o The b_realImag flag denotes which part of the complex volume to save.
+    //		false:	save the real part
+    //		true:	save the imag part
+    //	  
+    //
+    // POSTCONDITIONS
+    //	o The "current" volume class is saved to disk in MGH format. Note that, unlike
+    //	  the original MatLAB script, this method only saves individual 3D volumes. To
+    //	  save an entire pAz_data type MArray class, extract target repetitions/echoes into
+    //	  volumes and save the volumes individually.
+    //
+    // NOTE
+    //	o fwrite is used instead of fprintf since fwrite streams BINARY while fprintf
+    //	  would stream formatted (human readable).
+    //	o Linux on intel is *little endian*!
+    //
+    // SEE ALSO
+    //	save_mgh.m under /space/repo/1/dev/dev/matlab/save_mgh.m
+    //
+    // HISTORY
+    // 22 September 2003
+    //	o Initial design and coding.
+    //
+    // 25 September 2003
+    //	o Added byte swap code (from machine.h/c). Each data value is either individually swapped 
+    //	  or a whole buffer is swapped using the ByteSwapN(..) functions. Be aware that the number
+    //	  of items refers to the actual single byte count!
+    //
+    // 05 October 2003
+    //	o Encapsulation within C_IO_mgh class.
+    //
+    // 20 October 2003
+    //	o After a long and labourious debugging effort, the indices of the "vol unpack"
+    //	  loops were tweaked until the final mgh files were practically byte compatible
+    //	  with the same files as filtered by MatLAB. There are minor differences, though.
+    //	  In a typical test example (of say a 55 MB raw data file), about 12 bytes might be
+    //	  different between two 4.1 MB output mgh files (one generated by MatLAB, one by
+    //    the C++ unpack code). This is most likely to small rounding errors/differences
+    //	  between MatLAB fft code and MKL code.
+    //
+    // 12 December 2003
+    //  o Added magnitude / phase saving capability.
+    //
+    // 25 February 2004
+    //	o Added readOut crop capability - NB! dimensions need to be changed if cropped!
+    //
+    // 19 October 2026
+    //	o Split into header_build(), voxels_convert() and MRIParams_build() so
+    //	  that the same building blocks can be used by frameSave().
+    //	o Voxel data is converted and pwrite()n in parallel slabs (see
+    //	  C_IO::slabs_write()), rather than through a single FILE*.
+    //
+    //
+    // NOTES
+    //	NB! NB! NB!
+    //	tkmedit assumes a very specific dimension ordering when parsing the mgh files!
+    //	as well as the dimension labelling:
+    //	o ndim1:	slices		( partitions )
+    //	o ndim2:	rows		( ReadOut )
+    //	o ndim3:	cols		( PhaseEncode )
+    //
 
-    delete []	pch_buffer;
-    delete []	ps_buffer;
-    delete []	p_buffer;
-    delete [] 	pf_buffer;
-    delete []	pv_buffer;
-    delete      pM_trns3x3;
-    delete	pM_trns3x3sq;
-    delete 	pV_xyz;
+    debug_push("save(...)");
+
+    long	frameBytes	= frame_size();
+    off_t	fileSize	= MGH_HEADER_SIZE + frameBytes + MGH_MRIPARAMS_SIZE;
+    bool	b_ret		= true;
+    int		bufCount;
+    float	pf_params[4];
+    char*	pch_header	= new char [MGH_HEADER_SIZE];
+
+    int	fd	= open(astr_fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+	error("Could not open MGH file:spaceVolume " + astr_fileName, 1);
+    if(ftruncate(fd, fileSize)) {
+	close(fd);
+	error("Could not preallocate MGH file " + astr_fileName, 1);
+    }
+
+    header_build(pch_header, 1);
+    if(pwrite(fd, pch_header, MGH_HEADER_SIZE, 0) != MGH_HEADER_SIZE)
+	b_ret	= false;
+
+    // Now, finally, the actual volume itself!
+    if(!slabs_write(fd, MGH_HEADER_SIZE, pVl_extracted->slices_get()))
+	b_ret	= false;
+
+    // And at the very end, the MRIParams
+    bufCount	= MRIParams_build(pf_params);
+    if(pwrite(fd, pf_params, bufCount*sizeof(float), MGH_HEADER_SIZE + frameBytes)
+	    != (ssize_t) (bufCount*sizeof(float)))
+	b_ret	= false;
+
+    if(close(fd))
+	b_ret	= false;
+    if(!b_ret)
+	warn("Problem encountered writing " + astr_fileName, 1);
+
+    delete []	pch_header;
     debug_pop();
+    return b_ret;
+}
+
+bool
+C_IO_mgh::frameSave(
+    string		astr_fileName,
+    int			a_frame,
+    int			a_frames
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		multi-frame file to write to
+    //	a_frame			in		frame index of the current volume
+    //	a_frames		in		total frames in the file
+    //
+    // DESC
+    //	Writes the current volume as frame <a_frame> of a multi-frame
+    //	(nframes = a_frames) MGH file.
+    //
+    //	The first frame of a run to go to a file truncates it, whatever
+    //	was there before, preallocates it to its final size and writes
+    //	its header. The file then stays open for the frames that follow,
+    //	until frameFiles_close(). The frame data itself is written by the
+    //	slab writer at its final offset, so frames can arrive in any
+    //	order, as soon as each is reconstructed.
+    //
+    // PRECONDITIONS
+    //	o All frames share the same dimensions.
+    //
+    // POSTCONDITIONS
+    //	o MGH has a single set of MRI parameters per file. The trailer
+    //	  holds those of frame 0, i.e. the TE of the first echo. Frames
+    //	  run over the echoes fastest, so frame <f> of a file with <e>
+    //	  echoes has the TE of echo <f> % <e>.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o The file is kept open across frames, and always initialised
+    //	  by the first frame of a run.
+    //
+
+    debug_push("frameSave(...)");
+
+    long	frameBytes	= frame_size();
+    off_t	fileSize	= MGH_HEADER_SIZE + (off_t) a_frames * frameBytes
+				  + MGH_MRIPARAMS_SIZE;
+    bool	b_new;
+    bool	b_ret		= true;
+    int		bufCount;
+    float	pf_params[4];
+    int		fd;
+
+    if(a_frame < 0 || a_frame >= a_frames)
+	error("Frame index out of range for " + astr_fileName, 1);
+
+    map<string, int>::iterator	it_file	= map_frameFiles.find(astr_fileName);
+    b_new	= (it_file == map_frameFiles.end());
+    if(!b_new)
+	fd	= it_file->second;
+    else {
+	char*	pch_header	= new char [MGH_HEADER_SIZE];
+	fd	= open(astr_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0) {
+	    delete [] pch_header;
+	    error("Could not open MGH file " + astr_fileName, 1);
+	}
+	if(ftruncate(fd, fileSize)) {
+	    close(fd);
+	    delete [] pch_header;
+	    error("Could not preallocate MGH file " + astr_fileName, 1);
+	}
+	map_frameFiles[astr_fileName]	= fd;
+	header_build(pch_header, a_frames);
+	if(pwrite(fd, pch_header, MGH_HEADER_SIZE, 0) != MGH_HEADER_SIZE)
+	    b_ret	= false;
+	delete [] pch_header;
+    }
+
+    if(b_new || !a_frame) {
+	bufCount	= MRIParams_build(pf_params);
+	if(pwrite(fd, pf_params, bufCount*sizeof(float), fileSize-MGH_MRIPARAMS_SIZE)
+		!= (ssize_t) (bufCount*sizeof(float)))
+	    b_ret	= false;
+    }
+
+    if(!slabs_write(fd, MGH_HEADER_SIZE + (off_t) a_frame * frameBytes,
+		    pVl_extracted->slices_get()))
+	b_ret	= false;
+
+    if(!b_ret)
+	warn("Problem encountered writing frame to " + astr_fileName, 1);
+
+    debug_pop();
+    return b_ret;
+}
+
+map<string, int>	C_IO_mgh::map_frameFiles;
+
+bool
+C_IO_mgh::frameFiles_close() {
+    //
+    // DESC
+    //	Closes the multi-frame files that frameSave() has open.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    bool	b_ret	= true;
+
+    for(map<string, int>::iterator it_file = map_frameFiles.begin();
+	it_file != map_frameFiles.end(); it_file++)
+	if(close(it_file->second))
+	    b_ret	= false;
+    map_frameFiles.clear();
+    return b_ret;
+}
+
+void
+C_IO_mgh::voxels_store(
+    const float*	apf_buffer,
+    int			a_sliceStart,
+    int			a_sliceEnd
+) {
+    //
+    // ARGS
+    //	apf_buffer		in		(big endian) MGH voxel data
+    //	a_sliceStart		in		first *output* slice to store
+    //	a_sliceEnd		in		one past the last output slice
+    //
+    // DESC
+    //	The inverse of voxels_convert(): the e_iotype component read from
+    //	an MGH file is stored back into the volume, with the same slice,
+    //	readOut and column ordering.
+    //
+    //	Since an MGH file only holds a single component, the remaining
+    //	component of each voxel is kept as is. A complex volume is thus
+    //	assembled by loading the real and the imaginary file, in either
+    //	order.
+    //
+    // PRECONDITIONS
+    //	o e_iotype is e_real or e_imaginary - see frameLoad().
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Real/imaginary only.
+    //
+
+    int			i, j, k;
+    int			readOutStart, readOutEnd;
+    long		bufCount	= 0;
+    double		v_val;
+    double		v_real, v_imag;
+    int			slices		= pVl_extracted->slices_get();
+    GSL_complex_float	zv_val;
 
+    readOut_range(readOutStart, readOutEnd);
+
+    for(k=slices-1-a_sliceStart; k>slices-1-a_sliceEnd; k--) {
+        for(i=readOutStart; i<readOutEnd; i++) {
+            for(j=pVl_extracted->cols_get()-1; j>=0; j--) {
+		v_val	= swapFloat(apf_buffer[bufCount++]);
+		v_real	= GSL_REAL(pVl_extracted->val(i, j, k));
+		v_imag	= GSL_IMAG(pVl_extracted->val(i, j, k));
+                switch(e_iotype) {
+                    case e_imaginary:
+			v_imag	= v_val;
+                        break;
+                    default:
+			v_real	= v_val;
+                        break;
+                }
+		GSL_SET_COMPLEX(&zv_val, v_real, v_imag);
+		pVl_extracted->val(i, j, k)	= zv_val;
+	    }
+	}
+    }
 }
 
 bool
-C_IO_mgh::load(string str_fileName) {
+C_IO_mgh::load(string astr_fileName) {
+    //
+    // ARGS
+    //	astr_fileName		in		MGH file to load
+    //
+    // DESC
+    //	Loads the first (possibly only) frame of an MGH file - see
+    //	frameLoad().
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    return frameLoad(astr_fileName, 0);
+}
+
+bool
+C_IO_mgh::frameLoad(
+    string		astr_fileName,
+    int			a_frame
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		MGH file to load
+    //	a_frame			in		frame to load
+    //
+    // DESC
+    //	Loads a single frame of an existing MGH file, as written by save()
+    //	or frameSave(), into the current volume. The file is mmap()ed
+    //	and the voxels decoded straight from the mapping.
+    //
+    // PRECONDITIONS
+    //	o The volume must already be constructed and have the dimensions
+    //	  of the volume that was saved (including the readOut crop).
+    //
+    // POSTCONDITIONS
+    //	o The e_iotype component of the volume is set from the file.
+    //	o Returns false if the file could not be mapped or does not match
+    //	  the volume.
+    //	o Magnitude and phase files are refused: the saved phase is
+    //	  atan(imag/real), which loses the sign of the real part, so the
+    //	  complex volume cannot be rebuilt from them.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("frameLoad(...)");
+
+    const	int	MRI_FLOAT	= 3;
+
+    bool		b_ret		= false;
+    size_t		mapSize;
+    int			readOutStart, readOutEnd;
+    long		frameBytes	= frame_size();
+    char*		pch_map;
+
+    if(e_iotype != e_real && e_iotype != e_imaginary) {
+	warn("Only real/imaginary MGH files can be loaded: " + astr_fileName, 1);
+	debug_pop();
+	return false;
+    }
+    pch_map	= file_map(astr_fileName, mapSize);
+
+    readOut_range(readOutStart, readOutEnd);
+
+    if(pch_map && mapSize >= (size_t) MGH_HEADER_SIZE) {
+	int*	p_header	= (int*) pch_map;
+	int	nframes		= swapInt(p_header[4]);
+
+	if(	swapInt(p_header[1]) != pVl_extracted->cols_get()	||
+		swapInt(p_header[2]) != readOutEnd - readOutStart	||
+		swapInt(p_header[3]) != pVl_extracted->slices_get()	||
+		swapInt(p_header[5]) != MRI_FLOAT)
+	    warn("Volume dimensions or type do not match " + astr_fileName, 1);
+	else if(a_frame < 0 || a_frame >= nframes ||
+		mapSize < MGH_HEADER_SIZE + (size_t) nframes * frameBytes)
+	    warn("Frame is not available in " + astr_fileName, 1);
+	else {
+	    voxels_store((const float*) (pch_map + MGH_HEADER_SIZE +
+					 (off_t) a_frame * frameBytes),
+			 0, pVl_extracted->slices_get());
+	    b_ret	= true;
+	}
+    }
+    file_unmap(pch_map, mapSize);
+
+    debug_pop();
+    return b_ret;
 }
 
 //
@@ -838,6 +1583,7 @@ C_IO_analyze75::C_IO_analyze75(
     s_orientation		= a_orientation;
     v_intensityScale		= av_intensityScale;
     b_readOutFlip		= ab_readOutFlip;
+    b_saturated			= false;
     mpdsr_header                = new struct dsr;
 }
 
@@ -882,6 +1628,7 @@ C_IO_analyze75::C_IO_analyze75(
     s_orientation		= a_orientation;
     v_intensityScale		= av_intensityScale;
     b_readOutFlip		= ab_readOutFlip;
+    b_saturated			= false;
     mpdsr_header                = new struct dsr;
 }
 
@@ -944,30 +1691,108 @@ C_IO_analyze75::save(string astr_fileName)
     // 25 February 2004
     //	o Added readOUt crop capability
     //
+    // 19 October 2026
+    //	o The short norm is converted and pwrite()n in parallel slabs - see
+    //	  slab_convert() and C_IO::slabs_write().
+    //
 
     debug_push("save(...)");
 
-    FILE		*fp;
-    double		q;
-    int		        status, i, ix, iy, iz;
-    short		norm;
     bool		b_returnVal	= true;
+    off_t		fileSize;
+
+    fileSize	= (off_t) slice_size() * pVl_extracted->slices_get();
 
     /**********************************************/
     /* write norm of complex array as short image */
     /**********************************************/
-    if (!(fp = fopen ((const char*)(astr_fileName+".img").c_str(), "wb")))
+    int	fd	= open((astr_fileName+".img").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
 	error("Some problem encountered accessing output file " + astr_fileName, 1);
-    int cnt = 0;
-    m_maxval = status = 0;
-    m_minval = SHRT_MAX;
-    int			readOutStart	= 0;
-    int			readOutEnd	= pVl_extracted->rows_get();
-    if(pCadcPack->b_readOutCrop_get()) {
-	readOutStart	= readOutEnd / 4;
-	readOutEnd	= (int) (0.75 * readOutEnd);
+    if(ftruncate(fd, fileSize)) {
+	close(fd);
+	error("Some problem encountered preallocating output file " + astr_fileName, 1);
     }
-	
+
+    // Statistics are accumulated by the slab writer threads
+    m_maxval	= 0;
+    m_minval	= SHRT_MAX;
+    b_saturated	= false;
+
+    if(!slabs_write(fd, 0, pVl_extracted->slices_get()))
+	b_returnVal	= false;
+
+    if (close (fd))
+	error("Some error encountered when trying to close() " + astr_fileName, 1);
+    if(b_saturated)
+	b_returnVal	= false;
+
+    headerSave(astr_fileName + ".hdr");
+
+    debug_pop();
+    return b_returnVal;
+}
+
+long
+C_IO_analyze75::slice_size()
+{
+    //
+    // DESC
+    //	Size in bytes of a single converted (short) output slice.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    int		readOutStart, readOutEnd;
+
+    readOut_range(readOutStart, readOutEnd);
+    return (long) pVl_extracted->cols_get() * (readOutEnd - readOutStart)
+		* sizeof(short);
+}
+
+long
+C_IO_analyze75::slab_convert(
+    char*		apch_buffer,
+    int			a_sliceStart,
+    int			a_sliceEnd
+) {
+    //
+    // ARGS
+    //	apch_buffer		out		buffer to receive the slab
+    //	a_sliceStart		in		first slice of the slab
+    //	a_sliceEnd		in		one past the last slice
+    //
+    // DESC
+    //	Slab writer hook: converts slices to their short norm, honouring
+    //	the readOut flip and crop. This is the former body of the save()
+    //	loop.
+    //
+    //	The min/max/saturation statistics are kept locally and merged
+    //	into the object under mutex_slab, since several slabs are converted
+    //	concurrently.
+    //
+    // HISTORY
+    // 14 October 2003
+    //	o Initial port and integration (as part of save()).
+    //
+    // 19 October 2026
+    //	o Moved into the slab writer.
+    //
+
+    double		q;
+    int		        ix, iy, iz;
+    short		norm;
+    short*		ps_buffer	= (short*) apch_buffer;
+    long		bufCount	= 0;
+    int			minval		= SHRT_MAX;
+    int			maxval		= 0;
+    bool		b_sat		= false;
+    int			readOutStart, readOutEnd;
+
+    readOut_range(readOutStart, readOutEnd);
+
     int	RObegin, ROend, ROdel;
     if(b_readOutFlip) {
     	RObegin	= readOutEnd-1;
@@ -978,39 +1803,32 @@ C_IO_analyze75::save(string astr_fileName)
 	ROend	= readOutEnd;
 	ROdel	= 1;
     }
-    
-    for (iz = 0; iz < pVl_extracted->slices_get();   iz++) {
-//        for (iy = RObegin; iy < readOutEnd;   iy++) {
+
+    for (iz = a_sliceStart; iz < a_sliceEnd;   iz++) {
 	for (iy = RObegin; b_readOutFlip ? iy >= ROend : iy < ROend; iy+=ROdel) {
-//        for (iy = readOutEnd-1; iy >= readOutStart;   iy--) {
 	    for (ix = 0; ix < pVl_extracted->cols_get(); ix++) {
 		q = sqrt(
 		      GSL_REAL(pVl_extracted->val(iy, ix, iz)) * GSL_REAL(pVl_extracted->val(iy, ix, iz)) +
 		      GSL_IMAG(pVl_extracted->val(iy, ix, iz)) * GSL_IMAG(pVl_extracted->val(iy, ix, iz))
 		      );
-		//cout << q << " ";
-		if (q > (double) SHRT_MAX) status = -1;
+		if (q > (double) SHRT_MAX) b_sat = true;
 		norm = (short) (v_intensityScale*q + 0.5);
-		//cout << norm << " | ";
-		if (norm < m_minval) m_minval = norm;
-		if (norm > m_maxval) m_maxval = norm;
+		if (norm < minval) minval = norm;
+		if (norm > maxval) maxval = norm;
 		if(e_byteOrder==e_bigEndian)
 		    norm = swapShort(norm);
-		fwrite (&norm, sizeof (short), 1, fp);
-		//cnt++; if(cnt==15) exit(1);
+		ps_buffer[bufCount++]	= norm;
 	    }
 	}
     }
-        
-    if (fclose (fp))
-	error("Some error encountered when trying to fclose() " + astr_fileName, 1);
-    if(status)
-	b_returnVal	= false;
 
-    headerSave(astr_fileName + ".hdr");
+    pthread_mutex_lock(&mutex_slab);
+    if(minval < m_minval)	m_minval	= minval;
+    if(maxval > m_maxval)	m_maxval	= maxval;
+    if(b_sat)			b_saturated	= true;
+    pthread_mutex_unlock(&mutex_slab);
 
-    debug_pop();
-    return b_returnVal;
+    return bufCount * sizeof(short);
 }
 
 bool
@@ -1181,10 +1999,488 @@ C_IO_analyze75::header_byteSwap() {
 }
 
 
-bool	
-C_IO_analyze75::load(string str_fileName) {
+bool
+C_IO_analyze75::headerLoad(
+    string		astr_fileName,
+    e_BYTEORDER&	ae_byteOrder
+) {
+    //
+    // ARGS
+    //	astr_fileName			in		header file to read
+    //	ae_byteOrder			out		byte order of the file
+    //
+    // DESC
+    //	Reads an analyze 7.5 header into mpdsr_header. The byte order of
+    //	the header is determined from its sizeof_hdr field, and the header
+    //	is swapped if necessary.
+    //
+    // POSTCONDITIONS
+    //	o ae_byteOrder is the byte order of the file. The e_byteOrder
+    //	  that save() uses is left alone.
+    //	o m_minval and m_maxval are set from the header.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("headerLoad(...)");
+
+    bool	b_ret	= false;
+    FILE*	fp;
+    struct dsr*	phdr	= mpdsr_header;
+
+    if ((fp = fopen (astr_fileName.c_str(), "rb"))) {
+	b_ret	= fread (phdr, sizeof (struct dsr), 1, fp) == 1;
+	fclose (fp);
+    }
+    if(b_ret) {
+	ae_byteOrder	= e_littleEndian;
+	if(phdr->hk.sizeof_hdr != sizeof (struct dsr)) {
+	    header_byteSwap();
+	    ae_byteOrder	= e_bigEndian;
+	}
+	if(phdr->hk.sizeof_hdr != sizeof (struct dsr))
+	    b_ret	= false;
+	m_minval	= phdr->dime.glmin;
+	m_maxval	= phdr->dime.glmax;
+    }
+    if(!b_ret)
+	warn("Some problem occurred when reading the header " + astr_fileName, 1);
+
+    debug_pop();
+    return b_ret;
+}
+
+bool
+C_IO_analyze75::load(string astr_fileName) {
+    //
+    // ARGS
+    //	astr_fileName			in		base fileName to load from
+    //
+    // DESC
+    //	Loads an analyze 7.5 volume, as written by save(), into the current
+    //	volume. The .img file is mmap()ed and decoded straight from the
+    //	mapping, honouring the readOut flip and crop.
+    //
+    // PRECONDITIONS
+    //	o The volume must already be constructed and have the dimensions
+    //	  of the volume that was saved.
+    //
+    // POSTCONDITIONS
+    //	o Since only the (scaled) norm is saved, the volume is set to real
+    //	  values norm/v_intensityScale.
+    //	o Returns false if the files could not be read or do not match the
+    //	  volume.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    debug_push("load(...)");
+
+    bool		b_ret		= false;
+    int		        ix, iy, iz;
+    short		norm;
+    long		bufCount	= 0;
+    size_t		mapSize		= 0;
+    char*		pch_map		= NULL;
+    int			readOutStart, readOutEnd;
+    GSL_complex_float	zv_val;
+    struct dsr*		phdr		= mpdsr_header;
+    e_BYTEORDER		e_fileByteOrder	= e_littleEndian;
+
+    readOut_range(readOutStart, readOutEnd);
+
+    if(headerLoad(astr_fileName + ".hdr", e_fileByteOrder)) {
+	if(	phdr->dime.datatype	!= 4				||
+		phdr->dime.dim[1]	!= pVl_extracted->cols_get()	||
+		phdr->dime.dim[2]	!= readOutEnd - readOutStart	||
+		phdr->dime.dim[3]	!= pVl_extracted->slices_get())
+	    warn("Volume dimensions or type do not match " + astr_fileName, 1);
+	else
+	    pch_map	= file_map(astr_fileName + ".img", mapSize);
+    }
+
+    if(pch_map && mapSize >= (size_t) slice_size() * pVl_extracted->slices_get()) {
+	short*	ps_buffer	= (short*) pch_map;
+
+	int	RObegin, ROend, ROdel;
+	if(b_readOutFlip) {
+	    RObegin	= readOutEnd-1;
+	    ROend	= readOutStart;
+	    ROdel	= -1;
+	} else {
+	    RObegin	= readOutStart;
+	    ROend	= readOutEnd;
+	    ROdel	= 1;
+	}
+
+	for (iz = 0; iz < pVl_extracted->slices_get();   iz++) {
+	    for (iy = RObegin; b_readOutFlip ? iy >= ROend : iy < ROend; iy+=ROdel) {
+		for (ix = 0; ix < pVl_extracted->cols_get(); ix++) {
+		    norm	= ps_buffer[bufCount++];
+		    if(e_fileByteOrder==e_bigEndian)
+			norm = swapShort(norm);
+		    GSL_SET_COMPLEX(&zv_val, norm / v_intensityScale, 0.0);
+		    pVl_extracted->val(iy, ix, iz)	= zv_val;
+		}
+	    }
+	}
+	b_ret	= true;
+    } else if(pch_map)
+	warn("Image data is truncated in " + astr_fileName, 1);
+    file_unmap(pch_map, mapSize);
+
+    debug_pop();
+    return b_ret;
+}
+
+//
+//\\\***
+// C_IO_nifti definitions ****>>>>
+/////***
+//
+
+//
+// constructor / destructor block
+//
+
+C_IO_nifti::C_IO_nifti(
+    CVol<GSL_complex_float>*          	apVl_extracted,
+    CMatrix<double>&            	aM_vox2ras,
+    CMatrix<double>&            	aV_MRIParams
+) : C_IO(apVl_extracted)
+{
+    //
+    // ARGS
+    //  pVl_extracted		in		pointer to volume to be saved
+    //	M_vox2ras		in		vox2ras transformation matrix
+    //	V_MRIParams		in		Misc MRI parameters
+    //
+    // DESC
+    //	Constructor for the NIfTI-1 format I/O.
+    //
+    //	Note that the base IO class is passed a pointer to the extracted volume.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    str_obj             = "C_IO_nifti";
+
+    pM_vox2ras		= new CMatrix<double>(aM_vox2ras.rows_get(),
+					      aM_vox2ras.cols_get());
+    pM_vox2ras->copy(aM_vox2ras);
+    pV_MRIParams         = new CMatrix<double>(aV_MRIParams.rows_get(),
+					       aV_MRIParams.cols_get());
+    pV_MRIParams->copy(aV_MRIParams);
+    pV_MRIParamsEcho	= new CMatrix<double>(1, 4);
+}
+
+C_IO_nifti::C_IO_nifti(
+    CMatrix<double>&            aM_vox2ras,
+    CMatrix<double>&            aV_MRIParams
+) : C_IO()
+{
+    //
+    // ARGS
+    //	M_vox2ras		in		vox2ras transformation matrix
+    //	V_MRIParams		in		Misc MRI parameters
+    //
+    // DESC
+    //	Constructor for the NIfTI-1 format I/O.
+    //
+    //	This is a partial constructor that is used when the target volume
+    //	is unknown. Note that the parameterless "dummy" base constructor
+    //	is called!
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    str_obj             = "C_IO_nifti";
+
+    pM_vox2ras		= new CMatrix<double>(aM_vox2ras.rows_get(),
+					      aM_vox2ras.cols_get());
+    pM_vox2ras->copy(aM_vox2ras);
+    pV_MRIParams         = new CMatrix<double>(aV_MRIParams.rows_get(),
+					       aV_MRIParams.cols_get());
+    pV_MRIParams->copy(aV_MRIParams);
+    pV_MRIParamsEcho	= new CMatrix<double>(1, 4);
+}
+
+C_IO_nifti::~C_IO_nifti() {
+    delete	pM_vox2ras;
+    delete	pV_MRIParams;
+    delete	pV_MRIParamsEcho;
+}
+
+//
+// Misc access block
+//
+
+bool
+C_IO_nifti::header_fill(
+    struct nifti_1_header*	apnhdr,
+    int				a_ndim1,
+    int				a_ndim2,
+    int				a_ndim3
+) {
+    //
+    // ARGS
+    //	apnhdr			in/out		header to fill
+    //	a_ndim1			in		fastest varying dimension (cols)
+    //	a_ndim2			in		middle dimension (readOut)
+    //	a_ndim3			in		slowest varying dimension (slices)
+    //
+    // DESC
+    //	Fills a NIfTI-1 header describing a complex64 volume. The
+    //	vox2ras matrix is stored verbatim as the sform; the voxel
+    //	sizes are the column norms of its 3x3 rotation/scale part
+    //	(exactly as the M_delta of the MGH save).
+    //
+    // PRECONDITIONS
+    //	o apnhdr points to at least NIFTI_HEADER_SIZE bytes of zeroed
+    //	  memory.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    int		i, j;
+    double	v_delta;
+
+    apnhdr->sizeof_hdr		= NIFTI_HEADER_SIZE;
+    apnhdr->regular		= 'r';
+    apnhdr->dim[0]		= 3;
+    apnhdr->dim[1]		= a_ndim1;
+    apnhdr->dim[2]		= a_ndim2;
+    apnhdr->dim[3]		= a_ndim3;
+    for(i=4; i<8; i++)
+	apnhdr->dim[i]		= 1;
+    apnhdr->datatype		= NIFTI_TYPE_COMPLEX64;
+    apnhdr->bitpix		= 64;
+
+    apnhdr->pixdim[0]		= 1.0;		// qfac
+    for(j=0; j<3; j++) {
+	v_delta	= 0.0;
+	for(i=0; i<3; i++)
+	    v_delta += pM_vox2ras->val(i, j) * pM_vox2ras->val(i, j);
+	apnhdr->pixdim[j+1]	= (float) sqrt(v_delta);
+    }
+    // TR, converted to seconds
+    apnhdr->pixdim[4]		= pV_MRIParamsEcho->val(0, 0) / 1000.0;
+    apnhdr->vox_offset		= (float) NIFTI_SINGLE_OFFSET;
+    apnhdr->scl_slope		= 1.0;
+    apnhdr->scl_inter		= 0.0;
+    apnhdr->xyzt_units		= NIFTI_UNITS_MM | NIFTI_UNITS_SEC;
+    strncpy(apnhdr->descrip, "mdh_process complex reconstruction", 79);
+
+    apnhdr->qform_code		= NIFTI_XFORM_UNKNOWN;
+    apnhdr->sform_code		= NIFTI_XFORM_SCANNER_ANAT;
+    for(j=0; j<4; j++) {
+	apnhdr->srow_x[j]	= pM_vox2ras->val(0, j);
+	apnhdr->srow_y[j]	= pM_vox2ras->val(1, j);
+	apnhdr->srow_z[j]	= pM_vox2ras->val(2, j);
+    }
+    memcpy(apnhdr->magic, "n+1\0", 4);
+
+    return true;
 }
 
+bool
+C_IO_nifti::save(string astr_fileName)
+{
+    //
+    // ARGS
+    //	astr_fileName			in		fileName to save volume to
+    //
+    // DESC
+    //	Saves the complex volume, as well as the vox2ras affine, to a
+    //	single NIfTI-1 (.nii) file. Unlike the MGH save, where real and
+    //	imaginary (or mag/phase) components each need their own file and
+    //	their own conversion pass, the real/imag pairs are written together
+    //	as complex64 voxels.
+    //
+    //	The output file is first preallocated to its final size and then
+    //	mapped into memory. The header is filled directly in the map and
+    //	voxels are written straight into their final position; no
+    //	intermediate conversion buffer is created and no fwrite() calls are
+    //	made.
+    //
+    // PRECONDITIONS
+    //	pM_vox2ras			member		4x4 transformation matrix
+    //	pV_MRIParamsEcho		member		MRI parameters:
+    //								[tr flipangle te ti]
+    //
+    //	o The voxel ordering (and the readOut crop) is identical to that
+    //	  of C_IO_mgh::save(), so the same vox2ras applies to both outputs.
+    //
+    // POSTCONDITIONS
+    //	o The "current" volume class is saved to disk in NIfTI-1 format,
+    //	  in native byte order (NIfTI readers detect the byte order from
+    //	  sizeof_hdr).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Checks posix_fallocate(); readOut range from readOut_range().
+    //
+
+    debug_push("save(...)");
+
+    if(!pM_vox2ras->compatible(4, 4))
+	error("Passed vox2ras matrix is not 4x4! Has it been properly initialised?", 1);
+
+    int			i, j, k;
+    int			ndim1, ndim2, ndim3;
+    int			readOutStart, readOutEnd;
 
+    readOut_range(readOutStart, readOutEnd);
+
+    ndim1		= pVl_extracted->cols_get();
+    ndim2		= readOutEnd - readOutStart;
+    ndim3		= pVl_extracted->slices_get();
+
+    size_t		voxels		= (size_t) ndim1 * ndim2 * ndim3;
+    size_t		fileSize	= NIFTI_SINGLE_OFFSET +
+					  voxels * 2 * sizeof(float);
+
+    int	fd	= open(astr_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+	error("Could not open NIfTI file " + astr_fileName, 1);
+
+    // Reserve the whole file up front. The ftruncate() sizes the file
+    //	for the map, but leaves it sparse: a store into a page that the
+    //	filesystem then cannot back (ENOSPC, quota) raises SIGBUS. So the
+    //	blocks are allocated with posix_fallocate(), which may only be
+    //	skipped on filesystems that do not support it.
+    if(ftruncate(fd, fileSize)) {
+	close(fd);
+	unlink(astr_fileName.c_str());
+	error("Could not preallocate NIfTI file " + astr_fileName, 1);
+    }
+    int	ret	= posix_fallocate(fd, 0, fileSize);
+    if(ret && ret != EOPNOTSUPP && ret != EINVAL) {
+	close(fd);
+	unlink(astr_fileName.c_str());
+	error("Could not allocate NIfTI file " + astr_fileName + ": " + strerror(ret), 1);
+    }
+
+    char*	pch_map	= (char*) mmap(NULL, fileSize, PROT_READ | PROT_WRITE,
+					MAP_SHARED, fd, 0);
+    if(pch_map == MAP_FAILED) {
+	close(fd);
+	unlink(astr_fileName.c_str());
+	error("Could not mmap NIfTI file " + astr_fileName, 1);
+    }
 
+    // The freshly truncated file reads as zeroes, so both the unused header
+    //	fields and the 4 byte extender are already cleared.
+    header_fill((struct nifti_1_header*) pch_map, ndim1, ndim2, ndim3);
 
+    //
+    // The core "write" loop - see C_IO_mgh::save() for the rationale
+    //	behind the loop ordering and the inverted slice/column indices.
+    //
+    float*	pf_voxel	= (float*) (pch_map + NIFTI_SINGLE_OFFSET);
+    size_t	bufCount	= 0;
+    for(k=pVl_extracted->slices_get()-1; k>=0; k--) {
+        for(i=readOutStart; i<readOutEnd; i++) {
+            for(j=pVl_extracted->cols_get()-1; j>=0; j--) {
+		pf_voxel[bufCount++]	= GSL_REAL(pVl_extracted->val(i, j, k));
+		pf_voxel[bufCount++]	= GSL_IMAG(pVl_extracted->val(i, j, k));
+	    }
+	}
+    }
+
+    bool	b_ret	= true;
+    if(munmap(pch_map, fileSize))
+	b_ret	= false;
+    if(close(fd))
+	b_ret	= false;
+    if(!b_ret)
+	warn("Problem encountered closing NIfTI file " + astr_fileName, 1);
+
+    debug_pop();
+    return b_ret;
+}
+
+bool
+C_IO_nifti::load(string astr_fileName) {
+    //
+    // ARGS
+    //	astr_fileName		in		NIfTI file to load
+    //
+    // DESC
+    //	The inverse of save(): the complex64 voxels of a single file
+    //	NIfTI-1 volume are decoded from the mmap()ed file straight into
+    //	the current volume.
+    //
+    // PRECONDITIONS
+    //	o The volume must already be constructed and have the dimensions
+    //	  of the volume that was saved (including the readOut crop).
+    //	o The file was written by save() on a machine of the same byte
+    //	  order.
+    //
+    // POSTCONDITIONS
+    //	o Returns false if the file could not be mapped or does not match
+    //	  the volume. Voxels outside of the readOut crop are not touched.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o readOut range from readOut_range().
+    //
+
+    debug_push("load(...)");
+
+    int			i, j, k;
+    bool		b_ret		= false;
+    size_t		mapSize;
+    int			readOutStart, readOutEnd;
+
+    readOut_range(readOutStart, readOutEnd);
+    size_t		voxels		= (size_t) pVl_extracted->cols_get() *
+					  (readOutEnd - readOutStart) *
+					  pVl_extracted->slices_get();
+    char*		pch_map		= file_map(astr_fileName, mapSize);
+
+    if(pch_map && mapSize >= (size_t) NIFTI_SINGLE_OFFSET) {
+	struct nifti_1_header*	pnhdr	= (struct nifti_1_header*) pch_map;
+
+	if(	pnhdr->sizeof_hdr	!= NIFTI_HEADER_SIZE			||
+		pnhdr->datatype		!= NIFTI_TYPE_COMPLEX64			||
+		pnhdr->dim[1]		!= pVl_extracted->cols_get()		||
+		pnhdr->dim[2]		!= readOutEnd - readOutStart		||
+		pnhdr->dim[3]		!= pVl_extracted->slices_get()		||
+		mapSize < (size_t) pnhdr->vox_offset + voxels * 2 * sizeof(float))
+	    warn("Volume dimensions or type do not match " + astr_fileName, 1);
+	else {
+	    const float*	pf_voxel	= (const float*) (pch_map +
+							  (size_t) pnhdr->vox_offset);
+	    size_t		bufCount	= 0;
+	    GSL_complex_float	zv_val;
+	    for(k=pVl_extracted->slices_get()-1; k>=0; k--) {
+		for(i=readOutStart; i<readOutEnd; i++) {
+		    for(j=pVl_extracted->cols_get()-1; j>=0; j--) {
+			GSL_SET_COMPLEX(&zv_val, pf_voxel[bufCount],
+						 pf_voxel[bufCount+1]);
+			bufCount	+= 2;
+			pVl_extracted->val(i, j, k)	= zv_val;
+		    }
+		}
+	    }
+	    b_ret	= true;
+	}
+    }
+    file_unmap(pch_map, mapSize);
+
+    debug_pop();
+    return b_ret;
+}
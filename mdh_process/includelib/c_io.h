@@ -26,9 +26,13 @@
 
 #include <iostream>
 #include <string>
+#include <map>
 #include <complex>
 using namespace std;
 
+#include <sys/types.h>
+#include <pthread.h>
+
 #ifdef __x86_64__
 #include "mdh64.h"
 #else
@@ -38,10 +42,16 @@ using namespace std;
 #include "cmatrix.h"
 #include "machine.h"
 #include "analyze.h"
+#include "nifti1.h"
 
 namespace mdh {
     
 const int       C_IO_STACKDEPTH      = 64;
+const int	MGH_HEADER_SIZE		= 284;	// 7 ints, a short and the
+						//	256-2 byte geometry block
+const int	MGH_MRIPARAMS_SIZE	= 4*4;	// [tr flipangle te ti] floats
+const int	C_IO_SLABSPERTHREAD	= 4;	// slabs per writer thread, for
+						//	load balancing
 
     typedef enum _iotype {
 	e_complex       = 0,
@@ -101,6 +111,17 @@ class   C_IO {
 	C_adcPack*		pCadcPack;	// parent object that contains
 	                                        //	all system data.
 
+	// Slab writer state. A volume is split along its slice dimension
+	//	into slabs, each of which is converted by one of IOthreads
+	//	threads and written with pwrite() at its own file offset.
+	int			IOthreads;	// number of writer threads
+	int			slabSlices;	// slices per slab
+	int			slabNext;	// next slice to hand out
+	int			slabTotal;	// total slices to write
+	pthread_mutex_t		mutex_slab;	// guards slabNext and any
+	                                        //	per-save statistics kept
+	                                        //	by derived classes
+
 
     // methods
 
@@ -206,11 +227,48 @@ class   C_IO {
 	        };
 	void    volume_reconstruct(     CVol<GSL_complex_float>*      pVl);
 
+	int		IOthreads_get()
+	                    const {return IOthreads;};
+	void		IOthreads_set(int a_threads)
+	                    { IOthreads = a_threads;};
+
+	//
+	// Slab writer
+	//
+	bool		slabs_write(	int		a_fd,
+					off_t		a_offset,
+					int		a_slices);
+	bool		slab_next(	int&		a_sliceStart,
+					int&		a_sliceEnd);
+	static void*	slab_thread(	void*		apv_job);
+
+	// The derived classes that use the slab writer provide the size of
+	//	a single converted (output) slice and the conversion of a
+	//	range of output slices into a buffer.
+	virtual long	slice_size()	{return 0;};
+	virtual long	slab_convert(	char*		apch_buffer,
+					int		a_sliceStart,
+					int		a_sliceEnd);
+
+	// The readOut lines that are saved and loaded
+	void		readOut_range(	int&		a_readOutStart,
+					int&		a_readOutEnd);
+
+	//
+	// Read-only mapping of an existing file, used by the loaders
+	//
+	char*		file_map(	string		astr_fileName,
+					size_t&		a_size);
+	void		file_unmap(	char*		apch_map,
+					size_t		a_size);
+
 	//
 	// Overloads
 	//
-	virtual bool	save(string str_fileName) {};
-	virtual bool	load(string str_fileName) {};
+	virtual bool	save(string str_fileName) {return false;};
+	virtual bool	load(string str_fileName) {return false;};
+	virtual bool	frameSave(string str_fileName, int a_frame, int a_frames);
+	virtual bool	frameLoad(string str_fileName, int a_frame);
 
 };
 
@@ -247,10 +305,44 @@ class C_IO_mgh : public C_IO {
     CMatrix<double>*	pV_MRIParams_get() const
     			{ return pV_MRIParams;};
     CMatrix<double>*	pV_MRIParamsEcho_copy(CMatrix<double>& aV_target)
-    			{pV_MRIParamsEcho->copy(aV_target);};
+    			{pV_MRIParamsEcho->copy(aV_target); return pV_MRIParamsEcho;};
+
+    //
+    // Component building blocks of an MGH file. Each fills a caller
+    //	supplied buffer with big endian data, ready to be written.
+    //
+    int			header_build(	char*		apch_header,
+					int		a_nframes	= 1);
+    int			voxels_convert(	float*		apf_buffer,
+					int		a_sliceStart,
+					int		a_sliceEnd);
+    int			MRIParams_build(float*		apf_buffer);
+    long		frame_size();
+
+    // ... and the inverse of voxels_convert(), for the loaders
+    void		voxels_store(	const float*	apf_buffer,
+					int		a_sliceStart,
+					int		a_sliceEnd);
+
+    virtual long	slice_size();
+    virtual long	slab_convert(	char*		apch_buffer,
+					int		a_sliceStart,
+					int		a_sliceEnd);
 
     virtual bool	save(string astr_fileName);
     virtual bool	load(string astr_fileName);
+    virtual bool	frameSave(string astr_fileName, int a_frame, int a_frames);
+    virtual bool	frameLoad(string astr_fileName, int a_frame);
+
+    // Closes the multi-frame files frameSave() holds open. Call at the
+    //	end of a run: the next frameSave() to a file starts it afresh.
+    //	False if any of them failed to close.
+    static bool		frameFiles_close();
+
+    protected:
+
+    static map<string, int>	map_frameFiles;	// multi-frame files of the
+							//	run, and their fds
 
 };
 
@@ -268,6 +360,7 @@ class C_IO_analyze75 : public C_IO {
     bool			b_readOutFlip;		// boolean flag for "inverting" the
     							//	save order of the readout
 							//	dimension
+    bool			b_saturated;		// some voxel exceeded SHRT_MAX
 
     public:
 
@@ -298,11 +391,61 @@ class C_IO_analyze75 : public C_IO {
     virtual bool	load(string astr_fileName);
     
     bool		headerSave(string astr_fileName);
-    bool		headerLoad(string astr_fileName);
+    bool		headerLoad(	string		astr_fileName,
+					e_BYTEORDER&	ae_byteOrder);
     bool		header_byteSwap();
 
+    virtual long	slice_size();
+    virtual long	slab_convert(	char*		apch_buffer,
+					int		a_sliceStart,
+					int		a_sliceEnd);
+
 };
 
+class C_IO_nifti : public C_IO {
+
+    protected:
+
+
+    CMatrix<double>*		pM_vox2ras;	    	// transformation matrix
+    CMatrix<double>*		pV_MRIParams;	    	// *all* MRI parameters
+    CMatrix<double>*		pV_MRIParamsEcho;	// MRI paramaters for
+    							//	current echo
+
+    public:
+
+    //
+    // constructor / destructor block
+    //
+    C_IO_nifti(
+	        CVol<GSL_complex_float>*        pVl_extracted,
+		CMatrix<double>&                M_vox2ras,
+	        CMatrix<double>& 		V_MRIParams
+		  );
+    C_IO_nifti(
+	        CMatrix<double>&            	M_vox2ras,
+	        CMatrix<double>&            	V_MRIParams
+		  );
+
+    ~C_IO_nifti();
+
+    //
+    // Misc access block
+    //
+    CMatrix<double>*	pV_MRIParams_get() const
+    			{ return pV_MRIParams;};
+    CMatrix<double>*	pV_MRIParamsEcho_copy(CMatrix<double>& aV_target)
+    			{pV_MRIParamsEcho->copy(aV_target); return pV_MRIParamsEcho;};
+
+    bool		header_fill(	struct nifti_1_header*	apnhdr,
+					int			a_ndim1,
+					int			a_ndim2,
+					int			a_ndim3);
+
+    virtual bool	save(string astr_fileName);
+    virtual bool	load(string astr_fileName);
+
+};
 
 }
 
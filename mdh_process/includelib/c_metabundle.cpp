@@ -0,0 +1,199 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstring>
+using namespace std;
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "c_metabundle.h"
+#include "c_container.h"
+using namespace mdh;
+
+//
+//\\\***
+// meta data bundle definitions ****>>>>
+/////***
+//
+
+bool
+mdh::metaBundle_write(
+    const string&	astr_fileName,
+    const s_metaBundle&	a_bundle
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		bundle file
+    //	a_bundle		in		meta data to write
+    //
+    // DESC
+    //	Writes the bundle to a temporary file of its own (so that
+    //	concurrent writers do not clobber each other), syncs it, and
+    //	renames it over astr_fileName.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o mkstemp() temporary file.
+    //
+
+    s_metaBundleHeader	header;
+    size_t		paramBytes	= a_bundle.v_mriParams.size() * sizeof(double);
+    size_t		payloadBytes	= sizeof(s_metaBundleData) + paramBytes;
+    vector<char>	v_buffer(METABUNDLE_HEADERBYTES + payloadBytes, 0);
+    char*		pch_payload	= &v_buffer[METABUNDLE_HEADERBYTES];
+    string		str_template	= astr_fileName + ".tmp.XXXXXX";
+    vector<char>	v_tmp(str_template.begin(), str_template.end());
+
+    memcpy(pch_payload, &a_bundle.data, sizeof(s_metaBundleData));
+    if(paramBytes)
+	memcpy(pch_payload + sizeof(s_metaBundleData),
+	       &a_bundle.v_mriParams[0], paramBytes);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.pch_magic, METABUNDLE_MAGIC, sizeof(header.pch_magic));
+    header.version	= METABUNDLE_VERSION;
+    header.mriParams	= a_bundle.v_mriParams.size();
+    header.payloadBytes	= payloadBytes;
+    header.checksum	= C_container::hash_update(CONTAINER_HASH_SEED,
+						   pch_payload, payloadBytes);
+    memcpy(&v_buffer[0], &header, sizeof(header));
+
+    v_tmp.push_back('\0');
+    int		fd	= mkstemp(&v_tmp[0]);
+    if(fd < 0)
+	return false;
+    string	str_tmp(&v_tmp[0]);
+    fchmod(fd, 0644);
+
+    bool	b_ok	= true;
+    size_t	done	= 0;
+    while(b_ok && done < v_buffer.size()) {
+	ssize_t	bytes	= write(fd, &v_buffer[done], v_buffer.size() - done);
+	if(bytes <= 0)
+	    b_ok	= false;
+	else
+	    done	+= bytes;
+    }
+    if(b_ok && fsync(fd))
+	b_ok	= false;
+    if(close(fd))
+	b_ok	= false;
+    if(b_ok && rename(str_tmp.c_str(), astr_fileName.c_str()))
+	b_ok	= false;
+    if(!b_ok)
+	unlink(str_tmp.c_str());
+    return b_ok;
+}
+
+bool
+mdh::metaBundle_read(
+    const string&	astr_fileName,
+    s_metaBundle&	a_bundle
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		bundle file
+    //	a_bundle		out		meta data read
+    //
+    // DESC
+    //	Reads and validates (magic, version, sizes and checksum) a bundle.
+    //
+    // POSTCONDITIONS
+    //	o a_bundle is only changed if true is returned.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    struct stat		st_file;
+    s_metaBundleHeader	header;
+    int			fd	= open(astr_fileName.c_str(), O_RDONLY);
+
+    if(fd < 0)
+	return false;
+    if(fstat(fd, &st_file) || st_file.st_size < METABUNDLE_HEADERBYTES) {
+	close(fd);
+	return false;
+    }
+
+    vector<char>	v_buffer(st_file.st_size);
+    ssize_t		bytes	= read(fd, &v_buffer[0], v_buffer.size());
+    close(fd);
+    if(bytes != (ssize_t) v_buffer.size())
+	return false;
+
+    memcpy(&header, &v_buffer[0], sizeof(header));
+    if(	memcmp(header.pch_magic, METABUNDLE_MAGIC, sizeof(header.pch_magic)) ||
+	header.version != METABUNDLE_VERSION	||
+	header.mriParams < 0			||
+	header.payloadBytes != (long long) (sizeof(s_metaBundleData) +
+				header.mriParams * sizeof(double)) ||
+	header.payloadBytes != st_file.st_size - METABUNDLE_HEADERBYTES)
+	return false;
+
+    const char*		pch_payload	= &v_buffer[METABUNDLE_HEADERBYTES];
+    if(header.checksum != C_container::hash_update(CONTAINER_HASH_SEED,
+					pch_payload, header.payloadBytes))
+	return false;
+
+    memcpy(&a_bundle.data, pch_payload, sizeof(s_metaBundleData));
+    a_bundle.v_mriParams.resize(header.mriParams);
+    if(header.mriParams)
+	memcpy(&a_bundle.v_mriParams[0], pch_payload + sizeof(s_metaBundleData),
+	       header.mriParams * sizeof(double));
+    return true;
+}
+
+unsigned long long
+mdh::metaBundle_sourcesHash(
+    const vector<string>&	av_files
+) {
+    //
+    // ARGS
+    //	av_files		in		options file, then the matrix
+    //						files in METABUNDLE_SOURCES
+    //						order
+    //
+    // DESC
+    //	Hashes the contents of the files a bundle is made from. The files
+    //	are all small text files, so they are read whole.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    unsigned long long	hash	= CONTAINER_HASH_SEED;
+    char		pch_buffer[4096];
+    ssize_t		bytes;
+    long long		size;
+
+    for(unsigned int i=0; i<av_files.size(); i++) {
+	int	fd	= av_files[i].length() ?
+			  open(av_files[i].c_str(), O_RDONLY) : -1;
+	size	= -1;
+	if(fd >= 0) {
+	    size	= 0;
+	    while((bytes = read(fd, pch_buffer, sizeof(pch_buffer))) > 0) {
+		hash	= C_container::hash_update(hash, pch_buffer, bytes);
+		size	+= bytes;
+	    }
+	    close(fd);
+	}
+	hash	= C_container::hash_update(hash, &size, sizeof(size));
+    }
+    return hash;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_metabundle.h
+//
+// DESCRIPTION
+//
+//  `c_metabundle.h' declares the binary meta data bundle written by
+//   promasc. It carries, in one file, everything that promasc otherwise
+//   spreads over the *.cmt matrix files and the orientation edit of the
+//   options file:
+//
+//	[header]		METABUNDLE_HEADERBYTES bytes, s_metaBundleHeader
+//	[data]			s_metaBundleData
+//	[MRI parameters]	<mriParams> doubles: TR, flip angle, TI,
+//				TE[0] ... TE[echoes-1]
+//
+//   The checksum (64 bit FNV-1a) covers everything after the header. The
+//   bundle is written to a temporary file and renamed into place, so a
+//   reader never sees a partial bundle. As with containers, the bundle is
+//   in native byte order.
+//
+//   The bundle also records sourcesHash, a hash of the contents of the
+//   files it was made from, in the order of METABUNDLE_SOURCES: the
+//   options (meta) file, then the matrix files. A reader only uses a
+//   bundle whose sources, as named by its own options file, still hash
+//   the same; otherwise the files themselves are read.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//  o Version 2: sourcesHash.
+//
+
+#ifndef __C_METABUNDLE_H__
+#define __C_METABUNDLE_H__
+
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace mdh {
+
+const char	METABUNDLE_MAGIC[]	= "MDHMETA";	// 8 bytes with the '\0'
+const int	METABUNDLE_VERSION	= 2;
+const int	METABUNDLE_HEADERBYTES	= 64;
+const char	METABUNDLE_FILENAME[]	= "meta.mdhb";	// default name, in the
+							//	ADCbaseDirectory
+// The options keys of the matrix files in a bundle, in sourcesHash order
+const char* const	METABUNDLE_SOURCES[]	= {
+    "3DflagFile",		"echoListDimensionFile", "repListDimensionFile",
+    "kListDimensionFile",	"ROpePCDimensionFile",	"MGH_vox2ras",
+    "A75_voxelDimensions",	"MGH_MRIParameters",	NULL
+};
+
+    typedef struct _metaBundleHeader {
+	char			pch_magic[8];	// METABUNDLE_MAGIC
+	int			version;	// METABUNDLE_VERSION
+	int			mriParams;	// number of MRI parameters
+	long long		payloadBytes;	// bytes after the header
+	unsigned long long	checksum;	// of the payload
+	char			pch_reserved[32];
+    } s_metaBundleHeader;
+
+    typedef struct _metaBundleData {
+	int		is3D;			// 3D.cmt
+	int		orientationA75;		// Analyze 7.5 orientation code
+	int		pi_echoList[2];		// echolist.cmt
+	int		pi_repList[2];		// replist.cmt
+	int		pi_kList[2];		// klist.cmt
+	int		pi_ROpePC[3];		// ROpePC.cmt
+	int		reserved;
+	double		pv_vox2ras[16];		// vox2ras.cmt, row major
+	double		pv_voxelDimension[3];	// voxelDimension.cmt
+	unsigned long long
+			sourcesHash;		// see metaBundle_sourcesHash()
+    } s_metaBundleData;
+
+    typedef struct _metaBundle {
+	s_metaBundleData	data;
+	vector<double>		v_mriParams;	// mriparam.cmt
+    } s_metaBundle;
+
+// Atomically writes a bundle. Returns false on any I/O error, in which
+//	case no (partial) bundle is left behind.
+bool	metaBundle_write(	const string&		astr_fileName,
+				const s_metaBundle&	a_bundle);
+
+// Reads a bundle with a single read(). Returns false if the file is
+//	missing, or is not a valid bundle of this version.
+bool	metaBundle_read(	const string&		astr_fileName,
+				s_metaBundle&		a_bundle);
+
+// Hashes the contents of the options file and the matrix files (in
+//	METABUNDLE_SOURCES order) of a bundle. A missing file hashes
+//	differently from an empty one.
+unsigned long long
+	metaBundle_sourcesHash(	const vector<string>&	av_files);
+
+}
+
+#endif //__C_METABUNDLE_H__
@@ -0,0 +1,397 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+using namespace std;
+
+#include <unistd.h>
+
+#include "c_options.h"
+using namespace mdh;
+
+//
+//\\\***
+// C_options definitions ****>>>>
+/////***
+//
+
+void
+C_options::debug_push(
+        string                          astr_currentProc) {
+    //
+    // ARGS
+    //  astr_currentProc        in      method name to
+    //                                          "push" on the "stack"
+    //
+    // DESC
+    //  This attempts to keep a simple record of methods that
+    //  are called. Note that this "stack" is severely crippled in
+    //  that it has no "memory" - names pushed on overwrite those
+    //  currently there.
+    //
+
+    if(stackDepth_get() >= C_OPTIONS_STACKDEPTH-1)
+        error(  "Out of str_proc stack depth");
+    stackDepth_set(stackDepth_get()+1);
+    str_proc_set(stackDepth_get(), astr_currentProc);
+}
+
+void
+C_options::debug_pop() {
+    //
+    // DESC
+    //  "pop" the stack. Since the previous name has been
+    //  overwritten, there is no restoration, per se. The
+    //  only important parameter really is the stackDepth.
+    //
+
+    stackDepth_set(stackDepth_get()-1);
+}
+
+void
+C_options::error(
+        string          astr_msg        /*= "Some error has occured"    */,
+        int             code            /*= -1                          */)
+{
+    //
+    // ARGS
+    //  atr_msg                 in              message to dump to stderr
+    //  code                    in              error code
+    //
+    // DESC
+    //  Print error related information. This routine throws an exception
+    //  to the class itself, allowing for coarse grained, but simple
+    //  error flagging.
+    //
+
+    cerr << "\nFatal error encountered.\n";
+    cerr << "\tC_options object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "\n";
+    cerr << "Throwing an exception to (this) with code " << code << "\n\n";
+    throw(this);
+}
+
+void
+C_options::warn(
+        string          astr_msg,
+	int             code            /*= -1                  */
+) {
+    //
+    // ARGS
+    //  atr_msg          in              message to dump to stderr
+    //  code             in              error code
+    //
+    // DESC
+    //  Print error related information. Conceptually identical to
+    //  the `error' method, but no expection is thrown.
+    //
+
+    cerr << "\nWarning.\n";
+    cerr << "\tC_options object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "(code: " << code << ")\n";
+}
+
+void
+C_options::core_construct(
+        string          astr_name       /*= "unnamed"           */,
+        int             a_id            /*= -1                  */,
+        int             a_iter          /*= 0                   */,
+        int             a_verbosity     /*= 0                   */,
+        int             a_warnings      /*= 0                   */,
+        int             a_stackDepth    /*= 0                   */,
+        string          astr_proc       /*= "noproc"            */
+) {
+    //
+    // ARGS
+    //  astr_name        in              name of object
+    //  a_id             in              id of object
+    //  a_iter           in              current iteration in arbitrary scheme
+    //  a_verbosity      in              verbosity of object
+    //  a_stackDepth     in              stackDepth
+    //  astr_proc        in              current that has been "debug_push"ed
+    //
+    // DESC
+    //  Simply fill in the core values of the object with some defaults
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding
+    //
+
+    str_name                    = astr_name;
+    id                          = a_id;
+    iter                        = a_iter;
+    verbosity                   = a_verbosity;
+    warnings                    = a_warnings;
+    stackDepth                  = a_stackDepth;
+    str_proc[stackDepth]        = astr_proc;
+
+    pc_tokens			= NULL;
+
+    str_obj                     = "C_options";
+}
+
+C_options::C_options(
+    string		astr_optionsFileName
+) {
+    //
+    // ARGS
+    //	astr_optionsFileName	in		options (meta data) file
+    //
+    // DESC
+    //	Parses the options file, and reads every matrix file it refers
+    //	to. Matrix file names are relative to ADCbaseDirectory, except
+    //	for the 3DflagFile which is used as is.
+    //
+    //	A meta data bundle, named by "metaBundle" or else found under its
+    //	default name in the ADCbaseDirectory, replaces the matrix files
+    //	it contains - if it was made from them and this options file.
+    //
+    // POSTCONDITIONS
+    //	o Matrix files that are named but cannot be read are skipped, so
+    //	  that only the classes that actually need them fail.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    debug_push("C_options");
+
+    const char*		ppch_intFiles[]		= {
+	"ROpePCDimensionFile",	"kListDimensionFile",	"repListDimensionFile",
+	"echoListDimensionFile", NULL
+    };
+    const char*		ppch_realFiles[]	= {
+	"MGH_vox2ras",		"MGH_MRIParameters",	"NIFTI_vox2ras",
+	"NIFTI_MRIParameters",	"A75_voxelDimensions",	NULL
+    };
+    string		str_file;
+
+    pc_tokens			= new C_ascconv(astr_optionsFileName);
+    str_ADCbaseDirectory	= pc_tokens->str_get("ADCbaseDirectory");
+
+    if(b_has("metaBundle"))
+	bundle_load(str_path_get("metaBundle"), astr_optionsFileName);
+    else
+	bundle_load(str_ADCbaseDirectory + "/" + METABUNDLE_FILENAME,
+		    astr_optionsFileName);
+
+    for(int i=0; ppch_intFiles[i]; i++) {
+	if(!b_has(ppch_intFiles[i]) || pMi_get(ppch_intFiles[i]))
+	    continue;
+	str_file	= str_path_get(ppch_intFiles[i]);
+	if(!access(str_file.c_str(), R_OK))
+	    map_Mi[ppch_intFiles[i]]	= new CMatrix<int>((char*) str_file.c_str());
+    }
+    str_file	= str_get("3DflagFile");
+    if(!pMi_get("3DflagFile") && str_file.length() && !access(str_file.c_str(), R_OK))
+	map_Mi["3DflagFile"]	= new CMatrix<int>((char*) str_file.c_str());
+
+    for(int i=0; ppch_realFiles[i]; i++) {
+	if(!b_has(ppch_realFiles[i]) || pMv_get(ppch_realFiles[i]))
+	    continue;
+	str_file	= str_path_get(ppch_realFiles[i]);
+	if(!access(str_file.c_str(), R_OK))
+	    map_Mv[ppch_realFiles[i]]	= new CMatrix<double>((char*) str_file.c_str());
+    }
+
+    debug_pop();
+}
+
+C_options::~C_options() {
+    //
+    // DESC
+    //	Destructor.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    for(map<string, CMatrix<int>*>::iterator i = map_Mi.begin();
+	    i != map_Mi.end(); i++)
+	delete i->second;
+    for(map<string, CMatrix<double>*>::iterator i = map_Mv.begin();
+	    i != map_Mv.end(); i++)
+	delete i->second;
+    delete pc_tokens;
+}
+
+const CMatrix<int>*
+C_options::pMi_get(
+    const string&	astr_key
+) const {
+    map<string, CMatrix<int>*>::const_iterator	i	= map_Mi.find(astr_key);
+    return i == map_Mi.end() ? NULL : i->second;
+}
+
+const CMatrix<double>*
+C_options::pMv_get(
+    const string&	astr_key
+) const {
+    map<string, CMatrix<double>*>::const_iterator	i	= map_Mv.find(astr_key);
+    return i == map_Mv.end() ? NULL : i->second;
+}
+
+string
+C_options::str_path_get(
+    const string&	astr_key
+) const {
+    return str_ADCbaseDirectory + "/" + str_get(astr_key);
+}
+
+bool
+C_options::bundle_load(
+    const string&	astr_fileName,
+    const string&	astr_optionsFileName
+) {
+    //
+    // ARGS
+    //	astr_fileName		in		meta data bundle
+    //	astr_optionsFileName	in		options file being parsed
+    //
+    // DESC
+    //	Fills the matrices (and the Analyze orientation) from a meta data
+    //	bundle. Returns false, changing nothing, if there is no valid
+    //	bundle, or if it was not made from this options file and the
+    //	matrix files it names (see metaBundle_sourcesHash()).
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o Checks the bundle against its sources.
+    //
+
+    s_metaBundle	bundle;
+    CMatrix<int>*	pM;
+    CMatrix<double>*	pMv;
+    stringstream	sout("");
+    vector<string>	v_sources;
+
+    if(!metaBundle_read(astr_fileName, bundle))
+	return false;
+
+    // The 3DflagFile is used as is, the others are relative to the
+    //	ADCbaseDirectory - as in the constructor
+    v_sources.push_back(astr_optionsFileName);
+    for(int i=0; METABUNDLE_SOURCES[i]; i++) {
+	string	str_key	= METABUNDLE_SOURCES[i];
+	if(!b_has(str_key))
+	    v_sources.push_back("");
+	else if(str_key == "3DflagFile")
+	    v_sources.push_back(str_get(str_key));
+	else
+	    v_sources.push_back(str_path_get(str_key));
+    }
+    if(bundle.data.sourcesHash != metaBundle_sourcesHash(v_sources)) {
+	warn("Ignoring " + astr_fileName + ": it does not match the options "
+	     "and matrix files", 1);
+	return false;
+    }
+    str_bundleFile	= astr_fileName;
+
+    pM	= new CMatrix<int>(1, 1);
+    pM->val(0, 0)	= bundle.data.is3D;
+    map_Mi["3DflagFile"]		= pM;
+
+    const char*		ppch_lists[]	= {
+	"echoListDimensionFile", "repListDimensionFile", "kListDimensionFile"
+    };
+    const int*		ppi_lists[]	= {
+	bundle.data.pi_echoList, bundle.data.pi_repList, bundle.data.pi_kList
+    };
+    for(int list=0; list<3; list++) {
+	pM	= new CMatrix<int>(1, 2);
+	pM->val(0, 0)	= ppi_lists[list][0];
+	pM->val(0, 1)	= ppi_lists[list][1];
+	map_Mi[ppch_lists[list]]	= pM;
+    }
+
+    pM	= new CMatrix<int>(1, 3);
+    for(int i=0; i<3; i++)
+	pM->val(0, i)	= bundle.data.pi_ROpePC[i];
+    map_Mi["ROpePCDimensionFile"]	= pM;
+
+    pMv	= new CMatrix<double>(4, 4);
+    for(int i=0; i<16; i++)
+	pMv->val(i/4, i%4)	= bundle.data.pv_vox2ras[i];
+    map_Mv["MGH_vox2ras"]	= pMv;
+
+    pMv	= new CMatrix<double>(1, 3);
+    for(int i=0; i<3; i++)
+	pMv->val(0, i)	= bundle.data.pv_voxelDimension[i];
+    map_Mv["A75_voxelDimensions"]	= pMv;
+
+    if(bundle.v_mriParams.size()) {
+	pMv	= new CMatrix<double>(1, bundle.v_mriParams.size());
+	for(unsigned int i=0; i<bundle.v_mriParams.size(); i++)
+	    pMv->val(0, i)	= bundle.v_mriParams[i];
+	map_Mv["MGH_MRIParameters"]	= pMv;
+    }
+
+    sout << bundle.data.orientationA75;
+    map_override["orientation"]	= sout.str();
+    return true;
+}
+
+bool
+C_options::b_has(
+    const string&	astr_key
+) const {
+    return map_override.count(astr_key) || pc_tokens->b_has(astr_key);
+}
+
+bool
+C_options::scanFor(
+    string		astr_key,
+    string*		apstr_value
+) const {
+    map<string, string>::const_iterator	i	= map_override.find(astr_key);
+    if(i == map_override.end())
+	return pc_tokens->scanFor(astr_key, apstr_value);
+    *apstr_value	= i->second;
+    return true;
+}
+
+string
+C_options::str_get(
+    const string&	astr_key,
+    const string&	astr_default
+) const {
+    string	str_value	= astr_default;
+    scanFor(astr_key, &str_value);
+    return str_value;
+}
+
+int
+C_options::i_get(
+    const string&	astr_key,
+    int			a_default
+) const {
+    string	str_value;
+    return scanFor(astr_key, &str_value) ? atoi(str_value.c_str()) : a_default;
+}
+
+double
+C_options::v_get(
+    const string&	astr_key,
+    double		a_default
+) const {
+    string	str_value;
+    return scanFor(astr_key, &str_value) ? atof(str_value.c_str()) : a_default;
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_options.h
+//
+// DESCRIPTION
+//
+//  `c_options.h' declares the C_options class, the parsed form of an
+//   mdh_process options (meta data) file.
+//
+//   The options file is tokenized once (see c_ascconv.h), and all the
+//   small matrix files it names (dimension lists, vox2ras, MRI parameters,
+//   voxel dimensions, the 3D flag) are read at the same time. The object
+//   is not changed after construction; it is built once at startup and
+//   handed (as a const pointer) to C_dimensionLists and the C_adcPack
+//   classes, none of which then touch the options file again.
+//
+//   If promasc left a meta data bundle (see c_metabundle.h) that was made
+//   from this options file and the matrix files it names, the matrices
+//   and the Analyze orientation are taken from it - a single read - and
+//   the individual matrix files are not opened.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//  o Meta data bundle support.
+//
+
+#ifndef __C_OPTIONS_H__
+#define __C_OPTIONS_H__
+
+#include <iostream>
+#include <string>
+#include <map>
+using namespace std;
+
+#include "cmatrix.h"
+#include "c_ascconv.h"
+#include "c_metabundle.h"
+
+namespace mdh {
+
+const int	C_OPTIONS_STACKDEPTH	= 64;
+
+class C_options {
+
+        // data structures
+
+    protected:
+        //
+        // generic object structures - used for internal bookkeeping
+        // and debugging / automated tracing methods. The stackDepth
+        // and str_proc[] variables are maintained by the debug_push|pop
+        // methods
+        //
+        string  str_obj;                    // name of object class
+        string  str_name;                   // name of object variable
+        int     id;                         // id of agent
+        int     iter;                       // current iteration in an
+                                            //      arbitrary processing scheme
+        int     verbosity;                  // debug related value for object
+        int     warnings;                   // show warnings (and warnings level)
+        int     stackDepth;                 // current pseudo stack depth
+
+        string  str_proc[C_OPTIONS_STACKDEPTH];    // execution procedure stack
+
+	C_ascconv*		pc_tokens;	// key = value pairs of the file
+	string			str_ADCbaseDirectory;
+	string			str_bundleFile;	// meta data bundle used, or ""
+	map<string, string>	map_override;	// values that take precedence
+						//	over the file (from the
+						//	bundle)
+	map<string, CMatrix<int>*>
+				map_Mi;		// integer matrix files, by key
+	map<string, CMatrix<double>*>
+				map_Mv;		// real matrix files, by key
+
+	// Not copyable: the matrices are owned
+	C_options(const C_options&);
+	C_options& operator=(const C_options&);
+
+    // methods
+
+    public:
+        //
+        // constructor / destructor block
+        //
+	C_options(	string			astr_optionsFileName);
+        void    core_construct( string  astr_name               = "unnamed",
+                                int     a_id                    = -1,
+                                int     a_iter                  = 0,
+                                int     a_verbosity             = 0,
+                                int     a_warnings              = 0,
+                                int     a_stackDepth            = 0,
+                                string  astr_proc               = "noproc");
+        ~C_options();
+
+        //
+        // error / warn / print block
+        //
+        void        debug_push(         string astr_currentProc);
+        void        debug_pop();
+
+        void        error(              string  astr_msg        = "Some error has occured",
+                                        int     code            = -1);
+        void        warn(               string  astr_msg        = "",
+                                        int     code            = -1);
+
+        //
+        // access block
+        //
+        int     stackDepth_get()        const {return stackDepth;};
+        void    stackDepth_set(int anum)
+                        { stackDepth = anum;};
+        string  str_proc_get()          const {return str_proc[stackDepth_get()];};
+        void    str_proc_set(int depth, string astr)
+                        { str_proc[depth] = astr;};
+
+	string	str_fileName_get()	const {return pc_tokens->str_fileName_get();};
+	bool	b_read_get()		const {return pc_tokens->b_read_get();};
+	string	str_ADCbaseDirectory_get()
+					const {return str_ADCbaseDirectory;};
+	string	str_bundleFile_get()	const {return str_bundleFile;};
+
+	//
+	// lookup block (see C_ascconv)
+	//
+	bool	b_has(		const string&	astr_key) const;
+	bool	scanFor(	string		astr_key,
+				string*		apstr_value) const;
+	string	str_get(	const string&	astr_key,
+				const string&	astr_default = "") const;
+	int	i_get(		const string&	astr_key,
+				int		a_default = 0) const;
+	double	v_get(		const string&	astr_key,
+				double		a_default = 0.0) const;
+
+	// The matrix read from the file named by a key, or NULL if the key
+	//	is not in the options file (or its file could not be read).
+	const CMatrix<int>*	pMi_get(	const string&	astr_key) const;
+	const CMatrix<double>*	pMv_get(	const string&	astr_key) const;
+
+	// <ADCbaseDirectory>/<value of key>
+	string			str_path_get(	const string&	astr_key) const;
+
+	bool			bundle_load(	const string&	astr_fileName,
+						const string&	astr_optionsFileName);
+
+};
+
+}
+
+#endif //__C_OPTIONS_H__
@@ -0,0 +1,442 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "c_scheduler.h"
+using namespace mdh;
+
+//
+//\\\***
+// C_scheduler definitions ****>>>>
+/////***
+//
+
+void
+C_scheduler::debug_push(
+        string                          astr_currentProc) {
+    //
+    // ARGS
+    //  astr_currentProc        in      method name to
+    //                                          "push" on the "stack"
+    //
+    // DESC
+    //  This attempts to keep a simple record of methods that
+    //  are called. Note that this "stack" is severely crippled in
+    //  that it has no "memory" - names pushed on overwrite those
+    //  currently there.
+    //
+
+    if(stackDepth_get() >= C_SCHEDULER_STACKDEPTH-1)
+        error(  "Out of str_proc stack depth");
+    stackDepth_set(stackDepth_get()+1);
+    str_proc_set(stackDepth_get(), astr_currentProc);
+}
+
+void
+C_scheduler::debug_pop() {
+    //
+    // DESC
+    //  "pop" the stack. Since the previous name has been
+    //  overwritten, there is no restoration, per se. The
+    //  only important parameter really is the stackDepth.
+    //
+
+    stackDepth_set(stackDepth_get()-1);
+}
+
+void
+C_scheduler::error(
+        string          astr_msg        /*= "Some error has occured"    */,
+        int             code            /*= -1                          */)
+{
+    //
+    // ARGS
+    //  atr_msg                 in              message to dump to stderr
+    //  code                    in              error code
+    //
+    // DESC
+    //  Print error related information. This routine throws an exception
+    //  to the class itself, allowing for coarse grained, but simple
+    //  error flagging.
+    //
+
+    cerr << "\nFatal error encountered.\n";
+    cerr << "\tC_scheduler object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "\n";
+    cerr << "Throwing an exception to (this) with code " << code << "\n\n";
+    throw(this);
+}
+
+void
+C_scheduler::warn(
+        string          astr_msg,
+	int             code            /*= -1                  */
+) {
+    //
+    // ARGS
+    //  atr_msg          in              message to dump to stderr
+    //  code             in              error code
+    //
+    // DESC
+    //  Print error related information. Conceptually identical to
+    //  the `error' method, but no expection is thrown.
+    //
+
+    cerr << "\nWarning.\n";
+    cerr << "\tC_scheduler object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "(code: " << code << ")\n";
+}
+
+void
+C_scheduler::core_construct(
+        string          astr_name       /*= "unnamed"           */,
+        int             a_id            /*= -1                  */,
+        int             a_iter          /*= 0                   */,
+        int             a_verbosity     /*= 0                   */,
+        int             a_warnings      /*= 0                   */,
+        int             a_stackDepth    /*= 0                   */,
+        string          astr_proc       /*= "noproc"            */
+) {
+    //
+    // ARGS
+    //  astr_name        in              name of object
+    //  a_id             in              id of object
+    //  a_iter           in              current iteration in arbitrary scheme
+    //  a_verbosity      in              verbosity of object
+    //  a_stackDepth     in              stackDepth
+    //  astr_proc        in              current that has been "debug_push"ed
+    //
+    // DESC
+    //  Simply fill in the core values of the object with some defaults
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding
+    //
+
+    str_name                    = astr_name;
+    id                          = a_id;
+    iter                        = a_iter;
+    verbosity                   = a_verbosity;
+    warnings                    = a_warnings;
+    stackDepth                  = a_stackDepth;
+    str_proc[stackDepth]        = astr_proc;
+
+    units			= 0;
+    workers			= 1;
+    worker			= 0;
+    pch_shared			= NULL;
+    sharedSize			= 0;
+    dequeSize			= 0;
+
+    str_obj                     = "C_scheduler";
+}
+
+C_scheduler::C_scheduler(
+    int			a_units,
+    int			a_workers
+) {
+    //
+    // ARGS
+    //	a_units			in		number of units of work
+    //	a_workers		in		number of workers
+    //
+    // DESC
+    //	Sets up one deque per worker in a shared anonymous mapping, and
+    //	deals the units out in contiguous blocks.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    debug_push("C_scheduler");
+
+    pthread_mutexattr_t	attr;
+    void*		p_map;
+    int			w, i, first, last;
+
+    units		= a_units > 0 ? a_units : 0;
+    workers		= a_workers > 0 ? a_workers : 1;
+
+    // Each deque on its own cache lines
+    dequeSize		= sizeof(s_unitDeque) + units*sizeof(int);
+    dequeSize		= (dequeSize + 63) & ~((size_t) 63);
+    sharedSize		= workers*dequeSize;
+    p_map		= mmap(NULL, sharedSize, PROT_READ | PROT_WRITE,
+			       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(p_map == MAP_FAILED)
+	error("Could not map the unit deques", 1);
+    pch_shared		= (char*) p_map;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    for(w=0; w<workers; w++) {
+	s_unitDeque*	pdeque	= deque_get(w);
+	int*		pi_units	= pi_units_get(w);
+	pthread_mutex_init(&pdeque->mutex, &attr);
+	first		= (int) ((long) units*w / workers);
+	last		= (int) ((long) units*(w+1) / workers);
+	for(i=first; i<last; i++)
+	    pi_units[i-first]	= i;
+	pdeque->front	= 0;
+	pdeque->back	= last-first;
+	pdeque->done	= 0;
+	pdeque->stolen	= 0;
+    }
+    pthread_mutexattr_destroy(&attr);
+
+    debug_pop();
+}
+
+C_scheduler::~C_scheduler() {
+    //
+    // DESC
+    //	Destructor. Only reached in worker 0: the children leave through
+    //	workers_join().
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    if(pch_shared) {
+	for(int w=0; w<workers; w++)
+	    pthread_mutex_destroy(&deque_get(w)->mutex);
+	munmap(pch_shared, sharedSize);
+    }
+}
+
+s_unitDeque*
+C_scheduler::deque_get(
+    int			a_worker
+) const {
+    return (s_unitDeque*) (pch_shared + a_worker*dequeSize);
+}
+
+int*
+C_scheduler::pi_units_get(
+    int			a_worker
+) const {
+    return (int*) (pch_shared + a_worker*dequeSize + sizeof(s_unitDeque));
+}
+
+int
+C_scheduler::workers_fork() {
+    //
+    // DESC
+    //	Forks workers-1 processes; see c_scheduler.h.
+    //
+    // PRECONDITIONS
+    //	o No other threads are running in the calling process.
+    //
+    // POSTCONDITIONS
+    //	o Buffered output is flushed first, so that it is not repeated
+    //	  by every child.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    debug_push("workers_fork");
+
+    pid_t		pid;
+
+    cout.flush();
+    cerr.flush();
+    fflush(NULL);
+
+    for(int w=1; w<workers; w++) {
+	pid	= fork();
+	if(!pid) {
+	    worker	= w;
+	    v_children.clear();
+	    debug_pop();
+	    return worker;
+	}
+	if(pid < 0) {
+	    warn("Could not fork worker; its units will be stolen", 1);
+	    continue;
+	}
+	v_children.push_back(pid);
+    }
+
+    debug_pop();
+    return worker;
+}
+
+int
+C_scheduler::unit_next() {
+    //
+    // DESC
+    //	Takes the next unit from the front of this worker's deque or,
+    //	if that is empty, steals one from the back of the fullest other
+    //	deque.
+    //
+    // POSTCONDITIONS
+    //	o Returns -1 when no deque holds any units.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    s_unitDeque*	pown	= deque_get(worker);
+    s_unitDeque*	pvictim;
+    int			unit	= -1;
+    int			victim, most, left, w;
+
+    pthread_mutex_lock(&pown->mutex);
+    if(pown->front < pown->back)
+	unit	= pi_units_get(worker)[pown->front++];
+    pthread_mutex_unlock(&pown->mutex);
+    if(unit >= 0) {
+	pown->done++;
+	return unit;
+    }
+
+    for(;;) {
+	// The counts are only read here to pick a victim, and rechecked
+	//	under its lock.
+	victim	= -1;
+	most	= 0;
+	for(w=0; w<workers; w++) {
+	    if(w == worker)
+		continue;
+	    left	= deque_get(w)->back - deque_get(w)->front;
+	    if(left > most) {
+		most	= left;
+		victim	= w;
+	    }
+	}
+	if(victim < 0)
+	    return -1;
+	pvictim	= deque_get(victim);
+	pthread_mutex_lock(&pvictim->mutex);
+	if(pvictim->front < pvictim->back)
+	    unit	= pi_units_get(victim)[--pvictim->back];
+	pthread_mutex_unlock(&pvictim->mutex);
+	if(unit >= 0) {
+	    pown->done++;
+	    pown->stolen++;
+	    return unit;
+	}
+    }
+}
+
+bool
+C_scheduler::workers_join(
+    int			a_code
+) {
+    //
+    // ARGS
+    //	a_code			in		exit code of a child
+    //
+    // DESC
+    //	Ends the parallel section; see c_scheduler.h. Children _exit()
+    //	so that no destructors or exit handlers of the parent's objects
+    //	(open containers, temporary files) run twice.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    bool		b_ok	= true;
+    int			status;
+
+    if(worker) {
+	cout.flush();
+	cerr.flush();
+	fflush(NULL);
+	_exit(a_code);
+    }
+
+    debug_push("workers_join");
+    for(unsigned i=0; i<v_children.size(); i++) {
+	if(waitpid(v_children[i], &status, 0) < 0 ||
+	   !WIFEXITED(status) || WEXITSTATUS(status))
+	    b_ok	= false;
+    }
+    v_children.clear();
+    debug_pop();
+    return b_ok;
+}
+
+int
+C_scheduler::done_get(
+    int			a_worker
+) const {
+    return deque_get(a_worker)->done;
+}
+
+int
+C_scheduler::stolen_get(
+    int			a_worker
+) const {
+    return deque_get(a_worker)->stolen;
+}
+
+int
+C_scheduler::workers_plan(
+    int			a_workers,
+    int			a_units,
+    double		a_unitBytes,
+    double		a_budgetBytes
+) {
+    //
+    // ARGS
+    //	a_workers		in		requested workers (0: one per
+    //							online CPU)
+    //	a_units			in		units of work
+    //	a_unitBytes		in		memory needed per unit in
+    //							flight
+    //	a_budgetBytes		in		memory available (0: the
+    //							available physical
+    //							memory)
+    //
+    // DESC
+    //	Caps the number of workers - and so of units in flight - by the
+    //	CPUs, the work and the memory.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    int			workers	= a_workers;
+    double		budget	= a_budgetBytes;
+
+    if(workers <= 0)
+	workers	= (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(budget <= 0)
+	budget	= (double) sysconf(_SC_AVPHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    if(a_unitBytes > 0 && budget / a_unitBytes < workers)
+	workers	= (int) (budget / a_unitBytes);
+    if(workers > a_units)
+	workers	= a_units;
+    if(workers < 1)
+	workers	= 1;
+    return workers;
+}
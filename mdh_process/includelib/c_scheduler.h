@@ -0,0 +1,171 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_scheduler.h
+//
+// DESCRIPTION
+//
+//  `c_scheduler.h' declares the C_scheduler class, a work-stealing
+//   scheduler that hands out numbered, independent units of work (the
+//   (repetition, echo) volumes of a channel) to a set of worker
+//   processes.
+//
+//   Workers are fork()ed processes rather than threads: the
+//   reconstruction chain keeps its current volume in the C_adcPack and
+//   C_IO objects, so each worker needs a private copy of those, which
+//   fork() provides (the unpacked k-space is shared copy-on-write and
+//   only read).
+//
+//   Every worker owns a deque of units in shared memory, initially a
+//   contiguous block of the unit range. A worker takes units from the
+//   front of its own deque; once that is empty, it steals from the back
+//   of the fullest other deque. Each deque has its own process-shared
+//   mutex, so workers only contend when stealing.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//
+
+#ifndef __C_SCHEDULER_H__
+#define __C_SCHEDULER_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/types.h>
+using namespace std;
+
+namespace mdh {
+
+const int	C_SCHEDULER_STACKDEPTH	= 64;
+
+    // A unit deque, living in shared memory. The units themselves
+    //	follow the header.
+    typedef struct _unitDeque {
+	pthread_mutex_t	mutex;
+	int		front;			// next unit to take
+	int		back;			// one past the last unit
+	int		done;			// units run by the owner
+	int		stolen;			// units stolen by the owner
+    } s_unitDeque;
+
+class C_scheduler {
+
+        // data structures
+
+    protected:
+        //
+        // generic object structures - used for internal bookkeeping
+        // and debugging / automated tracing methods. The stackDepth
+        // and str_proc[] variables are maintained by the debug_push|pop
+        // methods
+        //
+        string  str_obj;                    // name of object class
+        string  str_name;                   // name of object variable
+        int     id;                         // id of agent
+        int     iter;                       // current iteration in an
+                                            //      arbitrary processing scheme
+        int     verbosity;                  // debug related value for object
+        int     warnings;                   // show warnings (and warnings level)
+        int     stackDepth;                 // current pseudo stack depth
+
+        string  str_proc[C_SCHEDULER_STACKDEPTH];    // execution procedure stack
+
+	int			units;		// units 0 ... units-1
+	int			workers;	// deques / worker processes
+	int			worker;		// this process' worker index
+	char*			pch_shared;	// shared mapping of the deques
+	size_t			sharedSize;
+	size_t			dequeSize;	// bytes per deque
+	vector<pid_t>		v_children;	// forked workers (in worker 0)
+
+	s_unitDeque*		deque_get(	int		a_worker) const;
+	int*			pi_units_get(	int		a_worker) const;
+
+	// Not copyable: owns the shared mapping
+	C_scheduler(const C_scheduler&);
+	C_scheduler& operator=(const C_scheduler&);
+
+    // methods
+
+    public:
+        //
+        // constructor / destructor block
+        //
+	C_scheduler(	int			a_units,
+			int			a_workers);
+        void    core_construct( string  astr_name               = "unnamed",
+                                int     a_id                    = -1,
+                                int     a_iter                  = 0,
+                                int     a_verbosity             = 0,
+                                int     a_warnings              = 0,
+                                int     a_stackDepth            = 0,
+                                string  astr_proc               = "noproc");
+        ~C_scheduler();
+
+        //
+        // error / warn / print block
+        //
+        void        debug_push(         string astr_currentProc);
+        void        debug_pop();
+
+        void        error(              string  astr_msg        = "Some error has occured",
+                                        int     code            = -1);
+        void        warn(               string  astr_msg        = "",
+                                        int     code            = -1);
+
+        //
+        // access block
+        //
+        int     stackDepth_get()        const {return stackDepth;};
+        void    stackDepth_set(int anum)
+                        { stackDepth = anum;};
+        string  str_proc_get()          const {return str_proc[stackDepth_get()];};
+        void    str_proc_set(int depth, string astr)
+                        { str_proc[depth] = astr;};
+
+	int	units_get()		const {return units;};
+	int	workers_get()		const {return workers;};
+	int	worker_get()		const {return worker;};
+
+	//
+	// scheduling block
+	//
+	// Forks workers-1 processes. Returns the worker index of the
+	//	calling process: 0 in the parent, 1 ... workers-1 in the
+	//	children. Workers that cannot be forked leave their units to
+	//	be stolen.
+	int	workers_fork();
+	// The next unit for this worker, or -1 once all units are taken.
+	int	unit_next();
+	// In a child: exits with a_code. In worker 0: waits for all the
+	//	children, and returns false if any of them failed.
+	bool	workers_join(		int		a_code);
+	// Units run / stolen by a worker (valid after workers_join()).
+	int	done_get(		int		a_worker) const;
+	int	stolen_get(		int		a_worker) const;
+
+	// How many workers to use: at most a_workers (0: one per online
+	//	CPU), at most a_units, and no more than fit a_unitBytes each
+	//	into a_budgetBytes (0: the available physical memory).
+	static int	workers_plan(	int		a_workers,
+					int		a_units,
+					double		a_unitBytes,
+					double		a_budgetBytes);
+
+};
+
+}
+
+#endif //__C_SCHEDULER_H__
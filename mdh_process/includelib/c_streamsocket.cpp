@@ -0,0 +1,442 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+using namespace std;
+
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "c_streamsocket.h"
+using namespace mdh;
+
+//
+//\\\***
+// C_streamSocket definitions ****>>>>
+/////***
+//
+
+void
+C_streamSocket::debug_push(
+        string                          astr_currentProc) {
+    //
+    // ARGS
+    //  astr_currentProc        in      method name to
+    //                                          "push" on the "stack"
+    //
+    // DESC
+    //  This attempts to keep a simple record of methods that
+    //  are called. Note that this "stack" is severely crippled in
+    //  that it has no "memory" - names pushed on overwrite those
+    //  currently there.
+    //
+
+    if(stackDepth_get() >= C_STREAMSOCKET_STACKDEPTH-1)
+        error(  "Out of str_proc stack depth");
+    stackDepth_set(stackDepth_get()+1);
+    str_proc_set(stackDepth_get(), astr_currentProc);
+}
+
+void
+C_streamSocket::debug_pop() {
+    //
+    // DESC
+    //  "pop" the stack. Since the previous name has been
+    //  overwritten, there is no restoration, per se. The
+    //  only important parameter really is the stackDepth.
+    //
+
+    stackDepth_set(stackDepth_get()-1);
+}
+
+void
+C_streamSocket::error(
+        string          astr_msg        /*= "Some error has occured"    */,
+        int             code            /*= -1                          */)
+{
+    //
+    // ARGS
+    //  atr_msg                 in              message to dump to stderr
+    //  code                    in              error code
+    //
+    // DESC
+    //  Print error related information. This routine throws an exception
+    //  to the class itself, allowing for coarse grained, but simple
+    //  error flagging.
+    //
+
+    cerr << "\nFatal error encountered.\n";
+    cerr << "\tC_streamSocket object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "\n";
+    cerr << "Throwing an exception to (this) with code " << code << "\n\n";
+    throw(this);
+}
+
+void
+C_streamSocket::warn(
+        string          astr_msg,
+	int             code            /*= -1                  */
+) {
+    //
+    // ARGS
+    //  atr_msg          in              message to dump to stderr
+    //  code             in              error code
+    //
+    // DESC
+    //  Print error related information. Conceptually identical to
+    //  the `error' method, but no expection is thrown.
+    //
+
+    cerr << "\nWarning.\n";
+    cerr << "\tC_streamSocket object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "(code: " << code << ")\n";
+}
+
+void
+C_streamSocket::core_construct(
+        string          astr_name       /*= "unnamed"           */,
+        int             a_id            /*= -1                  */,
+        int             a_iter          /*= 0                   */,
+        int             a_verbosity     /*= 0                   */,
+        int             a_warnings      /*= 0                   */,
+        int             a_stackDepth    /*= 0                   */,
+        string          astr_proc       /*= "noproc"            */
+) {
+    //
+    // ARGS
+    //  astr_name        in              name of object
+    //  a_id             in              id of object
+    //  a_iter           in              current iteration in arbitrary scheme
+    //  a_verbosity      in              verbosity of object
+    //  a_stackDepth     in              stackDepth
+    //  astr_proc        in              current that has been "debug_push"ed
+    //
+    // DESC
+    //  Simply fill in the core values of the object with some defaults
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding
+    //
+
+    str_name                    = astr_name;
+    id                          = a_id;
+    iter                        = a_iter;
+    verbosity                   = a_verbosity;
+    warnings                    = a_warnings;
+    stackDepth                  = a_stackDepth;
+    str_proc[stackDepth]        = astr_proc;
+
+    str_address			= "";
+    str_unixPath		= "";
+    e_role			= e_socketConnect;
+    fd				= -1;
+    str_pending			= "";
+
+    str_obj                     = "C_streamSocket";
+}
+
+C_streamSocket::C_streamSocket(
+    string		astr_address,
+    e_SOCKETROLE	ae_role
+) {
+    //
+    // ARGS
+    //	astr_address		in		address (see c_streamsocket.h)
+    //	ae_role			in		e_socketListen or
+    //							e_socketConnect
+    //
+    // DESC
+    //	Opens a socket listening on, or connected to, an address.
+    //
+    // POSTCONDITIONS
+    //	o If the socket could not be opened, a warning is shown and
+    //	  b_isOpen() is false.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    debug_push("C_streamSocket");
+
+    string		str_host	= "127.0.0.1";
+    string		str_port	= "";
+    string		str_rest	= astr_address;
+    struct addrinfo	s_hints;
+    struct addrinfo*	ps_addresses	= NULL;
+    struct addrinfo*	ps_address;
+    struct sockaddr_un	s_unix;
+    size_t		colon;
+    int			one		= 1;
+
+    str_address		= astr_address;
+    e_role		= ae_role;
+
+    if(!str_rest.compare(0, 5, "unix:") || str_rest.find('/') != string::npos) {
+	if(!str_rest.compare(0, 5, "unix:"))
+	    str_rest	= str_rest.substr(5);
+	memset(&s_unix, 0, sizeof(s_unix));
+	s_unix.sun_family	= AF_UNIX;
+	if(str_rest.length() >= sizeof(s_unix.sun_path)) {
+	    warn("Unix domain socket path too long: " + str_rest, 1);
+	    debug_pop();
+	    return;
+	}
+	strcpy(s_unix.sun_path, str_rest.c_str());
+	fd	= socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd >= 0 && e_role == e_socketListen) {
+	    unlink(str_rest.c_str());
+	    if(bind(fd, (struct sockaddr*) &s_unix, sizeof(s_unix)) ||
+	       listen(fd, STREAMSOCKET_BACKLOG)) {
+		::close(fd);
+		fd		= -1;
+	    } else
+		str_unixPath	= str_rest;
+	} else if(fd >= 0 && connect(fd, (struct sockaddr*) &s_unix, sizeof(s_unix))) {
+	    ::close(fd);
+	    fd		= -1;
+	}
+    } else {
+	if(!str_rest.compare(0, 4, "tcp:"))
+	    str_rest	= str_rest.substr(4);
+	colon		= str_rest.rfind(':');
+	if(colon != string::npos) {
+	    str_host	= str_rest.substr(0, colon);
+	    str_port	= str_rest.substr(colon+1);
+	} else
+	    str_port	= str_rest;
+	memset(&s_hints, 0, sizeof(s_hints));
+	s_hints.ai_family	= AF_UNSPEC;
+	s_hints.ai_socktype	= SOCK_STREAM;
+	if(e_role == e_socketListen)
+	    s_hints.ai_flags	= AI_PASSIVE;
+	if(getaddrinfo(str_host.length() && str_host != "*" ? str_host.c_str() : NULL,
+		       str_port.c_str(), &s_hints, &ps_addresses))
+	    ps_addresses	= NULL;
+	for(ps_address = ps_addresses; ps_address && fd < 0;
+	    ps_address = ps_address->ai_next) {
+	    fd	= socket(ps_address->ai_family, ps_address->ai_socktype,
+			 ps_address->ai_protocol);
+	    if(fd < 0)
+		continue;
+	    if(e_role == e_socketListen) {
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if(!bind(fd, ps_address->ai_addr, ps_address->ai_addrlen) &&
+		   !listen(fd, STREAMSOCKET_BACKLOG))
+		    continue;
+	    } else if(!connect(fd, ps_address->ai_addr, ps_address->ai_addrlen)) {
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		continue;
+	    }
+	    ::close(fd);
+	    fd	= -1;
+	}
+	if(ps_addresses)
+	    freeaddrinfo(ps_addresses);
+    }
+    if(fd < 0)
+	warn(string("Could not ") + (e_role == e_socketListen ? "listen on " : "connect to ") +
+	     str_address, 1);
+
+    debug_pop();
+}
+
+C_streamSocket::C_streamSocket(
+    int			a_fd
+) {
+    //
+    // ARGS
+    //	a_fd			in		accepted connection
+    //
+    // DESC
+    //	Wraps a connection returned by accept().
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    e_role		= e_socketAccepted;
+    fd			= a_fd;
+}
+
+C_streamSocket::~C_streamSocket() {
+    //
+    // DESC
+    //	Destructor. Closes the socket.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    close();
+}
+
+C_streamSocket*
+C_streamSocket::connection_accept() {
+    //
+    // DESC
+    //	Waits for the next connection to a listening socket.
+    //
+    // POSTCONDITIONS
+    //	o Returns a new (caller owned) socket for the connection, or NULL
+    //	  if the wait was interrupted or failed.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    int			connection;
+
+    if(e_role != e_socketListen || fd < 0)
+	return NULL;
+    connection	= accept(fd, NULL, NULL);
+    if(connection < 0)
+	return NULL;
+    return new C_streamSocket(connection);
+}
+
+bool
+C_streamSocket::str_send(
+    const string&	astr
+) {
+    //
+    // ARGS
+    //	astr			in		data to send
+    //
+    // DESC
+    //	Sends all of astr. A peer that has gone away does not raise
+    //	SIGPIPE; the send just fails.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    size_t		sent	= 0;
+    ssize_t		bytes;
+
+    while(fd >= 0 && sent < astr.length()) {
+	bytes	= send(fd, astr.data() + sent, astr.length() - sent, MSG_NOSIGNAL);
+	if(bytes <= 0)
+	    return false;
+	sent	+= bytes;
+    }
+    return fd >= 0;
+}
+
+bool
+C_streamSocket::pending_receive() {
+    //
+    // DESC
+    //	Appends what the peer has sent (up to one buffer's worth) to the
+    //	buffer that line_read() returns from, without waiting for more. Lets a
+    //	caller that polls many sockets collect a line piecemeal, and only
+    //	call line_read() once b_lineBuffered() (or the stream has ended).
+    //
+    // POSTCONDITIONS
+    //	o Returns false once the stream has ended (or failed); what was
+    //	  buffered is still returned by line_read().
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    char		pch_buffer[4096];
+    ssize_t		bytes;
+
+    if(fd < 0)
+	return false;
+    bytes	= recv(fd, pch_buffer, sizeof(pch_buffer), MSG_DONTWAIT);
+    if(bytes > 0) {
+	str_pending.append(pch_buffer, bytes);
+	return true;
+    }
+    return bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+}
+
+bool
+C_streamSocket::line_read(
+    string&		astr_line
+) {
+    //
+    // ARGS
+    //	astr_line		out		next line, without its '\n'
+    //
+    // DESC
+    //	Reads up to the next '\n'. A last line that the peer did not
+    //	terminate is still returned.
+    //
+    // POSTCONDITIONS
+    //	o Returns false once the stream has ended (or failed) and no
+    //	  data are left.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    char		pch_buffer[4096];
+    ssize_t		bytes;
+    size_t		newline;
+
+    while((newline = str_pending.find('\n')) == string::npos) {
+	bytes	= fd >= 0 ? recv(fd, pch_buffer, sizeof(pch_buffer), 0) : 0;
+	if(bytes <= 0) {
+	    if(!str_pending.length())
+		return false;
+	    astr_line	= str_pending;
+	    str_pending	= "";
+	    return true;
+	}
+	str_pending.append(pch_buffer, bytes);
+    }
+    astr_line	= str_pending.substr(0, newline);
+    str_pending.erase(0, newline+1);
+    return true;
+}
+
+void
+C_streamSocket::close() {
+    //
+    // DESC
+    //	Closes the socket. A listening Unix domain socket also removes
+    //	its socket file.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    if(fd >= 0)
+	::close(fd);
+    fd		= -1;
+    if(str_unixPath.length())
+	unlink(str_unixPath.c_str());
+    str_unixPath	= "";
+}
@@ -0,0 +1,159 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_streamsocket.h
+//
+// DESCRIPTION
+//
+//  `c_streamsocket.h' declares the C_streamSocket class, a line oriented
+//   stream (Unix domain or TCP) socket. It carries the recon job requests
+//   of --serve, --submit and --distribute, where the C_SSocket (UDP
+//   datagram) classes would lose or reorder the progress messages.
+//
+//   Addresses are given as
+//
+//	unix:<path>		Unix domain socket
+//	<path>			(anything containing a '/')
+//	tcp:<host>:<port>	TCP socket
+//	<host>:<port>
+//	<port>			TCP on the loopback interface
+//
+//   A listening socket on a Unix domain path replaces a stale socket file
+//   of that name, and removes it again when closed.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//
+
+#ifndef __C_STREAMSOCKET_H__
+#define __C_STREAMSOCKET_H__
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+namespace mdh {
+
+const int	C_STREAMSOCKET_STACKDEPTH	= 64;
+const int	STREAMSOCKET_BACKLOG		= 16;	// pending connections
+
+    typedef enum _socketRole {
+	e_socketListen		= 0,
+	e_socketConnect		= 1,
+	e_socketAccepted	= 2
+    } e_SOCKETROLE;
+
+class C_streamSocket {
+
+        // data structures
+
+    protected:
+        //
+        // generic object structures - used for internal bookkeeping
+        // and debugging / automated tracing methods. The stackDepth
+        // and str_proc[] variables are maintained by the debug_push|pop
+        // methods
+        //
+        string  str_obj;                    // name of object class
+        string  str_name;                   // name of object variable
+        int     id;                         // id of agent
+        int     iter;                       // current iteration in an
+                                            //      arbitrary processing scheme
+        int     verbosity;                  // debug related value for object
+        int     warnings;                   // show warnings (and warnings level)
+        int     stackDepth;                 // current pseudo stack depth
+
+        string  str_proc[C_STREAMSOCKET_STACKDEPTH];  // execution procedure stack
+
+	string			str_address;	// as given
+	string			str_unixPath;	// bound Unix domain path, or ""
+	e_SOCKETROLE		e_role;
+	int			fd;
+	string			str_pending;	// received, not yet returned
+						//	by line_read()
+
+	C_streamSocket(		int			a_fd);
+
+	// Not copyable: owns the descriptor
+	C_streamSocket(const C_streamSocket&);
+	C_streamSocket& operator=(const C_streamSocket&);
+
+    // methods
+
+    public:
+        //
+        // constructor / destructor block
+        //
+	C_streamSocket(	string			astr_address,
+			e_SOCKETROLE		ae_role);
+        void    core_construct( string  astr_name               = "unnamed",
+                                int     a_id                    = -1,
+                                int     a_iter                  = 0,
+                                int     a_verbosity             = 0,
+                                int     a_warnings              = 0,
+                                int     a_stackDepth            = 0,
+                                string  astr_proc               = "noproc");
+        ~C_streamSocket();
+
+        //
+        // error / warn / print block
+        //
+        void        debug_push(         string astr_currentProc);
+        void        debug_pop();
+
+        void        error(              string  astr_msg        = "Some error has occured",
+                                        int     code            = -1);
+        void        warn(               string  astr_msg        = "",
+                                        int     code            = -1);
+
+        //
+        // access block
+        //
+        int     stackDepth_get()        const {return stackDepth;};
+        void    stackDepth_set(int anum)
+                        { stackDepth = anum;};
+        string  str_proc_get()          const {return str_proc[stackDepth_get()];};
+        void    str_proc_set(int depth, string astr)
+                        { str_proc[depth] = astr;};
+
+	string		str_address_get()	const {return str_address;};
+	e_SOCKETROLE	e_role_get()		const {return e_role;};
+	int		fd_get()		const {return fd;};
+	bool		b_isOpen()		const {return fd >= 0;};
+	// A whole line has been received, that line_read() returns
+	//	without waiting.
+	bool		b_lineBuffered()	const
+			{return str_pending.find('\n') != string::npos;};
+	size_t		pendingLength_get()	const {return str_pending.length();};
+
+        //
+        // miscellaneous block
+        //
+	// The next connection to a listening socket (NULL on failure).
+	C_streamSocket*		connection_accept();
+	// Sends astr whole. False if the peer has gone.
+	bool			str_send(	const string&	astr);
+	// Adds what has been received to the line buffer, without
+	//	waiting. False once the stream has ended.
+	bool			pending_receive();
+	// The next '\n' terminated line (without the '\n'). False at the
+	//	end of the stream.
+	bool			line_read(	string&		astr_line);
+	// Closes the socket (and removes a Unix domain socket file).
+	void			close();
+
+};
+
+}
+
+#endif //__C_STREAMSOCKET_H__
@@ -0,0 +1,625 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+using namespace std;
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "c_volumering.h"
+using namespace mdh;
+
+//
+//\\\***
+// C_volumeRing definitions ****>>>>
+/////***
+//
+
+void
+C_volumeRing::debug_push(
+        string                          astr_currentProc) {
+    //
+    // ARGS
+    //  astr_currentProc        in      method name to
+    //                                          "push" on the "stack"
+    //
+    // DESC
+    //  This attempts to keep a simple record of methods that
+    //  are called. Note that this "stack" is severely crippled in
+    //  that it has no "memory" - names pushed on overwrite those
+    //  currently there.
+    //
+
+    if(stackDepth_get() >= C_VOLUMERING_STACKDEPTH-1)
+        error(  "Out of str_proc stack depth");
+    stackDepth_set(stackDepth_get()+1);
+    str_proc_set(stackDepth_get(), astr_currentProc);
+}
+
+void
+C_volumeRing::debug_pop() {
+    //
+    // DESC
+    //  "pop" the stack. Since the previous name has been
+    //  overwritten, there is no restoration, per se. The
+    //  only important parameter really is the stackDepth.
+    //
+
+    stackDepth_set(stackDepth_get()-1);
+}
+
+void
+C_volumeRing::error(
+        string          astr_msg        /*= "Some error has occured"    */,
+        int             code            /*= -1                          */)
+{
+    //
+    // ARGS
+    //  atr_msg                 in              message to dump to stderr
+    //  code                    in              error code
+    //
+    // DESC
+    //  Print error related information. This routine throws an exception
+    //  to the class itself, allowing for coarse grained, but simple
+    //  error flagging.
+    //
+
+    cerr << "\nFatal error encountered.\n";
+    cerr << "\tC_volumeRing object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "\n";
+    cerr << "Throwing an exception to (this) with code " << code << "\n\n";
+    throw(this);
+}
+
+void
+C_volumeRing::warn(
+        string          astr_msg,
+	int             code            /*= -1                  */
+) {
+    //
+    // ARGS
+    //  atr_msg          in              message to dump to stderr
+    //  code             in              error code
+    //
+    // DESC
+    //  Print error related information. Conceptually identical to
+    //  the `error' method, but no expection is thrown.
+    //
+
+    cerr << "\nWarning.\n";
+    cerr << "\tC_volumeRing object `" << str_name << "' (id: " << id << ")\n";
+    cerr << "\tCurrent function: " << str_obj << "::" << str_proc_get() << "\n";
+    cerr << "\t" << astr_msg << "(code: " << code << ")\n";
+}
+
+void
+C_volumeRing::core_construct(
+        string          astr_name       /*= "unnamed"           */,
+        int             a_id            /*= -1                  */,
+        int             a_iter          /*= 0                   */,
+        int             a_verbosity     /*= 0                   */,
+        int             a_warnings      /*= 0                   */,
+        int             a_stackDepth    /*= 0                   */,
+        string          astr_proc       /*= "noproc"            */
+) {
+    //
+    // ARGS
+    //  astr_name        in              name of object
+    //  a_id             in              id of object
+    //  a_iter           in              current iteration in arbitrary scheme
+    //  a_verbosity      in              verbosity of object
+    //  a_stackDepth     in              stackDepth
+    //  astr_proc        in              current that has been "debug_push"ed
+    //
+    // DESC
+    //  Simply fill in the core values of the object with some defaults
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding
+    //
+
+    str_name                    = astr_name;
+    id                          = a_id;
+    iter                        = a_iter;
+    verbosity                   = a_verbosity;
+    warnings                    = a_warnings;
+    stackDepth                  = a_stackDepth;
+    str_proc[stackDepth]        = astr_proc;
+
+    str_ringName		= "";
+    b_producer			= false;
+    pch_map			= NULL;
+    mapSize			= 0;
+    pheader			= NULL;
+    next			= 0;
+    timeout			= VOLUMERING_TIMEOUT;
+
+    str_obj                     = "C_volumeRing";
+}
+
+C_volumeRing::C_volumeRing(
+    string		astr_ringName,
+    int			a_slots,
+    long long		a_slotBytes,
+    int			a_readers	/*= 1			*/,
+    int			a_timeout	/*= VOLUMERING_TIMEOUT	*/
+) {
+    //
+    // ARGS
+    //	astr_ringName		in		POSIX shared memory object
+    //						name ("/<name>")
+    //	a_slots			in		volumes the ring holds
+    //	a_slotBytes		in		largest volume (bytes)
+    //	a_readers		in		readers that take every
+    //						volume
+    //	a_timeout		in		seconds that volume_publish()
+    //						and close() wait for
+    //						the readers
+    //
+    // DESC
+    //	Producer constructor. A ring of the same name left behind by an
+    //	earlier run is replaced; readers still attached to it keep their
+    //	mapping of the old one.
+    //
+    //	The object is sized up front, but only the pages that are
+    //	written take memory.
+    //
+    // POSTCONDITIONS
+    //	o If the ring could not be created, a warning is shown and
+    //	  b_isOpen() is false.
+    //	o The header is initialised before its magic is set, so a reader
+    //	  attaching too early finds an invalid ring rather than a
+    //	  half initialised one.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    debug_push("C_volumeRing");
+
+    pthread_mutexattr_t	mutexAttr;
+    pthread_condattr_t	condAttr;
+    s_ringHeader*	ph;
+    long long		tableBytes;
+    int			fd;
+    void*		p_map;
+
+    str_ringName	= astr_ringName;
+    b_producer		= true;
+    timeout		= a_timeout > 0 ? a_timeout : VOLUMERING_TIMEOUT;
+    if(a_slots < 1)
+	a_slots		= 1;
+    if(a_readers < 1)
+	a_readers	= 1;
+
+    tableBytes		= (a_slots * (long long) sizeof(s_ringSlot) + VOLUMERING_PAGE - 1) /
+			  VOLUMERING_PAGE * VOLUMERING_PAGE;
+    shm_unlink(str_ringName.c_str());
+    fd			= shm_open(str_ringName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd < 0) {
+	warn("Could not create volume ring " + str_ringName, 1);
+	debug_pop();
+	return;
+    }
+    long long	slotStride	= (a_slotBytes + VOLUMERING_PAGE - 1) /
+				  VOLUMERING_PAGE * VOLUMERING_PAGE;
+    mapSize		= VOLUMERING_PAGE + tableBytes + a_slots * slotStride;
+    p_map		= MAP_FAILED;
+    if(!ftruncate(fd, mapSize))
+	p_map	= mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(p_map == MAP_FAILED) {
+	warn("Could not map volume ring " + str_ringName, 1);
+	shm_unlink(str_ringName.c_str());
+	mapSize	= 0;
+	debug_pop();
+	return;
+    }
+    pch_map		= (char*) p_map;
+
+    ph			= (s_ringHeader*) pch_map;
+    ph->version		= VOLUMERING_VERSION;
+    ph->slots		= a_slots;
+    ph->readers		= a_readers;
+    ph->closed		= 0;
+    ph->slotBytes	= a_slotBytes;
+    ph->slotStride	= slotStride;
+    ph->payloadOffset	= VOLUMERING_PAGE + tableBytes;
+    ph->published	= 0;
+    // A reader that dies holding the mutex does not take the ring with it
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&ph->mutex, &mutexAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&ph->cond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+    for(int i=0; i<a_slots; i++) {
+	s_ringSlot*	pslot	= (s_ringSlot*) (pch_map + VOLUMERING_PAGE) + i;
+	pslot->sequence	= -1;
+	pslot->state	= e_slotFree;
+	pslot->pending	= 0;
+    }
+    __sync_synchronize();
+    memcpy(ph->pch_magic, VOLUMERING_MAGIC, sizeof(ph->pch_magic));
+    pheader		= ph;
+
+    debug_pop();
+}
+
+C_volumeRing::C_volumeRing(
+    string		astr_ringName
+) {
+    //
+    // ARGS
+    //	astr_ringName		in		POSIX shared memory object
+    //						name ("/<name>")
+    //
+    // DESC
+    //	Reader constructor: maps an existing ring. The reader takes the
+    //	volumes from the first one published.
+    //
+    // POSTCONDITIONS
+    //	o If there is no (valid) ring of that name, a warning is shown
+    //	  and b_isOpen() is false.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    core_construct();
+    debug_push("C_volumeRing");
+
+    struct stat		st_ring;
+    s_ringHeader*	ph;
+    int			fd;
+    void*		p_map	= MAP_FAILED;
+
+    str_ringName	= astr_ringName;
+    fd			= shm_open(str_ringName.c_str(), O_RDWR, 0);
+    if(fd >= 0) {
+	if(!fstat(fd, &st_ring) && st_ring.st_size >= VOLUMERING_PAGE) {
+	    mapSize	= st_ring.st_size;
+	    p_map	= mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+    }
+    if(p_map == MAP_FAILED) {
+	warn("Could not map volume ring " + str_ringName, 1);
+	mapSize	= 0;
+	debug_pop();
+	return;
+    }
+    pch_map		= (char*) p_map;
+    ph			= (s_ringHeader*) pch_map;
+    if(	strncmp(ph->pch_magic, VOLUMERING_MAGIC, 8)	||
+	ph->version != VOLUMERING_VERSION		||
+	ph->slots < 1					||
+	ph->payloadOffset + ph->slots * ph->slotStride > (long long) mapSize) {
+	warn("Not a valid volume ring: " + str_ringName, 1);
+	munmap(pch_map, mapSize);
+	pch_map	= NULL;
+	mapSize	= 0;
+    } else
+	pheader		= ph;
+
+    debug_pop();
+}
+
+C_volumeRing::~C_volumeRing() {
+    //
+    // DESC
+    //	Destructor. A producer closes the ring; see close().
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    if(b_producer)
+	close();
+    if(pch_map)
+	munmap(pch_map, mapSize);
+}
+
+s_ringSlot*
+C_volumeRing::slot_get(
+    long long		a_sequence
+) const {
+    return (s_ringSlot*) (pch_map + VOLUMERING_PAGE) + a_sequence % pheader->slots;
+}
+
+const float*
+C_volumeRing::pf_payload_get(
+    const s_ringSlot*	apslot
+) const {
+    long long	slot	= apslot - (s_ringSlot*) (pch_map + VOLUMERING_PAGE);
+    return (const float*) (pch_map + pheader->payloadOffset + slot * pheader->slotStride);
+}
+
+bool
+C_volumeRing::lock() {
+    //
+    // DESC
+    //	Locks the ring, taking over the mutex from a process that died
+    //	holding it: the slot table is only changed in single steps under
+    //	the lock, so it is still consistent.
+    //
+
+    int		ret	= pthread_mutex_lock(&pheader->mutex);
+    if(ret == EOWNERDEAD) {
+	pthread_mutex_consistent(&pheader->mutex);
+	ret	= 0;
+    }
+    return !ret;
+}
+
+void
+C_volumeRing::unlock() {
+    pthread_mutex_unlock(&pheader->mutex);
+}
+
+bool
+C_volumeRing::wait(
+    const struct timespec*	apts_deadline
+) {
+    //
+    // ARGS
+    //	apts_deadline		in		CLOCK_REALTIME deadline, or
+    //						NULL to wait for as long
+    //						as it takes
+    //
+    // DESC
+    //	Waits (locked) for a change of the slot table; see lock() for a
+    //	mutex that comes back from a dead process. False once the
+    //	deadline has passed.
+    //
+
+    int		ret;
+
+    if(apts_deadline)
+	ret	= pthread_cond_timedwait(&pheader->cond, &pheader->mutex, apts_deadline);
+    else
+	ret	= pthread_cond_wait(&pheader->cond, &pheader->mutex);
+    if(ret == EOWNERDEAD)
+	pthread_mutex_consistent(&pheader->mutex);
+    return ret != ETIMEDOUT;
+}
+
+bool
+C_volumeRing::volume_publish(
+    int				a_channel,
+    int				a_echo,
+    int				a_repetition,
+    CVol<GSL_complex_float>*	apVl,
+    CMatrix<double>&		aM_vox2ras
+) {
+    //
+    // ARGS
+    //	a_channel		in		channel of the volume
+    //	a_echo			in		echo of the volume
+    //	a_repetition		in		repetition of the volume
+    //	apVl			in		volume to publish
+    //	aM_vox2ras		in		its 4x4 vox2ras matrix
+    //
+    // DESC
+    //	Takes the next volume number and waits for its slot to be
+    //	released by the readers. The volume is copied in outside of the
+    //	lock, so that several producers (the recon workers) can fill in
+    //	their slots at the same time.
+    //
+    //	Volume <n> waits for the slot to have held volume <n> - <slots>,
+    //	published and released: with more producers than slots, a
+    //	producer ahead of its turn must not take the slot from the
+    //	one before it.
+    //
+    // POSTCONDITIONS
+    //	o Returns false, without publishing, if the volume is larger than
+    //	  a slot or the ring is not open, or if its slot is not released
+    //	  within the timeout. The ring is then of no further use.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o Waits for the volume before it in the slot, up to the timeout.
+    //
+
+    int			rows		= apVl->rows_get();
+    int			cols		= apVl->cols_get();
+    int			slices		= apVl->slices_get();
+    long long		bytes		= (long long) rows * cols * slices *
+					  2 * sizeof(float);
+    long long		sequence;
+    long		count		= 0;
+    s_ringSlot*		pslot;
+    float*		pf_payload;
+    struct timespec	ts_deadline;
+    int			i, j, k;
+
+    if(!pheader || bytes > pheader->slotBytes || !lock())
+	return false;
+    clock_gettime(CLOCK_REALTIME, &ts_deadline);
+    ts_deadline.tv_sec	+= timeout;
+    sequence		= pheader->published++;
+    pslot		= slot_get(sequence);
+    while(sequence < pheader->slots ?
+	  pslot->state != e_slotFree :
+	  (pslot->sequence != sequence - pheader->slots ||
+	   pslot->state != e_slotReady || pslot->pending > 0))
+	if(!wait(&ts_deadline)) {
+	    unlock();
+	    return false;
+	}
+    pslot->state	= e_slotWriting;
+    pslot->sequence	= sequence;
+    unlock();
+
+    pslot->channel	= a_channel;
+    pslot->echo		= a_echo;
+    pslot->repetition	= a_repetition;
+    pslot->rows		= rows;
+    pslot->cols		= cols;
+    pslot->slices	= slices;
+    pslot->bytes	= bytes;
+    for(i=0; i<16; i++)
+	pslot->pv_vox2ras[i]	= aM_vox2ras.compatible(4, 4) ?
+				  aM_vox2ras.val(i/4, i%4) : (i/4 == i%4);
+    pf_payload		= (float*) pf_payload_get(pslot);
+    for(k=0; k<slices; k++)
+	for(i=0; i<rows; i++)
+	    for(j=0; j<cols; j++) {
+		pf_payload[count++]	= GSL_REAL(apVl->val(i, j, k));
+		pf_payload[count++]	= GSL_IMAG(apVl->val(i, j, k));
+	    }
+
+    lock();
+    pslot->pending	= pheader->readers;
+    pslot->state	= e_slotReady;
+    pthread_cond_broadcast(&pheader->cond);
+    unlock();
+    return true;
+}
+
+const s_ringSlot*
+C_volumeRing::volume_next(
+    int			a_timeout	/*= 0			*/
+) {
+    //
+    // ARGS
+    //	a_timeout		in		seconds to wait (0: no limit)
+    //
+    // DESC
+    //	Waits for the next volume of this reader to be ready. Its slot is
+    //	held for the reader until volume_release(); the payload is at
+    //	pf_payload_get().
+    //
+    // POSTCONDITIONS
+    //	o Returns NULL once the ring has been closed and all its volumes
+    //	  taken, or if a_timeout expires.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    struct timespec	ts_deadline;
+    s_ringSlot*		pslot;
+    bool		b_ready;
+
+    if(!pheader || !lock())
+	return NULL;
+    clock_gettime(CLOCK_REALTIME, &ts_deadline);
+    ts_deadline.tv_sec	+= a_timeout;
+    pslot		= slot_get(next);
+    for(;;) {
+	b_ready	= pslot->sequence == next && pslot->state == e_slotReady;
+	if(b_ready || (pheader->closed && next >= pheader->published))
+	    break;
+	if(!wait(a_timeout ? &ts_deadline : NULL))
+	    break;
+    }
+    unlock();
+    if(!b_ready)
+	return NULL;
+    next++;
+    return pslot;
+}
+
+void
+C_volumeRing::volume_release(
+    const s_ringSlot*	apslot
+) {
+    //
+    // ARGS
+    //	apslot			in		slot from volume_next()
+    //
+    // DESC
+    //	Hands a slot back. Once every reader has, the producer may reuse
+    //	it, and its payload must no longer be used.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //
+
+    s_ringSlot*		pslot	= (s_ringSlot*) apslot;
+
+    if(!pheader || !pslot || !lock())
+	return;
+    if(pslot->pending > 0)
+	pslot->pending--;
+    pthread_cond_broadcast(&pheader->cond);
+    unlock();
+}
+
+bool
+C_volumeRing::close() {
+    //
+    // DESC
+    //	Producer: marks the end of the volumes, waits for the readers to
+    //	release all of them and removes the ring's name, so that the
+    //	memory goes once the readers have unmapped it. Closing a closed
+    //	ring is a no-op.
+    //
+    // PRECONDITIONS
+    //	o The other producers (the recon workers) are done.
+    //
+    // POSTCONDITIONS
+    //	o Returns false, with a warning, if the readers have not released
+    //	  the volumes within the timeout (a reader died, or none ever
+    //	  came). The name is removed all the same.
+    //
+    // HISTORY
+    // 19 October 2026
+    //  o Initial design and coding.
+    //  o Gives up after the timeout.
+    //
+
+    struct timespec	ts_deadline;
+    bool		b_busy;
+    bool		b_ok	= true;
+
+    if(!b_producer || !pheader || !lock())
+	return true;
+    pheader->closed	= 1;
+    pthread_cond_broadcast(&pheader->cond);
+    clock_gettime(CLOCK_REALTIME, &ts_deadline);
+    ts_deadline.tv_sec	+= timeout;
+    do {
+	b_busy	= false;
+	for(int i=0; i<pheader->slots; i++) {
+	    s_ringSlot*	pslot	= slot_get(i);
+	    if(pslot->state == e_slotReady && pslot->pending > 0)
+		b_busy	= true;
+	}
+	if(b_busy && !wait(&ts_deadline))
+	    b_busy	= b_ok	= false;
+    } while(b_busy);
+    unlock();
+    if(!b_ok)
+	warn("The readers of " + str_ringName + " did not release its volumes", 1);
+    shm_unlink(str_ringName.c_str());
+    b_producer	= false;
+    return b_ok;
+}
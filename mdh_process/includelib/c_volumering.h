@@ -0,0 +1,228 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+//
+// NAME
+//
+//  c_volumering.h
+//
+// DESCRIPTION
+//
+//  `c_volumering.h' declares the C_volumeRing class, a ring of
+//   reconstructed (channel, echo, repetition) volumes in a named POSIX
+//   shared memory object. mdh_process --shmRing publishes its volumes
+//   into the ring instead of saving them, and local consumers (QA, channel
+//   combination) map them from there without a round trip through the
+//   disk.
+//
+//   Object layout:
+//
+//	[header]		VOLUMERING_PAGE bytes, see s_ringHeader
+//	[slot table]		<slots> x s_ringSlot, padded to a page
+//	[payload 0]		at payloadOffset, each slot <slotStride>
+//	[payload 1]		bytes apart, holding a volume as
+//	...			[slice][row][col] (real, imag) float pairs
+//
+//   Volumes are numbered in the order in which they are published, and
+//   volume <n> goes to slot <n> % <slots>. A ring is created for a fixed
+//   number of readers. Each reader takes every volume, in order, and
+//   releases it when done with it. A slot is only reused for volume <n>
+//   once all the readers have released volume <n> - <slots>, so a
+//   producer that gets ahead waits for the readers: no volume is lost.
+//   A producer gives up after waiting <timeout> seconds for a slot (the
+//   readers died, or never came), rather than hang.
+//
+//   The header's process shared mutex and condition variable guard the
+//   slot table. The structures are in native byte order, for consumers
+//   on the same machine only.
+//
+// HISTORY
+// 19 October 2026
+//  o Initial design and coding.
+//
+
+#ifndef __C_VOLUMERING_H__
+#define __C_VOLUMERING_H__
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include <pthread.h>
+
+#include "cmatrix.h"
+
+namespace mdh {
+
+const int	C_VOLUMERING_STACKDEPTH	= 64;
+const int	VOLUMERING_VERSION	= 1;
+const char	VOLUMERING_MAGIC[]	= "MDHRING";	// 8 bytes with the '\0'
+const long	VOLUMERING_PAGE		= 4096;		// header size, and the
+							//	alignment of the
+							//	payloads
+const int	VOLUMERING_TIMEOUT	= 600;		// seconds a producer
+							//	waits for the
+							//	readers
+
+    typedef enum _ringSlotState {
+	e_slotFree		= 0,
+	e_slotWriting		= 1,
+	e_slotReady		= 2
+    } e_RINGSLOTSTATE;
+
+    typedef struct _ringHeader {
+	char		pch_magic[8];		// VOLUMERING_MAGIC
+	int		version;		// VOLUMERING_VERSION
+	int		slots;
+	int		readers;		// readers each volume waits for
+	int		closed;			// no more volumes will come
+	long long	slotBytes;		// payload capacity of a slot
+	long long	slotStride;		// payload spacing
+	long long	payloadOffset;		// of slot 0's payload
+	long long	published;		// volumes handed out to the
+						//	producers so far
+	pthread_mutex_t	mutex;
+	pthread_cond_t	cond;			// signalled on any change of
+						//	the slot table
+    } s_ringHeader;
+
+    // 256 bytes
+    typedef struct _ringSlot {
+	long long	sequence;		// number of the volume held
+	int		state;			// e_RINGSLOTSTATE
+	int		pending;		// readers yet to release it
+	int		channel;
+	int		echo;
+	int		repetition;
+	int		rows;
+	int		cols;
+	int		slices;
+	long long	bytes;			// payload size
+	double		pv_vox2ras[16];		// 4x4, row major
+	char		pch_reserved[80];
+    } s_ringSlot;
+
+class C_volumeRing {
+
+        // data structures
+
+    protected:
+        //
+        // generic object structures - used for internal bookkeeping
+        // and debugging / automated tracing methods. The stackDepth
+        // and str_proc[] variables are maintained by the debug_push|pop
+        // methods
+        //
+        string  str_obj;                    // name of object class
+        string  str_name;                   // name of object variable
+        int     id;                         // id of agent
+        int     iter;                       // current iteration in an
+                                            //      arbitrary processing scheme
+        int     verbosity;                  // debug related value for object
+        int     warnings;                   // show warnings (and warnings level)
+        int     stackDepth;                 // current pseudo stack depth
+
+        string  str_proc[C_VOLUMERING_STACKDEPTH];  // execution procedure stack
+
+	string			str_ringName;	// "/<name>"
+	bool			b_producer;	// created the ring
+	char*			pch_map;	// the whole object
+	size_t			mapSize;
+	s_ringHeader*		pheader;
+	long long		next;		// next volume this reader
+						//	takes
+	int			timeout;	// producer: seconds to wait
+						//	for the readers
+
+	// Not copyable: owns the mapping
+	C_volumeRing(const C_volumeRing&);
+	C_volumeRing& operator=(const C_volumeRing&);
+
+	s_ringSlot*		slot_get(	long long	a_sequence) const;
+	bool			lock();
+	void			unlock();
+	bool			wait(	const struct timespec*	apts_deadline);
+
+    // methods
+
+    public:
+        //
+        // constructor / destructor block
+        //
+	// Producer: (re)creates the ring
+	C_volumeRing(	string			astr_ringName,
+			int			a_slots,
+			long long		a_slotBytes,
+			int			a_readers	= 1,
+			int			a_timeout	= VOLUMERING_TIMEOUT);
+	// Reader: attaches to an existing ring
+	C_volumeRing(	string			astr_ringName);
+        void    core_construct( string  astr_name               = "unnamed",
+                                int     a_id                    = -1,
+                                int     a_iter                  = 0,
+                                int     a_verbosity             = 0,
+                                int     a_warnings              = 0,
+                                int     a_stackDepth            = 0,
+                                string  astr_proc               = "noproc");
+        ~C_volumeRing();
+
+        //
+        // error / warn / print block
+        //
+        void        debug_push(         string astr_currentProc);
+        void        debug_pop();
+
+        void        error(              string  astr_msg        = "Some error has occured",
+                                        int     code            = -1);
+        void        warn(               string  astr_msg        = "",
+                                        int     code            = -1);
+
+        //
+        // access block
+        //
+        int     stackDepth_get()        const {return stackDepth;};
+        void    stackDepth_set(int anum)
+                        { stackDepth = anum;};
+        string  str_proc_get()          const {return str_proc[stackDepth_get()];};
+        void    str_proc_set(int depth, string astr)
+                        { str_proc[depth] = astr;};
+
+	string		str_ringName_get()	const {return str_ringName;};
+	bool		b_isOpen()		const {return pheader != NULL;};
+	long long	slotBytes_get()		const
+			{return pheader ? pheader->slotBytes : 0;};
+	const float*	pf_payload_get(const s_ringSlot* apslot) const;
+
+        //
+        // miscellaneous block
+        //
+	// Producer: copies a volume into the next slot, waiting for the
+	//	readers if the ring is full. False if it does not fit, or
+	//	the readers did not free its slot in time.
+	bool		volume_publish(	int				a_channel,
+					int				a_echo,
+					int				a_repetition,
+					CVol<GSL_complex_float>*	apVl,
+					CMatrix<double>&		aM_vox2ras);
+	// Reader: the next volume, waiting up to a_timeout seconds (0: for
+	//	as long as it takes). NULL once the ring is closed and
+	//	drained, or on timeout.
+	const s_ringSlot*	volume_next(	int		a_timeout	= 0);
+	// Reader: done with a volume from volume_next()
+	void		volume_release(	const s_ringSlot*	apslot);
+	// Producer: no more volumes. Waits for the readers to release
+	//	the published volumes, and removes the ring's name. False if
+	//	they did not in time.
+	bool		close();
+
+};
+
+}
+
+#endif //__C_VOLUMERING_H__
@@ -0,0 +1,533 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+using namespace std;
+
+#include "c_options.h"
+#include "c_adcpack.h"
+#include "libmdh.h"
+using namespace mdh;
+
+// The study behind an mdh_study handle
+struct _mdh_study {
+    C_options*			pc_options;
+    C_dimensionLists*		pCdim;
+    C_adcPack*			pc_pack;	// sized for a pass, created
+						//	with the first volume
+    CMatrix<double>*		pM_vox2ras;
+    s_unpackTargets		s_IO;		// as mdh_process names files
+    s_unpackTargets		s_raw;		// as in the raw data
+    s_unpackTargets		s_packTargets;	// of pc_pack
+    int				outputFormat;
+    bool			b_3D;
+    int				volumes;
+    int				next;		// next volume to return
+    int				channelsPerPass;	// channels unpacked
+							//	together
+    int				channel0;	// first channel of the
+						//	unpacked pass, or -1
+    vector<float>		v_image;	// the last volume returned
+    string			str_error;
+};
+
+// mdh_study_open() failures, per thread
+static __thread char		pch_openError[1024]	= "";
+
+static void
+error_set(
+    mdh_study*		apstudy,
+    const string&	astr_error
+) {
+    //
+    // ARGS
+    //	apstudy			in/out		study, or NULL while opening
+    //	astr_error		in		what failed
+    //
+    // DESC
+    //	Records an error for mdh_error(). The classes of the pipeline
+    //	describe their own errors on stderr before throwing.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    if(apstudy)
+	apstudy->str_error	= astr_error;
+    else {
+	strncpy(pch_openError, astr_error.c_str(), sizeof(pch_openError)-1);
+	pch_openError[sizeof(pch_openError)-1]	= '\0';
+    }
+}
+
+static void
+study_free(
+    mdh_study*		apstudy
+) {
+    delete apstudy->pc_pack;
+    delete apstudy->pCdim;
+    delete apstudy->pM_vox2ras;
+    delete apstudy->pc_options;
+    delete apstudy;
+}
+
+static void
+pack_create(
+    mdh_study*		apstudy
+) {
+    //
+    // ARGS
+    //	apstudy			in/out		study
+    //
+    // DESC
+    //	Creates the unpack object of the study, sized for the channels
+    //	of a pass (all of them unless mdh_study_channelsPerPass() says
+    //	otherwise).
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Split out of mdh_study_open().
+    //
+
+    int		channels	= apstudy->s_raw.v_channels.size();
+
+    if(apstudy->channelsPerPass <= 0 || apstudy->channelsPerPass > channels)
+	apstudy->channelsPerPass	= channels;
+    apstudy->s_packTargets.v_channels.assign(apstudy->s_raw.v_channels.begin(),
+					     apstudy->s_raw.v_channels.begin() +
+					     apstudy->channelsPerPass);
+    switch(apstudy->outputFormat / 10) {
+	case 2:
+	    apstudy->pc_pack	= new C_adcPack_analyze75(
+				    apstudy->pCdim->str_ADCfileBaseName_get(),
+				    apstudy->pCdim, apstudy->b_3D,
+				    apstudy->s_packTargets);
+	break;
+	case 3:
+	    apstudy->pc_pack	= new C_adcPack_nifti(
+				    apstudy->pCdim->str_ADCfileBaseName_get(),
+				    apstudy->pCdim, apstudy->b_3D,
+				    apstudy->s_packTargets);
+	break;
+	default:
+	    apstudy->pc_pack	= new C_adcPack_mgh(
+				    apstudy->pCdim->str_ADCfileBaseName_get(),
+				    apstudy->pCdim, apstudy->b_3D,
+				    apstudy->s_packTargets);
+	break;
+    }
+}
+
+static void
+volume_copyOut(
+    mdh_study*			apstudy,
+    CVol<GSL_complex_float>*	apVl,
+    mdh_volume*			aps_volume
+) {
+    //
+    // ARGS
+    //	apstudy			in/out		study, holding the copy
+    //	apVl			in		volume to hand out
+    //	aps_volume		out		its dimensions, voxels and
+    //							vox2ras (channel,
+    //							echo and repetition
+    //							are up to the caller)
+    //
+    // DESC
+    //	Copies a volume of the unpack object into the study's image
+    //	buffer, as [slice][row][col] (real, imag) float pairs.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Split out of mdh_volume_next().
+    //
+
+    int		rows	= apVl->rows_get();
+    int		cols	= apVl->cols_get();
+    int		slices	= apVl->slices_get();
+    long	count	= 0;
+
+    apstudy->v_image.resize((long) rows * cols * slices * 2);
+    for(int k=0; k<slices; k++)
+	for(int i=0; i<rows; i++)
+	    for(int j=0; j<cols; j++) {
+		apstudy->v_image[count++]	= GSL_REAL(apVl->val(i, j, k));
+		apstudy->v_image[count++]	= GSL_IMAG(apVl->val(i, j, k));
+	    }
+    aps_volume->rows	= rows;
+    aps_volume->cols	= cols;
+    aps_volume->slices	= slices;
+    aps_volume->pf_data	= count ? &apstudy->v_image[0] : NULL;
+    for(int i=0; i<16; i++)
+	aps_volume->pv_vox2ras[i]	= apstudy->pM_vox2ras ?
+					  apstudy->pM_vox2ras->val(i/4, i%4) :
+					  (i/4 == i%4);
+}
+
+extern "C" int
+mdh_version(void) {
+    return LIBMDH_VERSION;
+}
+
+extern "C" mdh_study*
+mdh_study_open(
+    const char*		apch_inDir,
+    const char*		apch_optionsFile,
+    const char*		apch_channels,
+    const char*		apch_echoes,
+    const char*		apch_repetitions
+) {
+    //
+    // ARGS
+    //	apch_inDir		in		study directory
+    //	apch_optionsFile	in		options (meta data) file in it
+    //	apch_channels		in		target lists, or NULL
+    //	apch_echoes
+    //	apch_repetitions
+    //
+    // DESC
+    //	Parses the options and dimension lists, as mdh_process does
+    //	before its first pass. The unpack object is only created, and
+    //	the raw data read, by mdh_volume_next().
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o The unpack object is sized by mdh_volume_next(), for the
+    //	  channels of a pass.
+    //
+
+    mdh_study*		pstudy;
+    s_unpackTargets	s_targets;
+    string		str_value;
+    string		str_action	= "parsing the options file";
+    int			channels	= 0;
+
+    pch_openError[0]	= '\0';
+    if(!apch_inDir || !apch_optionsFile) {
+	error_set(NULL, "no study directory or options file given");
+	return NULL;
+    }
+    if(	(apch_channels    && !C_adcPack::targetList_parse(apch_channels,
+							  s_targets.v_channels)) ||
+	(apch_echoes      && !C_adcPack::targetList_parse(apch_echoes,
+							  s_targets.v_echoes))   ||
+	(apch_repetitions && !C_adcPack::targetList_parse(apch_repetitions,
+							  s_targets.v_repetitions))) {
+	error_set(NULL, "could not parse the target lists");
+	return NULL;
+    }
+
+    pstudy			= new mdh_study;
+    pstudy->pc_options		= NULL;
+    pstudy->pCdim		= NULL;
+    pstudy->pc_pack		= NULL;
+    pstudy->pM_vox2ras		= NULL;
+    pstudy->outputFormat	= 10;
+    pstudy->b_3D		= true;
+    pstudy->volumes		= 0;
+    pstudy->next		= 0;
+    pstudy->channelsPerPass	= 0;
+    pstudy->channel0		= -1;
+
+    try {
+	C_options*	pc_options;
+	pc_options		= new C_options(string(apch_inDir) + "/" + apch_optionsFile);
+	pstudy->pc_options	= pc_options;
+	if(!pc_options->b_read_get())
+	    throw string("could not read ") + apch_inDir + "/" + apch_optionsFile;
+	str_action		= "parsing the dimension lists";
+	pstudy->pCdim		= new C_dimensionLists(pc_options);
+	pstudy->pCdim->metaData_parse();
+
+	if(!pc_options->scanFor("channels", &str_value))
+	    throw string("no \"channels\" in the options file");
+	channels		= atoi(str_value.c_str());
+	if(pc_options->scanFor("outputFormat", &str_value))
+	    pstudy->outputFormat	= atoi(str_value.c_str());
+	if(pc_options->pMi_get("3DflagFile"))
+	    pstudy->b_3D	= pc_options->pMi_get("3DflagFile")->val(0, 0);
+
+	CMatrix<int>	M_echoList(pstudy->pCdim->M_echoList_get());
+	CMatrix<int>	M_repetitionList(pstudy->pCdim->M_repetitionList_get());
+	C_adcPack::targets_resolve(s_targets.v_channels, channels, NULL,
+			pstudy->s_IO.v_channels, pstudy->s_raw.v_channels);
+	C_adcPack::targets_resolve(s_targets.v_echoes, M_echoList.cols_get(), &M_echoList,
+			pstudy->s_IO.v_echoes, pstudy->s_raw.v_echoes);
+	C_adcPack::targets_resolve(s_targets.v_repetitions, M_repetitionList.cols_get(),
+			&M_repetitionList,
+			pstudy->s_IO.v_repetitions, pstudy->s_raw.v_repetitions);
+	pstudy->volumes	= pstudy->s_IO.v_channels.size() *
+			  pstudy->s_IO.v_echoes.size() *
+			  pstudy->s_IO.v_repetitions.size();
+	if(!pstudy->volumes)
+	    throw string("the study has no volumes to reconstruct");
+
+	const CMatrix<double>*	pM_vox2ras = pc_options->b_has("NIFTI_vox2ras") ?
+					     pc_options->pMv_get("NIFTI_vox2ras") :
+					     pc_options->pMv_get("MGH_vox2ras");
+	if(pM_vox2ras)
+	    pstudy->pM_vox2ras	= new CMatrix<double>(*pM_vox2ras);
+
+	if(!s_targets.v_echoes.empty())
+	    pstudy->s_packTargets.v_echoes	= pstudy->s_raw.v_echoes;
+	if(!s_targets.v_repetitions.empty())
+	    pstudy->s_packTargets.v_repetitions	= pstudy->s_raw.v_repetitions;
+    } catch(string& str_error) {
+	error_set(NULL, str_error);
+	study_free(pstudy);
+	return NULL;
+    } catch(...) {
+	error_set(NULL, "error " + str_action + " (see stderr)");
+	study_free(pstudy);
+	return NULL;
+    }
+    return pstudy;
+}
+
+extern "C" int
+mdh_study_channelsPerPass(
+    mdh_study*		apstudy,
+    int			a_channels
+) {
+    //
+    // ARGS
+    //	apstudy			in/out		study
+    //	a_channels		in		channels to unpack together
+    //							(0: all)
+    //
+    // DESC
+    //	Bounds the memory of the study: the raw data are read once per
+    //	<a_channels> channels, which are held in k-space together.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    if(!apstudy || a_channels < 0)
+	return -1;
+    if(apstudy->pc_pack) {
+	apstudy->str_error	= "the study has already been unpacked";
+	return -1;
+    }
+    apstudy->channelsPerPass	= a_channels;
+    return 0;
+}
+
+extern "C" int
+mdh_study_volumes(
+    const mdh_study*	apstudy
+) {
+    return apstudy ? apstudy->volumes : 0;
+}
+
+extern "C" int
+mdh_volume_next(
+    mdh_study*		apstudy,
+    mdh_volume*		aps_volume
+) {
+    //
+    // ARGS
+    //	apstudy			in/out		study
+    //	aps_volume		out		next volume
+    //
+    // DESC
+    //	Unpacks the raw data of the next pass of channels (all, by
+    //	default) in a single read when its first volume is due, and
+    //	reconstructs the volume as mdh_process does: zero pad and
+    //	ifftshift (unless the k-space was unpacked padded and shifted),
+    //	the IO specific preprocessing, the ifft and the fftshift.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //	o Channels are unpacked together, not one read per channel.
+    //
+
+    if(!apstudy || !aps_volume)
+	return -1;
+    if(apstudy->next >= apstudy->volumes)
+	return 0;
+
+    C_adcPack*		pc_pack;
+    int			echoes		= apstudy->s_IO.v_echoes.size();
+    int			repetitions	= apstudy->s_IO.v_repetitions.size();
+    int			unit		= apstudy->next;
+    int			echoIndex	= unit % echoes;
+    int			repetitionIndex	= (unit / echoes) % repetitions;
+    int			channel		= unit / (echoes*repetitions);
+    string		str_action	= "unpacking the raw data";
+
+    try {
+	if(!apstudy->pc_pack) {
+	    str_action	= "creating the unpack object";
+	    pack_create(apstudy);
+	    str_action	= "unpacking the raw data";
+	}
+	pc_pack		= apstudy->pc_pack;
+	if(apstudy->channel0 < 0 ||
+	   channel >= apstudy->channel0 + apstudy->channelsPerPass) {
+	    int		channel0	= channel - channel % apstudy->channelsPerPass;
+	    int		channels	= min(apstudy->channelsPerPass,
+					      (int) apstudy->s_raw.v_channels.size() -
+					      channel0);
+	    vector<int>	v_channels(apstudy->s_raw.v_channels.begin() + channel0,
+				   apstudy->s_raw.v_channels.begin() + channel0 +
+				   channels);
+	    apstudy->channel0	= -1;
+	    pc_pack->channelTargets_set(v_channels);
+	    pc_pack->headerFile_process();
+	    if(!pc_pack->dataFile_process())
+		throw string("no samples found for channels ") +
+		      C_adcPack::str_targetList(v_channels);
+	    apstudy->channel0	= channel0;
+	}
+
+	str_action	= "reconstructing the volume";
+	pc_pack->dataMemory_volumeExtract(repetitionIndex,
+					  pc_pack->kSpaceEcho_get(channel - apstudy->channel0,
+								  echoIndex),
+					  e_normalKSpace);
+	if(!pc_pack->b_unpackWpadShift_get()) {
+	    pc_pack->dataMemory_volumeZeroPad(		e_normalKSpace);
+	    pc_pack->dataMemory_volumeIfftShift(	e_normalKSpace);
+	}
+	pc_pack->dataMemory_volumePreprocess(	apstudy->s_IO.v_echoes[echoIndex], -1,
+						apstudy->s_IO.v_repetitions[repetitionIndex], -1,
+						e_normalKSpace);
+	pc_pack->dataMemory_volumeifft(		e_normalKSpace);
+	pc_pack->dataMemory_volumefftShift(	e_normalKSpace);
+
+	volume_copyOut(apstudy, pc_pack->dataMemory_volumeGet(e_normalKSpace),
+		       aps_volume);
+	pc_pack->dataMemory_volumeDestruct(e_normalKSpace);
+
+	aps_volume->channel	= apstudy->s_IO.v_channels[channel];
+	aps_volume->echo	= apstudy->s_IO.v_echoes[echoIndex];
+	aps_volume->repetition	= apstudy->s_IO.v_repetitions[repetitionIndex];
+    } catch(string& str_error) {
+	apstudy->str_error	= str_error;
+	return -1;
+    } catch(...) {
+	apstudy->str_error	= "error " + str_action + " (see stderr)";
+	return -1;
+    }
+    apstudy->next++;
+    return 1;
+}
+
+extern "C" int
+mdh_volume_load(
+    mdh_study*		apstudy,
+    const char*		apch_file,
+    const char*		apch_imagFile,
+    int			a_frame,
+    mdh_volume*		aps_volume
+) {
+    //
+    // ARGS
+    //	apstudy			in/out		study the outputs are of
+    //	apch_file		in		output file: the real MGH, the
+    //							NIfTI or the Analyze
+    //							base name
+    //	apch_imagFile		in		the imaginary MGH (MGH only)
+    //	a_frame			in		frame of a 4D MGH pair (0
+    //							otherwise)
+    //	aps_volume		out		the volume read back
+    //
+    // DESC
+    //	Reads a volume that mdh_process saved for this study back, in
+    //	the outputFormat of its options file, without reconstructing it
+    //	again. The files are mmap()ed by the C_IO loaders and decoded
+    //	into a volume of the study's dimensions.
+    //
+    // POSTCONDITIONS
+    //	o The channel, echo and repetition of aps_volume are -1: the
+    //	  files do not record them.
+    //	o Voxels outside of the readOut crop of the outputs are zero.
+    //
+    // HISTORY
+    // 19 October 2026
+    //	o Initial design and coding.
+    //
+
+    if(!apstudy || !apch_file || !aps_volume)
+	return -1;
+
+    C_adcPack*		pc_pack;
+    string		str_action	= "creating the unpack object";
+    bool		b_ok;
+    GSL_complex_float	z_zero(0, 0);
+
+    try {
+	if(!apstudy->pc_pack)
+	    pack_create(apstudy);
+	pc_pack		= apstudy->pc_pack;
+
+	// A volume of the dimensions of the saved ones to load into
+	str_action	= "loading the volume";
+	pc_pack->dataMemory_volumeExtract(0, pc_pack->kSpaceEcho_get(0, 0),
+					  e_normalKSpace);
+	if(!pc_pack->b_unpackWpadShift_get())
+	    pc_pack->dataMemory_volumeZeroPad(e_normalKSpace);
+	CVol<GSL_complex_float>*	pVl	= pc_pack->dataMemory_volumeGet(e_normalKSpace);
+	for(int k=0; k<pVl->slices_get(); k++)
+	    for(int i=0; i<pVl->rows_get(); i++)
+		for(int j=0; j<pVl->cols_get(); j++)
+		    pVl->val(i, j, k)	= z_zero;
+
+	if(apstudy->outputFormat / 10 == 2 || apstudy->outputFormat / 10 == 3)
+	    b_ok	= !a_frame && pc_pack->dataMemory_volumeLoad(apch_file, e_real);
+	else
+	    b_ok	= apch_imagFile &&
+			  pc_pack->dataMemory_volumeFrameLoad(apch_file, e_real, a_frame) &&
+			  pc_pack->dataMemory_volumeFrameLoad(apch_imagFile, e_imaginary,
+							      a_frame);
+	if(b_ok)
+	    volume_copyOut(apstudy, pVl, aps_volume);
+	pc_pack->dataMemory_volumeDestruct(e_normalKSpace);
+	if(!b_ok)
+	    throw string("could not load ") + apch_file +
+		  (apch_imagFile ? string(" / ") + apch_imagFile : string("")) +
+		  " (see stderr)";
+	aps_volume->channel	= -1;
+	aps_volume->echo	= -1;
+	aps_volume->repetition	= -1;
+    } catch(string& str_error) {
+	apstudy->str_error	= str_error;
+	return -1;
+    } catch(...) {
+	apstudy->str_error	= "error " + str_action + " (see stderr)";
+	return -1;
+    }
+    return 1;
+}
+
+extern "C" const char*
+mdh_error(
+    const mdh_study*	apstudy
+) {
+    return apstudy ? apstudy->str_error.c_str() : pch_openError;
+}
+
+extern "C" void
+mdh_study_close(
+    mdh_study*		apstudy
+) {
+    if(apstudy)
+	study_free(apstudy);
+}
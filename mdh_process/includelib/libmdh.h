@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright (C) 2003 by Rudolph Pienaar                                 *
+ *   rudolph@nmr.mgh.harvard.edu                                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+/*
+ * NAME
+ *
+ *  libmdh.h
+ *
+ * DESCRIPTION
+ *
+ *  `libmdh.h' declares the C API of libmdh, the unpack and reconstruction
+ *   pipeline of mdh_process (C_options, C_dimensionLists, C_adcPack and
+ *   its C_adc/C_IO objects) as a shared library. A service embeds the
+ *   reconstruction of a study in its own process. It gets each image in
+ *   memory, with no mdh_process to spawn and no output files to read
+ *   back.
+ *
+ *	mdh_study*	pstudy;
+ *	mdh_volume	s_volume;
+ *
+ *	pstudy	= mdh_study_open("/data/203610", "options.txt", NULL, NULL, NULL);
+ *	if(!pstudy)
+ *	    fprintf(stderr, "%s\n", mdh_error(NULL));
+ *	while(mdh_volume_next(pstudy, &s_volume) > 0)
+ *	    use(s_volume.pf_data, s_volume.rows, s_volume.cols, s_volume.slices);
+ *	mdh_study_close(pstudy);
+ *
+ *   The study is described by the same options (meta data) file as for
+ *   mdh_process. The raw data are read once, for all the targeted
+ *   channels (see mdh_study_channelsPerPass() to bound the memory this
+ *   takes), and the volumes reconstructed one at a time in the order of
+ *   mdh_process: channels, then repetitions, then echoes (fastest). Each volume is the complex image exactly as mdh_process
+ *   holds it before saving, i.e. before any output format specific
+ *   conversion (magnitude/phase, read out crop, scaling).
+ *
+ *   The automatic caches, the memory budget, the recon workers and the
+ *   output writers are features of the mdh_process executable and are not
+ *   part of the library.
+ *
+ *   A study handle must only be used by one thread at a time. Errors
+ *   never terminate the calling process: they are reported through the
+ *   return values and mdh_error().
+ *
+ * HISTORY
+ * 19 October 2026
+ *  o Initial design and coding.
+ *  o Channels unpacked in one read; mdh_study_channelsPerPass().
+ *  o mdh_volume_load() reads saved outputs back.
+ */
+
+#ifndef __LIBMDH_H__
+#define __LIBMDH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define	LIBMDH_VERSION	1			/* of this API */
+
+typedef struct _mdh_study	mdh_study;	/* opaque */
+
+typedef struct _mdh_volume {
+    int			channel;		/* as mdh_process names its */
+    int			echo;			/*	output files */
+    int			repetition;
+    int			rows;
+    int			cols;
+    int			slices;
+    const float*	pf_data;		/* [slice][row][col] (real,
+						 *	imag) float pairs, valid
+						 *	until the next call on
+						 *	the study */
+    double		pv_vox2ras[16];		/* 4x4, row major */
+} mdh_volume;
+
+/*
+ * The library's API version (LIBMDH_VERSION of the library binary).
+ */
+int		mdh_version(void);
+
+/*
+ * Opens the study described by <apch_optionsFile> in <apch_inDir>. The
+ * target lists are given as for mdh_process --channelTarget etc.
+ * ("0,3,7", "2-5"). NULL or "" selects all of a dimension.
+ *
+ * Returns NULL on failure; mdh_error(NULL) then describes it.
+ */
+mdh_study*	mdh_study_open(	const char*	apch_inDir,
+				const char*	apch_optionsFile,
+				const char*	apch_channels,
+				const char*	apch_echoes,
+				const char*	apch_repetitions);
+
+/*
+ * Unpacks <a_channels> channels of the study at a time (0, the default:
+ * all), reading the raw data once for each such pass. Fewer channels
+ * per pass take less memory. Only before the first mdh_volume_next().
+ *
+ * Returns 0, or -1 on error.
+ */
+int		mdh_study_channelsPerPass(	mdh_study*	apstudy,
+						int		a_channels);
+
+/*
+ * The number of volumes the study yields.
+ */
+int		mdh_study_volumes(	const mdh_study*	apstudy);
+
+/*
+ * Reconstructs the next volume of the study into <aps_volume>. Returns
+ * 1 if there was one, 0 once all have been returned and -1 on error.
+ */
+int		mdh_volume_next(	mdh_study*	apstudy,
+					mdh_volume*	aps_volume);
+
+/*
+ * Reads a volume that mdh_process saved for the study back into
+ * <aps_volume>, without reconstructing it: <apch_file> and
+ * <apch_imagFile> are the real and imaginary MGH outputs (single or 4D,
+ * of which <a_frame> is read), or for NIfTI and Analyze outputs
+ * <apch_file> is the file (base name) and <apch_imagFile> NULL. The
+ * volume's channel, echo and repetition are -1. Returns 1, or -1 on
+ * error.
+ */
+int		mdh_volume_load(	mdh_study*	apstudy,
+					const char*	apch_file,
+					const char*	apch_imagFile,
+					int		a_frame,
+					mdh_volume*	aps_volume);
+
+/*
+ * The last error of <apstudy>, or of the last failed mdh_study_open() of
+ * the calling thread if <apstudy> is NULL. "" if there was none.
+ */
+const char*	mdh_error(		const mdh_study*	apstudy);
+
+/*
+ * Frees the study and all its memory. NULL is allowed.
+ */
+void		mdh_study_close(	mdh_study*	apstudy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LIBMDH_H__ */
@@ -0,0 +1,84 @@
+/* NIFTI1.h  */
+
+#ifndef __NIFTI1_H__
+#define __NIFTI1_H__
+
+
+/*******************************************************************/
+/*struct nifti_1_header--the NIfTI-1 single file (.nii) header      */
+/*                                                                  */
+/* Only the subset of the NIfTI-1 specification that is needed to  */
+/* describe a (complex) reconstructed volume is defined here. The   */
+/* layout is byte compatible with the 348 byte header of the full   */
+/* nifti1.h as distributed by the NIfTI DFWG.                       */
+/********************************************************************/
+struct nifti_1_header{
+        int   sizeof_hdr;               /*required--must be 348*/
+        char  data_type[10];            /*unused*/
+        char  db_name[18];              /*unused*/
+        int   extents;                  /*unused*/
+        short session_error;            /*unused*/
+        char  regular;                  /*unused*/
+        char  dim_info;                 /*MRI slice ordering*/
+
+        short dim[8];                   /*required--data array dimensions*/
+        float intent_p1;
+        float intent_p2;
+        float intent_p3;
+        short intent_code;
+        short datatype;                 /*required--NIFTI_TYPE_* below*/
+        short bitpix;                   /*bits/voxel*/
+        short slice_start;
+        float pixdim[8];                /*grid spacings*/
+        float vox_offset;               /*offset into .nii file of voxel data*/
+        float scl_slope;                /*data scaling: slope*/
+        float scl_inter;                /*data scaling: offset*/
+        short slice_end;
+        char  slice_code;
+        char  xyzt_units;               /*units of pixdim[1..4]*/
+        float cal_max;
+        float cal_min;
+        float slice_duration;
+        float toffset;
+        int   glmax;                    /*unused*/
+        int   glmin;                    /*unused*/
+
+        char  descrip[80];              /*any text you like*/
+        char  aux_file[24];
+
+        short qform_code;               /*NIFTI_XFORM_* code*/
+        short sform_code;               /*NIFTI_XFORM_* code*/
+
+        float quatern_b;
+        float quatern_c;
+        float quatern_d;
+        float qoffset_x;
+        float qoffset_y;
+        float qoffset_z;
+
+        float srow_x[4];                /*1st row affine transform*/
+        float srow_y[4];                /*2nd row affine transform*/
+        float srow_z[4];                /*3rd row affine transform*/
+
+        char  intent_name[16];
+        char  magic[4];                 /*required--"n+1\0" for .nii*/
+};
+
+/* The 4 byte extension flag that follows the header in a .nii file */
+struct nifti1_extender{
+        char  extension[4];
+};
+
+#define NIFTI_HEADER_SIZE       348
+#define NIFTI_SINGLE_OFFSET     352     /* header + extender */
+
+#define NIFTI_TYPE_FLOAT32      16
+#define NIFTI_TYPE_COMPLEX64    32
+
+#define NIFTI_XFORM_UNKNOWN     0
+#define NIFTI_XFORM_SCANNER_ANAT 1
+
+#define NIFTI_UNITS_MM          2
+#define NIFTI_UNITS_SEC         8
+
+#endif //__NIFTI1_H__